@@ -90,7 +90,6 @@ int main()
 * - iterator_base
 * - deque
 * - Priority Queue
-* - Graph: Jump Point Search
 * - Vector3: refactor
 */
 
@@ -1,23 +1,30 @@
 #pragma once
 #include "Tests/StructureManager.h"
+#include "allocator.h"
 
+#include <algorithm>
 #include <iostream>
 #include <assert.h>
+#include <iterator>
+#include <memory>
+#include <ranges>
 #include <string>
 #include <optional>
+#include <utility>
 
 namespace zxstl
 {
 //---------------------------------------------------------------------------------------------------------------------
 // Binary Search Tree Declaration
 //---------------------------------------------------------------------------------------------------------------------
-template <class _KeyType, class _DataType>
+template <class _KeyType, class _DataType, class _Allocator = allocator<std::pair<const _KeyType, _DataType>>>
 class BinarySearchTree
 {
 public:
-	using BST = BinarySearchTree<_KeyType, _DataType>;
+	using BST = BinarySearchTree<_KeyType, _DataType, _Allocator>;
 	using KeyType = _KeyType;
 	using DataType = _DataType;
+	using Allocator = _Allocator;
 
 private:
 	struct Node
@@ -28,6 +35,7 @@ private:
 
 		KeyType m_key;
 		DataType m_data;
+		bool m_isInBlock;		// Lives in a NodeBlock, the block frees the memory
 
 		Node(const KeyType& key, const DataType& data)
 			: m_pParent(nullptr)
@@ -35,16 +43,10 @@ private:
 			, m_pRight(nullptr)
 			, m_key(key)
 			, m_data(data)
+			, m_isInBlock(false)
 		{
 		}
 
-		~Node()
-		{
-			delete m_pLeft;
-			delete m_pRight;
-			ClearPointers();
-		}
-
 		void ClearPointers()
 		{
 			m_pParent = nullptr;
@@ -53,16 +55,34 @@ private:
 		}
 	};
 
+	// Nodes made by BuildFromSorted() and InsertMany() in one allocation, freed together when the tree is destroyed
+	struct NodeBlock
+	{
+		NodeBlock* m_pNext;
+		Node* m_pNodes;
+		size_t m_count;
+	};
+
+	using NodeAllocator = rebind_allocator_t<Allocator, Node>;
+	using BlockAllocator = rebind_allocator_t<Allocator, NodeBlock>;
+	using NodePointerAllocator = rebind_allocator_t<Allocator, Node*>;
+
 private:
 	Node* m_pRoot;
 	size_t m_size;
+	NodeAllocator m_nodeAllocator;	// Every node comes from here
+	NodeBlock* m_pBlocks;			// Blocks of bulk made nodes
+	BlockAllocator m_blockAllocator;
 
 public:
 	BinarySearchTree();
+	explicit BinarySearchTree(const Allocator& alloc);
 	~BinarySearchTree();
 
 	// Modifiers
 	void Insert(const KeyType& key, const DataType& data);
+	template <class Range> void BuildFromSorted(Range&& sortedRange);
+	template <class Range> void InsertMany(Range&& range);
 	void Clear();
 	void DeleteBySuccessor(const KeyType& key);
 	void DeleteByPredecessor(const KeyType& key);
@@ -73,7 +93,7 @@ public:
 	std::optional<DataType> FindMaxIter() const;
 	std::optional<DataType> FindMinRecur() const;
 	std::optional<DataType> FindMaxRecur() const;
-	int GetHeight(Node* pNode) const;
+	size_t GetHeight() const;
 	size_t GetSize() const { return m_size; }
 	std::optional<DataType> GetRootData() const;
 
@@ -82,6 +102,8 @@ public:
 	template <class Func> void InOrderWalkRecursive(Func&& func);
 	template <class Func> void PreOrderWalkRecursive(Func&& func);
 	template <class Func> void PostOrderWalkRecursive(Func&& func);
+	template <class Func> void PreOrderWalkIterative(Func&& func);
+	template <class Func> void PostOrderWalkIterative(Func&& func);
 	void PrintNodesInOrder() const;
 
 	// Look up
@@ -91,19 +113,34 @@ public:
 
 	// Test
 	static void Test();
+	static bool UnitTest();
 
 private:
 	// Modifier
+	void InsertNode(Node* pNewNode);
 	void Destroy();
+	void DestroySubtree(Node* pNode);
 	void Transplant(Node* pNodeToReplace, Node* pReplacingNode);
 
+	// Bulk
+	template <class Range> void CreateNodeBlock(Range&& range, size_t count, Node** ppNodes);
+	Node* LinkBalanced(Node** ppNodes, size_t count);
+	void FreeNode(Node* pNode);
+	void FreeNodeBlocks();
+	static Node* GetSuccessor(Node* pNode);
+
+	// Test
+	bool ValidateTree() const;
+
 	// Accessors
-	Node* InteralFindMinRecur(Node* pParent) const;
-	Node* InternalFindMaxRecur(Node* pParent) const;
+	static Node* InternalFindMin(Node* pParent);
+	static Node* InternalFindMax(Node* pParent);
 
 	// Traversal
+	static Node* GetPreOrderSuccessor(Node* pNode, size_t& depth);
+	static Node* GetPostOrderFirst(Node* pNode);
+	static Node* GetPostOrderSuccessor(Node* pNode);
 	template <class Func> void RecursiveInOrderWalk(Node* pNode, Func&& func);
-	void RecursivePrintNodesInOrder(Node* pNode) const;
 	template <class Func> void RecursivePreOrderWalk(Node* pNode, Func&& func);
 	template <class Func> void RecursivePostOrderWalk(Node* pNode, Func&& func);
 
@@ -111,23 +148,41 @@ private:
 	Node* InternalFindNode(const KeyType& key) const;
 };
 
-template<class KeyType, class DataType>
-BinarySearchTree<KeyType, DataType>::BinarySearchTree()
+template<class KeyType, class DataType, class Allocator>
+BinarySearchTree<KeyType, DataType, Allocator>::BinarySearchTree()
+	: BinarySearchTree(Allocator())
+{
+}
+
+template<class KeyType, class DataType, class Allocator>
+BinarySearchTree<KeyType, DataType, Allocator>::BinarySearchTree(const Allocator& alloc)
 	: m_pRoot(nullptr)
 	, m_size{ 0 }
+	, m_nodeAllocator(alloc)
+	, m_pBlocks(nullptr)
+	, m_blockAllocator(alloc)
 {
 }
 
-template<class KeyType, class DataType>
-BinarySearchTree<KeyType, DataType>::~BinarySearchTree()
+template<class KeyType, class DataType, class Allocator>
+BinarySearchTree<KeyType, DataType, Allocator>::~BinarySearchTree()
 {
 	Destroy();
 }
 
-template<class KeyType, class DataType>
-void BinarySearchTree<KeyType, DataType>::Insert(const KeyType& key, const DataType& data)
+template<class KeyType, class DataType, class Allocator>
+void BinarySearchTree<KeyType, DataType, Allocator>::Insert(const KeyType& key, const DataType& data)
+{
+	InsertNode(NewObject(m_nodeAllocator, key, data));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Link a constructed node into the tree
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::InsertNode(Node* pNewNode)
 {
-	Node* pNewNode = new Node(key, data);
+	const KeyType& key = pNewNode->m_key;
 
 	Node* pParent = nullptr;
 	Node* pCurrent = m_pRoot;
@@ -169,8 +224,8 @@ void BinarySearchTree<KeyType, DataType>::Insert(const KeyType& key, const DataT
 //---------------------------------------------------------------------------------------------------------------------
 // Delete all nodes in the tree
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::Clear()
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::Clear()
 {
 	Destroy();
 }
@@ -178,8 +233,8 @@ inline void BinarySearchTree<_KeyType, _DataType>::Clear()
 //---------------------------------------------------------------------------------------------------------------------
 // Search and delete input key node
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::DeleteBySuccessor(const KeyType& key)
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::DeleteBySuccessor(const KeyType& key)
 {
 	// Find node to delete, return if not exists
 	Node* pNodeToDelete = InternalFindNode(key);
@@ -199,7 +254,7 @@ inline void BinarySearchTree<_KeyType, _DataType>::DeleteBySuccessor(const KeyTy
 	{
 		// The successor is guaranteed to be the node with the smallest value in our node's right branch.  
 		// We need to sugically remove the successor and replace our node with it.
-		Node* pSuccessor = InteralFindMinRecur(pNodeToDelete->m_pRight);
+		Node* pSuccessor = InternalFindMin(pNodeToDelete->m_pRight);
 		assert(pSuccessor);
 
 		// If the successor is not the direct child of the node we want to delete, 
@@ -219,7 +274,7 @@ inline void BinarySearchTree<_KeyType, _DataType>::DeleteBySuccessor(const KeyTy
 
 	// Destroy node
 	pNodeToDelete->ClearPointers();
-	delete pNodeToDelete;
+	FreeNode(pNodeToDelete);
 	pNodeToDelete = nullptr;
 
 	// Success deleted node
@@ -232,8 +287,8 @@ inline void BinarySearchTree<_KeyType, _DataType>::DeleteBySuccessor(const KeyTy
 //	2. Transplant predecessor's left subtree if it's not the direct child of the node we want to delete, 
 //	3. Link deleted right children to predecessor
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::DeleteByPredecessor(const KeyType& key)
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::DeleteByPredecessor(const KeyType& key)
 {	
 	// Find node to delete, return if not exists
 	Node* pNodeToDelete = InternalFindNode(key);
@@ -253,7 +308,7 @@ inline void BinarySearchTree<_KeyType, _DataType>::DeleteByPredecessor(const Key
 	{
 		// The predecessor is guaranteed to be the node with the largest value in our node's left branch.  
 		// We need to sugically remove the predecessor and replace our node with it.
-		Node* pPredecessor = InternalFindMaxRecur(pNodeToDelete->m_pLeft);
+		Node* pPredecessor = InternalFindMax(pNodeToDelete->m_pLeft);
 		assert(pPredecessor);
 
 		// If the predecessor is not the direct child of the node we want to delete, 
@@ -273,7 +328,7 @@ inline void BinarySearchTree<_KeyType, _DataType>::DeleteByPredecessor(const Key
 
 	// Destroy node
 	pNodeToDelete->ClearPointers();
-	delete pNodeToDelete;
+	FreeNode(pNodeToDelete);
 	pNodeToDelete = nullptr;
 
 	// Success deleted node
@@ -283,8 +338,8 @@ inline void BinarySearchTree<_KeyType, _DataType>::DeleteByPredecessor(const Key
 //--------------------------------------------------------------------------------------------------------------------
 // Return minimum value in this tree
 //--------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType>::FindMinIter() const
+template<class _KeyType, class _DataType, class _Allocator>
+typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType, _Allocator>::FindMinIter() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
@@ -301,8 +356,8 @@ typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType>::FindMin
 //--------------------------------------------------------------------------------------------------------------------
 // Return maximum value in this tree
 //--------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType>::FindMaxIter() const
+template<class _KeyType, class _DataType, class _Allocator>
+typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType, _Allocator>::FindMaxIter() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
@@ -316,33 +371,33 @@ typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType>::FindMax
 	return pCurrent->m_data;
 }
 
-template<class _KeyType, class _DataType>
-typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType>::FindMinRecur() const
+template<class _KeyType, class _DataType, class _Allocator>
+typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType, _Allocator>::FindMinRecur() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
 		return {};
 
-	Node* pNode = InteralFindMinRecur(m_pRoot);
+	Node* pNode = InternalFindMin(m_pRoot);
 	return pNode->m_data;
 }
 
-template<class _KeyType, class _DataType>
-typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType>::FindMaxRecur() const
+template<class _KeyType, class _DataType, class _Allocator>
+typename std::optional<_DataType> BinarySearchTree<_KeyType, _DataType, _Allocator>::FindMaxRecur() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
 		return {};
 
-	Node* pNode = InternalFindMaxRecur(m_pRoot);
+	Node* pNode = InternalFindMax(m_pRoot);
 	return pNode->m_data;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 // Allows you to change the key of a node. When a key is changed, it will need to be removed from the tree and reinserted.
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::ChangeKey(const KeyType& keyToFind, const KeyType& keyToChange)
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::ChangeKey(const KeyType& keyToFind, const KeyType& keyToChange)
 {
 	// Find node to change, return if not exists
 	Node* pNodeToChange = InternalFindNode(keyToFind);
@@ -359,14 +414,15 @@ inline void BinarySearchTree<_KeyType, _DataType>::ChangeKey(const KeyType& keyT
 	Insert(keyToChange, data);
 }
 
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::PrintNodesInOrder() const
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::PrintNodesInOrder() const
 {
-	RecursivePrintNodesInOrder(m_pRoot);
+	for (Node* pNode = m_pRoot ? InternalFindMin(m_pRoot) : nullptr; pNode; pNode = GetSuccessor(pNode))
+		std::cout << pNode->m_key << " => " << pNode->m_data << "\n";
 }
 
-template<class KeyType, class DataType>
-inline std::optional<DataType> BinarySearchTree<KeyType, DataType>::Search(const KeyType& key) const
+template<class KeyType, class DataType, class Allocator>
+inline std::optional<DataType> BinarySearchTree<KeyType, DataType, Allocator>::Search(const KeyType& key) const
 {
 	Node* pNode = InternalFindNode(key);
 	if (pNode)
@@ -376,36 +432,35 @@ inline std::optional<DataType> BinarySearchTree<KeyType, DataType>::Search(const
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Recursively get tree height
+// Get tree height, the number of nodes on the longest path from the root. A pre-order walk keeps track of the depth,
+// so a tree made a list by sorted inserts doesn't overflow the stack.
+// Time: O(n)
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline int BinarySearchTree<_KeyType, _DataType>::GetHeight(Node* pNode) const
+template<class _KeyType, class _DataType, class _Allocator>
+inline size_t BinarySearchTree<_KeyType, _DataType, _Allocator>::GetHeight() const
 {
-	// Empty tree
-	if (!m_pRoot)
-		return 0;
-
-	int leftSubTreeHeight = GetHeight(pNode->m_pLeft);
-	int rightSubTreeHeight = GetHeight(pNode->m_pRight);
+	size_t height = 0;
+	size_t depth = 1;
+	for (Node* pNode = m_pRoot; pNode; pNode = GetPreOrderSuccessor(pNode, depth))
+		height = std::max(height, depth);
 
-	// Return the greater subtree height
-	return leftSubTreeHeight > rightSubTreeHeight ? leftSubTreeHeight + 1 : rightSubTreeHeight + 1;
+	return height;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 // Return root's data if valid
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline std::optional<_DataType> BinarySearchTree<_KeyType, _DataType>::GetRootData() const
+template<class _KeyType, class _DataType, class _Allocator>
+inline std::optional<_DataType> BinarySearchTree<_KeyType, _DataType, _Allocator>::GetRootData() const
 {
 	if (m_pRoot)
 		return m_pRoot->m_data;
 	return {};
 }
 
-template<class KeyType, class DataType>
+template<class KeyType, class DataType, class Allocator>
 template<class Func>
-void BinarySearchTree<KeyType, DataType>::InOrderWalkRecursive(Func&& func)
+void BinarySearchTree<KeyType, DataType, Allocator>::InOrderWalkRecursive(Func&& func)
 {
 	RecursiveInOrderWalk(m_pRoot, std::forward<Func>(func));
 }
@@ -413,9 +468,9 @@ void BinarySearchTree<KeyType, DataType>::InOrderWalkRecursive(Func&& func)
 //---------------------------------------------------------------------------------------------------------------------
 // Iterative Inorder tree walk
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator>
 template<class Func>
-void BinarySearchTree<_KeyType, _DataType>::InOrderWalkIterative(Func&& func)
+void BinarySearchTree<_KeyType, _DataType, _Allocator>::InOrderWalkIterative(Func&& func)
 {
 	// Data
 	Node* pCurrent = m_pRoot;
@@ -462,23 +517,48 @@ void BinarySearchTree<_KeyType, _DataType>::InOrderWalkIterative(Func&& func)
 	}
 }
 
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator>
 template<class Func>
-inline void BinarySearchTree<_KeyType, _DataType>::PreOrderWalkRecursive(Func&& func)
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::PreOrderWalkRecursive(Func&& func)
 {
 	RecursivePreOrderWalk(m_pRoot, std::forward<Func>(func));
 }
 
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator>
 template<class Func>
-inline void BinarySearchTree<_KeyType, _DataType>::PostOrderWalkRecursive(Func&& func)
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::PostOrderWalkRecursive(Func&& func)
 {
 	RecursivePostOrderWalk(m_pRoot, std::forward<Func>(func));
 }
 
-template<class _KeyType, class _DataType>
+//---------------------------------------------------------------------------------------------------------------------
+// Iterative Preorder tree walk, follows the parent links so it needs no stack whatever the depth
+// Time: O(n)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
 template<class Func>
-inline void BinarySearchTree<_KeyType, _DataType>::RecursivePreOrderWalk(Node* pNode, Func&& func)
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::PreOrderWalkIterative(Func&& func)
+{
+	size_t depth = 0;
+	for (Node* pNode = m_pRoot; pNode; pNode = GetPreOrderSuccessor(pNode, depth))
+		func(const_cast<const KeyType&>(pNode->m_key), pNode->m_data);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Iterative Postorder tree walk, follows the parent links so it needs no stack whatever the depth
+// Time: O(n)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+template<class Func>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::PostOrderWalkIterative(Func&& func)
+{
+	for (Node* pNode = m_pRoot ? GetPostOrderFirst(m_pRoot) : nullptr; pNode; pNode = GetPostOrderSuccessor(pNode))
+		func(const_cast<const KeyType&>(pNode->m_key), pNode->m_data);
+}
+
+template<class _KeyType, class _DataType, class _Allocator>
+template<class Func>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::RecursivePreOrderWalk(Node* pNode, Func&& func)
 {
 	if (pNode)
 	{
@@ -488,9 +568,9 @@ inline void BinarySearchTree<_KeyType, _DataType>::RecursivePreOrderWalk(Node* p
 	}
 }
 
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator>
 template<class Func>
-inline void BinarySearchTree<_KeyType, _DataType>::RecursivePostOrderWalk(Node* pNode, Func&& func)
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::RecursivePostOrderWalk(Node* pNode, Func&& func)
 {
 	if (pNode)
 	{
@@ -500,9 +580,9 @@ inline void BinarySearchTree<_KeyType, _DataType>::RecursivePostOrderWalk(Node*
 	}
 }
 
-template<class KeyType, class DataType>
+template<class KeyType, class DataType, class Allocator>
 template<class Func>
-void BinarySearchTree<KeyType, DataType>::RecursiveInOrderWalk(Node* pNode, Func&& func)
+void BinarySearchTree<KeyType, DataType, Allocator>::RecursiveInOrderWalk(Node* pNode, Func&& func)
 {
 	if (pNode)
 	{
@@ -515,8 +595,8 @@ void BinarySearchTree<KeyType, DataType>::RecursiveInOrderWalk(Node* pNode, Func
 
 // Thomas990726@
 
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::Test()
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::Test()
 {
 	// Variables for testing
 	bool shouldQuit = false;
@@ -561,7 +641,7 @@ inline void BinarySearchTree<_KeyType, _DataType>::Test()
 
 
 		case '2':
-			bst.PreOrderWalkRecursive([](const BST::KeyType& key, const BST::DataType& data)
+			bst.PreOrderWalkIterative([](const BST::KeyType& key, const BST::DataType& data)
 			{
 				std::cout << key << " => " << data << "\n";
 			});
@@ -569,7 +649,7 @@ inline void BinarySearchTree<_KeyType, _DataType>::Test()
 			break;
 
 		case '3':
-			bst.PostOrderWalkRecursive([](const BST::KeyType& key, const BST::DataType& data)
+			bst.PostOrderWalkIterative([](const BST::KeyType& key, const BST::DataType& data)
 			{
 				std::cout << key << " => " << data << "\n";
 			});
@@ -643,23 +723,362 @@ inline void BinarySearchTree<_KeyType, _DataType>::Test()
 	}
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+// Automated test of the bulk modifiers
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline bool BinarySearchTree<_KeyType, _DataType, _Allocator>::UnitTest()
+{
+	//---------------------------------------------------------------
+	// BuildFromSorted, sorted input must not make a list
+	//---------------------------------------------------------------
+	std::pair<KeyType, DataType> pairs[kTestSize];
+	for (size_t i = 0; i < kTestSize; ++i)
+		pairs[i] = { static_cast<KeyType>(i * 2), static_cast<DataType>(i) };
+
+	BST testTree;
+	for (size_t count = 0; count <= kTestSize; ++count)
+	{
+		testTree.BuildFromSorted(std::ranges::subrange(pairs, pairs + count));
+		if (testTree.GetSize() != count || !testTree.ValidateTree())
+			RETURN_ERROR("BinarySearchTree::BuildFromSorted()");
+	}
+
+	if (testTree.m_pRoot->m_key != static_cast<KeyType>(kTestSize / 2 * 2))
+		RETURN_ERROR("BinarySearchTree::BuildFromSorted() root");
+
+	// Nodes of a block can still be deleted one by one
+	for (size_t i = 0; i < kTestSize; i += 3)
+		testTree.DeleteBySuccessor(static_cast<KeyType>(i * 2));
+	if (testTree.GetSize() != kTestSize - (kTestSize + 2) / 3 || !testTree.ValidateTree())
+		RETURN_ERROR("BinarySearchTree::DeleteBySuccessor() after BuildFromSorted()");
+
+	//---------------------------------------------------------------
+	// InsertMany, a batch large enough to rebuild and one small enough to insert one by one
+	//---------------------------------------------------------------
+	std::pair<KeyType, DataType> oddPairs[kTestSize];
+	for (size_t i = 0; i < kTestSize; ++i)
+	{
+		const size_t key = kTestSize - 1 - i;
+		oddPairs[i] = { static_cast<KeyType>(key * 2 + 1), static_cast<DataType>(key) };
+	}
+
+	// Half of the even keys, then a batch as large as the tree is merged in
+	static constexpr size_t kHalfSize = kTestSize / 2;
+	testTree.BuildFromSorted(std::ranges::subrange(pairs, pairs + kHalfSize));
+	testTree.InsertMany(std::ranges::subrange(oddPairs, oddPairs + kHalfSize));
+	if (testTree.GetSize() != kHalfSize * 2 || !testTree.ValidateTree())
+		RETURN_ERROR("BinarySearchTree::InsertMany() rebuild");
+
+	// The rest are smaller than the tree and go in one by one
+	testTree.InsertMany(std::ranges::subrange(oddPairs + kHalfSize, oddPairs + kTestSize));
+	testTree.InsertMany(std::ranges::subrange(pairs + kHalfSize, pairs + kTestSize));
+	if (testTree.GetSize() != kTestSize * 2 || !testTree.ValidateTree())
+		RETURN_ERROR("BinarySearchTree::InsertMany() one by one");
+
+	size_t expected = 0;
+	bool isInOrder = true;
+	testTree.InOrderWalkIterative([&expected, &isInOrder](const KeyType& key, DataType&)
+	{
+		isInOrder = isInOrder && key == static_cast<KeyType>(expected++);
+	});
+	if (!isInOrder)
+		RETURN_ERROR("BinarySearchTree::InsertMany() order");
+
+	//---------------------------------------------------------------
+	// Pre / post order walks and height, the middle of each range is the root of its subtree: 6 (2 (0, 4), 10 (8, 12))
+	//---------------------------------------------------------------
+	static constexpr size_t kPreOrder[] = { 3, 1, 0, 2, 5, 4, 6 };
+	static constexpr size_t kPostOrder[] = { 0, 2, 1, 4, 6, 5, 3 };
+	testTree.BuildFromSorted(std::ranges::subrange(pairs, pairs + std::size(kPreOrder)));
+
+	size_t index = 0;
+	bool isWalkInOrder = true;
+	testTree.PreOrderWalkIterative([&index, &isWalkInOrder](const KeyType& key, DataType&)
+	{
+		isWalkInOrder = isWalkInOrder && key == static_cast<KeyType>(kPreOrder[index++] * 2);
+	});
+	if (!isWalkInOrder || index != std::size(kPreOrder))
+		RETURN_ERROR("BinarySearchTree::PreOrderWalkIterative()");
+
+	index = 0;
+	testTree.PostOrderWalkIterative([&index, &isWalkInOrder](const KeyType& key, DataType&)
+	{
+		isWalkInOrder = isWalkInOrder && key == static_cast<KeyType>(kPostOrder[index++] * 2);
+	});
+	if (!isWalkInOrder || index != std::size(kPostOrder))
+		RETURN_ERROR("BinarySearchTree::PostOrderWalkIterative()");
+
+	if (testTree.GetHeight() != 3)
+		RETURN_ERROR("BinarySearchTree::GetHeight()");
+
+	// Sorted inserts make a list, every node hangs off the right of the previous one
+	testTree.Clear();
+	for (size_t i = 0; i < kTestSize; ++i)
+		testTree.Insert(static_cast<KeyType>(i), static_cast<DataType>(i));
+
+	expected = 0;
+	testTree.PreOrderWalkIterative([&expected, &isWalkInOrder](const KeyType& key, DataType&)
+	{
+		isWalkInOrder = isWalkInOrder && key == static_cast<KeyType>(expected++);
+	});
+	testTree.PostOrderWalkIterative([&expected, &isWalkInOrder](const KeyType& key, DataType&)
+	{
+		isWalkInOrder = isWalkInOrder && key == static_cast<KeyType>(--expected);
+	});
+	if (!isWalkInOrder || expected != 0 || testTree.GetHeight() != kTestSize)
+		RETURN_ERROR("BinarySearchTree walks on a list");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Check the order of the keys, the parent links and the size
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline bool BinarySearchTree<_KeyType, _DataType, _Allocator>::ValidateTree() const
+{
+	if (m_pRoot && m_pRoot->m_pParent)
+		return false;
+
+	size_t count = 0;
+	for (Node* pNode = m_pRoot ? InternalFindMin(m_pRoot) : nullptr; pNode; pNode = GetSuccessor(pNode))
+	{
+		if ((pNode->m_pLeft && pNode->m_pLeft->m_pParent != pNode) || (pNode->m_pRight && pNode->m_pRight->m_pParent != pNode))
+			return false;
+
+		Node* pNext = GetSuccessor(pNode);
+		if (pNext && pNext->m_key < pNode->m_key)
+			return false;
+		++count;
+	}
+
+	return count == m_size;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 // Destroy this tree by deleting root node
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::Destroy()
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::Destroy()
 {
-	delete m_pRoot;
+	DestroySubtree(m_pRoot);
 	m_pRoot = nullptr;
+	FreeNodeBlocks();
 
 	m_size = 0;
 }
 
+//---------------------------------------------------------------------------------------------------------------------
+// Give every node under pNode back to the allocator, children first
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::DestroySubtree(Node* pNode)
+{
+	if (!pNode)
+		return;
+
+	// Post-order, each node goes after its children and the walk never comes back to it
+	Node* pCurrent = GetPostOrderFirst(pNode);
+	while (pCurrent != pNode)
+	{
+		Node* pNext = GetPostOrderSuccessor(pCurrent);
+		FreeNode(pCurrent);
+		pCurrent = pNext;
+	}
+	FreeNode(pNode);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Replace the content of the tree with sortedRange, whose elements are (key, data) pairs sorted by key.
+// Every node comes from one allocation and the middle element of each range becomes the root of its subtree, so the
+// tree is as shallow as it can be however the keys were sorted. Plain Insert() of sorted keys makes a list instead.
+// Time: O(n)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+template <class Range>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::BuildFromSorted(Range&& sortedRange)
+{
+	Destroy();
+
+	const size_t count = static_cast<size_t>(std::ranges::distance(sortedRange));
+	if (count == 0)
+		return;
+
+	NodePointerAllocator pointerAllocator(m_nodeAllocator);
+	Node** ppNodes = std::to_address(std::allocator_traits<NodePointerAllocator>::allocate(pointerAllocator, count));
+
+	CreateNodeBlock(sortedRange, count, ppNodes);
+	assert(std::is_sorted(ppNodes, ppNodes + count, [](const Node* pLeft, const Node* pRight) { return pLeft->m_key < pRight->m_key; }));
+
+	m_pRoot = LinkBalanced(ppNodes, count);
+	m_pRoot->m_pParent = nullptr;
+	m_size = count;
+
+	std::allocator_traits<NodePointerAllocator>::deallocate(pointerAllocator, ppNodes, count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Insert every (key, data) pair of range. The batch is sorted first, then
+//  - a batch at least as large as the tree is merged with the nodes of the tree in order and the result is
+//    relinked like BuildFromSorted(), which also rebalances the tree
+//  - a small batch is inserted one by one in key order
+// Equal keys are kept, the batch ones after those already in the tree, the same as Insert() does.
+// Time: O(m * logm + n + m) when rebuilding, O(m * logm + m * h) otherwise, h = height of the tree
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+template <class Range>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::InsertMany(Range&& range)
+{
+	const size_t count = static_cast<size_t>(std::ranges::distance(range));
+	if (count == 0)
+		return;
+
+	// Same rule as RedBlackTree::InsertMany(), only rebuild when the batch is at least as large as the tree
+	const bool shouldRebuild = count >= m_size;
+	const size_t totalCount = m_size + count;
+
+	// Batch first, then the nodes of the tree and the merged order when rebuilding
+	NodePointerAllocator pointerAllocator(m_nodeAllocator);
+	const size_t pointerCount = shouldRebuild ? count + totalCount * 2 : count;
+	Node** ppNewNodes = std::to_address(std::allocator_traits<NodePointerAllocator>::allocate(pointerAllocator, pointerCount));
+
+	CreateNodeBlock(range, count, ppNewNodes);
+	std::stable_sort(ppNewNodes, ppNewNodes + count, [](const Node* pLeft, const Node* pRight) { return pLeft->m_key < pRight->m_key; });
+
+	if (shouldRebuild)
+	{
+		Node** ppOldNodes = ppNewNodes + count;
+		Node** ppMergedNodes = ppOldNodes + m_size;
+
+		size_t oldCount = 0;
+		for (Node* pNode = m_pRoot ? InternalFindMin(m_pRoot) : nullptr; pNode; pNode = GetSuccessor(pNode))
+			ppOldNodes[oldCount++] = pNode;
+		assert(oldCount == m_size);
+
+		// std::merge takes from the first range on ties, which puts the new nodes after equal old ones
+		std::merge(ppOldNodes, ppOldNodes + oldCount, ppNewNodes, ppNewNodes + count, ppMergedNodes,
+			[](const Node* pLeft, const Node* pRight) { return pLeft->m_key < pRight->m_key; });
+
+		m_pRoot = LinkBalanced(ppMergedNodes, totalCount);
+		m_pRoot->m_pParent = nullptr;
+		m_size = totalCount;
+	}
+	else
+	{
+		for (size_t i = 0; i < count; ++i)
+			InsertNode(ppNewNodes[i]);
+	}
+
+	std::allocator_traits<NodePointerAllocator>::deallocate(pointerAllocator, ppNewNodes, pointerCount);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Construct a node for each (key, data) pair of range in one new block, write their addresses to ppNodes
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+template <class Range>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::CreateNodeBlock(Range&& range, size_t count, Node** ppNodes)
+{
+	NodeBlock* pBlock = NewObject(m_blockAllocator);
+	pBlock->m_pNodes = std::to_address(std::allocator_traits<NodeAllocator>::allocate(m_nodeAllocator, count));
+	pBlock->m_count = count;
+	pBlock->m_pNext = m_pBlocks;
+	m_pBlocks = pBlock;
+
+	size_t index = 0;
+	for (auto&& element : range)
+	{
+		assert(index < count);
+		Node* pNode = new(pBlock->m_pNodes + index) Node(element.first, element.second);
+		pNode->m_isInBlock = true;
+		ppNodes[index++] = pNode;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Link the sorted nodes into a balanced subtree and return its root, the parent of the root is left to the caller
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::LinkBalanced(Node** ppNodes, size_t count)
+{
+	if (count == 0)
+		return nullptr;
+
+	const size_t middle = count / 2;
+	Node* pNode = ppNodes[middle];
+
+	pNode->m_pLeft = LinkBalanced(ppNodes, middle);
+	pNode->m_pRight = LinkBalanced(ppNodes + middle + 1, count - middle - 1);
+	if (pNode->m_pLeft)
+		pNode->m_pLeft->m_pParent = pNode;
+	if (pNode->m_pRight)
+		pNode->m_pRight->m_pParent = pNode;
+
+	return pNode;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Destroy a node, its memory goes back to the allocator unless a block owns it
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::FreeNode(Node* pNode)
+{
+	if (pNode->m_isInBlock)
+		std::destroy_at(pNode);
+	else
+		DeleteObject(m_nodeAllocator, pNode);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Free the memory of every node block, their nodes must have been destroyed already
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::FreeNodeBlocks()
+{
+	while (m_pBlocks)
+	{
+		NodeBlock* pBlock = m_pBlocks;
+		m_pBlocks = pBlock->m_pNext;
+
+		std::allocator_traits<NodeAllocator>::deallocate(m_nodeAllocator, pBlock->m_pNodes, pBlock->m_count);
+		DeleteObject(m_blockAllocator, pBlock);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the next node in key order, nullptr after the largest
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::GetSuccessor(Node* pNode)
+{
+	// Smallest node of the right subtree
+	if (pNode->m_pRight)
+	{
+		pNode = pNode->m_pRight;
+		while (pNode->m_pLeft)
+			pNode = pNode->m_pLeft;
+		return pNode;
+	}
+
+	// Otherwise the first ancestor we reach from its left side
+	Node* pParent = pNode->m_pParent;
+	while (pParent && pNode == pParent->m_pRight)
+	{
+		pNode = pParent;
+		pParent = pParent->m_pParent;
+	}
+	return pParent;
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 // Transplants one subtree with another.
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void BinarySearchTree<_KeyType, _DataType>::Transplant(Node* pNodeToReplace, Node* pReplacingNode)
+template<class _KeyType, class _DataType, class _Allocator>
+inline void BinarySearchTree<_KeyType, _DataType, _Allocator>::Transplant(Node* pNodeToReplace, Node* pReplacingNode)
 {
 	// Check to see if we're replacing the root node
 	// If so, set root node as pReplacing node
@@ -683,31 +1102,81 @@ inline void BinarySearchTree<_KeyType, _DataType>::Transplant(Node* pNodeToRepla
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Return the smallest starting the input parent node Recursively
+// Return the smallest node under the input parent node
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline typename BinarySearchTree<_KeyType, _DataType>::Node* BinarySearchTree<_KeyType, _DataType>::InteralFindMinRecur(Node* pParent) const
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::InternalFindMin(Node* pParent)
 {
-	if (pParent->m_pLeft)
-		return InteralFindMinRecur(pParent->m_pLeft);
+	while (pParent->m_pLeft)
+		pParent = pParent->m_pLeft;
 
 	return pParent;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Return the largest starting the input parent node in the tree Recursively
+// Return the largest node under the input parent node
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::InternalFindMax(Node* pParent)
+{
+	while (pParent->m_pRight)
+		pParent = pParent->m_pRight;
+
+	return pParent;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the node after pNode in pre-order, nullptr after the last one. depth is the depth of pNode on the way in and
+// of the returned node on the way out.
+// Goes down to the left child or else the right one, otherwise climbs until it comes up from a left child whose
+// parent has a right child. Every edge is taken twice over a whole walk, so the walk is O(n) with no stack.
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::GetPreOrderSuccessor(Node* pNode, size_t& depth)
+{
+	if (pNode->m_pLeft || pNode->m_pRight)
+	{
+		++depth;
+		return pNode->m_pLeft ? pNode->m_pLeft : pNode->m_pRight;
+	}
+
+	for (Node* pParent = pNode->m_pParent; pParent; pNode = pParent, pParent = pParent->m_pParent)
+	{
+		if (pNode == pParent->m_pLeft && pParent->m_pRight)
+			return pParent->m_pRight;
+		--depth;
+	}
+
+	return nullptr;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the first node of the subtree in post-order, the leaf reached by going left whenever possible
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::GetPostOrderFirst(Node* pNode)
+{
+	while (pNode->m_pLeft || pNode->m_pRight)
+		pNode = pNode->m_pLeft ? pNode->m_pLeft : pNode->m_pRight;
+
+	return pNode;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the node after pNode in post-order, only pNode's parent is read so pNode may be freed right after
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline typename BinarySearchTree<_KeyType, _DataType>::Node* BinarySearchTree<_KeyType, _DataType>::InternalFindMaxRecur(Node* pParent) const
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::GetPostOrderSuccessor(Node* pNode)
 {
-	if (pParent->m_pRight)
-		return InternalFindMaxRecur(pParent->m_pRight);
+	Node* pParent = pNode->m_pParent;
+	if (pParent && pNode == pParent->m_pLeft && pParent->m_pRight)
+		return GetPostOrderFirst(pParent->m_pRight);
 
 	return pParent;
 }
 
-template<class _KeyType, class _DataType>
-inline typename BinarySearchTree<_KeyType, _DataType>::Node* BinarySearchTree<_KeyType, _DataType>::InternalFindNode(const KeyType& key) const
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename BinarySearchTree<_KeyType, _DataType, _Allocator>::Node* BinarySearchTree<_KeyType, _DataType, _Allocator>::InternalFindNode(const KeyType& key) const
 {
 	Node* pCurrent = m_pRoot;
 	while (pCurrent)
@@ -727,15 +1196,4 @@ inline typename BinarySearchTree<_KeyType, _DataType>::Node* BinarySearchTree<_K
 }
 
 
-template<class KeyType, class DataType>
-void BinarySearchTree<KeyType, DataType>::RecursivePrintNodesInOrder(Node* pNode) const
-{
-	if (pNode)
-	{
-		RecursivePrintNodesInOrder(pNode->m_pLeft);
-		std::cout << pNode->m_key << " => " << pNode->m_data << "\n";
-		RecursivePrintNodesInOrder(pNode->m_pRight);
-	}
-}
-
 }
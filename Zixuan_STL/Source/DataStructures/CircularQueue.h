@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include "Tests/StructureManager.h"
+#include "allocator.h"
 
 namespace zxstl
 {
@@ -9,7 +10,7 @@ namespace zxstl
 // CircularQueue with a fixed size array.
 // Will wrap around by overriding elements which are already at the front of the queue when full 
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
+template<class Type, class Allocator = allocator<Type>>
 class CircularQueue
 {
 private:
@@ -22,9 +23,11 @@ private:
 	size_t m_frontIndex;
 	size_t m_rearIndex;
 
+	Allocator m_allocator;
+
 public:
 	CircularQueue();
-	CircularQueue(size_t capacity);
+	CircularQueue(size_t capacity, const Allocator& alloc = Allocator());
 	~CircularQueue();
 
 	// API
@@ -45,30 +48,33 @@ private:
 	void Destroy();
 };
 
-template<class Type>
-inline CircularQueue<Type>::CircularQueue()
+template<class Type, class Allocator>
+inline CircularQueue<Type, Allocator>::CircularQueue()
 	: m_pCircularQueue{ nullptr }
 	, m_capacity{ kInitialCapacity }
 	, m_size{ 0 }
 	, m_frontIndex{ 0 }
 	, m_rearIndex{ 0 }
 {
-	m_pCircularQueue = new Type[kInitialCapacity];
+	m_pCircularQueue = std::to_address(std::allocator_traits<Allocator>::allocate(m_allocator, m_capacity));
+	std::uninitialized_default_construct_n(m_pCircularQueue, m_capacity);
 }
 
-template<class Type>
-inline CircularQueue<Type>::CircularQueue(size_t capacity)
+template<class Type, class Allocator>
+inline CircularQueue<Type, Allocator>::CircularQueue(size_t capacity, const Allocator& alloc /*= Allocator()*/)
 	: m_pCircularQueue(nullptr)
 	, m_capacity(capacity)
 	, m_size(0)
 	, m_frontIndex{ 0 }
 	, m_rearIndex{ 0 }
+	, m_allocator(alloc)
 {
-	m_pCircularQueue = new Type[m_capacity];
+	m_pCircularQueue = std::to_address(std::allocator_traits<Allocator>::allocate(m_allocator, m_capacity));
+	std::uninitialized_default_construct_n(m_pCircularQueue, m_capacity);
 }
 
-template<class Type>
-inline CircularQueue<Type>::~CircularQueue()
+template<class Type, class Allocator>
+inline CircularQueue<Type, Allocator>::~CircularQueue()
 {
 	Destroy();
 }
@@ -76,8 +82,8 @@ inline CircularQueue<Type>::~CircularQueue()
 //--------------------------------------------------------------------------------------------------------------------
 // Will wrap around by overriding elements which are already at the front of the queue when full 
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void CircularQueue<Type>::Enqueue(const Type& val)
+template<class Type, class Allocator>
+inline void CircularQueue<Type, Allocator>::Enqueue(const Type& val)
 {
 	// We have two condition here
 	// 1. The queue is full, we need to overwrite the head, move head and tail one spot forward, and don't increment size
@@ -115,8 +121,8 @@ inline void CircularQueue<Type>::Enqueue(const Type& val)
 		m_rearIndex = 0;
 }
 
-template<class Type>
-inline Type& CircularQueue<Type>::Dequeue()
+template<class Type, class Allocator>
+inline Type& CircularQueue<Type, Allocator>::Dequeue()
 {
 	// Underflow checking
 	// If Queue.head = Queue.tail, and there is no value in there, Queue overflow
@@ -142,8 +148,8 @@ inline Type& CircularQueue<Type>::Dequeue()
 	return pVal;
 }
 
-template<class Type>
-inline void CircularQueue<Type>::Print() const
+template<class Type, class Allocator>
+inline void CircularQueue<Type, Allocator>::Print() const
 {
 	std::cout << "Queue: { ";
 
@@ -160,8 +166,8 @@ inline void CircularQueue<Type>::Print() const
 	std::cout << "} " << std::endl;
 }
 
-template<class Type>
-inline void CircularQueue<Type>::Clear()
+template<class Type, class Allocator>
+inline void CircularQueue<Type, Allocator>::Clear()
 {
 	std::memset(m_pCircularQueue, 0, sizeof(Type) * m_size);
 	m_frontIndex = 0;
@@ -169,22 +175,22 @@ inline void CircularQueue<Type>::Clear()
 	m_size = 0;
 }
 
-template<class Type>
-inline Type& CircularQueue<Type>::Rear() const
+template<class Type, class Allocator>
+inline Type& CircularQueue<Type, Allocator>::Rear() const
 {
 	assert(m_size > 0);
 	return m_pCircularQueue[(m_rearIndex == 0) ? (m_capacity - 1) : (m_rearIndex - 1)];
 }
 
-template<class Type>
-inline Type& CircularQueue<Type>::Front() const
+template<class Type, class Allocator>
+inline Type& CircularQueue<Type, Allocator>::Front() const
 {
 	assert(m_size > 0);
 	return m_pCircularQueue[m_frontIndex];
 }
 
-template<class Type>
-inline void CircularQueue<Type>::Test()
+template<class Type, class Allocator>
+inline void CircularQueue<Type, Allocator>::Test()
 {
 	// Variables for testing
 	bool shouldQuit = false;
@@ -261,8 +267,8 @@ inline void CircularQueue<Type>::Test()
 	}
 }
 
-template<class Type>
-inline void CircularQueue<Type>::Destroy()
+template<class Type, class Allocator>
+inline void CircularQueue<Type, Allocator>::Destroy()
 {
 	// If the type of elements is not trivially destructible, call it's destructor
 	if constexpr (!std::is_trivially_destructible_v<Type>)
@@ -281,7 +287,8 @@ inline void CircularQueue<Type>::Destroy()
 	// If m_pArray is not nullptr, deallocate it and set it to nullptr
 	if (m_pCircularQueue != nullptr)
 	{
-		delete[] m_pCircularQueue;
+		std::destroy_n(m_pCircularQueue, m_capacity);
+		std::allocator_traits<Allocator>::deallocate(m_allocator, m_pCircularQueue, m_capacity);
 		m_pCircularQueue = nullptr;
 	}
 }
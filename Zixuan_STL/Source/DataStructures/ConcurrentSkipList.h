@@ -0,0 +1,631 @@
+#pragma once
+#include "Tests/StructureManager.h"
+#include "allocator.h"
+
+#include <assert.h>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// Ordered map for read mostly traffic, a skip list with lock free readers
+//  - Search(), Contains() and the walks never take a lock, they only load the next pointers with acquire, so
+//    lookups never wait for an update and readers never write to memory shared with other readers
+//  - Insert() and Delete() are serialized by one writer lock. The writer publishes a fully built node with one release
+//    store per level, and never modifies a node readers can see: replacing the data of a key links in a new node
+//  - Unlinked nodes are freed with epoch based reclamation. A reader announces the epoch it started in, in a slot of
+//    its own cache line, and the writer frees a retired node only after every reader which could still see it is done
+//  - Keys are unique and compared with operator<
+//  - Nodes come from _Allocator, declared for pair<const Key, Data> like std::map. Only the writer allocates and
+//    frees, under the writer lock.
+//--------------------------------------------------------------------------------------------------------------------
+template <class _KeyType, class _DataType, class _Allocator = allocator<std::pair<const _KeyType, _DataType>>>
+class ConcurrentSkipList
+{
+public:
+	using KeyType = _KeyType;
+	using DataType = _DataType;
+	using Allocator = _Allocator;
+
+	static constexpr size_t kMaxLevel = 16;				// Enough for 4^16 keys with a 1 / 4 chance to go up a level
+	static constexpr size_t kReaderSlotCount = 64;		// Readers at once, more wait for a free slot
+	static constexpr size_t kReclaimThreshold = 64;		// Retired nodes which trigger a reclamation pass
+	static constexpr size_t kCacheLineSize = 64;
+
+private:
+	struct Node;
+	using Link = std::atomic<Node*>;
+
+	// The node is followed in memory by its m_height links, the one of level 0 first
+	struct Node
+	{
+		KeyType m_key;
+		DataType m_data;
+		uint32_t m_height;
+
+		// Only touched by the writer once the node is unlinked
+		Node* m_pNextRetired;
+		uint64_t m_retireEpoch;
+
+		Node(const KeyType& key, const DataType& data, uint32_t height)
+			: m_key(key)
+			, m_data(data)
+			, m_height(height)
+			, m_pNextRetired(nullptr)
+			, m_retireEpoch(0)
+		{
+		}
+
+		Link* GetLinks() { return reinterpret_cast<Link*>(this + 1); }
+		const Link* GetLinks() const { return reinterpret_cast<const Link*>(this + 1); }
+	};
+
+	static_assert(sizeof(Node) % alignof(Link) == 0, "Links must be aligned right after the node");
+
+	// Nodes have different sizes, so they are allocated as a run of these
+	struct alignas(Node) NodeUnit
+	{
+		std::byte m_bytes[alignof(Node)];
+	};
+
+	using NodeAllocator = rebind_allocator_t<Allocator, NodeUnit>;
+
+	// Epoch a reader started in, 0 while the slot is free
+	struct alignas(kCacheLineSize) ReaderSlot
+	{
+		std::atomic<uint64_t> m_epoch{ 0 };
+	};
+
+	// Holds a reader slot for the lifetime of a lookup
+	class ReadGuard
+	{
+		std::atomic<uint64_t>* m_pSlot;
+
+	public:
+		explicit ReadGuard(const ConcurrentSkipList& list) : m_pSlot{ list.EnterRead() } {}
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+		~ReadGuard() { m_pSlot->store(0, std::memory_order_release); }
+	};
+
+	Link m_head[kMaxLevel];							// First node of every level
+	std::atomic<size_t> m_height;					// Levels in use, readers may see it late and start lower
+	std::atomic<size_t> m_size;
+	std::atomic<uint64_t> m_epoch;					// Starts at 1, 0 marks a free reader slot
+	mutable ReaderSlot m_readerSlots[kReaderSlotCount];
+
+	// Writer state, only touched under m_writeMutex
+	std::mutex m_writeMutex;
+	NodeAllocator m_nodeAllocator;
+	Node* m_pRetired;								// Unlinked nodes waiting for the readers, newest first
+	size_t m_retiredCount;
+	uint32_t m_randomState;
+
+public:
+	ConcurrentSkipList();
+	explicit ConcurrentSkipList(const Allocator& alloc);
+	ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+	ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+	~ConcurrentSkipList();
+
+	// Modifiers, serialized among writers, never block readers
+	bool Insert(const KeyType& key, const DataType& data);
+	bool Delete(const KeyType& key);
+	void Clear();
+
+	// Look up, lock free. The data is copied out.
+	std::optional<DataType> Search(const KeyType& key) const;
+	bool Contains(const KeyType& key) const;
+	size_t GetSize() const { return m_size.load(std::memory_order_relaxed); }
+
+	// Traversal, lock free. Sees every key which is in the map for the whole walk, keys inserted or deleted meanwhile
+	// may or may not show up.
+	template <class Func> void ForEach(Func&& func) const;
+	template <class Func> void ForEachInRange(const KeyType& low, const KeyType& high, Func&& func) const;
+
+	// Test
+	static bool UnitTest();
+
+private:
+	// Readers
+	std::atomic<uint64_t>* EnterRead() const;
+	const Node* FindFirstNotLess(const KeyType& key) const;
+	static size_t GetThreadIndex();
+
+	// Writer
+	void FindPredecessors(const KeyType& key, Link** ppPredecessors);
+	uint32_t GetRandomHeight();
+	void Retire(Node* pNode);
+	void Reclaim();
+
+	// Nodes
+	static size_t GetNodeUnitCount(uint32_t height) { return (sizeof(Node) + height * sizeof(Link) + sizeof(NodeUnit) - 1) / sizeof(NodeUnit); }
+	Node* CreateNode(const KeyType& key, const DataType& data, uint32_t height);
+	void DestroyNode(Node* pNode);
+};
+
+template<class _KeyType, class _DataType, class _Allocator>
+inline ConcurrentSkipList<_KeyType, _DataType, _Allocator>::ConcurrentSkipList()
+	: ConcurrentSkipList(Allocator())
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ctor with the allocator to take nodes from
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline ConcurrentSkipList<_KeyType, _DataType, _Allocator>::ConcurrentSkipList(const Allocator& alloc)
+	: m_height{ 1 }
+	, m_size{ 0 }
+	, m_epoch{ 1 }
+	, m_nodeAllocator(alloc)
+	, m_pRetired{ nullptr }
+	, m_retiredCount{ 0 }
+	, m_randomState{ 0x9E3779B9u }
+{
+	for (Link& link : m_head)
+		link.store(nullptr, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Free every node, linked or retired. No reader may be running.
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline ConcurrentSkipList<_KeyType, _DataType, _Allocator>::~ConcurrentSkipList()
+{
+	Node* pNode = m_head[0].load(std::memory_order_relaxed);
+	while (pNode)
+	{
+		Node* pNext = pNode->GetLinks()[0].load(std::memory_order_relaxed);
+		DestroyNode(pNode);
+		pNode = pNext;
+	}
+
+	while (m_pRetired)
+	{
+		Node* pNext = m_pRetired->m_pNextRetired;
+		DestroyNode(m_pRetired);
+		m_pRetired = pNext;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert key, or replace its data if it exists. Return true if the key is new.
+// Time: O(logn) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline bool ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Insert(const KeyType& key, const DataType& data)
+{
+	std::lock_guard lock(m_writeMutex);
+
+	Link* pPredecessors[kMaxLevel];
+	FindPredecessors(key, pPredecessors);
+
+	// Existing key, readers may be reading its data, so a new node with the same height takes its place on every level
+	Node* pExisting = pPredecessors[0]->load(std::memory_order_relaxed);
+	if (pExisting && !(key < pExisting->m_key))
+	{
+		Node* pReplacement = CreateNode(key, data, pExisting->m_height);
+		for (uint32_t level = 0; level < pExisting->m_height; ++level)
+			pReplacement->GetLinks()[level].store(pExisting->GetLinks()[level].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+		for (uint32_t level = 0; level < pExisting->m_height; ++level)
+			pPredecessors[level]->store(pReplacement, std::memory_order_release);
+
+		Retire(pExisting);
+		return false;
+	}
+
+	const uint32_t height = GetRandomHeight();
+	if (height > m_height.load(std::memory_order_relaxed))
+		m_height.store(height, std::memory_order_relaxed);
+
+	Node* pNewNode = CreateNode(key, data, height);
+	for (uint32_t level = 0; level < height; ++level)
+		pNewNode->GetLinks()[level].store(pPredecessors[level]->load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	// Bottom up, a reader which finds the node on a level finds it on every level below as well
+	for (uint32_t level = 0; level < height; ++level)
+		pPredecessors[level]->store(pNewNode, std::memory_order_release);
+
+	m_size.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink key and retire its node, return false if it doesn't exist
+// Time: O(logn) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline bool ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Delete(const KeyType& key)
+{
+	std::lock_guard lock(m_writeMutex);
+
+	Link* pPredecessors[kMaxLevel];
+	FindPredecessors(key, pPredecessors);
+
+	Node* pNodeToDelete = pPredecessors[0]->load(std::memory_order_relaxed);
+	if (!pNodeToDelete || key < pNodeToDelete->m_key)
+		return false;
+
+	// Top down, the links of the node stay as they are for the readers standing on it
+	for (uint32_t level = pNodeToDelete->m_height; level-- > 0;)
+		pPredecessors[level]->store(pNodeToDelete->GetLinks()[level].load(std::memory_order_relaxed), std::memory_order_release);
+
+	Retire(pNodeToDelete);
+	m_size.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Detach every node at once and retire them
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Clear()
+{
+	std::lock_guard lock(m_writeMutex);
+
+	Node* pNode = m_head[0].load(std::memory_order_relaxed);
+	for (size_t level = kMaxLevel; level-- > 0;)
+		m_head[level].store(nullptr, std::memory_order_release);
+
+	while (pNode)
+	{
+		Node* pNext = pNode->GetLinks()[0].load(std::memory_order_relaxed);
+		Retire(pNode);
+		pNode = pNext;
+	}
+
+	m_size.store(0, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Copy the data of key out
+// Time: O(logn) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline std::optional<_DataType> ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Search(const KeyType& key) const
+{
+	ReadGuard guard(*this);
+
+	const Node* pNode = FindFirstNotLess(key);
+	if (pNode && !(key < pNode->m_key))
+		return pNode->m_data;
+
+	return {};
+}
+
+template<class _KeyType, class _DataType, class _Allocator>
+inline bool ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Contains(const KeyType& key) const
+{
+	ReadGuard guard(*this);
+
+	const Node* pNode = FindFirstNotLess(key);
+	return pNode && !(key < pNode->m_key);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call func(key, data) on every element in key order
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+template<class Func>
+inline void ConcurrentSkipList<_KeyType, _DataType, _Allocator>::ForEach(Func&& func) const
+{
+	ReadGuard guard(*this);
+
+	for (const Node* pNode = m_head[0].load(std::memory_order_acquire); pNode; pNode = pNode->GetLinks()[0].load(std::memory_order_acquire))
+		func(pNode->m_key, pNode->m_data);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call func(key, data) for every element with low <= key <= high, in key order
+// Time: O(logn + k), k = elements in range
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+template<class Func>
+inline void ConcurrentSkipList<_KeyType, _DataType, _Allocator>::ForEachInRange(const KeyType& low, const KeyType& high, Func&& func) const
+{
+	ReadGuard guard(*this);
+
+	for (const Node* pNode = FindFirstNotLess(low); pNode && !(high < pNode->m_key); pNode = pNode->GetLinks()[0].load(std::memory_order_acquire))
+		func(pNode->m_key, pNode->m_data);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Claim a free reader slot and announce the current epoch in it.
+// The fence after the claim pairs with the one in Reclaim(): either the writer sees the slot, or this reader sees
+// every unlink done before the writer's fence, so it can't reach a node the writer is about to free.
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline std::atomic<uint64_t>* ConcurrentSkipList<_KeyType, _DataType, _Allocator>::EnterRead() const
+{
+	size_t index = GetThreadIndex() % kReaderSlotCount;
+	for (;;)
+	{
+		std::atomic<uint64_t>& slot = m_readerSlots[index].m_epoch;
+		uint64_t expected = 0;
+		if (slot.load(std::memory_order_relaxed) == 0 &&
+			slot.compare_exchange_strong(expected, m_epoch.load(std::memory_order_acquire), std::memory_order_relaxed))
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			return &slot;
+		}
+
+		index = (index + 1) % kReaderSlotCount;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Return the first node whose key is not less than key, nullptr if there's none
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline const typename ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Node* ConcurrentSkipList<_KeyType, _DataType, _Allocator>::FindFirstNotLess(const KeyType& key) const
+{
+	const Link* pLinks = m_head;
+	const Node* pNext = nullptr;
+
+	for (size_t level = m_height.load(std::memory_order_relaxed); level-- > 0;)
+	{
+		pNext = pLinks[level].load(std::memory_order_acquire);
+		while (pNext && pNext->m_key < key)
+		{
+			pLinks = pNext->GetLinks();
+			pNext = pLinks[level].load(std::memory_order_acquire);
+		}
+	}
+
+	return pNext;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Small per thread number, spreads the readers over the slots
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline size_t ConcurrentSkipList<_KeyType, _DataType, _Allocator>::GetThreadIndex()
+{
+	static std::atomic<size_t> s_nextThreadIndex{ 0 };
+	thread_local const size_t t_threadIndex = s_nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+	return t_threadIndex;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Record, for every level, the link which points at the first node not less than key. Only the writer calls this,
+// so the links can't change under it.
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void ConcurrentSkipList<_KeyType, _DataType, _Allocator>::FindPredecessors(const KeyType& key, Link** ppPredecessors)
+{
+	Link* pLinks = m_head;
+	for (size_t level = kMaxLevel; level-- > 0;)
+	{
+		Node* pNext = pLinks[level].load(std::memory_order_relaxed);
+		while (pNext && pNext->m_key < key)
+		{
+			pLinks = pNext->GetLinks();
+			pNext = pLinks[level].load(std::memory_order_relaxed);
+		}
+		ppPredecessors[level] = &pLinks[level];
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Each level up is taken with a chance of 1 / 4, which gives ~1.33 links per node
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline uint32_t ConcurrentSkipList<_KeyType, _DataType, _Allocator>::GetRandomHeight()
+{
+	// xorshift
+	m_randomState ^= m_randomState << 13;
+	m_randomState ^= m_randomState >> 17;
+	m_randomState ^= m_randomState << 5;
+
+	uint32_t height = 1;
+	uint32_t bits = m_randomState;
+	while (height < kMaxLevel && (bits & 3) == 0)
+	{
+		++height;
+		bits >>= 2;
+	}
+	return height;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Queue an unlinked node for freeing, tagged with the epoch it was unlinked in
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Retire(Node* pNode)
+{
+	pNode->m_retireEpoch = m_epoch.load(std::memory_order_relaxed);
+	pNode->m_pNextRetired = m_pRetired;
+	m_pRetired = pNode;
+
+	if (++m_retiredCount >= kReclaimThreshold)
+		Reclaim();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Start a new epoch, then free the retired nodes which are older than the oldest epoch a reader is still in.
+// A reader which announced the new epoch started after every unlink so far and can't reach any retired node.
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline void ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Reclaim()
+{
+	m_epoch.fetch_add(1, std::memory_order_acq_rel);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	uint64_t oldestEpoch = UINT64_MAX;
+	for (const ReaderSlot& slot : m_readerSlots)
+	{
+		const uint64_t epoch = slot.m_epoch.load(std::memory_order_acquire);
+		if (epoch != 0 && epoch < oldestEpoch)
+			oldestEpoch = epoch;
+	}
+
+	Node** ppLink = &m_pRetired;
+	while (*ppLink)
+	{
+		Node* pNode = *ppLink;
+		if (pNode->m_retireEpoch < oldestEpoch)
+		{
+			*ppLink = pNode->m_pNextRetired;
+			DestroyNode(pNode);
+			--m_retiredCount;
+		}
+		else
+		{
+			ppLink = &pNode->m_pNextRetired;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Allocate a node with room for its links right behind it
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline typename ConcurrentSkipList<_KeyType, _DataType, _Allocator>::Node* ConcurrentSkipList<_KeyType, _DataType, _Allocator>::CreateNode(const KeyType& key, const DataType& data, uint32_t height)
+{
+	NodeUnit* pMemory = std::to_address(std::allocator_traits<NodeAllocator>::allocate(m_nodeAllocator, GetNodeUnitCount(height)));
+	Node* pNode = new(pMemory) Node(key, data, height);
+
+	for (uint32_t level = 0; level < height; ++level)
+		new(pNode->GetLinks() + level) Link(nullptr);
+
+	return pNode;
+}
+
+template<class _KeyType, class _DataType, class _Allocator>
+inline void ConcurrentSkipList<_KeyType, _DataType, _Allocator>::DestroyNode(Node* pNode)
+{
+	const size_t unitCount = GetNodeUnitCount(pNode->m_height);
+	std::destroy_n(pNode->GetLinks(), pNode->m_height);
+	std::destroy_at(pNode);
+	std::allocator_traits<NodeAllocator>::deallocate(m_nodeAllocator, reinterpret_cast<NodeUnit*>(pNode), unitCount);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unit Test for ConcurrentSkipList, readers check the keys which never change while a writer churns the others
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator>
+inline bool ConcurrentSkipList<_KeyType, _DataType, _Allocator>::UnitTest()
+{
+	static constexpr size_t kReaderCount = 3;
+	static constexpr size_t kKeyCount = 2000;
+	static constexpr size_t kWriterRounds = 20;
+
+	//---------------------------------------------------------------
+	// Single threaded basics
+	//---------------------------------------------------------------
+	ConcurrentSkipList testList;
+	for (size_t i = 0; i < kTestSize; ++i)
+	{
+		if (!testList.Insert(static_cast<KeyType>(kTestSize - 1 - i), static_cast<DataType>(i)))
+			RETURN_ERROR("ConcurrentSkipList::Insert()");
+	}
+
+	if (testList.Insert(static_cast<KeyType>(0), static_cast<DataType>(0)) || testList.Search(static_cast<KeyType>(0)) != static_cast<DataType>(0) ||
+		testList.GetSize() != kTestSize)
+	{
+		RETURN_ERROR("ConcurrentSkipList::Insert() existing key");
+	}
+
+	size_t expected = 0;
+	bool isInOrder = true;
+	testList.ForEach([&expected, &isInOrder](const KeyType& key, const DataType&)
+	{
+		isInOrder = isInOrder && key == static_cast<KeyType>(expected++);
+	});
+	if (!isInOrder || expected != kTestSize)
+		RETURN_ERROR("ConcurrentSkipList::ForEach()");
+
+	if (!testList.Delete(static_cast<KeyType>(1)) || testList.Delete(static_cast<KeyType>(1)) || testList.Contains(static_cast<KeyType>(1)))
+		RETURN_ERROR("ConcurrentSkipList::Delete()");
+
+	size_t rangeCount = 0;
+	testList.ForEachInRange(static_cast<KeyType>(0), static_cast<KeyType>(4), [&rangeCount](const KeyType&, const DataType&) { ++rangeCount; });
+	if (rangeCount != 4)
+		RETURN_ERROR("ConcurrentSkipList::ForEachInRange()");
+
+	testList.Clear();
+	if (testList.GetSize() != 0 || testList.Contains(static_cast<KeyType>(0)))
+		RETURN_ERROR("ConcurrentSkipList::Clear()");
+
+	//---------------------------------------------------------------
+	// Even keys stay put, a writer inserts, replaces and deletes the odd ones while readers look the even ones up
+	//---------------------------------------------------------------
+	for (size_t i = 0; i < kKeyCount; i += 2)
+		testList.Insert(static_cast<KeyType>(i), static_cast<DataType>(i));
+
+	std::atomic<bool> isWriterDone{ false };
+	std::vector<size_t> failures(kReaderCount, 0);
+	std::vector<std::thread> readers;
+	for (size_t readerIndex = 0; readerIndex < kReaderCount; ++readerIndex)
+	{
+		readers.emplace_back([&testList, &isWriterDone, &failures, readerIndex]()
+		{
+			size_t failureCount = 0;
+			while (!isWriterDone.load(std::memory_order_acquire))
+			{
+				for (size_t i = 0; i < kKeyCount; i += 2)
+				{
+					const std::optional<DataType> data = testList.Search(static_cast<KeyType>(i));
+					if (!data || *data != static_cast<DataType>(i))
+						++failureCount;
+				}
+
+				// Whatever the writer does, the walk must be sorted and see every even key
+				size_t evenCount = 0;
+				bool hasPrevious = false;
+				KeyType previous{};
+				testList.ForEach([&](const KeyType& key, const DataType&)
+				{
+					if (hasPrevious && !(previous < key))
+						++failureCount;
+					if (static_cast<size_t>(key) % 2 == 0)
+						++evenCount;
+					previous = key;
+					hasPrevious = true;
+				});
+				if (evenCount != kKeyCount / 2)
+					++failureCount;
+			}
+			failures[readerIndex] = failureCount;
+		});
+	}
+
+	for (size_t round = 0; round < kWriterRounds; ++round)
+	{
+		for (size_t i = 1; i < kKeyCount; i += 2)
+			testList.Insert(static_cast<KeyType>(i), static_cast<DataType>(round));
+		for (size_t i = 1; i < kKeyCount; i += 4)
+			testList.Insert(static_cast<KeyType>(i), static_cast<DataType>(round + 1));
+		for (size_t i = 1; i < kKeyCount; i += 2)
+			testList.Delete(static_cast<KeyType>(i));
+	}
+	isWriterDone.store(true, std::memory_order_release);
+
+	for (std::thread& reader : readers)
+		reader.join();
+
+	for (size_t failure : failures)
+	{
+		if (failure != 0)
+			RETURN_ERROR("ConcurrentSkipList concurrent Search() / ForEach()");
+	}
+
+	if (testList.GetSize() != kKeyCount / 2)
+		RETURN_ERROR("ConcurrentSkipList::GetSize() after concurrent updates");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+}
@@ -6,12 +6,17 @@
 
 #include "Tests/StructureManager.h"
 #include "Utils/Math/Vector2.h"
+#include "Utils/Threading/ThreadPool.h"
+#include "IndexedHeap.h"
+#include "RadixHeap.h"
 
 #include <vector>
 #include <map>
 #include <assert.h>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <queue>
 #include <stack>
 
@@ -22,9 +27,23 @@ namespace zxstl
 // - BFS
 // - DFS
 // - Dijkstra's Algorithm
-// - A*
+// - A*, on a grid or with landmarks (ALT)
+// - Bidirectional Dijkstra
 // - Transpose
 // - In/Out Degree
+//
+// Edges live in one std::map per node while the graph is built. Freeze() packs them into compressed sparse row
+// arrays, one offset per node and the targets and weights of all edges back to back, which every search walks the
+// same way through ForEachNeighbor(). A frozen graph can't take new nodes or edges until Unfreeze().
+//
+// ParallelBreadthFirstSearch() runs on a frozen graph and keeps its data in a BreadthFirstSearchState owned by the
+// caller, so the graph is only read and any number of searches can share it.
+//
+// The other searches take a SearchContext the same way, one per thread lets many threads query one graph at once.
+// Without one they reuse the graph's own context and copy its results to the vertices, which is what Test() prints.
+//
+// Point to point queries on a graph frozen with its incoming edges can search from both ends at once with
+// RunBidirectionalDijkstraFind(), or run A* on any graph with the landmark distances BuildLandmarks() precomputes.
 //--------------------------------------------------------------------------------------------------------------------
 template <class Type>
 class Graph
@@ -44,7 +63,7 @@ private:
 		Type m_data;
 		NodeId m_id;
 
-		// Graph search data, could also use SearchMap somewhere else instead
+		// Results of the last search run without a SearchContext
 		NodeId m_prev;
 		Dist m_distance;
 		bool m_closed;
@@ -67,8 +86,155 @@ private:
 	};
 
 	std::vector<GraphVertex> m_vertices;
-	AdjacencyList m_adjacencyList;
+	AdjacencyList m_adjacencyList;			// Empty while frozen
 	inline static NodeId s_id = 0;
+	size_t m_gridWidth = 5;					// Row length GetXYFromIndex() lays the nodes out with
+
+	// Frozen storage, the edges of node i are [m_edgeOffsets[i], m_edgeOffsets[i + 1]), sorted by target like the maps
+	std::vector<size_t> m_edgeOffsets;		// Node count + 1 entries, empty unless frozen
+	std::vector<NodeId> m_edgeTargets;
+	std::vector<Dist> m_edgeWeights;		// Apart from the targets, BFS and DFS never load them
+
+	// Edges coming into node i are [m_incomingOffsets[i], m_incomingOffsets[i + 1]), only built by Freeze(true)
+	std::vector<size_t> m_incomingOffsets;
+	std::vector<NodeId> m_incomingSources;
+	std::vector<Dist> m_incomingWeights;
+
+	// ALT tables of BuildLandmarks(), the distances between node i and landmark l are at [i * landmark count + l]
+	std::vector<NodeId> m_landmarkIds;
+	std::vector<Dist> m_distancesFromLandmarks;
+	std::vector<Dist> m_distancesToLandmarks;
+
+	// ParallelBreadthFirstSearch() switches to bottom-up when the frontier's edges outnumber the unexplored ones
+	// divided by kTopDownToBottomUp, and back once the frontier is smaller than the nodes divided by kBottomUpToTopDown.
+	// Values from Beamer et al., "Direction-Optimizing Breadth-First Search".
+	static constexpr size_t kTopDownToBottomUp = 14;
+	static constexpr size_t kBottomUpToTopDown = 24;
+	static constexpr size_t kParallelChunkSize = 1024;	// Frontier nodes, or bitmap words, per ParallelFor task
+
+	// Dijkstra's open set, the best distance comes out first
+#if PATH_CHOICE == 1
+	using OpenSet = IndexedHeap<Dist, 4, std::less<Dist>>;
+#elif PATH_CHOICE == 2
+	using OpenSet = IndexedHeap<Dist, 4, std::greater<Dist>>;
+#endif
+
+public:
+	//-------------------------------------------------------------
+	// Data of one ParallelBreadthFirstSearch(), reusing it keeps the buffers
+	//-------------------------------------------------------------
+	class BreadthFirstSearchState
+	{
+		friend class Graph;
+
+		// Next frontier and counts of one ParallelFor task, on its own cache line
+		struct alignas(64) TaskResult
+		{
+			std::vector<NodeId> m_frontier;
+			size_t m_nodeCount = 0;
+			size_t m_edgeCount = 0;		// Edges leaving the nodes found
+		};
+
+		std::vector<NodeId> m_prev;				// kInvalidNodeId if not reached, the start node is its own
+		std::vector<size_t> m_depth;
+		size_t m_reachedCount = 0;
+
+		std::vector<uint64_t> m_visited;		// One bit per node, only set through std::atomic_ref while top-down
+		std::vector<uint64_t> m_frontierBits;	// Frontier while bottom-up
+		std::vector<uint64_t> m_nextFrontierBits;
+		std::vector<NodeId> m_frontier;			// Frontier while top-down
+		std::vector<TaskResult> m_taskResults;
+
+	public:
+		bool IsReached(NodeId nodeId) const { return m_prev[nodeId] != kInvalidNodeId; }
+		NodeId GetPrev(NodeId nodeId) const { return m_prev[nodeId]; }
+		size_t GetDepth(NodeId nodeId) const { return m_depth[nodeId]; }
+		size_t GetReachedCount() const { return m_reachedCount; }
+	};
+
+	//-------------------------------------------------------------
+	// Data of one search, reusing it for the next search only resets the nodes that search reaches
+	//-------------------------------------------------------------
+	class SearchContext
+	{
+		friend class Graph;
+
+		struct NodeState
+		{
+			uint32_t m_generation = 0;	// Data below belongs to an older search unless it's the context's generation
+			bool m_closed = false;
+			NodeId m_prev = kInvalidNodeId;
+			Dist m_distance = kStartDist;
+		};
+
+		std::vector<NodeState> m_nodeStates;
+		std::vector<NodeId> m_reachedNodes;		// Nodes of m_nodeStates stamped with m_generation
+		uint32_t m_generation = 0;
+
+		// Open sets, kept to reuse their memory
+		std::vector<NodeId> m_openNodes;	// Queue of BFS, stack of DFS
+		OpenSet m_openSet;
+		RadixHeap<Dist, NodeId> m_radixOpenSet;
+
+	public:
+		bool IsReached(NodeId nodeId) const { return m_nodeStates[nodeId].m_generation == m_generation; }
+		bool IsClosed(NodeId nodeId) const { return IsReached(nodeId) && m_nodeStates[nodeId].m_closed; }
+		NodeId GetPrev(NodeId nodeId) const { return IsReached(nodeId) ? m_nodeStates[nodeId].m_prev : kInvalidNodeId; }
+		Dist GetDistance(NodeId nodeId) const { return IsReached(nodeId) ? m_nodeStates[nodeId].m_distance : kStartDist; }
+		const std::vector<NodeId>& GetReachedNodes() const { return m_reachedNodes; }
+
+	private:
+		// Start a search of a graph with nodeCount nodes, O(1) unless the node count changed or the generation wraps
+		void Begin(size_t nodeCount)
+		{
+			if (m_nodeStates.size() != nodeCount || ++m_generation == 0)
+			{
+				m_nodeStates.assign(nodeCount, NodeState());
+				m_openSet.Reset(nodeCount);
+				m_generation = 1;
+			}
+
+			m_reachedNodes.clear();
+			m_openNodes.clear();
+			m_openSet.Clear();
+			m_radixOpenSet.Clear();
+		}
+
+		// State of the node for this search, reset the first time the search reaches it
+		NodeState& Touch(NodeId nodeId)
+		{
+			NodeState& nodeState = m_nodeStates[nodeId];
+			if (nodeState.m_generation != m_generation)
+			{
+				nodeState = NodeState{ m_generation, false, kInvalidNodeId, kStartDist };
+				m_reachedNodes.emplace_back(nodeId);
+			}
+			return nodeState;
+		}
+	};
+
+	//-------------------------------------------------------------
+	// Data of one RunBidirectionalDijkstraFind(), a SearchContext for each end
+	//-------------------------------------------------------------
+	class BidirectionalSearchContext
+	{
+		friend class Graph;
+
+		SearchContext m_forwardContext;
+		SearchContext m_backwardContext;	// Distances to the end node, over the incoming edges
+		std::vector<NodeId> m_path;			// Start node to end node, both included
+		Dist m_distance = kStartDist;
+
+	public:
+		Dist GetDistance() const { return m_distance; }
+		const std::vector<NodeId>& GetPath() const { return m_path; }
+		size_t GetReachedCount() const { return m_forwardContext.GetReachedNodes().size() + m_backwardContext.GetReachedNodes().size(); }
+		const SearchContext& GetForwardContext() const { return m_forwardContext; }
+		const SearchContext& GetBackwardContext() const { return m_backwardContext; }
+	};
+
+private:
+	SearchContext m_searchContext;		// Reused by the searches which store their results in the vertices
 
 public:
 	// Adding
@@ -82,16 +248,41 @@ public:
 	// Transpose
 	constexpr void TransposeGraph();
 
+	// Storage
+	constexpr void Freeze(bool buildIncomingEdges = false);
+	constexpr void Unfreeze();
+	constexpr bool IsFrozen() const { return !m_edgeOffsets.empty(); }
+	constexpr bool HasIncomingEdges() const { return !m_incomingOffsets.empty(); }
+	constexpr size_t GetNodeCount() const { return m_vertices.size(); }
+	constexpr size_t GetEdgeCount() const;
+
 	// Searching
 	constexpr bool BreadthFirstSearchFind(NodeId startNodeId, NodeId endNodeId);	
+	constexpr bool BreadthFirstSearchFind(NodeId startNodeId, NodeId endNodeId, SearchContext& context) const;
 	template <class Func> constexpr void BreadthFirstSearch(NodeId startNodeId, Func&& func);
+	template <class Func> constexpr void BreadthFirstSearch(NodeId startNodeId, SearchContext& context, Func&& func) const;
 	template <class Func> constexpr void DepthFirstSearchIter(NodeId startNodeId, Func&& func);
+	template <class Func> constexpr void DepthFirstSearchIter(NodeId startNodeId, SearchContext& context, Func&& func) const;
 	template <class Func> constexpr void DepthFirstSearchRecur(NodeId startNodeId, Func&& func);
+	void ParallelBreadthFirstSearch(NodeId startNodeId, BreadthFirstSearchState& state, ThreadPool& threadPool = ThreadPool::Get()) const;
+	bool ParallelBreadthFirstSearchFind(NodeId startNodeId, NodeId endNodeId, BreadthFirstSearchState& state, ThreadPool& threadPool = ThreadPool::Get()) const;
 
 	// Path-finding
 	template <class Func> constexpr void RunDijkstraSearch(NodeId startNodeId, Func&& func);
+	template <class Func> constexpr void RunDijkstraSearch(NodeId startNodeId, SearchContext& context, Func&& func) const;
 	template <class Func> constexpr std::vector<NodeId> RunDijkstraFind(NodeId startNodeId, NodeId endNodeId, Func&& func);
+	template <class Func> constexpr std::vector<NodeId> RunDijkstraFind(NodeId startNodeId, NodeId endNodeId, SearchContext& context, Func&& func) const;
+	template <class Func> constexpr void RunRadixDijkstraSearch(NodeId startNodeId, Func&& func);
+	template <class Func> constexpr void RunRadixDijkstraSearch(NodeId startNodeId, SearchContext& context, Func&& func) const;
 	template <class Func> constexpr void RunAStar(NodeId startNodeId, NodeId destNodeId, Func&& func);
+	template <class Func> constexpr void RunAStar(NodeId startNodeId, NodeId destNodeId, SearchContext& context, Func&& func) const;
+	bool RunBidirectionalDijkstraFind(NodeId startNodeId, NodeId endNodeId, BidirectionalSearchContext& context) const;
+	template <class Func> constexpr void RunLandmarkAStar(NodeId startNodeId, NodeId destNodeId, SearchContext& context, Func&& func) const;
+
+	// Landmarks of RunLandmarkAStar()
+	void BuildLandmarks(size_t landmarkCount);
+	constexpr size_t GetLandmarkCount() const { return m_landmarkIds.size(); }
+	constexpr NodeId GetLandmarkId(size_t landmark) const { return m_landmarkIds[landmark]; }
 	 
 	// Printing
 	constexpr void PrintShortestPath(NodeId node);
@@ -100,18 +291,38 @@ public:
 	// Getters
 	constexpr Dist GetDist(NodeId fromId, NodeId toId) const;
 
+	// A* heuristic, for graphs laid out as a grid of this width
+	constexpr void SetGridWidth(size_t width) { assert(width > 0); m_gridWidth = width; }
+
 	// tests
 	constexpr void BuildUndirectedUnweightedGraph();
 	constexpr void BuildDirectedWeightedGraph();
 	constexpr void BuildDirectedUnweightedGraph();
 	void static Test();
+	static bool UnitTest();
 
 private:
 	constexpr void DestroyGraph();
+	template <class Func> constexpr void ForEachNeighbor(NodeId nodeId, Func&& func) const;
+	template <class Func> constexpr void ForEachIncomingNeighbor(NodeId nodeId, Func&& func) const;
+	constexpr const Dist* FindEdgeWeight(NodeId fromId, NodeId toId) const;
+	constexpr void BuildTransposedEdges(std::vector<size_t>& offsets, std::vector<NodeId>& sources, std::vector<Dist>* pWeights) const;
+	constexpr size_t GetFrozenOutDegree(NodeId nodeId) const { return m_edgeOffsets[nodeId + 1] - m_edgeOffsets[nodeId]; }
 	template <class Func> constexpr void InternalDepthFirstSearch(NodeId nodeId, Func&& func);
-	constexpr bool Relax(NodeId sourceNodeId, NodeId destNodeId, Dist weight);
+	template <class Func> constexpr bool InternalBreadthFirstSearch(NodeId startNodeId, NodeId endNodeId, SearchContext& context, Func&& func) const;
+	template <class Func> constexpr bool InternalDijkstraSearch(NodeId startNodeId, NodeId endNodeId, SearchContext& context, Func&& func, bool isBackward = false) const;
+	template <class Func, class HeuristicFunc> constexpr void InternalAStar(NodeId startNodeId, NodeId destNodeId, SearchContext& context, Func&& func, HeuristicFunc&& heuristicFunc) const;
+	constexpr void ClearLandmarks();
+	constexpr bool Relax(SearchContext& context, NodeId sourceNodeId, NodeId destNodeId, Dist weight) const;
+	constexpr void StoreSearchData(const SearchContext& context);
 	Dist Heuristic(NodeId sourceNodeId, NodeId destNodeId) const;
+	Dist LandmarkHeuristic(NodeId nodeId, NodeId destNodeId) const;
 	constexpr Vector2 GetXYFromIndex(NodeId id) const;	// Only works if it's a grid-like graph
+
+	// Parallel BFS
+	bool InternalParallelBreadthFirstSearch(NodeId startNodeId, NodeId endNodeId, BreadthFirstSearchState& state, ThreadPool& threadPool) const;
+	void ParallelTopDownStep(size_t depth, BreadthFirstSearchState& state, ThreadPool& threadPool) const;
+	void ParallelBottomUpStep(size_t depth, BreadthFirstSearchState& state, ThreadPool& threadPool) const;
 };
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -122,36 +333,122 @@ constexpr void Graph<Type>::DestroyGraph()
 {
 	m_vertices.clear();
 	m_adjacencyList.clear();
+	m_edgeOffsets.clear();
+	m_edgeTargets.clear();
+	m_edgeWeights.clear();
+	m_incomingOffsets.clear();
+	m_incomingSources.clear();
+	m_incomingWeights.clear();
+	ClearLandmarks();
 }
 
+//--------------------------------------------------------------------------------------------------------------------
+// Call func(neighborId, weight) for every edge leaving nodeId, in target order whichever storage is in use
+//--------------------------------------------------------------------------------------------------------------------
 template<class Type>
-inline constexpr bool Graph<Type>::Relax(NodeId sourceNodeId, NodeId destNodeId, Dist weight)
+template<class Func>
+inline constexpr void Graph<Type>::ForEachNeighbor(NodeId nodeId, Func&& func) const
 {
-#if PATH_CHOICE == 1
-	if (m_vertices[destNodeId].m_distance > m_vertices[sourceNodeId].m_distance + weight)
+	if (IsFrozen())
 	{
-		m_vertices[destNodeId].m_distance = m_vertices[sourceNodeId].m_distance + weight;
-		m_vertices[destNodeId].m_prev = sourceNodeId;
-		return true;
+		const size_t kEnd = m_edgeOffsets[nodeId + 1];
+		for (size_t edge = m_edgeOffsets[nodeId]; edge < kEnd; ++edge)
+			func(m_edgeTargets[edge], m_edgeWeights[edge]);
+	}
+	else
+	{
+		for (const auto& [kNeighborId, kWeight] : m_adjacencyList[nodeId])
+			func(kNeighborId, kWeight);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call func(neighborId, weight) for every edge coming into nodeId, in source order. Only on a graph frozen with its
+// incoming edges, searches going backward from a node use it.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::ForEachIncomingNeighbor(NodeId nodeId, Func&& func) const
+{
+	assert(HasIncomingEdges());
+
+	const size_t kEnd = m_incomingOffsets[nodeId + 1];
+	for (size_t edge = m_incomingOffsets[nodeId]; edge < kEnd; ++edge)
+		func(m_incomingSources[edge], m_incomingWeights[edge]);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Return the weight of the edge fromId -> toId, nullptr if there is none
+// Time: O(log(E)), a binary search over the node's edges when frozen
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr const typename Graph<Type>::Dist* Graph<Type>::FindEdgeWeight(NodeId fromId, NodeId toId) const
+{
+	if (IsFrozen())
+	{
+		const auto kBegin = m_edgeTargets.begin() + m_edgeOffsets[fromId];
+		const auto kEnd = m_edgeTargets.begin() + m_edgeOffsets[fromId + 1];
+		const auto kFound = std::lower_bound(kBegin, kEnd, toId);
+		if (kFound == kEnd || *kFound != toId)
+			return nullptr;
+		return &m_edgeWeights[kFound - m_edgeTargets.begin()];
 	}
+
+	const auto kFound = m_adjacencyList[fromId].find(toId);
+	if (kFound == m_adjacencyList[fromId].end())
+		return nullptr;
+	return &kFound->second;
+}
+
+template<class Type>
+inline constexpr bool Graph<Type>::Relax(SearchContext& context, NodeId sourceNodeId, NodeId destNodeId, Dist weight) const
+{
+	const Dist kDistance = context.m_nodeStates[sourceNodeId].m_distance + weight;
+	typename SearchContext::NodeState& destState = context.Touch(destNodeId);
+
+#if PATH_CHOICE == 1
+	if (destState.m_distance > kDistance)
 #elif PATH_CHOICE == 2
-	if (m_vertices[destNodeId].m_distance == kStartDist || m_vertices[destNodeId].m_distance < m_vertices[sourceNodeId].m_distance + weight)
+	if (destState.m_distance == kStartDist || destState.m_distance < kDistance)
+#endif
 	{
-		m_vertices[destNodeId].m_distance = m_vertices[sourceNodeId].m_distance + weight;
-		m_vertices[destNodeId].m_prev = sourceNodeId;
+		destState.m_distance = kDistance;
+		destState.m_prev = sourceNodeId;
 		return true;
 	}
-#endif
 
 	return false;
 }
 
+//--------------------------------------------------------------------------------------------------------------------
+// Copy the results of a search to the vertices, the nodes the search didn't reach get reset
+// O(V)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr void Graph<Type>::StoreSearchData(const SearchContext& context)
+{
+	for (GraphVertex& vertex : m_vertices)
+		vertex.ResetSearchData();
+
+	for (const NodeId kNodeId : context.m_reachedNodes)
+	{
+		const typename SearchContext::NodeState& kNodeState = context.m_nodeStates[kNodeId];
+		m_vertices[kNodeId].m_prev = kNodeState.m_prev;
+		m_vertices[kNodeId].m_distance = kNodeState.m_distance;
+		m_vertices[kNodeId].m_closed = kNodeState.m_closed;
+	}
+}
+
 //--------------------------------------------------------------------------------------------------------------------
 // calculates the distance between the two nodes' world coordinates
+// Octile distance, the cheapest path on a grid where straight steps cost at least 1 and diagonal ones sqrt(2). It never
+// overestimates on 4 or 8 connected grids, Manhattan distance does on 8 connected ones.
 //--------------------------------------------------------------------------------------------------------------------
 template<class Type>
 inline typename Graph<Type>::Dist Graph<Type>::Heuristic(NodeId sourceNodeId, NodeId destNodeId) const
 {
+	static constexpr float kDiagonalExtraCost = 1.41421356f - 1.0f;
+
 	Vector2 startPos = GetXYFromIndex(sourceNodeId);
 	float startX = startPos.x;
 	float startY = startPos.y;
@@ -160,7 +457,9 @@ inline typename Graph<Type>::Dist Graph<Type>::Heuristic(NodeId sourceNodeId, No
 	float endX = destPos.x;
 	float endY = destPos.y;
 
-	return Dist(std::fabs(startX - endX) + std::fabs(startY - endY));
+	const float kDistX = std::fabs(startX - endX);
+	const float kDistY = std::fabs(startY - endY);
+	return Dist(std::max(kDistX, kDistY) + kDiagonalExtraCost * std::min(kDistX, kDistY));
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -169,8 +468,8 @@ inline typename Graph<Type>::Dist Graph<Type>::Heuristic(NodeId sourceNodeId, No
 template<class Type>
 inline constexpr Vector2 Graph<Type>::GetXYFromIndex(NodeId id) const
 {
-	float y = static_cast<float>(id / 5);
-	float x = static_cast<float>(id % 5);
+	float y = static_cast<float>(id / m_gridWidth);
+	float x = static_cast<float>(id % m_gridWidth);
 	return Vector2(x, y);
 }
 
@@ -180,6 +479,7 @@ inline constexpr Vector2 Graph<Type>::GetXYFromIndex(NodeId id) const
 template<class Type>
 constexpr typename Graph<Type>::NodeId Graph<Type>::AddNode(const Type& data)
 {
+	assert(!IsFrozen());
 	m_vertices.emplace_back(data, s_id);
 	++s_id;
 	m_adjacencyList.emplace_back();
@@ -194,6 +494,7 @@ constexpr typename Graph<Type>::NodeId Graph<Type>::AddNode(const Type& data)
 template<class Type>
 constexpr void Graph<Type>::AddEdge(NodeId fromId, NodeId toId, Dist weight /*= 1.0f*/)
 {
+	assert(!IsFrozen());
 	assert(fromId < m_vertices.size() && toId < m_vertices.size());
 	m_adjacencyList[fromId].emplace(toId, weight);
 }
@@ -215,7 +516,7 @@ inline constexpr size_t Graph<Type>::ComputeInDegree(NodeId nodeId)
 	{
 		// Collect all nodes that pointing to the target node
 		// O(log(E))
-		if (m_adjacencyList[i].find(nodeId) != m_adjacencyList[i].end())
+		if (FindEdgeWeight(i, nodeId))
 			++count;
 	}
 
@@ -230,6 +531,8 @@ template<class Type>
 inline constexpr size_t Graph<Type>::ComputeOutDegree(NodeId nodeId)
 {
 	assert(nodeId < m_vertices.size());
+	if (IsFrozen())
+		return m_edgeOffsets[nodeId + 1] - m_edgeOffsets[nodeId];
 	return m_adjacencyList[nodeId].size();
 }
 
@@ -243,6 +546,33 @@ inline constexpr void Graph<Type>::TransposeGraph()
 {
 	assert(!m_vertices.empty());
 
+	// Distances from a landmark are now distances to it
+	// O(1)
+	m_distancesFromLandmarks.swap(m_distancesToLandmarks);
+
+	// Frozen, the incoming edges are the new edges
+	// O(1) if they are built already, O(V + E) otherwise
+	if (IsFrozen())
+	{
+		if (HasIncomingEdges())
+		{
+			m_incomingOffsets.swap(m_edgeOffsets);
+			m_incomingSources.swap(m_edgeTargets);
+			m_incomingWeights.swap(m_edgeWeights);
+			return;
+		}
+
+		std::vector<size_t> transposedOffsets;
+		std::vector<NodeId> transposedTargets;
+		std::vector<Dist> transposedWeights;
+		BuildTransposedEdges(transposedOffsets, transposedTargets, &transposedWeights);
+
+		m_edgeOffsets.swap(transposedOffsets);
+		m_edgeTargets.swap(transposedTargets);
+		m_edgeWeights.swap(transposedWeights);
+		return;
+	}
+
 	// Grab an empty adjacencylist as the result 
 	// Space: O(E)
 	AdjacencyList transposedAdjacencyList;
@@ -265,54 +595,131 @@ inline constexpr void Graph<Type>::TransposeGraph()
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Assignment 12.2 breadth first search finding
+// Pack the edges into the compressed sparse row arrays and free the maps. Each edge then costs a target and a
+// weight instead of a tree node, and the edges of a node are read in one sequential pass.
+// buildIncomingEdges also packs each node's incoming edges, a source and a weight per edge, which
+// ParallelBreadthFirstSearch() needs to go bottom-up and the searches going backward from a node need to walk.
+// Time: O(V + E)
 //--------------------------------------------------------------------------------------------------------------------
 template<class Type>
-inline constexpr bool Graph<Type>::BreadthFirstSearchFind(NodeId startNodeId, NodeId endNodeId)
+inline constexpr void Graph<Type>::Freeze(bool buildIncomingEdges /*= false*/)
 {
-	// reset all the search data
-	// O(|V|)
-	for (GraphVertex& vertex : m_vertices)
-		vertex.ResetSearchData();
-
-	// set the search data for the starting vertex
-	m_vertices[startNodeId].m_distance = 0;
-	m_vertices[startNodeId].m_closed = true;
+	assert(!IsFrozen());
 
-	// Declare the open set, which is the queue of nodes we need to visit, and push our starting node there.
-	std::queue<NodeId> openSet;
-	openSet.push(startNodeId);
+	m_edgeOffsets.resize(m_vertices.size() + 1);
+	m_edgeTargets.reserve(GetEdgeCount());
+	m_edgeWeights.reserve(GetEdgeCount());
 
-	// Search begins here, quit search if openSet is empty
-	while (!openSet.empty())
+	for (NodeId nodeId = 0; nodeId < m_vertices.size(); ++nodeId)
 	{
-		// Pop the next vertex off of the queue
-		NodeId currentNodeId = openSet.front();
-		openSet.pop();
+		m_edgeOffsets[nodeId] = m_edgeTargets.size();
+		for (const auto& [kNeighborId, kWeight] : m_adjacencyList[nodeId])
+		{
+			m_edgeTargets.emplace_back(kNeighborId);
+			m_edgeWeights.emplace_back(kWeight);
+		}
+	}
+	m_edgeOffsets.back() = m_edgeTargets.size();
 
-		// Return if found end node id
-		if (currentNodeId == endNodeId)
-			return true;
+	AdjacencyList().swap(m_adjacencyList);
 
-		// For each neighbor of the current node
-		// O(E)
-		for (const auto& [kNeighborId, kWeight] : m_adjacencyList[currentNodeId])
-		{
-			// If we haven't seen this neighbor before
-			if (!m_vertices[kNeighborId].m_closed)
-			{
-				// Set the distance and previous node
-				m_vertices[kNeighborId].m_distance = m_vertices[currentNodeId].m_distance + 1;
-				m_vertices[kNeighborId].m_prev = currentNodeId;
+	if (buildIncomingEdges)
+		BuildTransposedEdges(m_incomingOffsets, m_incomingSources, &m_incomingWeights);
+}
 
-				// close the node and add to the open set
-				m_vertices[kNeighborId].m_closed = true;
-				openSet.push(kNeighborId);
-			}
+//--------------------------------------------------------------------------------------------------------------------
+// Build the compressed sparse row arrays of the reversed edges: count the edges coming into each node to place them,
+// then fill them in source order so each node's edges stay sorted. Weights are only copied if pWeights is given.
+// Time: O(V + E)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr void Graph<Type>::BuildTransposedEdges(std::vector<size_t>& offsets, std::vector<NodeId>& sources, std::vector<Dist>* pWeights) const
+{
+	assert(IsFrozen());
+
+	offsets.assign(m_edgeOffsets.size(), 0);
+	for (const NodeId kTargetId : m_edgeTargets)
+		++offsets[kTargetId + 1];
+	for (size_t i = 1; i < offsets.size(); ++i)
+		offsets[i] += offsets[i - 1];
+
+	sources.resize(m_edgeTargets.size());
+	if (pWeights)
+		pWeights->resize(m_edgeTargets.size());
+
+	std::vector<size_t> nextSlots(offsets.begin(), offsets.end() - 1);
+	for (NodeId nodeId = 0; nodeId < m_vertices.size(); ++nodeId)
+	{
+		for (size_t edge = m_edgeOffsets[nodeId]; edge < m_edgeOffsets[nodeId + 1]; ++edge)
+		{
+			const size_t kSlot = nextSlots[m_edgeTargets[edge]]++;
+			sources[kSlot] = nodeId;
+			if (pWeights)
+				(*pWeights)[kSlot] = m_edgeWeights[edge];
 		}
 	}
+}
 
-	return false;
+//--------------------------------------------------------------------------------------------------------------------
+// Rebuild the maps from the compressed sparse row arrays so nodes and edges can be added again
+// Time: O(V + E*log(E))
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr void Graph<Type>::Unfreeze()
+{
+	assert(IsFrozen());
+
+	m_adjacencyList.resize(m_vertices.size());
+	for (NodeId nodeId = 0; nodeId < m_vertices.size(); ++nodeId)
+	{
+		for (size_t edge = m_edgeOffsets[nodeId]; edge < m_edgeOffsets[nodeId + 1]; ++edge)
+			m_adjacencyList[nodeId].emplace_hint(m_adjacencyList[nodeId].end(), m_edgeTargets[edge], m_edgeWeights[edge]);
+	}
+
+	std::vector<size_t>().swap(m_edgeOffsets);
+	std::vector<NodeId>().swap(m_edgeTargets);
+	std::vector<Dist>().swap(m_edgeWeights);
+	std::vector<size_t>().swap(m_incomingOffsets);
+	std::vector<NodeId>().swap(m_incomingSources);
+	std::vector<Dist>().swap(m_incomingWeights);
+	ClearLandmarks();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Return the number of edges
+// Time: O(1) when frozen, O(V) otherwise
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr size_t Graph<Type>::GetEdgeCount() const
+{
+	if (IsFrozen())
+		return m_edgeTargets.size();
+
+	size_t count = 0;
+	for (const Edge& edges : m_adjacencyList)
+		count += edges.size();
+	return count;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Assignment 12.2 breadth first search finding, the results are stored in the vertices
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr bool Graph<Type>::BreadthFirstSearchFind(NodeId startNodeId, NodeId endNodeId)
+{
+	SearchContext& context = m_searchContext;
+	const bool kHasFound = BreadthFirstSearchFind(startNodeId, endNodeId, context);
+	StoreSearchData(context);
+	return kHasFound;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Breadth first search which stops once it gets to endNodeId, the graph is only read
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr bool Graph<Type>::BreadthFirstSearchFind(NodeId startNodeId, NodeId endNodeId, SearchContext& context) const
+{
+	return InternalBreadthFirstSearch(startNodeId, endNodeId, context, [](NodeId, const Type&) {});
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -339,12 +746,10 @@ inline constexpr void Graph<Type>::PrintGraph()
 	for (NodeId nodeId = 0; nodeId < m_vertices.size(); ++nodeId)
 	{
 		std::cout << nodeId << "->";
-		for (NodeId adjacentNodeId = 0; adjacentNodeId < m_adjacencyList[nodeId].size(); ++adjacentNodeId)
+		ForEachNeighbor(nodeId, [](const NodeId kNeighborId, const Dist)
 		{
-			auto itr = m_adjacencyList[nodeId].begin();
-			std::advance(itr, adjacentNodeId);
-			std::cout << itr->first << ", ";
-		}
+			std::cout << kNeighborId << ", ";
+		});
 		std::cout << std::endl;
 	}
 	std::cout << std::endl;
@@ -356,8 +761,9 @@ inline constexpr void Graph<Type>::PrintGraph()
 template<class Type>
 inline constexpr typename Graph<Type>::Dist Graph<Type>::GetDist(NodeId fromId, NodeId toId) const
 {
-	assert(m_adjacencyList[fromId].find(toId) != m_adjacencyList[fromId].end());
-	return m_adjacencyList[fromId].at(toId);
+	const Dist* pWeight = FindEdgeWeight(fromId, toId);
+	assert(pWeight);
+	return *pWeight;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -597,320 +1003,943 @@ inline void Graph<Type>::Test()
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Run breadth first search with start node
+// Automated test of the frozen storage, every search must visit the same nodes in the same order as on the maps
 //--------------------------------------------------------------------------------------------------------------------
 template<class Type>
-template<class Func>
-inline constexpr void Graph<Type>::BreadthFirstSearch(NodeId startNodeId, Func&& func)
+inline bool Graph<Type>::UnitTest()
 {
-	// reset all the search data
-	// O(|V|)
-	for (GraphVertex& vertex : m_vertices)
-		vertex.ResetSearchData();
+	// Visited nodes and distances of every search from the first node, Type must hold the node ids
+	auto runSearches = [](Graph<Type>& graph, std::vector<NodeId>& visits, std::vector<Dist>& distances)
+	{
+		visits.clear();
+		distances.clear();
+		auto recordVisit = [&visits](NodeId nodeId, const Type&) { visits.emplace_back(nodeId); };
+		auto recordData = [&visits](const Type& data) { visits.emplace_back(static_cast<NodeId>(data)); };
+		auto recordDistances = [&graph, &distances]()
+		{
+			for (const GraphVertex& vertex : graph.m_vertices)
+				distances.emplace_back(vertex.m_distance);
+		};
+
+		graph.BreadthFirstSearch(0, recordVisit);
+		recordDistances();
+		visits.emplace_back(graph.BreadthFirstSearchFind(0, graph.GetNodeCount() - 1));
+		graph.DepthFirstSearchIter(0, recordData);
+		graph.DepthFirstSearchRecur(0, recordData);
+		graph.RunDijkstraSearch(0, recordVisit);
+		recordDistances();
+		for (const NodeId kNodeId : graph.RunDijkstraFind(0, graph.GetNodeCount() - 1, recordVisit))
+			visits.emplace_back(kNodeId);
+		graph.RunAStar(0, graph.GetNodeCount() - 1, recordVisit);
+		recordDistances();
+	};
 
-	// set the search data for the starting vertex
-	m_vertices[startNodeId].m_distance = 0;
-	m_vertices[startNodeId].m_closed = true;
+	// Parallel BFS of the frozen graph must reach the nodes BFS of graph does at the same depths, through real edges
+	ThreadPool threadPool(2);
+	BreadthFirstSearchState state;
+	auto checkParallelSearch = [&threadPool, &state](Graph<Type>& graph, const Graph<Type>& frozenGraph)
+	{
+		const NodeId kEndNodeId = graph.GetNodeCount() - 1;
+		graph.BreadthFirstSearch(0, [](NodeId, const Type&) {});
+		if (frozenGraph.ParallelBreadthFirstSearchFind(0, kEndNodeId, state, threadPool) != graph.m_vertices[kEndNodeId].m_closed)
+			return false;
+
+		frozenGraph.ParallelBreadthFirstSearch(0, state, threadPool);
+		size_t reachedCount = 0;
+		for (NodeId nodeId = 0; nodeId < graph.GetNodeCount(); ++nodeId)
+		{
+			const GraphVertex& kVertex = graph.m_vertices[nodeId];
+			if (state.IsReached(nodeId) != kVertex.m_closed)
+				return false;
+			if (!kVertex.m_closed)
+				continue;
 
-	// Declare the open set, which is the queue of nodes we need to visit, and push our starting node there.
-	std::queue<NodeId> openSet;
-	openSet.emplace(startNodeId);
+			++reachedCount;
+			if (static_cast<Dist>(state.GetDepth(nodeId)) != kVertex.m_distance)
+				return false;
+			if (nodeId != 0 && (state.GetDepth(state.GetPrev(nodeId)) + 1 != state.GetDepth(nodeId) || !frozenGraph.FindEdgeWeight(state.GetPrev(nodeId), nodeId)))
+				return false;
+		}
+		return reachedCount == state.GetReachedCount();
+	};
 
-	// Search begins here, quit search if openSet is empty
-	while (!openSet.empty())
+	// The 5x5 grid A* expects, moving right costs 1 and moving down 2
+	Graph<Type> gridGraph;
+	for (NodeId nodeId = 0; nodeId < 25; ++nodeId)
+		gridGraph.AddNode(static_cast<Type>(nodeId));
+	for (NodeId nodeId = 0; nodeId < 25; ++nodeId)
 	{
-		// Pop the next vertex off of the queue
-		const NodeId kCurrentNodeId = openSet.front();
-		openSet.pop();
+		if (nodeId % 5 != 4)
+			gridGraph.AddEdge(nodeId, nodeId + 1, 1.0f);
+		if (nodeId < 20)
+			gridGraph.AddEdge(nodeId, nodeId + 5, 2.0f);
+	}
 
-		// Perform lambda function here
-		func(kCurrentNodeId, m_vertices[kCurrentNodeId].m_data);
+	Graph<Type> graphs[4];
+	graphs[0].BuildDirectedWeightedGraph();
+	graphs[1].BuildUndirectedUnweightedGraph();
+	graphs[2].BuildDirectedUnweightedGraph();
+	graphs[3] = gridGraph;
+
+	//---------------------------------------------------------------
+	// Parallel BFS of a graph big enough to split into tasks and go bottom-up
+	//---------------------------------------------------------------
+	Graph<Type> randomGraph;
+	for (NodeId nodeId = 0; nodeId < 5000; ++nodeId)
+		randomGraph.AddNode(Type());
+	uint32_t randomState = 1;
+	for (size_t i = 0; i < 5000 * 8; ++i)
+	{
+		randomState = randomState * 1664525 + 1013904223;
+		const NodeId kFromId = (randomState >> 8) % 5000;
+		randomState = randomState * 1664525 + 1013904223;
+		const NodeId kToId = (randomState >> 8) % 5000;
+		randomState = randomState * 1664525 + 1013904223;
+		randomGraph.AddEdge(kFromId, kToId, static_cast<Dist>((randomState >> 8) % 100 + 1) * 0.25f);
+	}
 
-		// For each neighbor of the current node
-		// O(E)
-		for (const auto& [kNeighbor, kWeight] : m_adjacencyList[kCurrentNodeId])
+	for (int buildIncomingEdges = 0; buildIncomingEdges < 2; ++buildIncomingEdges)
+	{
+		Graph<Type> frozenGraph = randomGraph;
+		frozenGraph.Freeze(buildIncomingEdges != 0);
+		if (frozenGraph.HasIncomingEdges() != (buildIncomingEdges != 0) || !checkParallelSearch(randomGraph, frozenGraph))
+			RETURN_ERROR("Graph::ParallelBreadthFirstSearch()");
+	}
+
+#if PATH_CHOICE == 1
+	//---------------------------------------------------------------
+	// Dijkstra against Bellman-Ford, every node reached once in distance order
+	//---------------------------------------------------------------
+	std::vector<Dist> shortestDistances(randomGraph.GetNodeCount(), kStartDist);
+	shortestDistances[0] = 0.0f;
+	for (bool hasChanged = true; hasChanged; )
+	{
+		hasChanged = false;
+		for (NodeId fromId = 0; fromId < randomGraph.GetNodeCount(); ++fromId)
 		{
-			// If we haven't seen this neighbor before
-			if (m_vertices[kNeighbor].m_closed)
+			if (shortestDistances[fromId] == kStartDist)
 				continue;
-			
-			// Set the distance and previous node
-			m_vertices[kNeighbor].m_distance = m_vertices[kCurrentNodeId].m_distance + 1;
-			m_vertices[kNeighbor].m_prev = kCurrentNodeId;
 
-			// close the node and add to the open set
-			m_vertices[kNeighbor].m_closed = true;
-			openSet.emplace(kNeighbor);
+			randomGraph.ForEachNeighbor(fromId, [&](const NodeId kToId, const Dist kWeight)
+			{
+				if (shortestDistances[fromId] + kWeight < shortestDistances[kToId])
+				{
+					shortestDistances[kToId] = shortestDistances[fromId] + kWeight;
+					hasChanged = true;
+				}
+			});
 		}
 	}
-}
 
-//--------------------------------------------------------------------------------------------------------------------
-// Iterative depth first search with a stack
-// O(V + E)
-//--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-template<class Func>
-inline constexpr void Graph<Type>::DepthFirstSearchIter(NodeId startNodeId, Func&& func)
-{
-	// O(V)
-	for (GraphVertex& node : m_vertices)
-		node.ResetSearchData();
+	auto checkDijkstra = [&randomGraph, &shortestDistances](bool useRadixHeap)
+	{
+		std::vector<NodeId> visits;
+		auto recordVisit = [&visits](NodeId nodeId, const Type&) { visits.emplace_back(nodeId); };
+		if (useRadixHeap)
+			randomGraph.RunRadixDijkstraSearch(0, recordVisit);
+		else
+			randomGraph.RunDijkstraSearch(0, recordVisit);
+
+		std::vector<bool> isVisited(randomGraph.GetNodeCount(), false);
+		for (size_t i = 0; i < visits.size(); ++i)
+		{
+			const Dist kDistance = randomGraph.m_vertices[visits[i]].m_distance;
+			if (isVisited[visits[i]] || (i > 0 && kDistance < randomGraph.m_vertices[visits[i - 1]].m_distance))
+				return false;
+			isVisited[visits[i]] = true;
+		}
 
-	// set the search data for the starting vertex
-	m_vertices[startNodeId].m_distance = 0;
-	m_vertices[startNodeId].m_closed = true;
+		for (NodeId nodeId = 0; nodeId < randomGraph.GetNodeCount(); ++nodeId)
+		{
+			if (isVisited[nodeId] != (shortestDistances[nodeId] != kStartDist) || randomGraph.m_vertices[nodeId].m_distance != shortestDistances[nodeId])
+				return false;
+		}
+		return true;
+	};
 
-	// Declare the open stack, which is the stack of nodes we need to visit, and push our starting node there.
-	std::stack<NodeId> openSet;
-	openSet.emplace(startNodeId);
+	if (!checkDijkstra(false))
+		RETURN_ERROR("Graph::RunDijkstraSearch()");
+	if (!checkDijkstra(true))
+		RETURN_ERROR("Graph::RunRadixDijkstraSearch()");
+	randomGraph.Freeze(true);
+	if (!checkDijkstra(false) || !checkDijkstra(true))
+		RETURN_ERROR("Graph Dijkstra when frozen");
+
+	//---------------------------------------------------------------
+	// SearchContext, one per thread querying the same graph, reused after a search which stopped early
+	//---------------------------------------------------------------
+	const Graph<Type>& kReadOnlyGraph = randomGraph;
+	std::vector<SearchContext> contexts(4);
+	std::atomic<size_t> failedTaskCount = 0;
+	auto checkContexts = [&]()
+	{
+		threadPool.ParallelFor(contexts.size(), [&](size_t task)
+		{
+			SearchContext& context = contexts[task];
+			const NodeId kEndNodeId = task * 1000 + 1;
+			kReadOnlyGraph.RunDijkstraFind(0, kEndNodeId, context, [](NodeId, const Type&) {});
+			if (context.GetDistance(kEndNodeId) != shortestDistances[kEndNodeId] ||
+				kReadOnlyGraph.BreadthFirstSearchFind(0, kEndNodeId, context) != (shortestDistances[kEndNodeId] != kStartDist))
+			{
+				++failedTaskCount;
+			}
 
-	// Search begins here, quit search if openSet is empty
-	while (!openSet.empty())
+			kReadOnlyGraph.RunDijkstraSearch(0, context, [](NodeId, const Type&) {});
+			for (NodeId nodeId = 0; nodeId < kReadOnlyGraph.GetNodeCount(); ++nodeId)
+			{
+				if (context.GetDistance(nodeId) != shortestDistances[nodeId] || context.IsClosed(nodeId) != (shortestDistances[nodeId] != kStartDist))
+				{
+					++failedTaskCount;
+					break;
+				}
+			}
+		});
+	};
+
+	checkContexts();
+	for (SearchContext& context : contexts)
+		context.m_generation = std::numeric_limits<uint32_t>::max();
+	checkContexts();
+	if (failedTaskCount != 0)
+		RETURN_ERROR("Graph::SearchContext");
+
+	//---------------------------------------------------------------
+	// Point to point, bidirectional Dijkstra and landmark A* against Dijkstra, before and after transposing
+	//---------------------------------------------------------------
+	auto noVisit = [](NodeId, const Type&) {};
+	auto isShortestPath = [&randomGraph](const std::vector<NodeId>& path, NodeId startNodeId, NodeId endNodeId, Dist distance)
 	{
-		// Pop the next vertex off of the stack
-		const NodeId kCurrentNodeId = openSet.top();
-		openSet.pop();
+		if (path.empty() || path.front() != startNodeId || path.back() != endNodeId)
+			return false;
 
-		// Perfrom func here
-		func(m_vertices[kCurrentNodeId].m_data);
+		Dist pathDistance = 0.0f;
+		for (size_t i = 1; i < path.size(); ++i)
+		{
+			const Dist* pWeight = randomGraph.FindEdgeWeight(path[i - 1], path[i]);
+			if (!pWeight)
+				return false;
+			pathDistance += *pWeight;
+		}
+		return pathDistance == distance;
+	};
 
-		// For each neighbor of the current node
-		// O(E)
-		for (const auto& [kTargetId, kWeight] : m_adjacencyList[kCurrentNodeId])
+	SearchContext dijkstraContext;
+	SearchContext landmarkContext;
+	BidirectionalSearchContext bidirectionalContext;
+	auto checkPointToPoint = [&](bool useLandmarks)
+	{
+		uint32_t queryState = 7;
+		for (size_t query = 0; query < kTestSize * 4; ++query)
 		{
-			if (!m_vertices[kTargetId].m_closed)
-			{
-				// set the distance and previous node
-				m_vertices[kTargetId].m_distance = m_vertices[kCurrentNodeId].m_distance + 1;
-				m_vertices[kTargetId].m_prev = kCurrentNodeId;
+			queryState = queryState * 1664525 + 1013904223;
+			const NodeId kStartNodeId = (queryState >> 8) % randomGraph.GetNodeCount();
+			queryState = queryState * 1664525 + 1013904223;
+			const NodeId kEndNodeId = (query % 8 == 0) ? kStartNodeId : (queryState >> 8) % randomGraph.GetNodeCount();
 
-				// close the node and add to the open set
-				m_vertices[kTargetId].m_closed = true;
-				openSet.emplace(kTargetId);
+			randomGraph.InternalDijkstraSearch(kStartNodeId, kEndNodeId, dijkstraContext, noVisit);
+			const Dist kDistance = dijkstraContext.GetDistance(kEndNodeId);
+
+			if (!useLandmarks)
+			{
+				if (randomGraph.RunBidirectionalDijkstraFind(kStartNodeId, kEndNodeId, bidirectionalContext) != (kDistance != kStartDist) ||
+					bidirectionalContext.GetDistance() != kDistance)
+				{
+					return false;
+				}
+				if (kDistance != kStartDist && !isShortestPath(bidirectionalContext.GetPath(), kStartNodeId, kEndNodeId, kDistance))
+					return false;
+				continue;
 			}
+
+			randomGraph.RunLandmarkAStar(kStartNodeId, kEndNodeId, landmarkContext, noVisit);
+			if (landmarkContext.GetDistance(kEndNodeId) != kDistance)
+				return false;
+
+			std::vector<NodeId> path;
+			for (NodeId nodeId = kEndNodeId; kDistance != kStartDist && nodeId != kInvalidNodeId; nodeId = landmarkContext.GetPrev(nodeId))
+				path.insert(path.begin(), nodeId);
+			if (kDistance != kStartDist && !isShortestPath(path, kStartNodeId, kEndNodeId, kDistance))
+				return false;
 		}
+		return true;
+	};
+
+	if (!checkPointToPoint(false))
+		RETURN_ERROR("Graph::RunBidirectionalDijkstraFind()");
+	if (!checkPointToPoint(true))
+		RETURN_ERROR("Graph::RunLandmarkAStar() without landmarks");
+
+	randomGraph.BuildLandmarks(4);
+	if (randomGraph.GetLandmarkCount() != 4 || !checkPointToPoint(true))
+		RETURN_ERROR("Graph::RunLandmarkAStar()");
+
+	// Transposed, the distances from node 0 are the ones to it and the landmarks must never overestimate them
+	randomGraph.TransposeGraph();
+	for (NodeId nodeId = 0; nodeId < randomGraph.GetNodeCount(); ++nodeId)
+	{
+		if (shortestDistances[nodeId] != kStartDist && randomGraph.LandmarkHeuristic(nodeId, 0) > shortestDistances[nodeId])
+			RETURN_ERROR("Graph::BuildLandmarks()");
 	}
-}
+	if (!checkPointToPoint(false) || !checkPointToPoint(true))
+		RETURN_ERROR("Graph point to point searches when transposed");
+	randomGraph.TransposeGraph();
+#endif
 
-//--------------------------------------------------------------------------------------------------------------------
-// Recursive Depth First Search interface
-// O(V + E)
-//--------------------------------------------------------------------------------------------------------------------
+	// Builders store characters as data, store the node ids instead
+	for (Graph<Type>& graph : graphs)
+	{
+		for (GraphVertex& vertex : graph.m_vertices)
+			vertex.m_data = static_cast<Type>(&vertex - graph.m_vertices.data());
+	}
+
+	std::vector<NodeId> expectedVisits;
+	std::vector<Dist> expectedDistances;
+	std::vector<NodeId> visits;
+	std::vector<Dist> distances;
+
+	for (Graph<Type>& graph : graphs)
+	{
+		//---------------------------------------------------------------
+		// Freeze
+		//---------------------------------------------------------------
+		Graph<Type> frozenGraph = graph;
+		frozenGraph.Freeze();
+		if (!frozenGraph.IsFrozen() || graph.IsFrozen() || frozenGraph.GetEdgeCount() != graph.GetEdgeCount() || !frozenGraph.m_adjacencyList.empty())
+			RETURN_ERROR("Graph::Freeze()");
+
+		for (NodeId fromId = 0; fromId < graph.GetNodeCount(); ++fromId)
+		{
+			if (frozenGraph.ComputeOutDegree(fromId) != graph.ComputeOutDegree(fromId) || frozenGraph.ComputeInDegree(fromId) != graph.ComputeInDegree(fromId))
+				RETURN_ERROR("Graph degree when frozen");
+
+			for (NodeId toId = 0; toId < graph.GetNodeCount(); ++toId)
+			{
+				const Dist* pWeight = graph.FindEdgeWeight(fromId, toId);
+				const Dist* pFrozenWeight = frozenGraph.FindEdgeWeight(fromId, toId);
+				if ((pWeight == nullptr) != (pFrozenWeight == nullptr) || (pWeight && *pWeight != *pFrozenWeight))
+					RETURN_ERROR("Graph::GetDist() when frozen");
+			}
+		}
+
+		//---------------------------------------------------------------
+		// Searches, before and after transposing
+		//---------------------------------------------------------------
+		Graph<Type> bidirectionalGraph = graph;
+		bidirectionalGraph.Freeze(true);
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			runSearches(graph, expectedVisits, expectedDistances);
+			runSearches(frozenGraph, visits, distances);
+			if (visits != expectedVisits || distances != expectedDistances)
+				RETURN_ERROR("Graph searches when frozen");
+
+			if (!checkParallelSearch(graph, frozenGraph) || !checkParallelSearch(graph, bidirectionalGraph))
+				RETURN_ERROR("Graph::ParallelBreadthFirstSearch()");
+
+			graph.TransposeGraph();
+			frozenGraph.TransposeGraph();
+			bidirectionalGraph.TransposeGraph();
+		}
+
+		//---------------------------------------------------------------
+		// Unfreeze, the graph can grow again
+		//---------------------------------------------------------------
+		frozenGraph.Unfreeze();
+		runSearches(graph, expectedVisits, expectedDistances);
+		runSearches(frozenGraph, visits, distances);
+		if (frozenGraph.IsFrozen() || visits != expectedVisits || distances != expectedDistances)
+			RETURN_ERROR("Graph::Unfreeze()");
+
+		frozenGraph.AddEdge(frozenGraph.AddNode(static_cast<Type>(frozenGraph.GetNodeCount())), 0);
+		if (frozenGraph.GetEdgeCount() != graph.GetEdgeCount() + 1)
+			RETURN_ERROR("Graph::AddEdge() after Unfreeze()");
+	}
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Run breadth first search with start node, the results are stored in the vertices
+//--------------------------------------------------------------------------------------------------------------------
 template<class Type>
 template<class Func>
-inline constexpr void Graph<Type>::DepthFirstSearchRecur(NodeId startNodeId, Func&& func)
+inline constexpr void Graph<Type>::BreadthFirstSearch(NodeId startNodeId, Func&& func)
 {
-	// reset all the search data
-	// O(V)
-	for (GraphVertex& node : m_vertices)
-		node.ResetSearchData();
+	SearchContext& context = m_searchContext;
+	BreadthFirstSearch(startNodeId, context, std::forward<Func>(func));
+	StoreSearchData(context);
+}
 
-	// Internal search
-	InternalDepthFirstSearch(startNodeId, std::forward<Func>(func));
+//--------------------------------------------------------------------------------------------------------------------
+// Run breadth first search with start node, the results go to context and the graph is only read
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::BreadthFirstSearch(NodeId startNodeId, SearchContext& context, Func&& func) const
+{
+	InternalBreadthFirstSearch(startNodeId, kInvalidNodeId, context, std::forward<Func>(func));
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Dijkstra Algorithm searching
+// Breadth first search until endNodeId is popped, or every node reachable if it's kInvalidNodeId
+// Time: O(nodes reached + their edges), the context only resets the nodes it reaches
 //--------------------------------------------------------------------------------------------------------------------
 template<class Type>
 template<class Func>
-inline constexpr void Graph<Type>::RunDijkstraSearch(NodeId startNodeId, Func&& func)
+inline constexpr bool Graph<Type>::InternalBreadthFirstSearch(NodeId startNodeId, NodeId endNodeId, SearchContext& context, Func&& func) const
 {
-	// initialize single source
-	for (GraphVertex& node : m_vertices)
-		node.ResetSearchData();
+	context.Begin(m_vertices.size());
 
-	// The lambda that priority queue is using
-	auto openSetPriorityFunc = [this](NodeId left, NodeId right) -> bool
+	// set the search data for the starting vertex
+	typename SearchContext::NodeState& startState = context.Touch(startNodeId);
+	startState.m_distance = 0;
+	startState.m_closed = true;
+
+	// Declare the open set, which is the queue of nodes we need to visit, and push our starting node there.
+	// Nodes are never removed from the vector, openHead is the front of the queue.
+	std::vector<NodeId>& openSet = context.m_openNodes;
+	openSet.emplace_back(startNodeId);
+
+	// Search begins here, quit search if openSet is empty
+	for (size_t openHead = 0; openHead < openSet.size(); ++openHead)
 	{
-#if PATH_CHOICE == 1
-		return m_vertices[left].m_distance > m_vertices[right].m_distance;
-#elif PATH_CHOICE == 2
-		return m_vertices[left].m_distance < m_vertices[right].m_distance;
-#endif
-	};
+		// Pop the next vertex off of the queue
+		const NodeId kCurrentNodeId = openSet[openHead];
 
-	// Declare the open set, which is all the nodes we have yet to expand.
-	using OpenSet = std::priority_queue<NodeId, std::vector<NodeId>, decltype(openSetPriorityFunc)>;
-	OpenSet openSet(openSetPriorityFunc);
+		// Perform lambda function here
+		func(kCurrentNodeId, m_vertices[kCurrentNodeId].m_data);
 
-	// add the start vertex and set it's dist to 0
-	m_vertices[startNodeId].m_distance = 0.0f;
-	openSet.emplace(startNodeId);
+		// Return if found end node id
+		if (kCurrentNodeId == endNodeId)
+			return true;
 
-	// keep going as long as there's anything in the open set
+		// For each neighbor of the current node
+		// O(E)
+		const Dist kNeighborDistance = context.m_nodeStates[kCurrentNodeId].m_distance + 1;
+		ForEachNeighbor(kCurrentNodeId, [&](const NodeId kNeighbor, const Dist)
+		{
+			// If we haven't seen this neighbor before
+			typename SearchContext::NodeState& neighborState = context.Touch(kNeighbor);
+			if (neighborState.m_closed)
+				return;
+			
+			// Set the distance and previous node
+			neighborState.m_distance = kNeighborDistance;
+			neighborState.m_prev = kCurrentNodeId;
+
+			// close the node and add to the open set
+			neighborState.m_closed = true;
+			openSet.emplace_back(kNeighbor);
+		});
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Iterative depth first search with a stack, the results are stored in the vertices
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::DepthFirstSearchIter(NodeId startNodeId, Func&& func)
+{
+	SearchContext& context = m_searchContext;
+	DepthFirstSearchIter(startNodeId, context, std::forward<Func>(func));
+	StoreSearchData(context);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Iterative depth first search with a stack, the results go to context and the graph is only read
+// O(nodes reached + their edges)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::DepthFirstSearchIter(NodeId startNodeId, SearchContext& context, Func&& func) const
+{
+	context.Begin(m_vertices.size());
+
+	// set the search data for the starting vertex
+	typename SearchContext::NodeState& startState = context.Touch(startNodeId);
+	startState.m_distance = 0;
+	startState.m_closed = true;
+
+	// Declare the open stack, which is the stack of nodes we need to visit, and push our starting node there.
+	std::vector<NodeId>& openSet = context.m_openNodes;
+	openSet.emplace_back(startNodeId);
+
+	// Search begins here, quit search if openSet is empty
 	while (!openSet.empty())
 	{
-		// grab the best weight
-		NodeId nodeId = openSet.top();
-		openSet.pop();
-
-		// Perform func
-		func(nodeId, m_vertices[nodeId].m_data);
+		// Pop the next vertex off of the stack
+		const NodeId kCurrentNodeId = openSet.back();
+		openSet.pop_back();
 
-		// Add this vertex to the closed set.  
-		// We only use it to ask whether or not a node is in the closed set, so as an optimization we just store its membership as a bool.
-		m_vertices[nodeId].m_closed = true;
+		// Perfrom func here
+		func(m_vertices[kCurrentNodeId].m_data);
 
-		// for each neighbor
-		for (const auto& [kNeighborNodeId, kWeight] : m_adjacencyList[nodeId])
+		// For each neighbor of the current node
+		// O(E)
+		const Dist kTargetDistance = context.m_nodeStates[kCurrentNodeId].m_distance + 1;
+		ForEachNeighbor(kCurrentNodeId, [&](const NodeId kTargetId, const Dist)
 		{
-			// Grab the neighbor.  If it's in the closed set, skip it.  This keeps us from processing cycles.
-			if (m_vertices[kNeighborNodeId].m_closed)
-				continue;
+			typename SearchContext::NodeState& targetState = context.Touch(kTargetId);
+			if (!targetState.m_closed)
+			{
+				// set the distance and previous node
+				targetState.m_distance = kTargetDistance;
+				targetState.m_prev = kCurrentNodeId;
 
-			// Relax the node.  If this path is better, we insert it into the open set.  Note that this is guaranteed 
-			// to be the case the first time the node is seen because the distance is set to infinity, so this path is 
-			// guaranteed to be better.
-			if (Relax(nodeId, kNeighborNodeId, kWeight))
-				openSet.emplace(kNeighborNodeId);
-		}
+				// close the node and add to the open set
+				targetState.m_closed = true;
+				openSet.emplace_back(kTargetId);
+			}
+		});
 	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Dijkstra Algorithm finding
-// Returns a vector of nodeId that passed through 
+// Recursive Depth First Search interface
+// O(V + E)
 //--------------------------------------------------------------------------------------------------------------------
 template<class Type>
 template<class Func>
-inline constexpr std::vector<typename Graph<Type>::NodeId> Graph<Type>::RunDijkstraFind(NodeId startNodeId, NodeId endNodeId, Func&& func)
+inline constexpr void Graph<Type>::DepthFirstSearchRecur(NodeId startNodeId, Func&& func)
 {
-	// Data
-	std::vector<NodeId> path;
-	bool hasFoundTarget = false;
-
-	// initialize single source
+	// reset all the search data
+	// O(V)
 	for (GraphVertex& node : m_vertices)
 		node.ResetSearchData();
 
-	// The lambda that priority queue is using
-	auto openSetPriorityFunc = [this](NodeId left, NodeId right) -> bool
-	{
-#if PATH_CHOICE == 1
-		return m_vertices[left].m_distance > m_vertices[right].m_distance;
-#elif PATH_CHOICE == 2
-		return m_vertices[left].m_distance < m_vertices[right].m_distance;
-#endif
-	};
+	// Internal search
+	InternalDepthFirstSearch(startNodeId, std::forward<Func>(func));
+}
 
-	// Declare the open set, which is all the nodes we have yet to expand.
-	using OpenSet = std::priority_queue<NodeId, std::vector<NodeId>, decltype(openSetPriorityFunc)>;
-	OpenSet openSet(openSetPriorityFunc);
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra Algorithm searching, the results are stored in the vertices
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::RunDijkstraSearch(NodeId startNodeId, Func&& func)
+{
+	SearchContext& context = m_searchContext;
+	RunDijkstraSearch(startNodeId, context, std::forward<Func>(func));
+	StoreSearchData(context);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra Algorithm searching, the results go to context and the graph is only read
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::RunDijkstraSearch(NodeId startNodeId, SearchContext& context, Func&& func) const
+{
+	InternalDijkstraSearch(startNodeId, kInvalidNodeId, context, std::forward<Func>(func));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra Algorithm until endNodeId is popped, or every node reachable if it's kInvalidNodeId
+// isBackward follows the incoming edges, the distances are then the ones to startNodeId
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr bool Graph<Type>::InternalDijkstraSearch(NodeId startNodeId, NodeId endNodeId, SearchContext& context, Func&& func, bool isBackward /*= false*/) const
+{
+	// initialize single source
+	context.Begin(m_vertices.size());
+
+	// Declare the open set, which is all the nodes we have yet to expand. Each node is in it once, with its distance.
+	OpenSet& openSet = context.m_openSet;
 
 	// add the start vertex and set it's dist to 0
-	m_vertices[startNodeId].m_distance = 0.0f;
-	openSet.emplace(startNodeId);
+	context.Touch(startNodeId).m_distance = 0.0f;
+	openSet.Push(startNodeId, 0.0f);
 
 	// keep going as long as there's anything in the open set
-	while (!openSet.empty())
+	while (!openSet.Empty())
 	{
 		// grab the best weight
-		NodeId nodeId = openSet.top();
-		openSet.pop();
+		const NodeId nodeId = openSet.Pop();
 
 		// Perform func
 		func(nodeId, m_vertices[nodeId].m_data);
 
 		// If this is the node we are looking for. Succeeded found it
 		if (nodeId == endNodeId)
-		{
-			hasFoundTarget = true;
-			break;
-		}
+			return true;
 
 		// Add this vertex to the closed set.  
 		// We only use it to ask whether or not a node is in the closed set, so as an optimization we just store its membership as a bool.
-		m_vertices[nodeId].m_closed = true;
+		context.m_nodeStates[nodeId].m_closed = true;
 
 		// for each neighbor
-		for (const auto& [kNeighborNodeId, kWeight] : m_adjacencyList[nodeId])
+		auto relaxNeighbor = [&](const NodeId kNeighborNodeId, const Dist kWeight)
 		{
 			// Grab the neighbor.  If it's in the closed set, skip it.  This keeps us from processing cycles.
-			if (m_vertices[kNeighborNodeId].m_closed)
-				continue;
-
-			// Relax the node.  If this path is better, we insert it into the open set.  Note that this is guaranteed 
-			// to be the case the first time the node is seen because the distance is set to infinity, so this path is 
-			// guaranteed to be better.
-			if (Relax(nodeId, kNeighborNodeId, kWeight))
-				openSet.emplace(kNeighborNodeId);
-		}
+			if (context.IsClosed(kNeighborNodeId))
+				return;
+
+			// Relax the node.  If this path is better, we insert it into the open set, or move it up if it's there already.
+			// Note that this is guaranteed to be the case the first time the node is seen because the distance is set
+			// to infinity, so this path is guaranteed to be better.
+			if (Relax(context, nodeId, kNeighborNodeId, kWeight))
+				openSet.PushOrDecreaseKey(kNeighborNodeId, context.m_nodeStates[kNeighborNodeId].m_distance);
+		};
+
+		if (isBackward)
+			ForEachIncomingNeighbor(nodeId, relaxNeighbor);
+		else
+			ForEachNeighbor(nodeId, relaxNeighbor);
 	}
 
-	if (hasFoundTarget)
+	return false;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra Algorithm finding, the results are stored in the vertices
+// Returns a vector of nodeId that passed through 
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr std::vector<typename Graph<Type>::NodeId> Graph<Type>::RunDijkstraFind(NodeId startNodeId, NodeId endNodeId, Func&& func)
+{
+	SearchContext& context = m_searchContext;
+	std::vector<NodeId> path = RunDijkstraFind(startNodeId, endNodeId, context, std::forward<Func>(func));
+	StoreSearchData(context);
+	return path;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra Algorithm finding, the results go to context and the graph is only read
+// Returns a vector of nodeId that passed through 
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr std::vector<typename Graph<Type>::NodeId> Graph<Type>::RunDijkstraFind(NodeId startNodeId, NodeId endNodeId, SearchContext& context, Func&& func) const
+{
+	std::vector<NodeId> path;
+
+	if (InternalDijkstraSearch(startNodeId, endNodeId, context, std::forward<Func>(func)))
 	{
-		NodeId targetId = m_vertices[endNodeId].m_id;
-		while (m_vertices[targetId].m_prev != startNodeId && 
-			   m_vertices[m_vertices[targetId].m_prev].m_id != startNodeId)
+		NodeId targetId = endNodeId;
+		while (context.GetPrev(targetId) != startNodeId)
 		{
 			path.emplace_back(targetId);
-			targetId = m_vertices[targetId].m_prev;
+			targetId = context.GetPrev(targetId);
 		}
 	}
 
 	return path;
 }
 
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra Algorithm searching with a radix heap, the results are stored in the vertices
+//--------------------------------------------------------------------------------------------------------------------
 template<class Type>
 template<class Func>
-inline constexpr void Graph<Type>::RunAStar(NodeId startNodeId, NodeId destNodeId, Func&& func)
+inline constexpr void Graph<Type>::RunRadixDijkstraSearch(NodeId startNodeId, Func&& func)
+{
+	SearchContext& context = m_searchContext;
+	RunRadixDijkstraSearch(startNodeId, context, std::forward<Func>(func));
+	StoreSearchData(context);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra Algorithm searching with a radix heap for the open set, only for shortest paths with non negative weights
+// A node is pushed again each time its distance improves, Push() is O(1) and Pop() skips the closed copies
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::RunRadixDijkstraSearch(NodeId startNodeId, SearchContext& context, Func&& func) const
 {
+	static_assert(PATH_CHOICE == 1, "The radix heap only handles distances which never decrease");
+
 	// initialize single source
-	for (GraphVertex& node : m_vertices)
-		node.ResetSearchData();
+	context.Begin(m_vertices.size());
+	RadixHeap<Dist, NodeId>& openSet = context.m_radixOpenSet;
 
-	// The lambda that priority queue is using
-	auto openSetPriorityFunc = [this](NodeId left, NodeId right) -> bool
+	// add the start vertex and set it's dist to 0
+	context.Touch(startNodeId).m_distance = 0.0f;
+	openSet.Push(0.0f, startNodeId);
+
+	while (!openSet.Empty())
 	{
-#if PATH_CHOICE == 1
-		return m_vertices[left].m_distance > m_vertices[right].m_distance;
-#elif PATH_CHOICE == 2
-		return m_vertices[left].m_distance < m_vertices[right].m_distance;
-#endif
-	};
+		// A node closed already was pushed again with a better distance
+		const NodeId nodeId = openSet.Pop().second;
+		if (context.m_nodeStates[nodeId].m_closed)
+			continue;
+
+		func(nodeId, m_vertices[nodeId].m_data);
+		context.m_nodeStates[nodeId].m_closed = true;
+
+		ForEachNeighbor(nodeId, [&](const NodeId kNeighborNodeId, const Dist kWeight)
+		{
+			assert(kWeight >= 0.0f);
+			if (!context.IsClosed(kNeighborNodeId) && Relax(context, nodeId, kNeighborNodeId, kWeight))
+				openSet.Push(context.m_nodeStates[kNeighborNodeId].m_distance, kNeighborNodeId);
+		});
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// A* from startNodeId to destNodeId, the results are stored in the vertices
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::RunAStar(NodeId startNodeId, NodeId destNodeId, Func&& func)
+{
+	SearchContext& context = m_searchContext;
+	RunAStar(startNodeId, destNodeId, context, std::forward<Func>(func));
+	StoreSearchData(context);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// A* from startNodeId to destNodeId, the results go to context and the graph is only read
+// Nodes come out of the open set by distance plus Heuristic(), the distances stored are the real ones
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::RunAStar(NodeId startNodeId, NodeId destNodeId, SearchContext& context, Func&& func) const
+{
+	InternalAStar(startNodeId, destNodeId, context, std::forward<Func>(func), [this, destNodeId](NodeId nodeId)
+	{
+		return Heuristic(destNodeId, nodeId);
+	});
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// A* from startNodeId to destNodeId with the landmark heuristic, for any graph BuildLandmarks() was called on
+// The results go to context and the graph is only read. Without landmarks the heuristic is 0, which is Dijkstra.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func>
+inline constexpr void Graph<Type>::RunLandmarkAStar(NodeId startNodeId, NodeId destNodeId, SearchContext& context, Func&& func) const
+{
+	static_assert(PATH_CHOICE == 1, "Landmark distances only bound shortest paths");
+
+	InternalAStar(startNodeId, destNodeId, context, std::forward<Func>(func), [this, destNodeId](NodeId nodeId)
+	{
+		return LandmarkHeuristic(nodeId, destNodeId);
+	});
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// A* until destNodeId is popped, heuristicFunc(nodeId) estimates the distance left from nodeId to destNodeId
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+template<class Func, class HeuristicFunc>
+inline constexpr void Graph<Type>::InternalAStar(NodeId startNodeId, NodeId destNodeId, SearchContext& context, Func&& func, HeuristicFunc&& heuristicFunc) const
+{
+	// initialize single source
+	context.Begin(m_vertices.size());
 
 	// Declare the open set, which is all the nodes we have yet to expand.
-	using OpenSet = std::priority_queue<NodeId, std::vector<NodeId>, decltype(openSetPriorityFunc)>;
-	OpenSet openSet(openSetPriorityFunc);
+	OpenSet& openSet = context.m_openSet;
 
 	// add the start vertex and set it's dist to 0
-	m_vertices[startNodeId].m_distance = 0.0f;
-	openSet.emplace(startNodeId);
+	context.Touch(startNodeId).m_distance = 0.0f;
+	openSet.Push(startNodeId, heuristicFunc(startNodeId));
 
 	// keep going as long as there's anything in the open set
-	while (!openSet.empty())
+	while (!openSet.Empty())
 	{
 		// grab the best weight
-		NodeId currentNodeId = openSet.top();
-		openSet.pop();
+		const NodeId currentNodeId = openSet.Pop();
 
 		// Perform func
 		func(currentNodeId, m_vertices[currentNodeId].m_data);
 
+		// The destination is out of the open set, nothing left can give it a shorter path
+		if (currentNodeId == destNodeId)
+			return;
+
 		// Add this vertex to the closed set.  
 		// We only use it to ask whether or not a node is in the closed set, so as an optimization we just store its membership as a bool.
-		m_vertices[currentNodeId].m_closed = true;
+		context.m_nodeStates[currentNodeId].m_closed = true;
 
 		// for each neighbor
-		for (const auto& [kNeighborNodeId, kWeight] : m_adjacencyList[currentNodeId])
+		ForEachNeighbor(currentNodeId, [&](const NodeId kNeighborNodeId, const Dist kWeight)
 		{
 			// Grab the neighbor.  If it's in the closed set, skip it.  This keeps us from processing cycles.
-			if (m_vertices[kNeighborNodeId].m_closed)
-				continue;
+			if (context.IsClosed(kNeighborNodeId))
+				return;
+
+			// Relax the node.  If this path is better, we insert it into the open set, or move it up if it's there already.
+			if (Relax(context, currentNodeId, kNeighborNodeId, kWeight))
+				openSet.PushOrDecreaseKey(kNeighborNodeId, context.m_nodeStates[kNeighborNodeId].m_distance + heuristicFunc(kNeighborNodeId));
+		});
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dijkstra from both ends at once, forward from startNodeId over the edges and backward from endNodeId over the
+// incoming ones, on a graph frozen with its incoming edges. Each step expands the side with the smaller open set,
+// and every edge reaching a node the other side reached gives a path. Once the two best distances left add up to
+// the best path found, no node left can give a shorter one.
+// Both searches stop around half way, on a road like graph they reach half to two thirds of the nodes RunDijkstraFind()
+// does.
+// Returns true if endNodeId is reachable, the path and its distance are in context
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline bool Graph<Type>::RunBidirectionalDijkstraFind(NodeId startNodeId, NodeId endNodeId, BidirectionalSearchContext& context) const
+{
+	static_assert(PATH_CHOICE == 1, "Meeting in the middle only bounds shortest paths");
+	assert(IsFrozen() && HasIncomingEdges());
+
+	SearchContext& forwardContext = context.m_forwardContext;
+	SearchContext& backwardContext = context.m_backwardContext;
+	forwardContext.Begin(m_vertices.size());
+	backwardContext.Begin(m_vertices.size());
+	context.m_path.clear();
+
+	forwardContext.Touch(startNodeId).m_distance = 0.0f;
+	forwardContext.m_openSet.Push(startNodeId, 0.0f);
+	backwardContext.Touch(endNodeId).m_distance = 0.0f;
+	backwardContext.m_openSet.Push(endNodeId, 0.0f);
 
-			// Relax the node.  If this path is better, we insert it into the open set. 
-			// Note that this is guaranteed to be the case the first time the node is seen because the distance is set to infinity,
-			// so this path is guaranteed to be better.
-			if (m_vertices[kNeighborNodeId].m_distance > m_vertices[currentNodeId].m_distance + kWeight)
+	// Node on the best path found so far where the two searches meet
+	NodeId meetingNodeId = (startNodeId == endNodeId) ? startNodeId : kInvalidNodeId;
+	context.m_distance = (startNodeId == endNodeId) ? 0.0f : kStartDist;
+
+	while (!forwardContext.m_openSet.Empty() && !backwardContext.m_openSet.Empty())
+	{
+		if (forwardContext.m_openSet.GetTopKey() + backwardContext.m_openSet.GetTopKey() >= context.m_distance)
+			break;
+
+		const bool kIsForward = forwardContext.m_openSet.GetSize() <= backwardContext.m_openSet.GetSize();
+		SearchContext& searchContext = kIsForward ? forwardContext : backwardContext;
+		const SearchContext& kOtherContext = kIsForward ? backwardContext : forwardContext;
+
+		const NodeId kNodeId = searchContext.m_openSet.Pop();
+		searchContext.m_nodeStates[kNodeId].m_closed = true;
+
+		auto relaxNeighbor = [&](const NodeId kNeighborNodeId, const Dist kWeight)
+		{
+			if (searchContext.IsClosed(kNeighborNodeId))
+				return;
+
+			if (Relax(searchContext, kNodeId, kNeighborNodeId, kWeight))
+				searchContext.m_openSet.PushOrDecreaseKey(kNeighborNodeId, searchContext.m_nodeStates[kNeighborNodeId].m_distance);
+
+			// A path through the neighbor, if the other side got to it
+			if (kOtherContext.IsReached(kNeighborNodeId))
 			{
-				m_vertices[kNeighborNodeId].m_distance = m_vertices[currentNodeId].m_distance + kWeight + Heuristic(destNodeId, kNeighborNodeId);
-				m_vertices[kNeighborNodeId].m_prev = currentNodeId;
-				openSet.emplace(kNeighborNodeId);
+				const Dist kDistance = searchContext.m_nodeStates[kNeighborNodeId].m_distance + kOtherContext.m_nodeStates[kNeighborNodeId].m_distance;
+				if (kDistance < context.m_distance)
+				{
+					context.m_distance = kDistance;
+					meetingNodeId = kNeighborNodeId;
+				}
 			}
+		};
+
+		if (kIsForward)
+			ForEachNeighbor(kNodeId, relaxNeighbor);
+		else
+			ForEachIncomingNeighbor(kNodeId, relaxNeighbor);
+	}
+
+	if (meetingNodeId == kInvalidNodeId)
+		return false;
+
+	// Start node to the meeting node, then on to the end node
+	for (NodeId nodeId = meetingNodeId; nodeId != kInvalidNodeId; nodeId = forwardContext.GetPrev(nodeId))
+		context.m_path.emplace_back(nodeId);
+	std::reverse(context.m_path.begin(), context.m_path.end());
+	for (NodeId nodeId = backwardContext.GetPrev(meetingNodeId); nodeId != kInvalidNodeId; nodeId = backwardContext.GetPrev(nodeId))
+		context.m_path.emplace_back(nodeId);
+
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Precompute the distances from and to landmarkCount landmarks for RunLandmarkAStar(), on a graph frozen with its
+// incoming edges. Each landmark is the node farthest from the ones picked before, a node no landmark reaches first,
+// so the landmarks end up around the edges of the graph, behind most nodes seen from most others.
+// Time: O(landmarkCount * (V + E) * log(V))
+// Space: O(landmarkCount * V)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline void Graph<Type>::BuildLandmarks(size_t landmarkCount)
+{
+	static_assert(PATH_CHOICE == 1, "Landmark distances only bound shortest paths");
+	assert(IsFrozen() && HasIncomingEdges());
+
+	ClearLandmarks();
+	landmarkCount = std::min(landmarkCount, m_vertices.size());
+	if (landmarkCount == 0)
+		return;
+
+	m_distancesFromLandmarks.assign(m_vertices.size() * landmarkCount, kStartDist);
+	m_distancesToLandmarks.assign(m_vertices.size() * landmarkCount, kStartDist);
+
+	// Distance from the closest landmark, the first landmark is the node farthest from node 0
+	std::vector<Dist> landmarkDistances(m_vertices.size(), kStartDist);
+	SearchContext context;
+	InternalDijkstraSearch(0, kInvalidNodeId, context, [](NodeId, const Type&) {});
+	for (const NodeId kNodeId : context.GetReachedNodes())
+		landmarkDistances[kNodeId] = context.m_nodeStates[kNodeId].m_distance;
+
+	auto noVisit = [](NodeId, const Type&) {};
+	for (size_t landmark = 0; landmark < landmarkCount; ++landmark)
+	{
+		const NodeId kLandmarkId = static_cast<NodeId>(std::max_element(landmarkDistances.begin(), landmarkDistances.end()) - landmarkDistances.begin());
+		m_landmarkIds.emplace_back(kLandmarkId);
+		if (landmark == 0)
+			std::fill(landmarkDistances.begin(), landmarkDistances.end(), kStartDist);
+
+		InternalDijkstraSearch(kLandmarkId, kInvalidNodeId, context, noVisit);
+		for (const NodeId kNodeId : context.GetReachedNodes())
+		{
+			const Dist kDistance = context.m_nodeStates[kNodeId].m_distance;
+			m_distancesFromLandmarks[kNodeId * landmarkCount + landmark] = kDistance;
+			landmarkDistances[kNodeId] = std::min(landmarkDistances[kNodeId], kDistance);
 		}
+
+		InternalDijkstraSearch(kLandmarkId, kInvalidNodeId, context, noVisit, true);
+		for (const NodeId kNodeId : context.GetReachedNodes())
+			m_distancesToLandmarks[kNodeId * landmarkCount + landmark] = context.m_nodeStates[kNodeId].m_distance;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Forget the landmarks, their distances no longer hold once the edges change
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline constexpr void Graph<Type>::ClearLandmarks()
+{
+	m_landmarkIds.clear();
+	m_distancesFromLandmarks.clear();
+	m_distancesToLandmarks.clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Lower bound of the distance from nodeId to destNodeId from the triangle inequality, for each landmark L:
+//  - d(L, dest) <= d(L, node) + d(node, dest)
+//  - d(node, L) <= d(node, dest) + d(dest, L)
+// Never more than the real distance whatever the graph, unlike Heuristic() which needs a grid.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline typename Graph<Type>::Dist Graph<Type>::LandmarkHeuristic(NodeId nodeId, NodeId destNodeId) const
+{
+	const size_t kLandmarkCount = m_landmarkIds.size();
+	const Dist* pFromLandmarksToNode = m_distancesFromLandmarks.data() + nodeId * kLandmarkCount;
+	const Dist* pFromLandmarksToDest = m_distancesFromLandmarks.data() + destNodeId * kLandmarkCount;
+	const Dist* pToLandmarksFromNode = m_distancesToLandmarks.data() + nodeId * kLandmarkCount;
+	const Dist* pToLandmarksFromDest = m_distancesToLandmarks.data() + destNodeId * kLandmarkCount;
+
+	// A landmark which can't reach, or be reached from, one of the two nodes bounds nothing
+	Dist bound = 0.0f;
+	for (size_t landmark = 0; landmark < kLandmarkCount; ++landmark)
+	{
+		if (pFromLandmarksToNode[landmark] != kStartDist && pFromLandmarksToDest[landmark] != kStartDist)
+			bound = std::max(bound, pFromLandmarksToDest[landmark] - pFromLandmarksToNode[landmark]);
+		if (pToLandmarksFromNode[landmark] != kStartDist && pToLandmarksFromDest[landmark] != kStartDist)
+			bound = std::max(bound, pToLandmarksFromNode[landmark] - pToLandmarksFromDest[landmark]);
 	}
+	return bound;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -925,10 +1954,10 @@ inline constexpr void Graph<Type>::InternalDepthFirstSearch(NodeId nodeId, Func&
 	m_vertices[nodeId].m_closed = true;
 	func(m_vertices[nodeId].m_data);
 
-	for (const auto& [kTargetId, kWeight] : m_adjacencyList[nodeId])
+	ForEachNeighbor(nodeId, [&](const NodeId kTargetId, const Dist)
 	{
 		if (m_vertices[kTargetId].m_closed)
-			continue;
+			return;
 
 		// set the distance and previous node
 		m_vertices[kTargetId].m_distance = m_vertices[nodeId].m_distance + 1;
@@ -936,7 +1965,211 @@ inline constexpr void Graph<Type>::InternalDepthFirstSearch(NodeId nodeId, Func&
 
 		// Recursive call 
 		InternalDepthFirstSearch(kTargetId, std::forward<Func>(func));
+	});
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Multithreaded breadth first search of a frozen graph, the depth and parent of every node reached end up in state
+// Time: O(V + E), split across the threads of threadPool
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline void Graph<Type>::ParallelBreadthFirstSearch(NodeId startNodeId, BreadthFirstSearchState& state, ThreadPool& threadPool /*= ThreadPool::Get()*/) const
+{
+	InternalParallelBreadthFirstSearch(startNodeId, kInvalidNodeId, state, threadPool);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Multithreaded reachability query, stops after the level which reaches endNodeId
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline bool Graph<Type>::ParallelBreadthFirstSearchFind(NodeId startNodeId, NodeId endNodeId, BreadthFirstSearchState& state, ThreadPool& threadPool /*= ThreadPool::Get()*/) const
+{
+	assert(endNodeId < m_vertices.size());
+	return InternalParallelBreadthFirstSearch(startNodeId, endNodeId, state, threadPool);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Level synchronous, direction optimizing breadth first search:
+//  - Top-down, the frontier is a list and each task claims the unvisited targets of its share of it, a fetch_or on
+//    the visited bitmap decides which task gets a node reached from two places
+//  - Bottom-up, the frontier is a bitmap and each task looks for a parent in the frontier for every unvisited node
+//    of its share of the bitmap, stopping at the first one. Needs the incoming edges of Freeze(true).
+// Top-down touches every edge of the frontier, bottom-up every edge of the unvisited nodes until a parent is found,
+// so the search goes bottom-up while the frontier is a large part of the graph.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline bool Graph<Type>::InternalParallelBreadthFirstSearch(NodeId startNodeId, NodeId endNodeId, BreadthFirstSearchState& state, ThreadPool& threadPool) const
+{
+	assert(IsFrozen() && startNodeId < m_vertices.size());
+
+	const size_t kNodeCount = m_vertices.size();
+	const size_t kWordCount = (kNodeCount + 63) / 64;
+
+	// Reset the state
+	state.m_prev.assign(kNodeCount, kInvalidNodeId);
+	state.m_depth.assign(kNodeCount, 0);
+	state.m_visited.assign(kWordCount, 0);
+	state.m_frontierBits.assign(kWordCount, 0);
+	state.m_nextFrontierBits.assign(kWordCount, 0);
+
+	state.m_prev[startNodeId] = startNodeId;
+	state.m_visited[startNodeId / 64] |= uint64_t(1) << (startNodeId % 64);
+	state.m_frontier.assign(1, startNodeId);
+	state.m_reachedCount = 1;
+
+	size_t frontierSize = 1;
+	size_t lastFrontierSize = 0;
+	size_t frontierEdgeCount = GetFrozenOutDegree(startNodeId);
+	size_t unexploredEdgeCount = m_edgeTargets.size();
+	bool isBottomUp = false;
+
+	for (size_t depth = 1; frontierSize > 0; ++depth)
+	{
+		if (endNodeId != kInvalidNodeId && state.IsReached(endNodeId))
+			return true;
+
+		// Pick the direction of this level, converting the frontier if it changes
+		unexploredEdgeCount -= std::min(unexploredEdgeCount, frontierEdgeCount);
+		if (!isBottomUp && HasIncomingEdges() && frontierEdgeCount > unexploredEdgeCount / kTopDownToBottomUp)
+		{
+			std::fill(state.m_frontierBits.begin(), state.m_frontierBits.end(), 0);
+			for (const NodeId kNodeId : state.m_frontier)
+				state.m_frontierBits[kNodeId / 64] |= uint64_t(1) << (kNodeId % 64);
+			isBottomUp = true;
+		}
+		else if (isBottomUp && frontierSize < lastFrontierSize && frontierSize < kNodeCount / kBottomUpToTopDown)
+		{
+			state.m_frontier.clear();
+			for (size_t word = 0; word < kWordCount; ++word)
+			{
+				for (uint64_t bits = state.m_frontierBits[word]; bits; bits &= bits - 1)
+					state.m_frontier.emplace_back(word * 64 + std::countr_zero(bits));
+			}
+			isBottomUp = false;
+		}
+
+		if (isBottomUp)
+			ParallelBottomUpStep(depth, state, threadPool);
+		else
+			ParallelTopDownStep(depth, state, threadPool);
+
+		// Sum what the tasks found
+		lastFrontierSize = frontierSize;
+		frontierSize = 0;
+		frontierEdgeCount = 0;
+		for (const auto& kTaskResult : state.m_taskResults)
+		{
+			frontierSize += kTaskResult.m_nodeCount;
+			frontierEdgeCount += kTaskResult.m_edgeCount;
+		}
+		state.m_reachedCount += frontierSize;
 	}
+
+	return endNodeId != kInvalidNodeId && state.IsReached(endNodeId);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Expand the frontier list by one level, each task collects the nodes it claimed, then they make the next frontier
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline void Graph<Type>::ParallelTopDownStep(size_t depth, BreadthFirstSearchState& state, ThreadPool& threadPool) const
+{
+	const size_t kFrontierSize = state.m_frontier.size();
+	const size_t kTaskCount = (kFrontierSize + kParallelChunkSize - 1) / kParallelChunkSize;
+	if (state.m_taskResults.size() < kTaskCount)
+		state.m_taskResults.resize(kTaskCount);
+	for (auto& taskResult : state.m_taskResults)
+	{
+		taskResult.m_frontier.clear();
+		taskResult.m_nodeCount = 0;
+		taskResult.m_edgeCount = 0;
+	}
+
+	threadPool.ParallelFor(kTaskCount, [this, depth, kFrontierSize, &state](size_t task)
+	{
+		auto& taskResult = state.m_taskResults[task];
+		const size_t kEnd = std::min(kFrontierSize, (task + 1) * kParallelChunkSize);
+		for (size_t i = task * kParallelChunkSize; i < kEnd; ++i)
+		{
+			const NodeId kCurrentNodeId = state.m_frontier[i];
+			for (size_t edge = m_edgeOffsets[kCurrentNodeId]; edge < m_edgeOffsets[kCurrentNodeId + 1]; ++edge)
+			{
+				const NodeId kNeighborId = m_edgeTargets[edge];
+				const uint64_t kBit = uint64_t(1) << (kNeighborId % 64);
+				std::atomic_ref<uint64_t> visitedWord(state.m_visited[kNeighborId / 64]);
+
+				// Plain load first, most targets are visited already and the fetch_or would take the cache line
+				if ((visitedWord.load(std::memory_order_relaxed) & kBit) || (visitedWord.fetch_or(kBit, std::memory_order_relaxed) & kBit))
+					continue;
+
+				// This task claimed the node, nobody else writes its data
+				state.m_prev[kNeighborId] = kCurrentNodeId;
+				state.m_depth[kNeighborId] = depth;
+				taskResult.m_frontier.emplace_back(kNeighborId);
+				taskResult.m_edgeCount += GetFrozenOutDegree(kNeighborId);
+			}
+		}
+		taskResult.m_nodeCount = taskResult.m_frontier.size();
+	});
+
+	state.m_frontier.clear();
+	for (const auto& kTaskResult : state.m_taskResults)
+		state.m_frontier.insert(state.m_frontier.end(), kTaskResult.m_frontier.begin(), kTaskResult.m_frontier.end());
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Find a parent in the frontier bitmap for every unvisited node. Tasks own whole words of the bitmaps, so the visited
+// and next frontier words are written without atomics.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline void Graph<Type>::ParallelBottomUpStep(size_t depth, BreadthFirstSearchState& state, ThreadPool& threadPool) const
+{
+	const size_t kNodeCount = m_vertices.size();
+	const size_t kWordCount = state.m_visited.size();
+	const size_t kTaskCount = (kWordCount + kParallelChunkSize - 1) / kParallelChunkSize;
+	if (state.m_taskResults.size() < kTaskCount)
+		state.m_taskResults.resize(kTaskCount);
+	for (auto& taskResult : state.m_taskResults)
+	{
+		taskResult.m_frontier.clear();
+		taskResult.m_nodeCount = 0;
+		taskResult.m_edgeCount = 0;
+	}
+
+	threadPool.ParallelFor(kTaskCount, [this, depth, kNodeCount, kWordCount, &state](size_t task)
+	{
+		auto& taskResult = state.m_taskResults[task];
+		const size_t kEnd = std::min(kWordCount, (task + 1) * kParallelChunkSize);
+		for (size_t word = task * kParallelChunkSize; word < kEnd; ++word)
+		{
+			uint64_t nextBits = 0;
+			for (uint64_t unvisitedBits = ~state.m_visited[word]; unvisitedBits; unvisitedBits &= unvisitedBits - 1)
+			{
+				const NodeId kNodeId = word * 64 + std::countr_zero(unvisitedBits);
+				if (kNodeId >= kNodeCount)
+					break;
+
+				for (size_t edge = m_incomingOffsets[kNodeId]; edge < m_incomingOffsets[kNodeId + 1]; ++edge)
+				{
+					const NodeId kSourceId = m_incomingSources[edge];
+					if (!(state.m_frontierBits[kSourceId / 64] & (uint64_t(1) << (kSourceId % 64))))
+						continue;
+
+					state.m_prev[kNodeId] = kSourceId;
+					state.m_depth[kNodeId] = depth;
+					nextBits |= uint64_t(1) << (kNodeId % 64);
+					++taskResult.m_nodeCount;
+					taskResult.m_edgeCount += GetFrozenOutDegree(kNodeId);
+					break;
+				}
+			}
+
+			state.m_visited[word] |= nextBits;
+			state.m_nextFrontierBits[word] = nextBits;
+		}
+	});
+
+	state.m_frontierBits.swap(state.m_nextFrontierBits);
 }
 
 }
\ No newline at end of file
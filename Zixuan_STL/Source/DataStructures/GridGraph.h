@@ -0,0 +1,596 @@
+#pragma once
+#include "Tests/StructureManager.h"
+#include "Graph.h"
+#include "IndexedHeap.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// 8 connected grid of walkable and blocked cells, with Jump Point Search path-finding
+//  - Straight steps cost 1 and diagonal ones sqrt(2). A diagonal step needs both straight cells next to it walkable,
+//    paths never cut a corner.
+//  - The cells are the edges, the grid is a byte per cell instead of 8 edges per node of a Graph
+//  - FindPathJps() is A* over jump points only: from a cell it walks each useful direction until a cell with a forced
+//    neighbor (a path around an obstacle no other cell can give), and only those cells enter the open set
+//  - FindPathJpsPlus() reads the walks from tables built once by BuildJumpTables(), the distance to the next jump point
+//    or wall in each of the 8 directions of every cell. Changing a cell drops the tables.
+//  - Searches keep their data in a SearchContext, one per thread lets many threads search one grid at once
+//--------------------------------------------------------------------------------------------------------------------
+class GridGraph
+{
+public:
+	using CellId = size_t;
+	using Dist = float;
+
+	static constexpr CellId kInvalidCellId = std::numeric_limits<CellId>::max();
+	static constexpr Dist kStartDist = std::numeric_limits<Dist>::max();
+	static constexpr Dist kDiagonalCost = 1.41421356f;
+
+	// Straight directions first, jump tables store the 8 entries of a cell in this order
+	static constexpr size_t kDirectionCount = 8;
+	static constexpr int kDirectionX[kDirectionCount] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static constexpr int kDirectionY[kDirectionCount] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+	//-------------------------------------------------------------
+	// Data of one search, reusing it for the next search only resets the cells that search reaches
+	//-------------------------------------------------------------
+	class SearchContext
+	{
+		friend class GridGraph;
+
+		struct CellState
+		{
+			uint32_t m_generation = 0;	// Data below belongs to an older search unless it's the context's generation
+			bool m_closed = false;
+			CellId m_prev = kInvalidCellId;
+			Dist m_distance = kStartDist;
+		};
+
+		std::vector<CellState> m_cellStates;
+		uint32_t m_generation = 0;
+		IndexedHeap<Dist, 4> m_openSet;		// By distance plus heuristic
+		size_t m_expandedCount = 0;
+
+	public:
+		bool IsReached(CellId cellId) const { return m_cellStates[cellId].m_generation == m_generation; }
+		Dist GetDistance(CellId cellId) const { return IsReached(cellId) ? m_cellStates[cellId].m_distance : kStartDist; }
+		CellId GetPrev(CellId cellId) const { return IsReached(cellId) ? m_cellStates[cellId].m_prev : kInvalidCellId; }
+		size_t GetExpandedCount() const { return m_expandedCount; }
+
+	private:
+		// Start a search of a grid with cellCount cells, O(1) unless the cell count changed or the generation wraps
+		void Begin(size_t cellCount)
+		{
+			if (m_cellStates.size() != cellCount || ++m_generation == 0)
+			{
+				m_cellStates.assign(cellCount, CellState());
+				m_openSet.Reset(cellCount);
+				m_generation = 1;
+			}
+
+			m_openSet.Clear();
+			m_expandedCount = 0;
+		}
+
+		// State of the cell for this search, reset the first time the search reaches it
+		CellState& Touch(CellId cellId)
+		{
+			CellState& cellState = m_cellStates[cellId];
+			if (cellState.m_generation != m_generation)
+				cellState = CellState{ m_generation, false, kInvalidCellId, kStartDist };
+			return cellState;
+		}
+	};
+
+private:
+	int m_width;
+	int m_height;
+	std::vector<uint8_t> m_isWalkable;
+
+	// Per cell and direction, steps to the next jump point if positive, or minus the steps possible before a wall.
+	// Empty until BuildJumpTables().
+	std::vector<int16_t> m_jumpDistances;
+
+public:
+	GridGraph(size_t width, size_t height);
+
+	// Cells
+	void SetWalkable(size_t x, size_t y, bool isWalkable);
+	bool IsWalkable(int x, int y) const { return x >= 0 && y >= 0 && x < m_width && y < m_height && m_isWalkable[GetCellId(x, y)]; }
+	size_t GetWidth() const { return static_cast<size_t>(m_width); }
+	size_t GetHeight() const { return static_cast<size_t>(m_height); }
+	size_t GetCellCount() const { return m_isWalkable.size(); }
+	CellId GetCellId(int x, int y) const { return static_cast<CellId>(y) * m_width + x; }
+	int GetX(CellId cellId) const { return static_cast<int>(cellId % m_width); }
+	int GetY(CellId cellId) const { return static_cast<int>(cellId / m_width); }
+
+	// Path-finding, a path lists its start, its turns and its goal, empty if there's none
+	std::vector<CellId> FindPathJps(CellId startCellId, CellId goalCellId, SearchContext& context) const;
+	void BuildJumpTables();
+	bool HasJumpTables() const { return !m_jumpDistances.empty(); }
+	std::vector<CellId> FindPathJpsPlus(CellId startCellId, CellId goalCellId, SearchContext& context) const;
+
+	// The same grid as a Graph, for its searches
+	template <class Type> void BuildGraph(Graph<Type>& graph) const;
+
+	static bool UnitTest();
+
+private:
+	Dist Heuristic(CellId fromCellId, CellId toCellId) const;
+	bool CanStep(int x, int y, size_t direction) const;
+	bool HasForcedNeighbor(int x, int y, size_t direction) const;
+	CellId JumpStraight(int x, int y, size_t direction, CellId goalCellId) const;
+	CellId Jump(int x, int y, size_t direction, CellId goalCellId) const;
+	template <class Func> void ForEachJumpPlus(CellId cellId, size_t direction, CellId goalCellId, Func&& func) const;
+	template <class Func> void ForEachSearchDirection(CellId cellId, const SearchContext& context, Func&& func) const;
+	template <class Func> std::vector<CellId> InternalFindPath(CellId startCellId, CellId goalCellId, SearchContext& context, Func&& forEachSuccessor) const;
+};
+
+inline GridGraph::GridGraph(size_t width, size_t height)
+	: m_width(static_cast<int>(width))
+	, m_height(static_cast<int>(height))
+	, m_isWalkable(width * height, 1)
+{
+	// Jump distances are 16 bits
+	assert(width > 0 && height > 0 && width < INT16_MAX && height < INT16_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Open or block a cell, the jump tables no longer match the grid
+//--------------------------------------------------------------------------------------------------------------------
+inline void GridGraph::SetWalkable(size_t x, size_t y, bool isWalkable)
+{
+	assert(x < GetWidth() && y < GetHeight());
+	m_isWalkable[GetCellId(static_cast<int>(x), static_cast<int>(y))] = isWalkable;
+	m_jumpDistances.clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Octile distance, the cost of the shortest path without obstacles
+//--------------------------------------------------------------------------------------------------------------------
+inline GridGraph::Dist GridGraph::Heuristic(CellId fromCellId, CellId toCellId) const
+{
+	const int kDistX = std::abs(GetX(fromCellId) - GetX(toCellId));
+	const int kDistY = std::abs(GetY(fromCellId) - GetY(toCellId));
+	return static_cast<Dist>(std::max(kDistX, kDistY)) + (kDiagonalCost - 1.0f) * static_cast<Dist>(std::min(kDistX, kDistY));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Whether one step in direction from (x, y) is allowed, a diagonal step can't cut a corner
+//--------------------------------------------------------------------------------------------------------------------
+inline bool GridGraph::CanStep(int x, int y, size_t direction) const
+{
+	const int kDirX = kDirectionX[direction];
+	const int kDirY = kDirectionY[direction];
+	if (!IsWalkable(x + kDirX, y + kDirY))
+		return false;
+
+	return kDirX == 0 || kDirY == 0 || (IsWalkable(x + kDirX, y) && IsWalkable(x, y + kDirY));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Whether (x, y), entered with a straight step in direction, is a jump point: a cell beside it is open while the one
+// beside the previous cell is blocked, so the only shortest path to it may go through (x, y)
+//--------------------------------------------------------------------------------------------------------------------
+inline bool GridGraph::HasForcedNeighbor(int x, int y, size_t direction) const
+{
+	const int kDirX = kDirectionX[direction];
+	const int kDirY = kDirectionY[direction];
+	if (kDirX != 0)
+		return (IsWalkable(x, y - 1) && !IsWalkable(x - kDirX, y - 1)) || (IsWalkable(x, y + 1) && !IsWalkable(x - kDirX, y + 1));
+
+	return (IsWalkable(x - 1, y) && !IsWalkable(x - 1, y - kDirY)) || (IsWalkable(x + 1, y) && !IsWalkable(x + 1, y - kDirY));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Walk a straight direction from (x, y) to the goal or the next jump point, kInvalidCellId if a wall comes first
+// Time: O(cells walked)
+//--------------------------------------------------------------------------------------------------------------------
+inline GridGraph::CellId GridGraph::JumpStraight(int x, int y, size_t direction, CellId goalCellId) const
+{
+	for (;;)
+	{
+		x += kDirectionX[direction];
+		y += kDirectionY[direction];
+		if (!IsWalkable(x, y))
+			return kInvalidCellId;
+
+		const CellId kCellId = GetCellId(x, y);
+		if (kCellId == goalCellId || HasForcedNeighbor(x, y, direction))
+			return kCellId;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Walk a direction from (x, y) to the goal or the next jump point. Walking diagonally stops at the first cell whose
+// straight walks along both parts of the diagonal find one.
+// Time: O(cells walked)
+//--------------------------------------------------------------------------------------------------------------------
+inline GridGraph::CellId GridGraph::Jump(int x, int y, size_t direction, CellId goalCellId) const
+{
+	const int kDirX = kDirectionX[direction];
+	const int kDirY = kDirectionY[direction];
+	if (kDirX == 0 || kDirY == 0)
+		return JumpStraight(x, y, direction, goalCellId);
+
+	// Straight directions with the same x and y parts
+	const size_t kDirectionAlongX = kDirX > 0 ? 0 : 1;
+	const size_t kDirectionAlongY = kDirY > 0 ? 2 : 3;
+
+	while (CanStep(x, y, direction))
+	{
+		x += kDirX;
+		y += kDirY;
+
+		const CellId kCellId = GetCellId(x, y);
+		if (kCellId == goalCellId || JumpStraight(x, y, kDirectionAlongX, goalCellId) != kInvalidCellId || JumpStraight(x, y, kDirectionAlongY, goalCellId) != kInvalidCellId)
+			return kCellId;
+	}
+
+	return kInvalidCellId;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Fill the jump tables, straight directions first since the diagonal ones stop where a straight walk finds a jump point
+// Each entry comes from the entry of the next cell in its direction, so cells are visited from that end of the grid.
+// Time: O(cells)
+//--------------------------------------------------------------------------------------------------------------------
+inline void GridGraph::BuildJumpTables()
+{
+	m_jumpDistances.assign(m_isWalkable.size() * kDirectionCount, 0);
+
+	for (size_t direction = 0; direction < kDirectionCount; ++direction)
+	{
+		const int kDirX = kDirectionX[direction];
+		const int kDirY = kDirectionY[direction];
+		const bool kIsDiagonal = kDirX != 0 && kDirY != 0;
+		const size_t kDirectionAlongX = kDirX > 0 ? 0 : 1;
+		const size_t kDirectionAlongY = kDirY > 0 ? 2 : 3;
+
+		for (int row = 0; row < m_height; ++row)
+		{
+			const int kY = kDirY > 0 ? m_height - 1 - row : row;
+			for (int column = 0; column < m_width; ++column)
+			{
+				const int kX = kDirX > 0 ? m_width - 1 - column : column;
+				if (!IsWalkable(kX, kY) || !CanStep(kX, kY, direction))
+					continue;
+
+				const CellId kNextCellId = GetCellId(kX + kDirX, kY + kDirY);
+				const int16_t* pNextDistances = &m_jumpDistances[kNextCellId * kDirectionCount];
+
+				bool isJumpPoint = false;
+				if (kIsDiagonal)
+					isJumpPoint = pNextDistances[kDirectionAlongX] > 0 || pNextDistances[kDirectionAlongY] > 0;
+				else
+					isJumpPoint = HasForcedNeighbor(kX + kDirX, kY + kDirY, direction);
+
+				const int16_t kNextDistance = pNextDistances[direction];
+				int16_t& distance = m_jumpDistances[GetCellId(kX, kY) * kDirectionCount + direction];
+				if (isJumpPoint)
+					distance = 1;
+				else
+					distance = static_cast<int16_t>(kNextDistance > 0 ? kNextDistance + 1 : kNextDistance - 1);
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// What Jump() finds, read from the tables. The goal isn't in them: if it's within reach along the direction, or
+// diagonally ahead such that a straight walk could reach it, the cell where that happens is also a successor.
+//--------------------------------------------------------------------------------------------------------------------
+template <class Func>
+inline void GridGraph::ForEachJumpPlus(CellId cellId, size_t direction, CellId goalCellId, Func&& func) const
+{
+	const int kDirX = kDirectionX[direction];
+	const int kDirY = kDirectionY[direction];
+	const int kDistance = m_jumpDistances[cellId * kDirectionCount + direction];
+	const int kReach = std::abs(kDistance);
+	const int kX = GetX(cellId);
+	const int kY = GetY(cellId);
+
+	// Steps to the goal along each axis, in this direction
+	const int kGoalStepsX = (GetX(goalCellId) - kX) * kDirX;
+	const int kGoalStepsY = (GetY(goalCellId) - kY) * kDirY;
+
+	int targetSteps = 0;
+	if (kDirX == 0 || kDirY == 0)
+	{
+		// The goal is on the line
+		const bool kIsOnLine = kDirX == 0 ? GetX(goalCellId) == kX : GetY(goalCellId) == kY;
+		const int kGoalSteps = kDirX == 0 ? kGoalStepsY : kGoalStepsX;
+		if (kIsOnLine && kGoalSteps > 0)
+			targetSteps = kGoalSteps;
+	}
+	else if (kGoalStepsX > 0 && kGoalStepsY > 0)
+	{
+		// The goal is in the quadrant, stop where a straight walk can get to it
+		targetSteps = std::min(kGoalStepsX, kGoalStepsY);
+	}
+
+	if (targetSteps > 0 && targetSteps <= kReach)
+		func(GetCellId(kX + kDirX * targetSteps, kY + kDirY * targetSteps));
+	if (kDistance > 0 && kDistance != targetSteps)
+		func(GetCellId(kX + kDirX * kDistance, kY + kDirY * kDistance));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Directions worth walking from a cell, given the direction the search came from: the start walks all 8, a diagonal
+// keeps going and tries both of its straight parts, a straight walk keeps going and tries both sides, which covers the
+// forced neighbors
+//--------------------------------------------------------------------------------------------------------------------
+template <class Func>
+inline void GridGraph::ForEachSearchDirection(CellId cellId, const SearchContext& context, Func&& func) const
+{
+	const CellId kPrevCellId = context.m_cellStates[cellId].m_prev;
+	if (kPrevCellId == kInvalidCellId)
+	{
+		for (size_t direction = 0; direction < kDirectionCount; ++direction)
+			func(direction);
+		return;
+	}
+
+	const int kDirX = (GetX(cellId) > GetX(kPrevCellId)) - (GetX(cellId) < GetX(kPrevCellId));
+	const int kDirY = (GetY(cellId) > GetY(kPrevCellId)) - (GetY(cellId) < GetY(kPrevCellId));
+	for (size_t direction = 0; direction < kDirectionCount; ++direction)
+	{
+		const int kX = kDirectionX[direction];
+		const int kY = kDirectionY[direction];
+
+		bool isUseful = false;
+		if (kDirX != 0 && kDirY != 0)
+			isUseful = (kX == kDirX && kY == kDirY) || (kX == kDirX && kY == 0) || (kX == 0 && kY == kDirY);
+		else if (kDirX != 0)
+			isUseful = kX == kDirX || (kX == 0 && kY != 0);
+		else
+			isUseful = kY == kDirY || (kY == 0 && kX != 0);
+
+		if (isUseful)
+			func(direction);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// A* over the cells forEachSuccessor(cellId, direction, func) gives, each a straight or diagonal line away
+//--------------------------------------------------------------------------------------------------------------------
+template <class Func>
+inline std::vector<GridGraph::CellId> GridGraph::InternalFindPath(CellId startCellId, CellId goalCellId, SearchContext& context, Func&& forEachSuccessor) const
+{
+	assert(startCellId < GetCellCount() && goalCellId < GetCellCount());
+
+	std::vector<CellId> path;
+	if (!m_isWalkable[startCellId] || !m_isWalkable[goalCellId])
+		return path;
+
+	context.Begin(GetCellCount());
+	IndexedHeap<Dist, 4>& openSet = context.m_openSet;
+
+	context.Touch(startCellId).m_distance = 0.0f;
+	openSet.Push(startCellId, Heuristic(startCellId, goalCellId));
+
+	while (!openSet.Empty())
+	{
+		const CellId kCellId = openSet.Pop();
+		++context.m_expandedCount;
+
+		if (kCellId == goalCellId)
+		{
+			for (CellId cellId = goalCellId; cellId != kInvalidCellId; cellId = context.m_cellStates[cellId].m_prev)
+				path.emplace_back(cellId);
+			std::reverse(path.begin(), path.end());
+			return path;
+		}
+
+		SearchContext::CellState& cellState = context.m_cellStates[kCellId];
+		cellState.m_closed = true;
+		const Dist kDistance = cellState.m_distance;
+
+		ForEachSearchDirection(kCellId, context, [&](size_t direction)
+		{
+			forEachSuccessor(kCellId, direction, [&](CellId successorId)
+			{
+				SearchContext::CellState& successorState = context.Touch(successorId);
+				if (successorState.m_closed)
+					return;
+
+				// Jump points are a straight or diagonal line away, the heuristic is their exact distance
+				const Dist kSuccessorDistance = kDistance + Heuristic(kCellId, successorId);
+				if (kSuccessorDistance < successorState.m_distance)
+				{
+					successorState.m_distance = kSuccessorDistance;
+					successorState.m_prev = kCellId;
+					openSet.PushOrDecreaseKey(successorId, kSuccessorDistance + Heuristic(successorId, goalCellId));
+				}
+			});
+		});
+	}
+
+	return path;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Jump Point Search from startCellId to goalCellId
+// Time: O(cells walked), the open set only holds jump points
+//--------------------------------------------------------------------------------------------------------------------
+inline std::vector<GridGraph::CellId> GridGraph::FindPathJps(CellId startCellId, CellId goalCellId, SearchContext& context) const
+{
+	return InternalFindPath(startCellId, goalCellId, context, [this, goalCellId](CellId cellId, size_t direction, auto&& func)
+	{
+		const CellId kJumpPointId = Jump(GetX(cellId), GetY(cellId), direction, goalCellId);
+		if (kJumpPointId != kInvalidCellId)
+			func(kJumpPointId);
+	});
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Jump Point Search reading the jump tables, BuildJumpTables() must have run since the grid last changed
+// Time: O(jump points), no cell is walked
+//--------------------------------------------------------------------------------------------------------------------
+inline std::vector<GridGraph::CellId> GridGraph::FindPathJpsPlus(CellId startCellId, CellId goalCellId, SearchContext& context) const
+{
+	assert(HasJumpTables());
+
+	return InternalFindPath(startCellId, goalCellId, context, [this, goalCellId](CellId cellId, size_t direction, auto&& func)
+	{
+		ForEachJumpPlus(cellId, direction, goalCellId, func);
+	});
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Add a node per cell and an edge per allowed step to an empty graph, node data is the cell id
+//--------------------------------------------------------------------------------------------------------------------
+template <class Type>
+inline void GridGraph::BuildGraph(Graph<Type>& graph) const
+{
+	assert(graph.GetNodeCount() == 0);
+
+	for (CellId cellId = 0; cellId < GetCellCount(); ++cellId)
+		graph.AddNode(static_cast<Type>(cellId));
+
+	for (int y = 0; y < m_height; ++y)
+	{
+		for (int x = 0; x < m_width; ++x)
+		{
+			if (!IsWalkable(x, y))
+				continue;
+
+			for (size_t direction = 0; direction < kDirectionCount; ++direction)
+			{
+				if (!CanStep(x, y, direction))
+					continue;
+
+				const bool kIsDiagonal = kDirectionX[direction] != 0 && kDirectionY[direction] != 0;
+				graph.AddEdge(GetCellId(x, y), GetCellId(x + kDirectionX[direction], y + kDirectionY[direction]), kIsDiagonal ? kDiagonalCost : 1.0f);
+			}
+		}
+	}
+
+	graph.SetGridWidth(GetWidth());
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Automated test, both searches must find paths as short as A* on the same grid as a Graph
+//--------------------------------------------------------------------------------------------------------------------
+inline bool GridGraph::UnitTest()
+{
+	// Cost of a path of lines, and whether each line is straight or diagonal over walkable cells
+	auto checkPath = [](const GridGraph& grid, const std::vector<CellId>& path, Dist& cost)
+	{
+		cost = 0.0f;
+		for (size_t i = 1; i < path.size(); ++i)
+		{
+			int x = grid.GetX(path[i - 1]);
+			int y = grid.GetY(path[i - 1]);
+			const int kDirX = (grid.GetX(path[i]) > x) - (grid.GetX(path[i]) < x);
+			const int kDirY = (grid.GetY(path[i]) > y) - (grid.GetY(path[i]) < y);
+			size_t direction = 0;
+			while (kDirectionX[direction] != kDirX || kDirectionY[direction] != kDirY)
+				++direction;
+
+			while (grid.GetCellId(x, y) != path[i])
+			{
+				if ((x != grid.GetX(path[i]) && kDirX == 0) || (y != grid.GetY(path[i]) && kDirY == 0) || !grid.CanStep(x, y, direction))
+					return false;
+				x += kDirX;
+				y += kDirY;
+			}
+			cost += grid.Heuristic(path[i - 1], path[i]);
+		}
+		return true;
+	};
+
+	//---------------------------------------------------------------
+	// Around a wall
+	//---------------------------------------------------------------
+	GridGraph wallGrid(kTestSize, kTestSize);
+	for (size_t y = 0; y + 1 < kTestSize; ++y)
+		wallGrid.SetWalkable(kTestSize / 2, y, false);
+
+	SearchContext context;
+	Dist cost = 0.0f;
+	const CellId kStartCellId = wallGrid.GetCellId(0, 0);
+	const CellId kGoalCellId = wallGrid.GetCellId(kTestSize - 1, 0);
+	std::vector<CellId> path = wallGrid.FindPathJps(kStartCellId, kGoalCellId, context);
+	if (path.empty() || path.front() != kStartCellId || path.back() != kGoalCellId || !checkPath(wallGrid, path, cost))
+		RETURN_ERROR("GridGraph::FindPathJps()");
+
+	// Down to the gap, straight through it since corners can't be cut, and back up
+	const Dist kExpectedCost = 2.0f * (kTestSize - 1) + 2.0f + (kDiagonalCost - 1.0f) * (kTestSize - 3);
+	if (std::fabs(cost - kExpectedCost) > 0.01f)
+		RETURN_ERROR("GridGraph::FindPathJps() cost");
+
+	wallGrid.SetWalkable(kTestSize / 2, kTestSize - 1, false);
+	if (!wallGrid.FindPathJps(kStartCellId, kGoalCellId, context).empty())
+		RETURN_ERROR("GridGraph::FindPathJps() without a path");
+
+	//---------------------------------------------------------------
+	// Random grids against A*
+	//---------------------------------------------------------------
+	uint32_t randomState = 1;
+	auto nextRandom = [&randomState]()
+	{
+		randomState = randomState * 1664525 + 1013904223;
+		return randomState >> 8;
+	};
+
+	for (size_t round = 0; round < 8; ++round)
+	{
+		const size_t kWidth = kTestSize + round * 7;
+		const size_t kHeight = kTestSize - round * 3;
+		GridGraph grid(kWidth, kHeight);
+		for (size_t y = 0; y < kHeight; ++y)
+		{
+			for (size_t x = 0; x < kWidth; ++x)
+			{
+				if (nextRandom() % 100 < 10 + round * 4)
+					grid.SetWalkable(x, y, false);
+			}
+		}
+
+		Graph<CellId> graph;
+		grid.BuildGraph(graph);
+		graph.Freeze();
+		Graph<CellId>::SearchContext graphContext;
+		grid.BuildJumpTables();
+
+		for (size_t query = 0; query < kTestSize; ++query)
+		{
+			const CellId kStart = nextRandom() % grid.GetCellCount();
+			const CellId kGoal = nextRandom() % grid.GetCellCount();
+			if (!grid.m_isWalkable[kStart] || !grid.m_isWalkable[kGoal])
+				continue;
+
+			graph.RunAStar(kStart, kGoal, graphContext, [](Graph<CellId>::NodeId, const CellId&) {});
+			const Dist kAStarCost = graphContext.GetDistance(kGoal);
+
+			for (int usesTables = 0; usesTables < 2; ++usesTables)
+			{
+				path = usesTables ? grid.FindPathJpsPlus(kStart, kGoal, context) : grid.FindPathJps(kStart, kGoal, context);
+				if (path.empty() != (kAStarCost == Graph<CellId>::kStartDist))
+					RETURN_ERROR("GridGraph path found against A*");
+				if (path.empty())
+					continue;
+
+				const bool kIsShortest = path.front() == kStart && path.back() == kGoal && checkPath(grid, path, cost) && std::fabs(cost - kAStarCost) <= 0.001f * (1.0f + cost);
+				if (!kIsShortest && usesTables)
+					RETURN_ERROR("GridGraph::FindPathJpsPlus()");
+				if (!kIsShortest)
+					RETURN_ERROR("GridGraph::FindPathJps()");
+			}
+		}
+	}
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+}
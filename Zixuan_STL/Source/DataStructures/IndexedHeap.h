@@ -0,0 +1,309 @@
+#pragma once
+#include "Tests/StructureManager.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// d-ary heap of the indices [0, GetIndexCount()), each in the heap at most once with a key
+//  - Every index remembers its position in the heap, so Contains() and GetKey() are O(1) and DecreaseKey() moves the
+//    index up in place instead of pushing a duplicate
+//  - Keys sit next to their index in the heap array, sifting compares them without touching any other memory
+//  - kArity children per node make the heap shallower than a binary one, Pop() compares more keys per level but the
+//    children of a node share a cache line
+//  - Compare orders the keys like std::priority_queue's inverse: Compare(a, b) means a comes out before b
+//--------------------------------------------------------------------------------------------------------------------
+template <class _KeyType, size_t kArity = 4, class _Compare = std::less<_KeyType>>
+class IndexedHeap
+{
+	static_assert(kArity >= 2, "IndexedHeap needs at least two children per node");
+
+public:
+	using KeyType = _KeyType;
+	using Compare = _Compare;
+	using Index = size_t;
+
+	static constexpr size_t kInvalidPosition = static_cast<size_t>(-1);
+
+private:
+	struct Entry
+	{
+		KeyType m_key;
+		Index m_index;
+	};
+
+	std::vector<Entry> m_heap;
+	std::vector<size_t> m_positions;	// Position of each index in m_heap, kInvalidPosition if not in it
+	Compare m_compare;
+
+public:
+	IndexedHeap() = default;
+	explicit IndexedHeap(size_t indexCount, const Compare& compare = Compare());
+
+	void Reset(size_t indexCount);
+	void Clear();
+
+	void Push(Index index, const KeyType& key);
+	void DecreaseKey(Index index, const KeyType& key);
+	bool PushOrDecreaseKey(Index index, const KeyType& key);
+	Index Pop();
+
+	bool Empty() const { return m_heap.empty(); }
+	size_t GetSize() const { return m_heap.size(); }
+	size_t GetIndexCount() const { return m_positions.size(); }
+	bool Contains(Index index) const { return m_positions[index] != kInvalidPosition; }
+	const KeyType& GetKey(Index index) const { assert(Contains(index)); return m_heap[m_positions[index]].m_key; }
+	Index GetTop() const { assert(!Empty()); return m_heap.front().m_index; }
+	const KeyType& GetTopKey() const { assert(!Empty()); return m_heap.front().m_key; }
+
+	static bool UnitTest();
+
+private:
+	void SiftUp(size_t position, Entry entry);
+	void SiftDown(size_t position, Entry entry);
+};
+
+template<class _KeyType, size_t kArity, class _Compare>
+inline IndexedHeap<_KeyType, kArity, _Compare>::IndexedHeap(size_t indexCount, const Compare& compare /*= Compare()*/)
+	: m_positions(indexCount, kInvalidPosition)
+	, m_compare(compare)
+{
+	//
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Empty the heap and take the indices [0, indexCount)
+// Time: O(indexCount)
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline void IndexedHeap<_KeyType, kArity, _Compare>::Reset(size_t indexCount)
+{
+	m_heap.clear();
+	m_positions.assign(indexCount, kInvalidPosition);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Empty the heap, only the positions of the indices still in it are touched
+// Time: O(GetSize())
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline void IndexedHeap<_KeyType, kArity, _Compare>::Clear()
+{
+	for (const Entry& kEntry : m_heap)
+		m_positions[kEntry.m_index] = kInvalidPosition;
+	m_heap.clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Add an index which isn't in the heap
+// Time: O(log(n) / log(kArity))
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline void IndexedHeap<_KeyType, kArity, _Compare>::Push(Index index, const KeyType& key)
+{
+	assert(index < m_positions.size() && !Contains(index));
+
+	m_heap.emplace_back();
+	SiftUp(m_heap.size() - 1, Entry{ key, index });
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Give an index of the heap a key which comes out no later than its current one
+// Time: O(log(n) / log(kArity))
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline void IndexedHeap<_KeyType, kArity, _Compare>::DecreaseKey(Index index, const KeyType& key)
+{
+	assert(Contains(index) && !m_compare(GetKey(index), key));
+
+	SiftUp(m_positions[index], Entry{ key, index });
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Push the index, or decrease its key if it's already in the heap and key is better
+// Returns true if the heap changed
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline bool IndexedHeap<_KeyType, kArity, _Compare>::PushOrDecreaseKey(Index index, const KeyType& key)
+{
+	if (!Contains(index))
+	{
+		Push(index, key);
+		return true;
+	}
+
+	if (!m_compare(key, GetKey(index)))
+		return false;
+
+	DecreaseKey(index, key);
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Remove the index with the best key and return it
+// Time: O(kArity * log(n) / log(kArity))
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline typename IndexedHeap<_KeyType, kArity, _Compare>::Index IndexedHeap<_KeyType, kArity, _Compare>::Pop()
+{
+	assert(!Empty());
+
+	const Index kTop = m_heap.front().m_index;
+	m_positions[kTop] = kInvalidPosition;
+
+	// Sift the last entry down from the root
+	const Entry kLast = m_heap.back();
+	m_heap.pop_back();
+	if (!m_heap.empty())
+		SiftDown(0, kLast);
+
+	return kTop;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move the hole at position up until entry fits in it, parents move down into the hole on the way
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline void IndexedHeap<_KeyType, kArity, _Compare>::SiftUp(size_t position, Entry entry)
+{
+	while (position > 0)
+	{
+		const size_t kParent = (position - 1) / kArity;
+		if (!m_compare(entry.m_key, m_heap[kParent].m_key))
+			break;
+
+		m_heap[position] = m_heap[kParent];
+		m_positions[m_heap[position].m_index] = position;
+		position = kParent;
+	}
+
+	m_heap[position] = entry;
+	m_positions[entry.m_index] = position;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move the hole at position down until entry fits in it, the best child moves up into the hole on the way
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline void IndexedHeap<_KeyType, kArity, _Compare>::SiftDown(size_t position, Entry entry)
+{
+	const size_t kSize = m_heap.size();
+	for (;;)
+	{
+		const size_t kFirstChild = position * kArity + 1;
+		if (kFirstChild >= kSize)
+			break;
+
+		// Best of the children
+		const size_t kLastChild = std::min(kFirstChild + kArity, kSize);
+		size_t bestChild = kFirstChild;
+		for (size_t child = kFirstChild + 1; child < kLastChild; ++child)
+		{
+			if (m_compare(m_heap[child].m_key, m_heap[bestChild].m_key))
+				bestChild = child;
+		}
+
+		if (!m_compare(m_heap[bestChild].m_key, entry.m_key))
+			break;
+
+		m_heap[position] = m_heap[bestChild];
+		m_positions[m_heap[position].m_index] = position;
+		position = bestChild;
+	}
+
+	m_heap[position] = entry;
+	m_positions[entry.m_index] = position;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Automated test, every pop must come out in key order with the latest key of the index
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, size_t kArity, class _Compare>
+inline bool IndexedHeap<_KeyType, kArity, _Compare>::UnitTest()
+{
+	static constexpr size_t kIndexCount = kTestSize * 20;
+
+	//---------------------------------------------------------------
+	// Push and Pop
+	//---------------------------------------------------------------
+	IndexedHeap testHeap(kTestSize);
+	for (size_t i = 0; i < kTestSize; ++i)
+		testHeap.Push((i * 7) % kTestSize, static_cast<KeyType>((i * 7) % kTestSize));
+
+	if (testHeap.GetSize() != kTestSize || !testHeap.Contains(0) || testHeap.GetKey(3) != static_cast<KeyType>(3))
+		RETURN_ERROR("IndexedHeap::Push()");
+
+	KeyType lastKey = testHeap.GetTopKey();
+	while (!testHeap.Empty())
+	{
+		const KeyType kKey = testHeap.GetTopKey();
+		const Index kIndex = testHeap.Pop();
+		if (testHeap.m_compare(kKey, lastKey) || testHeap.Contains(kIndex) || kKey != static_cast<KeyType>(kIndex))
+			RETURN_ERROR("IndexedHeap::Pop()");
+		lastKey = kKey;
+	}
+
+	//---------------------------------------------------------------
+	// DecreaseKey against a plain array
+	//---------------------------------------------------------------
+	testHeap.Reset(kIndexCount);
+	std::vector<KeyType> keys(kIndexCount);
+	std::vector<bool> isInHeap(kIndexCount, false);
+	uint32_t randomState = 1;
+	auto nextRandom = [&randomState]()
+	{
+		randomState = randomState * 1664525 + 1013904223;
+		return randomState >> 8;
+	};
+
+	for (size_t round = 0; round < kIndexCount * 4; ++round)
+	{
+		const Index kIndex = nextRandom() % kIndexCount;
+		const KeyType kKey = static_cast<KeyType>(nextRandom() % 1000);
+		if (nextRandom() % 4 == 0 && !testHeap.Empty())
+		{
+			// The top must be a best key of the array
+			const Index kTop = testHeap.Pop();
+			for (size_t i = 0; i < kIndexCount; ++i)
+			{
+				if (isInHeap[i] && testHeap.m_compare(keys[i], keys[kTop]))
+					RETURN_ERROR("IndexedHeap::Pop() after DecreaseKey()");
+			}
+			isInHeap[kTop] = false;
+			continue;
+		}
+
+		const bool kShouldChange = !isInHeap[kIndex] || testHeap.m_compare(kKey, keys[kIndex]);
+		if (testHeap.PushOrDecreaseKey(kIndex, kKey) != kShouldChange)
+			RETURN_ERROR("IndexedHeap::PushOrDecreaseKey()");
+		if (kShouldChange)
+			keys[kIndex] = kKey;
+		isInHeap[kIndex] = true;
+
+		if (testHeap.GetKey(kIndex) != keys[kIndex])
+			RETURN_ERROR("IndexedHeap::GetKey()");
+	}
+
+	//---------------------------------------------------------------
+	// Clear
+	//---------------------------------------------------------------
+	testHeap.Clear();
+	for (size_t i = 0; i < kIndexCount; ++i)
+	{
+		if (testHeap.Contains(i))
+			RETURN_ERROR("IndexedHeap::Clear()");
+	}
+	if (!testHeap.Empty() || testHeap.GetIndexCount() != kIndexCount)
+		RETURN_ERROR("IndexedHeap::Clear()");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+}
@@ -7,12 +7,14 @@
 #include <optional>
 #include <conio.h>
 
+#include "allocator.h"
+
 namespace zxstl
 {
 //--------------------------------------------------------------------------------------------------------------------
 // Ordered array class, I didn't make it derived from UnorderedArray class because we want data structures as fast as possible
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
+template<class Type, class Allocator = allocator<Type>>
 class OrderedArray
 {
 private:
@@ -21,10 +23,11 @@ private:
     size_t m_capacity;
     size_t m_size;     
     bool m_isIncreasingOrder;   // Used for ordering decreasing or increasing
+    Allocator m_allocator;
 
 public:
-    OrderedArray(size_t capacity, bool isIncreasingOrder = true);
-    OrderedArray(bool isIncreasingOrder = true);
+    OrderedArray(size_t capacity, bool isIncreasingOrder = true, const Allocator& alloc = Allocator());
+    OrderedArray(bool isIncreasingOrder = true, const Allocator& alloc = Allocator());
     ~OrderedArray();
 
     // API
@@ -59,12 +62,13 @@ private:
 //--------------------------------------------------------------------------------------------------------------------
 // Ctor, takes in the size of the array and dynamically allocate in the ctor, takes in a boolean of ordering method
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline OrderedArray<Type>::OrderedArray(size_t capacity, bool isIncreasingOrder)
+template<class Type, class Allocator>
+inline OrderedArray<Type, Allocator>::OrderedArray(size_t capacity, bool isIncreasingOrder, const Allocator& alloc)
     : m_pBuffer(nullptr)
     , m_capacity(capacity)
     , m_size(0)
     , m_isIncreasingOrder{ isIncreasingOrder }
+    , m_allocator(alloc)
 {
     assert(capacity >= 0);
     Expand(capacity);
@@ -73,12 +77,13 @@ inline OrderedArray<Type>::OrderedArray(size_t capacity, bool isIncreasingOrder)
 //--------------------------------------------------------------------------------------------------------------------
 // Default ctor
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline OrderedArray<Type>::OrderedArray(bool isIncreasingOrder)
+template<class Type, class Allocator>
+inline OrderedArray<Type, Allocator>::OrderedArray(bool isIncreasingOrder, const Allocator& alloc)
     : m_pBuffer(nullptr)
     , m_capacity(kInitialCapacity)
     , m_size(0)
     , m_isIncreasingOrder{ isIncreasingOrder }
+    , m_allocator(alloc)
 {
     Expand(m_capacity);
 }
@@ -86,8 +91,8 @@ inline OrderedArray<Type>::OrderedArray(bool isIncreasingOrder)
 //--------------------------------------------------------------------------------------------------------------------
 // The destructor will need to clean up and deallocate any memory that was allocated in the constructor.
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline OrderedArray<Type>::~OrderedArray()
+template<class Type, class Allocator>
+inline OrderedArray<Type, Allocator>::~OrderedArray()
 {
     Destroy();
 }
@@ -95,8 +100,8 @@ inline OrderedArray<Type>::~OrderedArray()
 //--------------------------------------------------------------------------------------------------------------------
 // Removes all elements from the array, set size back to 0
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::Clear()
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Clear()
 {
     Destroy();
     m_size = 0;
@@ -105,8 +110,8 @@ inline void OrderedArray<Type>::Clear()
 //--------------------------------------------------------------------------------------------------------------------
 // Takes in a value to be inserted at the end of the array
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::Push(const Type& val)
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Push(const Type& val)
 {
     // If the array is full, expand it
     if (m_size >= m_capacity)
@@ -123,8 +128,8 @@ inline void OrderedArray<Type>::Push(const Type& val)
     ++m_size;
 }
 
-template<class Type>
-inline void OrderedArray<Type>::Push(Type&& val)
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Push(Type&& val)
 {
     // If the array is full, expand it
     if (m_size >= m_capacity)
@@ -144,8 +149,8 @@ inline void OrderedArray<Type>::Push(Type&& val)
 //--------------------------------------------------------------------------------------------------------------------
 // Removes the last element of the array.
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline Type OrderedArray<Type>::Pop()
+template<class Type, class Allocator>
+inline Type OrderedArray<Type, Allocator>::Pop()
 {
     // Underflow checking
     assert(!Empty());
@@ -167,8 +172,8 @@ inline Type OrderedArray<Type>::Pop()
 //--------------------------------------------------------------------------------------------------------------------
 // Takes an index of the element that should be removed, and removes it from the array.
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::Erase(size_t index)
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Erase(size_t index)
 {
     assert(index >= 0 && index <= (m_size - 1) && m_size > 0);
 
@@ -189,16 +194,16 @@ inline void OrderedArray<Type>::Erase(size_t index)
 //--------------------------------------------------------------------------------------------------------------------
 // Return a reference of a particular element.
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline Type& OrderedArray<Type>::operator[](size_t index)
+template<class Type, class Allocator>
+inline Type& OrderedArray<Type, Allocator>::operator[](size_t index)
 {
     assert(index >= 0 && index < m_size && !Empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
     return pTypeArray[index];
 }
 
-template<class Type>
-inline const Type& OrderedArray<Type>::operator[](size_t index) const
+template<class Type, class Allocator>
+inline const Type& OrderedArray<Type, Allocator>::operator[](size_t index) const
 {
     assert(index >= 0 && index < m_size && !Empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -208,8 +213,8 @@ inline const Type& OrderedArray<Type>::operator[](size_t index) const
 //--------------------------------------------------------------------------------------------------------------------
 // Print out every element
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::Print() const
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Print() const
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
     std::cout << "Elements: { ";
@@ -223,8 +228,8 @@ inline void OrderedArray<Type>::Print() const
 // Time:  O(n/2)
 // Spcae: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::Reverse()
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Reverse()
 {
     // Update order boolean
     m_isIncreasingOrder = !m_isIncreasingOrder;
@@ -248,14 +253,14 @@ inline void OrderedArray<Type>::Reverse()
 // Time:  O(log(n))
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline std::optional<size_t> OrderedArray<Type>::Search(const Type& val) const
+template<class Type, class Allocator>
+inline std::optional<size_t> OrderedArray<Type, Allocator>::Search(const Type& val) const
 {
     return BinarySearch(val, 0, m_size);
 }
 
-template<class Type>
-inline void OrderedArray<Type>::Test()
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Test()
 {
     // Variables for testing
     bool shouldQuit = false;
@@ -356,18 +361,16 @@ inline void OrderedArray<Type>::Test()
 //--------------------------------------------------------------------------------------------------------------------
 // Create a bigger array, update capacity, copy and move elements from previous array to the new one
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::Expand(size_t newCapacity)
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Expand(size_t newCapacity)
 {
-    const size_t newBufferSize = newCapacity * sizeof(Type);
-
-    std::byte* pNewBuffer = new std::byte[newBufferSize];
+    std::byte* pNewBuffer = reinterpret_cast<std::byte*>(std::to_address(std::allocator_traits<Allocator>::allocate(m_allocator, newCapacity)));
 
     // if the current buffer has data, copy it over to our new buffer and deallocate
-    if (m_capacity > 0)
+    if (m_pBuffer)
     {
         std::memcpy(pNewBuffer, m_pBuffer, sizeof(Type) * m_size);
-        delete[] m_pBuffer;
+        std::allocator_traits<Allocator>::deallocate(m_allocator, reinterpret_cast<Type*>(m_pBuffer), m_capacity);
     }
 
     // point to the new buffer and new capacity
@@ -378,8 +381,8 @@ inline void OrderedArray<Type>::Expand(size_t newCapacity)
 //--------------------------------------------------------------------------------------------------------------------
 // Delete pArray and set it to nullptr
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::Destroy()
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::Destroy()
 {
     // If the type of elements is not trivially destructible, call it's destructor
     if constexpr (!std::is_trivially_destructible_v<Type>)
@@ -394,7 +397,7 @@ inline void OrderedArray<Type>::Destroy()
     // If m_pArray is not nullptr, deallocate it and set it to nullptr
     if (m_pBuffer)
     {
-        delete[] m_pBuffer;
+        std::allocator_traits<Allocator>::deallocate(m_allocator, reinterpret_cast<Type*>(m_pBuffer), m_capacity);
         m_pBuffer = nullptr;
     }
 }
@@ -402,8 +405,8 @@ inline void OrderedArray<Type>::Destroy()
 //--------------------------------------------------------------------------------------------------------------------
 // Push a new element into the current location
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void OrderedArray<Type>::InternalPush(const Type& val)
+template<class Type, class Allocator>
+inline void OrderedArray<Type, Allocator>::InternalPush(const Type& val)
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -435,9 +438,9 @@ inline void OrderedArray<Type>::InternalPush(const Type& val)
     }
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <class... Args>
-inline void OrderedArray<Type>::InternalEmplace(Args&&... args)
+inline void OrderedArray<Type, Allocator>::InternalEmplace(Args&&... args)
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -472,8 +475,8 @@ inline void OrderedArray<Type>::InternalEmplace(Args&&... args)
 //--------------------------------------------------------------------------------------------------------------------
 // Recursive binary search
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline std::optional<size_t> OrderedArray<Type>::BinarySearch(const Type& val, size_t start, size_t end) const
+template<class Type, class Allocator>
+inline std::optional<size_t> OrderedArray<Type, Allocator>::BinarySearch(const Type& val, size_t start, size_t end) const
 {
     assert(start <= end);
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -498,9 +501,9 @@ inline std::optional<size_t> OrderedArray<Type>::BinarySearch(const Type& val, s
         return BinarySearch(val, midPointIndex + 1, end);
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<class ...Args>
-inline void OrderedArray<Type>::Emplace(Args && ...args)
+inline void OrderedArray<Type, Allocator>::Emplace(Args && ...args)
 {
     // If the array is full, expand it
     if (m_size >= m_capacity)
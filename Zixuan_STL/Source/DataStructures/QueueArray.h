@@ -4,12 +4,14 @@
 #include <cstring>
 #include <optional>
 
+#include "allocator.h"
+
 namespace zxstl
 {
 //--------------------------------------------------------------------------------------------------------------------
 // Queue implemented by T array
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
+template<class Type, class Allocator = allocator<Type>>
 class QueueArray
 {
 private:
@@ -22,8 +24,10 @@ private:
 	size_t m_headIndex;
 	size_t m_tailIndex;
 
+	Allocator m_allocator;
+
 public:
-	QueueArray(size_t capacity = kInitialCapacity);
+	QueueArray(size_t capacity = kInitialCapacity, const Allocator& alloc = Allocator());
 	~QueueArray();
 
 	void Enqueue(const Type& val);
@@ -43,28 +47,29 @@ private:
 	void Destroy();
 };
 
-template<class Type>
-inline QueueArray<Type>::QueueArray(size_t capacity /*= kInitialCapacity*/)
+template<class Type, class Allocator>
+inline QueueArray<Type, Allocator>::QueueArray(size_t capacity /*= kInitialCapacity*/, const Allocator& alloc /*= Allocator()*/)
 	: m_pBuffer(nullptr)
 	, m_capacity(capacity)
 	, m_size(0)
 	, m_headIndex{ 0 }
 	, m_tailIndex{ 0 }
+	, m_allocator(alloc)
 {
-	m_pBuffer = new std::byte[m_capacity * sizeof(Type)];
+	m_pBuffer = reinterpret_cast<std::byte*>(std::to_address(std::allocator_traits<Allocator>::allocate(m_allocator, m_capacity)));
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 // Default ctor
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline QueueArray<Type>::~QueueArray()
+template<class Type, class Allocator>
+inline QueueArray<Type, Allocator>::~QueueArray()
 {
 	Destroy();
 }
 
-template<class Type>
-inline void QueueArray<Type>::Enqueue(const Type& val)
+template<class Type, class Allocator>
+inline void QueueArray<Type, Allocator>::Enqueue(const Type& val)
 {
 	// Overflow checking
 	// If size is equal to the capacity, it's full
@@ -85,8 +90,8 @@ inline void QueueArray<Type>::Enqueue(const Type& val)
 	++m_size;
 }
 
-template<class Type>
-inline Type QueueArray<Type>::Dequeue()
+template<class Type, class Allocator>
+inline Type QueueArray<Type, Allocator>::Dequeue()
 {
 	// Underflow checking
 	// If size is less than 0, it's empty
@@ -113,8 +118,8 @@ inline Type QueueArray<Type>::Dequeue()
 	return pVal;
 }
 
-template<class Type>
-inline void QueueArray<Type>::Print() const
+template<class Type, class Allocator>
+inline void QueueArray<Type, Allocator>::Print() const
 {
 	std::cout << "Queue: { ";
 
@@ -133,8 +138,8 @@ inline void QueueArray<Type>::Print() const
 	std::cout << "} " << std::endl;
 }
 
-template<class Type>
-inline void QueueArray<Type>::Clear()
+template<class Type, class Allocator>
+inline void QueueArray<Type, Allocator>::Clear()
 {
 	Destroy();
 	m_headIndex = 0;
@@ -142,24 +147,24 @@ inline void QueueArray<Type>::Clear()
 	m_size = 0;
 }
 
-template<class Type>
-inline Type& QueueArray<Type>::Tail() const
+template<class Type, class Allocator>
+inline Type& QueueArray<Type, Allocator>::Tail() const
 {
 	assert(m_size > 0);
 	Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 	return pTypeArray[(m_tailIndex == 0) ? (m_capacity - 1) : (m_tailIndex - 1)];
 }
 
-template<class Type>
-inline Type& QueueArray<Type>::Head() const
+template<class Type, class Allocator>
+inline Type& QueueArray<Type, Allocator>::Head() const
 {
 	assert(m_size > 0);
 	Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 	return pTypeArray[m_headIndex];
 }
 
-template<class Type>
-inline void QueueArray<Type>::Test()
+template<class Type, class Allocator>
+inline void QueueArray<Type, Allocator>::Test()
 {
 	// Variables for testing
 	bool shouldQuit = false;
@@ -231,8 +236,8 @@ inline void QueueArray<Type>::Test()
 //--------------------------------------------------------------------------------------------------------------------
 // Delete pArray and set it to nullptr
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void QueueArray<Type>::Destroy()
+template<class Type, class Allocator>
+inline void QueueArray<Type, Allocator>::Destroy()
 {
 	// If the type of elements is not trivially destructible, call it's destructor
 	if constexpr (!std::is_trivially_destructible_v<Type>)
@@ -250,7 +255,8 @@ inline void QueueArray<Type>::Destroy()
 		}
 	}
 
-	delete[] m_pBuffer;
+	if (m_pBuffer)
+		std::allocator_traits<Allocator>::deallocate(m_allocator, reinterpret_cast<Type*>(m_pBuffer), m_capacity);
 	m_pBuffer = nullptr;
 }
 }
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+#include "Tests/StructureManager.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// Monotone priority queue, keys pushed are never smaller than the last key popped. That's all Dijkstra needs with
+// non-negative weights, and it lets the heap skip comparisons entirely:
+//  - Bucket i holds the keys whose highest bit differing from the last popped key is bit i - 1, bucket 0 the keys
+//    equal to it. Push() is one bit_width and an append.
+//  - Pop() takes bucket 0, or empties the first non empty bucket: its smallest key becomes the last popped key and
+//    every key of the bucket falls into a lower one. A key only ever moves down, at most once per bit.
+//  - Float keys are ordered by their bits, which for non negative floats is the same order as their values
+//  - Duplicates are fine, Dijkstra pushes a node again when its distance improves and skips the stale entries
+//--------------------------------------------------------------------------------------------------------------------
+template <class _KeyType, class _ValueType>
+class RadixHeap
+{
+	static_assert(std::is_unsigned_v<_KeyType> || std::is_floating_point_v<_KeyType>, "RadixHeap keys must be unsigned or floating point");
+
+public:
+	using KeyType = _KeyType;
+	using ValueType = _ValueType;
+
+private:
+	// Bits of the key, compared as an unsigned integer
+	using RadixKey = std::conditional_t<(sizeof(KeyType) > 4), uint64_t, uint32_t>;
+	static constexpr size_t kBucketCount = std::numeric_limits<RadixKey>::digits + 1;
+
+	struct Entry
+	{
+		RadixKey m_radixKey;
+		ValueType m_value;
+	};
+
+	std::vector<Entry> m_buckets[kBucketCount];
+	RadixKey m_lastRadixKey = 0;
+	size_t m_size = 0;
+
+public:
+	void Push(const KeyType& key, const ValueType& value);
+	std::pair<KeyType, ValueType> Pop();
+	void Clear();
+
+	bool Empty() const { return m_size == 0; }
+	size_t GetSize() const { return m_size; }
+	KeyType GetLastKey() const { return FromRadixKey(m_lastRadixKey); }
+
+	static bool UnitTest();
+
+private:
+	static RadixKey ToRadixKey(const KeyType& key);
+	static KeyType FromRadixKey(RadixKey radixKey);
+	size_t GetBucketIndex(RadixKey radixKey) const { return static_cast<size_t>(std::bit_width(radixKey ^ m_lastRadixKey)); }
+};
+
+template<class _KeyType, class _ValueType>
+inline typename RadixHeap<_KeyType, _ValueType>::RadixKey RadixHeap<_KeyType, _ValueType>::ToRadixKey(const KeyType& key)
+{
+	if constexpr (std::is_floating_point_v<KeyType>)
+	{
+		assert(key >= KeyType(0));
+		return std::bit_cast<RadixKey>(key + KeyType(0));		// + 0 turns -0 into 0
+	}
+	else
+	{
+		return static_cast<RadixKey>(key);
+	}
+}
+
+template<class _KeyType, class _ValueType>
+inline typename RadixHeap<_KeyType, _ValueType>::KeyType RadixHeap<_KeyType, _ValueType>::FromRadixKey(RadixKey radixKey)
+{
+	if constexpr (std::is_floating_point_v<KeyType>)
+		return std::bit_cast<KeyType>(radixKey);
+	else
+		return static_cast<KeyType>(radixKey);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Add a value, key can't be smaller than the last key popped
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _ValueType>
+inline void RadixHeap<_KeyType, _ValueType>::Push(const KeyType& key, const ValueType& value)
+{
+	const RadixKey kRadixKey = ToRadixKey(key);
+	assert(kRadixKey >= m_lastRadixKey);
+
+	m_buckets[GetBucketIndex(kRadixKey)].emplace_back(Entry{ kRadixKey, value });
+	++m_size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Remove a value with the smallest key, returns the key and the value
+// Time: O(log(key range)) amortized
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _ValueType>
+inline std::pair<_KeyType, _ValueType> RadixHeap<_KeyType, _ValueType>::Pop()
+{
+	assert(!Empty());
+
+	if (m_buckets[0].empty())
+	{
+		// First non empty bucket, its smallest key is the smallest of the heap
+		size_t bucketIndex = 1;
+		while (m_buckets[bucketIndex].empty())
+			++bucketIndex;
+
+		std::vector<Entry>& bucket = m_buckets[bucketIndex];
+		m_lastRadixKey = std::min_element(bucket.begin(), bucket.end(), [](const Entry& kLeft, const Entry& kRight)
+		{
+			return kLeft.m_radixKey < kRight.m_radixKey;
+		})->m_radixKey;
+
+		// Every key of the bucket now shares more high bits with the last key, spread them over the lower buckets
+		for (const Entry& kEntry : bucket)
+			m_buckets[GetBucketIndex(kEntry.m_radixKey)].emplace_back(kEntry);
+		bucket.clear();
+	}
+
+	const Entry kEntry = m_buckets[0].back();
+	m_buckets[0].pop_back();
+	--m_size;
+	return { FromRadixKey(kEntry.m_radixKey), kEntry.m_value };
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Remove every value and accept any key again, the buckets keep their memory
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _ValueType>
+inline void RadixHeap<_KeyType, _ValueType>::Clear()
+{
+	for (std::vector<Entry>& bucket : m_buckets)
+		bucket.clear();
+	m_lastRadixKey = 0;
+	m_size = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Automated test, interleaved pushes and pops must come out like from a sorted array
+//--------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _ValueType>
+inline bool RadixHeap<_KeyType, _ValueType>::UnitTest()
+{
+	//---------------------------------------------------------------
+	// Push and Pop
+	//---------------------------------------------------------------
+	RadixHeap testHeap;
+	for (size_t i = 0; i < kTestSize; ++i)
+		testHeap.Push(static_cast<KeyType>((i * 7) % kTestSize), static_cast<ValueType>((i * 7) % kTestSize));
+
+	if (testHeap.GetSize() != kTestSize)
+		RETURN_ERROR("RadixHeap::Push()");
+
+	for (size_t i = 0; i < kTestSize; ++i)
+	{
+		const auto [kKey, kValue] = testHeap.Pop();
+		if (kKey != static_cast<KeyType>(i) || kValue != static_cast<ValueType>(i) || testHeap.GetLastKey() != kKey)
+			RETURN_ERROR("RadixHeap::Pop()");
+	}
+
+	//---------------------------------------------------------------
+	// Monotone pushes interleaved with pops, like Dijkstra does
+	//---------------------------------------------------------------
+	testHeap.Clear();
+	std::vector<KeyType> expectedKeys;
+	uint32_t randomState = 1;
+	for (size_t round = 0; round < kTestSize * 40; ++round)
+	{
+		randomState = randomState * 1664525 + 1013904223;
+		if ((randomState >> 30) == 0 && !testHeap.Empty())
+		{
+			// The smallest key of the sorted array must come out
+			std::sort(expectedKeys.begin(), expectedKeys.end());
+			const auto [kKey, kValue] = testHeap.Pop();
+			if (kKey != expectedKeys.front() || kValue != static_cast<ValueType>(kKey))
+				RETURN_ERROR("RadixHeap::Pop() interleaved");
+			expectedKeys.erase(expectedKeys.begin());
+			continue;
+		}
+
+		const KeyType kKey = testHeap.GetLastKey() + static_cast<KeyType>((randomState >> 8) % 1000);
+		testHeap.Push(kKey, static_cast<ValueType>(kKey));
+		expectedKeys.emplace_back(kKey);
+	}
+
+	if (testHeap.GetSize() != expectedKeys.size())
+		RETURN_ERROR("RadixHeap::GetSize()");
+
+	//---------------------------------------------------------------
+	// Clear
+	//---------------------------------------------------------------
+	testHeap.Clear();
+	testHeap.Push(KeyType(0), ValueType());
+	if (testHeap.GetSize() != 1 || testHeap.Pop().first != KeyType(0) || !testHeap.Empty())
+		RETURN_ERROR("RadixHeap::Clear()");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+}
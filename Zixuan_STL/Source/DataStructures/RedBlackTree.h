@@ -1,13 +1,31 @@
 #pragma once
 #include "Tests/StructureManager.h"
+#include "allocator.h"
 
 #include <iostream>
+#include <algorithm>
 #include <assert.h>
+#include <bit>
+#include <iterator>
+#include <memory>
+#include <ranges>
 #include <string>
 #include <optional>
+#include <type_traits>
+#include <utility>
 
 namespace zxstl
 {
+// Size of the subtree rooted at a node, nodes carry it only when the tree keeps order statistics
+struct RedBlackTreeSubtreeSize
+{
+	size_t m_subtreeSize = 1;
+};
+
+struct RedBlackTreeNoSubtreeSize
+{
+};
+
 //---------------------------------------------------------------------------------------------------------------------
 // Red black tree implementation
 //  - Every node is either red or black.
@@ -15,14 +33,19 @@ namespace zxstl
 //  - Every leaf(nil) is black.
 //  - If the node is red, then both its children are black.
 //  - For each node, all simple paths from the node to descendant leaves contain the same number of black nodes.
+//
+// With _kOrderStatistics every node also counts the nodes of its subtree, which Rank() and Select() need to run in
+// O(logn). Insert, Delete and the rotations keep the counts up to date, costing one extra word per node.
 //---------------------------------------------------------------------------------------------------------------------
-template <class _KeyType, class _DataType>
+template <class _KeyType, class _DataType, class _Allocator = allocator<std::pair<const _KeyType, _DataType>>, bool _kOrderStatistics = false>
 class RedBlackTree
 {
 public:
-	using RBT = RedBlackTree<_KeyType, _DataType>;
+	using RBT = RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>;
 	using KeyType = _KeyType;
 	using DataType = _DataType;
+	using Allocator = _Allocator;
+	static constexpr bool kOrderStatistics = _kOrderStatistics;
 
 private:
 	enum class NodeColor : uint8_t
@@ -31,7 +54,7 @@ private:
 		kBlack,
 	};
 
-	struct Node
+	struct Node : public std::conditional_t<kOrderStatistics, RedBlackTreeSubtreeSize, RedBlackTreeNoSubtreeSize>
 	{
 		Node* m_pParent;
 		Node* m_pLeft;
@@ -40,6 +63,7 @@ private:
 		KeyType m_key;
 		DataType m_data;
 		NodeColor m_color;
+		bool m_isInBlock;		// Lives in a NodeBlock, the block frees the memory
 
 		Node(const KeyType& key, const DataType& data)
 			: m_pParent(nullptr)
@@ -48,16 +72,10 @@ private:
 			, m_key(key)
 			, m_data(data)
 			, m_color(NodeColor::kRed)
+			, m_isInBlock(false)
 		{
 		}
 
-		~Node()
-		{
-			delete m_pLeft;
-			delete m_pRight;
-			ClearPointers();
-		}
-
 		void ClearPointers()
 		{
 			m_pParent = nullptr;
@@ -86,16 +104,101 @@ private:
 		}
 	};
 
+	// Nodes made by BuildFromSorted() and InsertMany() in one allocation, freed together when the tree is destroyed
+	struct NodeBlock
+	{
+		NodeBlock* m_pNext;
+		Node* m_pNodes;
+		size_t m_count;
+	};
+
+	// What a node turns into once its key and data are destroyed and it's parked in the node pool
+	struct FreeNode
+	{
+		FreeNode* m_pNext;
+		bool m_isInBlock;		// A pooled block node goes back to its block, not to the allocator
+	};
+
+	using NodeAllocator = rebind_allocator_t<Allocator, Node>;
+	using BlockAllocator = rebind_allocator_t<Allocator, NodeBlock>;
+	using NodePointerAllocator = rebind_allocator_t<Allocator, Node*>;
+
 private:
 	Node* m_pRoot;
 	size_t m_size;
+	NodeAllocator m_nodeAllocator;	// Every node comes from here
+	NodeBlock* m_pBlocks;			// Blocks of bulk made nodes
+	BlockAllocator m_blockAllocator;
+	FreeNode* m_pFreeNodes;			// Node pool, deleted nodes wait here for the next insert instead of going back to the allocator
+	size_t m_freeNodeCount;
+
+public:
+	//-------------------------------------------------------------
+	// In order iterator, walks parent links so it needs no stack
+	//-------------------------------------------------------------
+	template<bool kIsConst>
+	class Iterator
+	{
+		friend class RedBlackTree;
+		template<bool> friend class Iterator;
+
+		using TreeType = std::conditional_t<kIsConst, const RedBlackTree, RedBlackTree>;
+		using DataReference = std::conditional_t<kIsConst, const DataType&, DataType&>;
+
+		Node* m_pNode;			// nullptr is end()
+		TreeType* m_pTree;		// Stepping back from end() starts at the largest node
+
+		Iterator(Node* pNode, TreeType* pTree) : m_pNode{ pNode }, m_pTree{ pTree } {}
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = std::pair<const KeyType, DataType>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::pair<const KeyType&, DataReference>;
+
+		struct pointer
+		{
+			reference m_reference;
+			reference* operator->() { return &m_reference; }
+		};
+
+		Iterator() : Iterator(nullptr, nullptr) {}
+
+		// iterator converts to const_iterator
+		operator Iterator<true>() const requires (!kIsConst) { return Iterator<true>(m_pNode, m_pTree); }
+
+		const KeyType& key() const { return m_pNode->m_key; }
+		DataReference data() const { return m_pNode->m_data; }
+		reference operator*() const { return reference(key(), data()); }
+		pointer operator->() const { return pointer{ **this }; }
+		bool operator==(const Iterator& other) const { return m_pNode == other.m_pNode; }
+
+		Iterator& operator++() { m_pNode = GetSuccessor(m_pNode); return *this; }
+		Iterator operator++(int) { Iterator old = *this; ++(*this); return old; }
+
+		Iterator& operator--()
+		{
+			if (m_pNode)
+				m_pNode = GetPredecessor(m_pNode);
+			else
+				m_pNode = m_pTree->InternalFindMax(m_pTree->m_pRoot);
+			return *this;
+		}
+		Iterator operator--(int) { Iterator old = *this; --(*this); return old; }
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
 
 public:
 	RedBlackTree();
+	explicit RedBlackTree(const Allocator& alloc);
 	~RedBlackTree();
 
 	// Modifiers
 	void Insert(const KeyType& key, const DataType& data);
+	template <class Range> void BuildFromSorted(Range&& sortedRange);
+	template <class Range> void InsertMany(Range&& range);
 	void Clear();
 	void Delete(const KeyType& key);
 
@@ -113,6 +216,15 @@ public:
 	template <class Func> void PostOrderWalkRecursive(Func&& func);
 	template <class Func> void InOrderWalkRecursive(Func&& func);
 	template <class Func> void InOrderWalkIterative(Func&& func);
+	template <class Func> void PreOrderWalkIterative(Func&& func);
+	template <class Func> void PostOrderWalkIterative(Func&& func);
+	template <class Func> void ForEachInRange(const KeyType& low, const KeyType& high, Func&& func);
+
+	// Iterators
+	iterator begin() { return iterator(m_pRoot ? InternalFindMin(m_pRoot) : nullptr, this); }
+	iterator end() { return iterator(nullptr, this); }
+	const_iterator begin() const { return const_iterator(m_pRoot ? InternalFindMin(m_pRoot) : nullptr, this); }
+	const_iterator end() const { return const_iterator(nullptr, this); }
 
 	// Print
 	void PrintNodesInOrder() const;
@@ -122,38 +234,81 @@ public:
 	std::optional<DataType> Search(const KeyType& key) const;
 	std::optional<DataType> operator[](const KeyType& key) { return Search(key); }
 	const std::optional<DataType> operator[](const KeyType& key) const { return Search(key); }
-	int GetHeight(Node* pNode) const;
+	size_t GetHeight() const;
 	size_t GetSize() const { return m_size; }
 	std::optional<DataType> GetRootData() const;
 
+	// Range queries
+	iterator LowerBound(const KeyType& key) { return iterator(InternalLowerBound(key), this); }
+	const_iterator LowerBound(const KeyType& key) const { return const_iterator(InternalLowerBound(key), this); }
+	iterator UpperBound(const KeyType& key) { return iterator(InternalUpperBound(key), this); }
+	const_iterator UpperBound(const KeyType& key) const { return const_iterator(InternalUpperBound(key), this); }
+
+	// Order statistics, only with _kOrderStatistics
+	size_t Rank(const KeyType& key) const requires (kOrderStatistics);
+	iterator Select(size_t index) requires (kOrderStatistics) { return iterator(InternalSelect(index), this); }
+	const_iterator Select(size_t index) const requires (kOrderStatistics) { return const_iterator(InternalSelect(index), this); }
+
+	// Node pool
+	void ReserveNodes(size_t count);
+	void ShrinkNodePool();
+	size_t GetPooledNodeCount() const { return m_freeNodeCount; }
+
 	// Test
 	static void Test();
+	static bool UnitTest();
 
 private:
 	// Modifier
+	void InsertNode(Node* pNewNode);
+	void UnlinkNode(Node* pNodeToUnlink);
 	void Destroy();
+	void DestroySubtree(Node* pNode);
 	void RedBlackTransplant(Node* pNodeToReplace, Node* pReplacingNode);
 
+	// Bulk
+	template <class Range> void CreateNodeBlock(Range&& range, size_t count, Node** ppNodes);
+	Node* LinkBalanced(Node** ppNodes, size_t count, size_t depth, size_t redDepth);
+	void FreeNodeBlocks();
+
+	// Node pool
+	Node* AcquireNode(const KeyType& key, const DataType& data);
+	void RecycleNode(Node* pNode);
+
 	// Max and minimum
-	Node* InteralFindMinRecur(Node* pParent) const;
-	Node* InternalFindMaxRecur(Node* pParent) const;
+	static Node* InternalFindMin(Node* pParent);
+	static Node* InternalFindMax(Node* pParent);
 
 	// Traversal
+	static Node* GetPreOrderSuccessor(Node* pNode, size_t& depth);
+	static Node* GetPostOrderFirst(Node* pNode);
+	static Node* GetPostOrderSuccessor(Node* pNode);
 	template <class Func> void RecursivePreOrderWalk(Node* pNode, Func&& func);
 	template <class Func> void RecursivePostOrderWalk(Node* pNode, Func&& func);
 	template <class Func> void RecursiveInOrderWalk(Node* pNode, Func&& func);
 
-	// Print
-	void RecursivePrintNodesInOrder(Node* pNode) const;
-
 	// Lookup
 	Node* InternalFindNode(const KeyType& key) const;
+	Node* InternalLowerBound(const KeyType& key) const;
+	Node* InternalUpperBound(const KeyType& key) const;
+	Node* InternalSelect(size_t index) const;
+	static Node* GetSuccessor(Node* pNode);
+	static Node* GetPredecessor(Node* pNode);
+
+	// Order statistics
+	static size_t GetSubtreeSize(const Node* pNode);
+	void UpdateSubtreeSize(Node* pNode);
+	void UpdateSubtreeSizesToRoot(Node* pNode);
+
+	// Test
+	bool ValidateTree() const;
+	size_t ValidateSubtree(const Node* pNode, bool& isValid) const;
 
 	//-------------------------------------------------------------
 	// red / black tre
 	//-------------------------------------------------------------
 	void FixupAfterInsert(Node* pNodeInserted);
-	void FixupAfterDelete(Node* pNodeFix);
+	void FixupAfterDelete(Node* pNodeFix, Node* pParent);
 
 	// Node rotation.  In this example, pNode == x.
 	// 
@@ -166,23 +321,43 @@ private:
 	NodeColor GetNodeColor(Node* pNode) const;
 };
 
-template<class _KeyType, class _DataType>
-inline RedBlackTree<_KeyType, _DataType>::RedBlackTree()
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RedBlackTree()
+	: RedBlackTree(Allocator())
+{
+}
+
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RedBlackTree(const Allocator& alloc)
 	: m_pRoot(nullptr)
 	, m_size{ 0 }
+	, m_nodeAllocator(alloc)
+	, m_pBlocks(nullptr)
+	, m_blockAllocator(alloc)
+	, m_pFreeNodes(nullptr)
+	, m_freeNodeCount{ 0 }
 {
 }
 
-template<class _KeyType, class _DataType>
-inline RedBlackTree<_KeyType, _DataType>::~RedBlackTree()
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::~RedBlackTree()
 {
 	Destroy();
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::Insert(const KeyType& key, const DataType& data)
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Insert(const KeyType& key, const DataType& data)
 {
-	Node* pNewNode = new Node(key, data);
+	InsertNode(AcquireNode(key, data));
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Link a constructed node into the tree and rebalance
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InsertNode(Node* pNewNode)
+{
+	const KeyType& key = pNewNode->m_key;
 
 	Node* pParent = nullptr;
 	Node* pCurrent = m_pRoot;
@@ -193,6 +368,10 @@ inline void RedBlackTree<_KeyType, _DataType>::Insert(const KeyType& key, const
 		// set the last node, aka the parent node
 		pParent = pCurrent;
 
+		// the new node ends up in this subtree
+		if constexpr (kOrderStatistics)
+			++pCurrent->m_subtreeSize;
+
 		// move to the next level
 		if (key < pCurrent->m_key)
 			pCurrent = pCurrent->m_pLeft;
@@ -225,44 +404,60 @@ inline void RedBlackTree<_KeyType, _DataType>::Insert(const KeyType& key, const
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Delete all nodes in the tree
+// Delete all nodes in the tree, they stay in the node pool for the next inserts
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::Clear()
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Clear()
 {
-	Destroy();
+	DestroySubtree(m_pRoot);
+	m_pRoot = nullptr;
+	m_size = 0;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 // Search and delete input key node
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::Delete(const KeyType& key)
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Delete(const KeyType& key)
 {
 	// Find node to delete, return if not exists
 	Node* pNodeToDelete = InternalFindNode(key);
 	if (!pNodeToDelete)
 		return;
 
-	//  sets y to point to node z when z has fewer than two children and is therefore removed.
-	Node* pSuccessor = pNodeToDelete;
+	UnlinkNode(pNodeToDelete);
+
+	// Destroy node
+	RecycleNode(pNodeToDelete);
+	pNodeToDelete = nullptr;
+}
 
-	// Because node ys color might change, the variable y-original-color stores ys color before any changes occur.
-	NodeColor successorOriginalColor = pSuccessor->m_color;
+//---------------------------------------------------------------------------------------------------------------------
+// Take a node out of the tree and rebalance, the node itself is left to the caller
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::UnlinkNode(Node* pNodeToDelete)
+{
+	// The color of the node which is removed from its spot, that's the successor when the node has two children
+	NodeColor removedColor = pNodeToDelete->m_color;
 
-	// Node to fix
+	// Node moving into the removed spot and its parent. The node is nullptr when a leaf is removed, so the parent is
+	// kept apart for the fixup.
 	Node* pNodeToFix = nullptr;
+	Node* pFixParent = nullptr;
 
 	// Case 1: Node has no left children. Shift right node up.
 	if (!pNodeToDelete->m_pLeft)
 	{
 		pNodeToFix = pNodeToDelete->m_pRight;
+		pFixParent = pNodeToDelete->m_pParent;
 		RedBlackTransplant(pNodeToDelete, pNodeToFix);
 	}
 	// Case 2: Node has no right children. Shift left node up.
 	else if (!pNodeToDelete->m_pRight)
 	{
 		pNodeToFix = pNodeToDelete->m_pLeft;
+		pFixParent = pNodeToDelete->m_pParent;
 		RedBlackTransplant(pNodeToDelete, pNodeToFix);
 	}
 	// Case 3: Both children are valid.
@@ -270,21 +465,21 @@ inline void RedBlackTree<_KeyType, _DataType>::Delete(const KeyType& key)
 	{
 		// The successor is guaranteed to be the node with the smallest value in our node's right branch.  
 		// We need to sugically remove the successor and replace our node with it.
-		pSuccessor = InteralFindMinRecur(pNodeToDelete->m_pRight);
+		Node* pSuccessor = InternalFindMin(pNodeToDelete->m_pRight);
 		assert(pSuccessor);
 
-		// Reset successor's color
-		successorOriginalColor = pSuccessor->m_color;
+		removedColor = pSuccessor->m_color;
 		pNodeToFix = pSuccessor->m_pRight;
 
-		// If the successor is not the direct child of the node we want to delete, 
+		// If the successor is the direct child of the node we want to delete, its right subtree stays where it is
 		if (pSuccessor->m_pParent == pNodeToDelete)
 		{
-			pNodeToFix->m_pParent = pSuccessor;
+			pFixParent = pSuccessor;
 		}
 		else
 		{
 			// Link right children
+			pFixParent = pSuccessor->m_pParent;
 			RedBlackTransplant(pSuccessor, pNodeToFix);
 			pSuccessor->m_pRight = pNodeToDelete->m_pRight;
 			pSuccessor->m_pRight->m_pParent = pSuccessor;
@@ -297,24 +492,25 @@ inline void RedBlackTree<_KeyType, _DataType>::Delete(const KeyType& key)
 		pSuccessor->m_color = pNodeToDelete->m_color;
 	}
 
+	// Every subtree which lost a node is on the way from the removed spot to the root
+	if constexpr (kOrderStatistics)
+		UpdateSubtreeSizesToRoot(pFixParent);
+
 	// Fix up after delete
-	if (successorOriginalColor == NodeColor::kBlack)
-		FixupAfterDelete(pNodeToFix);
+	if (removedColor == NodeColor::kBlack)
+		FixupAfterDelete(pNodeToFix, pFixParent);
 
-	// Destroy node
 	pNodeToDelete->ClearPointers();
-	delete pNodeToDelete;
-	pNodeToDelete = nullptr;
 
-	// Success deleted node
+	// Success unlinked node
 	--m_size;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 // Return minimum value in this tree
 //--------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::FindMinIter() const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::FindMinIter() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
@@ -331,8 +527,8 @@ inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::FindMinIter()
 //--------------------------------------------------------------------------------------------------------------------
 // Return maximum value in this tree
 //--------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::FindMaxIter() const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::FindMaxIter() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
@@ -346,64 +542,78 @@ inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::FindMaxIter()
 	return pCurrent->m_data;
 }
 
-template<class _KeyType, class _DataType>
-inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::FindMinRecur() const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::FindMinRecur() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
 		return {};
 
-	Node* pNode = InteralFindMinRecur(m_pRoot);
+	Node* pNode = InternalFindMin(m_pRoot);
 	return pNode->m_data;
 }
 
-template<class _KeyType, class _DataType>
-inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::FindMaxRecur() const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::FindMaxRecur() const
 {
 	// Return nothing if the tree is empty
 	if (!m_pRoot)
 		return {};
 
-	Node* pNode = InternalFindMaxRecur(m_pRoot);
+	Node* pNode = InternalFindMax(m_pRoot);
 	return pNode->m_data;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Allows you to change the key of a node. When a key is changed, it will need to be removed from the tree and reinserted.
+// Allows you to change the key of a node. The node keeps its data and its memory:
+//  - If the new key still falls between the keys of its neighbours, only the key is written
+//  - Otherwise the node is unlinked and linked again at the spot of its new key
+// Time: O(logn)
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::ChangeKey(const KeyType& keyToFind, const KeyType& keyToChange)
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::ChangeKey(const KeyType& keyToFind, const KeyType& keyToChange)
 {	
 	// Find node to change, return if not exists
 	Node* pNodeToChange = InternalFindNode(keyToFind);
 	if (!pNodeToChange)
 		return;
 
-	// Retrieve data
-	DataType data = pNodeToChange->m_data;
+	// Still in order, the tree doesn't change shape
+	const Node* pPredecessor = GetPredecessor(pNodeToChange);
+	const Node* pSuccessor = GetSuccessor(pNodeToChange);
+	if ((!pPredecessor || !(keyToChange < pPredecessor->m_key)) && (!pSuccessor || !(pSuccessor->m_key < keyToChange)))
+	{
+		pNodeToChange->m_key = keyToChange;
+		return;
+	}
 
 	// Remove it from the tree
-	Delete(keyToFind);
-
-	// Re insert it
-	Insert(keyToChange, data);
+	UnlinkNode(pNodeToChange);
+
+	// Reset it to a fresh red leaf and re insert it
+	pNodeToChange->m_key = keyToChange;
+	pNodeToChange->m_color = NodeColor::kRed;
+	if constexpr (kOrderStatistics)
+		pNodeToChange->m_subtreeSize = 1;
+	InsertNode(pNodeToChange);
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::PrintNodesInOrder() const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::PrintNodesInOrder() const
 {
-	RecursivePrintNodesInOrder(m_pRoot);
+	for (Node* pNode = m_pRoot ? InternalFindMin(m_pRoot) : nullptr; pNode; pNode = GetSuccessor(pNode))
+		std::cout << pNode->m_key << " => " << pNode->m_data << "\n";
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::PrintTree() const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::PrintTree() const
 {
 	if (m_pRoot)
 		m_pRoot->PrintNode(0);
 }
 
-template<class _KeyType, class _DataType>
-inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::Search(const KeyType& key) const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Search(const KeyType& key) const
 {
 	Node* pNode = InternalFindNode(key);
 	if (pNode)
@@ -413,35 +623,34 @@ inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::Search(const
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Recursively get tree height
+// Get tree height, the number of nodes on the longest path from the root. A pre-order walk keeps track of the depth,
+// so a tree made a list by sorted inserts doesn't overflow the stack.
+// Time: O(n)
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline int RedBlackTree<_KeyType, _DataType>::GetHeight(Node* pNode) const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline size_t RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetHeight() const
 {
-	// Empty tree
-	if (!m_pRoot)
-		return 0;
-
-	int leftSubTreeHeight = GetHeight(pNode->m_pLeft);
-	int rightSubTreeHeight = GetHeight(pNode->m_pRight);
+	size_t height = 0;
+	size_t depth = 1;
+	for (Node* pNode = m_pRoot; pNode; pNode = GetPreOrderSuccessor(pNode, depth))
+		height = std::max(height, depth);
 
-	// Return the greater subtree height
-	return leftSubTreeHeight > rightSubTreeHeight ? leftSubTreeHeight + 1 : rightSubTreeHeight + 1;
+	return height;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 // Return root's data if valid
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType>::GetRootData() const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline std::optional<_DataType> RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetRootData() const
 {
 	if (m_pRoot)
 		return m_pRoot->m_data;
 	return {};
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::Test()
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Test()
 {
 	// Variables for testing
 	bool shouldQuit = false;
@@ -489,7 +698,7 @@ inline void RedBlackTree<_KeyType, _DataType>::Test()
 
 
 		case '2':
-			rbt.PreOrderWalkRecursive([](const RBT::KeyType& key, const RBT::DataType& data)
+			rbt.PreOrderWalkIterative([](const RBT::KeyType& key, const RBT::DataType& data)
 			{
 				std::cout << key << " => " << data << "\n";
 			});
@@ -497,7 +706,7 @@ inline void RedBlackTree<_KeyType, _DataType>::Test()
 			break;
 
 		case '3':
-			rbt.PostOrderWalkRecursive([](const RBT::KeyType& key, const RBT::DataType& data)
+			rbt.PostOrderWalkIterative([](const RBT::KeyType& key, const RBT::DataType& data)
 			{
 				std::cout << key << " => " << data << "\n";
 			});
@@ -572,22 +781,579 @@ inline void RedBlackTree<_KeyType, _DataType>::Test()
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Destroy this tree by deleting root node
+// Automated test of the ordered queries and, if enabled, the order statistics
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::Destroy()
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline bool RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::UnitTest()
 {
-	delete m_pRoot;
-	m_pRoot = nullptr;
+	//---------------------------------------------------------------
+	// Insert in scrambled order, iterate both ways
+	//---------------------------------------------------------------
+	// kStride is coprime with kTestSize, so i * kStride % kTestSize visits every key once
+	static constexpr size_t kStride = 7;
+	static_assert(kTestSize % kStride != 0);
+
+	RBT testTree;
+	for (size_t i = 0; i < kTestSize; ++i)
+	{
+		const size_t key = i * kStride % kTestSize;
+		testTree.Insert(static_cast<KeyType>(key * 2), static_cast<DataType>(key));
+	}
 
-	m_size = 0;
+	if (testTree.GetSize() != kTestSize || !testTree.ValidateTree())
+		RETURN_ERROR("RedBlackTree::Insert()");
+
+	size_t expected = 0;
+	for (auto it = testTree.begin(); it != testTree.end(); ++it)
+	{
+		if (it.key() != static_cast<KeyType>(expected * 2) || it->second != static_cast<DataType>(expected))
+			RETURN_ERROR("RedBlackTree iteration");
+		++expected;
+	}
+
+	for (auto it = testTree.end(); it != testTree.begin();)
+	{
+		if ((*--it).first != static_cast<KeyType>(--expected * 2))
+			RETURN_ERROR("RedBlackTree reverse iteration");
+	}
+
+	//---------------------------------------------------------------
+	// LowerBound / UpperBound, keys are the even numbers
+	//---------------------------------------------------------------
+	const RBT& constTree = testTree;
+	if (constTree.LowerBound(static_cast<KeyType>(4)).key() != static_cast<KeyType>(4) ||
+		constTree.LowerBound(static_cast<KeyType>(5)).key() != static_cast<KeyType>(6) ||
+		constTree.UpperBound(static_cast<KeyType>(4)).key() != static_cast<KeyType>(6) ||
+		constTree.LowerBound(static_cast<KeyType>(kTestSize * 2)) != constTree.end() ||
+		constTree.UpperBound(static_cast<KeyType>(kTestSize * 2 - 2)) != constTree.end())
+	{
+		RETURN_ERROR("RedBlackTree::LowerBound() / UpperBound()");
+	}
+
+	testTree.LowerBound(static_cast<KeyType>(8)).data() = static_cast<DataType>(0);
+	if (testTree.Search(static_cast<KeyType>(8)) != static_cast<DataType>(0))
+		RETURN_ERROR("RedBlackTree writing through iterator");
+	testTree.LowerBound(static_cast<KeyType>(8)).data() = static_cast<DataType>(4);
+
+	//---------------------------------------------------------------
+	// ForEachInRange, both ends inclusive
+	//---------------------------------------------------------------
+	size_t visitedCount = 0;
+	expected = 5;
+	testTree.ForEachInRange(static_cast<KeyType>(9), static_cast<KeyType>(20), [&visitedCount, &expected](const KeyType& key, DataType&)
+	{
+		if (key == static_cast<KeyType>(expected * 2))
+			++visitedCount;
+		++expected;
+	});
+	if (visitedCount != 6 || expected != 11)
+		RETURN_ERROR("RedBlackTree::ForEachInRange()");
+
+	//---------------------------------------------------------------
+	// Delete every other key, the tree must stay balanced
+	//---------------------------------------------------------------
+	for (size_t i = 0; i < kTestSize; i += 2)
+	{
+		testTree.Delete(static_cast<KeyType>(i * 2));
+		if (!testTree.ValidateTree())
+			RETURN_ERROR("RedBlackTree::Delete()");
+	}
+
+	if (testTree.GetSize() != kTestSize / 2 || testTree.Search(static_cast<KeyType>(0)).has_value() || !testTree.Search(static_cast<KeyType>(2)).has_value())
+		RETURN_ERROR("RedBlackTree::Delete()");
+
+	//---------------------------------------------------------------
+	// Rank / Select
+	//---------------------------------------------------------------
+	if constexpr (kOrderStatistics)
+	{
+		// Keys left are 2, 6, 10 ...
+		for (size_t i = 0; i < testTree.GetSize(); ++i)
+		{
+			const KeyType key = static_cast<KeyType>(i * 4 + 2);
+			if (testTree.Rank(key) != i || testTree.Rank(static_cast<KeyType>(key + 1)) != i + 1 || testTree.Select(i).key() != key)
+				RETURN_ERROR("RedBlackTree::Rank() / Select()");
+		}
+
+		if (testTree.Select(testTree.GetSize()) != testTree.end())
+			RETURN_ERROR("RedBlackTree::Select() out of range");
+	}
+
+	testTree.Clear();
+	if (testTree.GetSize() != 0 || testTree.begin() != testTree.end())
+		RETURN_ERROR("RedBlackTree::Clear()");
+
+	//---------------------------------------------------------------
+	// BuildFromSorted, every size up to kTestSize must come out balanced and colored right
+	//---------------------------------------------------------------
+	std::pair<KeyType, DataType> pairs[kTestSize];
+	for (size_t i = 0; i < kTestSize; ++i)
+		pairs[i] = { static_cast<KeyType>(i * 2), static_cast<DataType>(i) };
+
+	for (size_t count = 0; count <= kTestSize; ++count)
+	{
+		testTree.BuildFromSorted(std::ranges::subrange(pairs, pairs + count));
+		if (testTree.GetSize() != count || !testTree.ValidateTree())
+			RETURN_ERROR("RedBlackTree::BuildFromSorted()");
+	}
+
+	// Nodes of a block can still be deleted one by one
+	for (size_t i = 0; i < kTestSize; i += 3)
+		testTree.Delete(static_cast<KeyType>(i * 2));
+	if (testTree.GetSize() != kTestSize - (kTestSize + 2) / 3 || !testTree.ValidateTree())
+		RETURN_ERROR("RedBlackTree::Delete() after BuildFromSorted()");
+
+	//---------------------------------------------------------------
+	// InsertMany, a batch large enough to rebuild and one small enough to insert one by one
+	//---------------------------------------------------------------
+	std::pair<KeyType, DataType> oddPairs[kTestSize];
+	for (size_t i = 0; i < kTestSize; ++i)
+	{
+		const size_t key = i * kStride % kTestSize;
+		oddPairs[i] = { static_cast<KeyType>(key * 2 + 1), static_cast<DataType>(key) };
+	}
+
+	// Half of the even keys, then a batch as large as the tree is merged in
+	static constexpr size_t kHalfSize = kTestSize / 2;
+	testTree.BuildFromSorted(std::ranges::subrange(pairs, pairs + kHalfSize));
+	testTree.InsertMany(std::ranges::subrange(oddPairs, oddPairs + kHalfSize));
+	if (testTree.GetSize() != kHalfSize * 2 || !testTree.ValidateTree())
+		RETURN_ERROR("RedBlackTree::InsertMany() rebuild");
+
+	// The rest are smaller than the tree and go in one by one
+	testTree.InsertMany(std::ranges::subrange(oddPairs + kHalfSize, oddPairs + kTestSize));
+	testTree.InsertMany(std::ranges::subrange(pairs + kHalfSize, pairs + kTestSize));
+	if (testTree.GetSize() != kTestSize * 2 || !testTree.ValidateTree())
+		RETURN_ERROR("RedBlackTree::InsertMany() one by one");
+
+	expected = 0;
+	for (auto it = testTree.begin(); it != testTree.end(); ++it)
+	{
+		if (it.key() != static_cast<KeyType>(expected++))
+			RETURN_ERROR("RedBlackTree::InsertMany() order");
+	}
+
+	//---------------------------------------------------------------
+	// Cleared and deleted nodes are pooled and reused by Insert
+	//---------------------------------------------------------------
+	testTree.Clear();
+	if (testTree.GetSize() != 0 || testTree.GetPooledNodeCount() != kTestSize * 2)
+		RETURN_ERROR("RedBlackTree::Clear() node pool");
+
+	// Keys are multiples of 4
+	for (size_t i = 0; i < kTestSize; ++i)
+		testTree.Insert(static_cast<KeyType>(i * 4), static_cast<DataType>(i));
+	if (testTree.GetPooledNodeCount() != kTestSize || !testTree.ValidateTree())
+		RETURN_ERROR("RedBlackTree::Insert() from node pool");
+
+	testTree.Delete(static_cast<KeyType>(4));
+	testTree.Insert(static_cast<KeyType>(4), static_cast<DataType>(1));
+	if (testTree.GetPooledNodeCount() != kTestSize || testTree.GetSize() != kTestSize)
+		RETURN_ERROR("RedBlackTree::Delete() into node pool");
+
+	testTree.ShrinkNodePool();
+	testTree.ReserveNodes(kTestSize);
+	if (testTree.GetPooledNodeCount() != kTestSize)
+		RETURN_ERROR("RedBlackTree::ShrinkNodePool() / ReserveNodes()");
+
+	//---------------------------------------------------------------
+	// ChangeKey, in place and relinked, the node and its data stay where they are
+	//---------------------------------------------------------------
+	const DataType* pData = &testTree.LowerBound(static_cast<KeyType>(8)).data();
+
+	// 9 still sorts between 4 and 12
+	testTree.ChangeKey(static_cast<KeyType>(8), static_cast<KeyType>(9));
+	if (&testTree.LowerBound(static_cast<KeyType>(9)).data() != pData || !testTree.ValidateTree())
+		RETURN_ERROR("RedBlackTree::ChangeKey() in place");
+
+	// Past every other key
+	testTree.ChangeKey(static_cast<KeyType>(9), static_cast<KeyType>(kTestSize * 4 + 1));
+	if (&(--testTree.end()).data() != pData || *pData != static_cast<DataType>(2) || !testTree.ValidateTree())
+		RETURN_ERROR("RedBlackTree::ChangeKey() relink");
+
+	// Before its predecessor
+	testTree.ChangeKey(static_cast<KeyType>(12), static_cast<KeyType>(1));
+	testTree.ChangeKey(static_cast<KeyType>(3), static_cast<KeyType>(5));
+	if (testTree.Search(static_cast<KeyType>(1)) != static_cast<DataType>(3) || testTree.Search(static_cast<KeyType>(12)).has_value() ||
+		testTree.Search(static_cast<KeyType>(5)).has_value() || !testTree.ValidateTree())
+	{
+		RETURN_ERROR("RedBlackTree::ChangeKey()");
+	}
+
+	if (testTree.GetSize() != kTestSize || testTree.GetPooledNodeCount() != kTestSize)
+		RETURN_ERROR("RedBlackTree::ChangeKey() allocated");
+
+	//---------------------------------------------------------------
+	// Pre / post order walks and height, the middle of each range is the root of its subtree: 6 (2 (0, 4), 10 (8, 12))
+	//---------------------------------------------------------------
+	static constexpr size_t kPreOrder[] = { 3, 1, 0, 2, 5, 4, 6 };
+	static constexpr size_t kPostOrder[] = { 0, 2, 1, 4, 6, 5, 3 };
+	testTree.BuildFromSorted(std::ranges::subrange(pairs, pairs + std::size(kPreOrder)));
+
+	size_t index = 0;
+	bool isWalkInOrder = true;
+	testTree.PreOrderWalkIterative([&index, &isWalkInOrder](const KeyType& key, DataType&)
+	{
+		isWalkInOrder = isWalkInOrder && key == static_cast<KeyType>(kPreOrder[index++] * 2);
+	});
+	if (!isWalkInOrder || index != std::size(kPreOrder))
+		RETURN_ERROR("RedBlackTree::PreOrderWalkIterative()");
+
+	index = 0;
+	testTree.PostOrderWalkIterative([&index, &isWalkInOrder](const KeyType& key, DataType&)
+	{
+		isWalkInOrder = isWalkInOrder && key == static_cast<KeyType>(kPostOrder[index++] * 2);
+	});
+	if (!isWalkInOrder || index != std::size(kPostOrder))
+		RETURN_ERROR("RedBlackTree::PostOrderWalkIterative()");
+
+	if (testTree.GetHeight() != 3)
+		RETURN_ERROR("RedBlackTree::GetHeight()");
+
+	// Sorted inserts stay within twice the height of a perfect tree
+	testTree.Clear();
+	for (size_t i = 0; i < kTestSize; ++i)
+		testTree.Insert(static_cast<KeyType>(i), static_cast<DataType>(i));
+
+	const size_t height = testTree.GetHeight();
+	if (height < static_cast<size_t>(std::bit_width(kTestSize)) || height > static_cast<size_t>(std::bit_width(kTestSize + 1)) * 2)
+		RETURN_ERROR("RedBlackTree::GetHeight() after sorted inserts");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Check the red black properties, the parent links and, if kept, the subtree sizes
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline bool RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::ValidateTree() const
+{
+	if (GetNodeColor(m_pRoot) != NodeColor::kBlack || (m_pRoot && m_pRoot->m_pParent))
+		return false;
+
+	bool isValid = true;
+	ValidateSubtree(m_pRoot, isValid);
+
+	// Count the nodes through the iterators, which also checks the order
+	size_t count = 0;
+	for (auto it = begin(); it != end(); ++it)
+	{
+		auto next = it;
+		if (++next != end() && next.key() < it.key())
+			return false;
+		++count;
+	}
+
+	return isValid && count == m_size;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the black height of pNode, clear isValid on any broken property below it
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline size_t RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::ValidateSubtree(const Node* pNode, bool& isValid) const
+{
+	if (!pNode)
+		return 1;
+
+	for (const Node* pChild : { pNode->m_pLeft, pNode->m_pRight })
+	{
+		if (pChild && pChild->m_pParent != pNode)
+			isValid = false;
+		if (pNode->m_color == NodeColor::kRed && GetNodeColor(const_cast<Node*>(pChild)) == NodeColor::kRed)
+			isValid = false;
+	}
+
+	if constexpr (kOrderStatistics)
+	{
+		if (pNode->m_subtreeSize != GetSubtreeSize(pNode->m_pLeft) + GetSubtreeSize(pNode->m_pRight) + 1)
+			isValid = false;
+	}
+
+	const size_t leftBlackHeight = ValidateSubtree(pNode->m_pLeft, isValid);
+	const size_t rightBlackHeight = ValidateSubtree(pNode->m_pRight, isValid);
+	if (leftBlackHeight != rightBlackHeight)
+		isValid = false;
+
+	return leftBlackHeight + (pNode->m_color == NodeColor::kBlack ? 1 : 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Destroy this tree by deleting root node, every node goes back to the allocator including the pooled ones
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Destroy()
+{
+	Clear();
+
+	// Pooled block nodes are left after shrinking, they go away with their blocks
+	ShrinkNodePool();
+	m_pFreeNodes = nullptr;
+	m_freeNodeCount = 0;
+	FreeNodeBlocks();
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Park every node under pNode in the node pool, children first
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::DestroySubtree(Node* pNode)
+{
+	if (!pNode)
+		return;
+
+	// Post-order, each node goes after its children and the walk never comes back to it
+	Node* pCurrent = GetPostOrderFirst(pNode);
+	while (pCurrent != pNode)
+	{
+		Node* pNext = GetPostOrderSuccessor(pCurrent);
+		RecycleNode(pCurrent);
+		pCurrent = pNext;
+	}
+	RecycleNode(pNode);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Replace the content of the tree with sortedRange, whose elements are (key, data) pairs sorted by key.
+// Every node comes from one allocation and is linked straight into place, no descent, no rotation:
+//  - The middle element of each range becomes the root of its subtree, so the levels above the last are full
+//  - Nodes on the last level are red when it is not full, every other node is black, so each path has the same
+//    number of black nodes and no red node has a red child
+// Time: O(n)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+template <class Range>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::BuildFromSorted(Range&& sortedRange)
+{
+	Destroy();
+
+	const size_t count = static_cast<size_t>(std::ranges::distance(sortedRange));
+	if (count == 0)
+		return;
+
+	NodePointerAllocator pointerAllocator(m_nodeAllocator);
+	Node** ppNodes = std::to_address(std::allocator_traits<NodePointerAllocator>::allocate(pointerAllocator, count));
+
+	CreateNodeBlock(sortedRange, count, ppNodes);
+	assert(std::is_sorted(ppNodes, ppNodes + count, [](const Node* pLeft, const Node* pRight) { return pLeft->m_key < pRight->m_key; }));
+
+	m_pRoot = LinkBalanced(ppNodes, count, 0, std::bit_width(count + 1) - 1);
+	m_pRoot->m_pParent = nullptr;
+	m_size = count;
+
+	std::allocator_traits<NodePointerAllocator>::deallocate(pointerAllocator, ppNodes, count);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Insert every (key, data) pair of range. The batch is sorted first, then
+//  - a batch at least as large as the tree is merged with the nodes of the tree in order and the result is
+//    relinked like BuildFromSorted(), the old nodes are reused as they are
+//  - a small batch is inserted one by one, in key order the descents share their upper levels in cache
+// Equal keys are kept, the batch ones after those already in the tree, the same as Insert() does.
+// Time: O(m * logm + n + m) when rebuilding, O(m * logm + m * log(n + m)) otherwise
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+template <class Range>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InsertMany(Range&& range)
+{
+	const size_t count = static_cast<size_t>(std::ranges::distance(range));
+	if (count == 0)
+		return;
+
+	// Sorted inserts share their descents so well that on 1M uint32_t keys they still matched a rebuild with a batch
+	// of half the tree, only rebuild when the batch is at least as large as the tree
+	const bool shouldRebuild = count >= m_size;
+	const size_t totalCount = m_size + count;
+
+	// Batch first, then the nodes of the tree and the merged order when rebuilding
+	NodePointerAllocator pointerAllocator(m_nodeAllocator);
+	const size_t pointerCount = shouldRebuild ? count + totalCount * 2 : count;
+	Node** ppNewNodes = std::to_address(std::allocator_traits<NodePointerAllocator>::allocate(pointerAllocator, pointerCount));
+
+	CreateNodeBlock(range, count, ppNewNodes);
+	std::stable_sort(ppNewNodes, ppNewNodes + count, [](const Node* pLeft, const Node* pRight) { return pLeft->m_key < pRight->m_key; });
+
+	if (shouldRebuild)
+	{
+		Node** ppOldNodes = ppNewNodes + count;
+		Node** ppMergedNodes = ppOldNodes + m_size;
+
+		size_t oldCount = 0;
+		for (Node* pNode = m_pRoot ? InternalFindMin(m_pRoot) : nullptr; pNode; pNode = GetSuccessor(pNode))
+			ppOldNodes[oldCount++] = pNode;
+		assert(oldCount == m_size);
+
+		// std::merge takes from the first range on ties, which puts the new nodes after equal old ones
+		std::merge(ppOldNodes, ppOldNodes + oldCount, ppNewNodes, ppNewNodes + count, ppMergedNodes,
+			[](const Node* pLeft, const Node* pRight) { return pLeft->m_key < pRight->m_key; });
+
+		m_pRoot = LinkBalanced(ppMergedNodes, totalCount, 0, std::bit_width(totalCount + 1) - 1);
+		m_pRoot->m_pParent = nullptr;
+		m_size = totalCount;
+	}
+	else
+	{
+		for (size_t i = 0; i < count; ++i)
+			InsertNode(ppNewNodes[i]);
+	}
+
+	std::allocator_traits<NodePointerAllocator>::deallocate(pointerAllocator, ppNewNodes, pointerCount);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Construct a node for each (key, data) pair of range in one new block, write their addresses to ppNodes
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+template <class Range>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::CreateNodeBlock(Range&& range, size_t count, Node** ppNodes)
+{
+	NodeBlock* pBlock = NewObject(m_blockAllocator);
+	pBlock->m_pNodes = std::to_address(std::allocator_traits<NodeAllocator>::allocate(m_nodeAllocator, count));
+	pBlock->m_count = count;
+	pBlock->m_pNext = m_pBlocks;
+	m_pBlocks = pBlock;
+
+	size_t index = 0;
+	for (auto&& element : range)
+	{
+		assert(index < count);
+		Node* pNode = new(pBlock->m_pNodes + index) Node(element.first, element.second);
+		pNode->m_isInBlock = true;
+		ppNodes[index++] = pNode;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Link the sorted nodes into a balanced subtree and return its root, the parent of the root is left to the caller.
+// Nodes at redDepth, which is only the last level when it isn't full, are red and all the others are black.
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::LinkBalanced(Node** ppNodes, size_t count, size_t depth, size_t redDepth)
+{
+	if (count == 0)
+		return nullptr;
+
+	const size_t middle = count / 2;
+	Node* pNode = ppNodes[middle];
+
+	pNode->m_pLeft = LinkBalanced(ppNodes, middle, depth + 1, redDepth);
+	pNode->m_pRight = LinkBalanced(ppNodes + middle + 1, count - middle - 1, depth + 1, redDepth);
+	if (pNode->m_pLeft)
+		pNode->m_pLeft->m_pParent = pNode;
+	if (pNode->m_pRight)
+		pNode->m_pRight->m_pParent = pNode;
+
+	pNode->m_color = (depth == redDepth) ? NodeColor::kRed : NodeColor::kBlack;
+	if constexpr (kOrderStatistics)
+		pNode->m_subtreeSize = count;
+
+	return pNode;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Free the memory of every node block, their nodes must have been destroyed and taken out of the pool already
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::FreeNodeBlocks()
+{
+	while (m_pBlocks)
+	{
+		NodeBlock* pBlock = m_pBlocks;
+		m_pBlocks = pBlock->m_pNext;
+
+		std::allocator_traits<NodeAllocator>::deallocate(m_nodeAllocator, pBlock->m_pNodes, pBlock->m_count);
+		DeleteObject(m_blockAllocator, pBlock);
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Fill the node pool up to count nodes, so the next count inserts don't touch the allocator
+// Time: O(n), n = count
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::ReserveNodes(size_t count)
+{
+	while (m_freeNodeCount < count)
+	{
+		Node* pNode = std::to_address(std::allocator_traits<NodeAllocator>::allocate(m_nodeAllocator, 1));
+		m_pFreeNodes = new(static_cast<void*>(pNode)) FreeNode{ m_pFreeNodes, false };
+		++m_freeNodeCount;
+	}
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Give every pooled node back to the allocator. Nodes of a block can't go back one by one, they stay pooled until
+// the tree is destroyed or rebuilt by BuildFromSorted().
+// Time: O(n), n = pooled nodes
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::ShrinkNodePool()
+{
+	FreeNode* pBlockNodes = nullptr;
+	size_t blockNodeCount = 0;
+
+	while (m_pFreeNodes)
+	{
+		FreeNode* pFreeNode = m_pFreeNodes;
+		m_pFreeNodes = pFreeNode->m_pNext;
+
+		if (pFreeNode->m_isInBlock)
+		{
+			pFreeNode->m_pNext = pBlockNodes;
+			pBlockNodes = pFreeNode;
+			++blockNodeCount;
+		}
+		else
+		{
+			std::allocator_traits<NodeAllocator>::deallocate(m_nodeAllocator, reinterpret_cast<Node*>(pFreeNode), 1);
+		}
+	}
+
+	m_pFreeNodes = pBlockNodes;
+	m_freeNodeCount = blockNodeCount;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Take a node from the pool, or from the allocator if the pool is empty
+// Time: O(1)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::AcquireNode(const KeyType& key, const DataType& data)
+{
+	if (!m_pFreeNodes)
+		return NewObject(m_nodeAllocator, key, data);
+
+	FreeNode* pFreeNode = m_pFreeNodes;
+	const bool isInBlock = pFreeNode->m_isInBlock;
+	m_pFreeNodes = pFreeNode->m_pNext;
+	--m_freeNodeCount;
+
+	Node* pNode = new(static_cast<void*>(pFreeNode)) Node(key, data);
+	pNode->m_isInBlock = isInBlock;
+	return pNode;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Destroy the node's key and data and park the node in the pool
+// Time: O(1)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RecycleNode(Node* pNode)
+{
+	const bool isInBlock = pNode->m_isInBlock;
+	std::destroy_at(pNode);
+	m_pFreeNodes = new(static_cast<void*>(pNode)) FreeNode{ m_pFreeNodes, isInBlock };
+	++m_freeNodeCount;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
 // Transplants one subtree with another.
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::RedBlackTransplant(Node* pNodeToReplace, Node* pReplacingNode)
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RedBlackTransplant(Node* pNodeToReplace, Node* pReplacingNode)
 {
 	// Check to see if we're replacing the root node
 	// If so, set root node as pReplacing node
@@ -605,47 +1371,87 @@ inline void RedBlackTree<_KeyType, _DataType>::RedBlackTransplant(Node* pNodeToR
 	else if (pNodeToReplace == pNodeToReplace->m_pParent->m_pRight)
 		pNodeToReplace->m_pParent->m_pRight = pReplacingNode;
 
-	// Update the parent of the replacing node
-	pReplacingNode->m_pParent = pNodeToReplace->m_pParent;
+	// Update the parent of the replacing node, which is nullptr when a leaf is removed
+	if (pReplacingNode)
+		pReplacingNode->m_pParent = pNodeToReplace->m_pParent;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Return the smallest starting the input parent node Recursively
+// Return the smallest node under the input parent node
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline typename RedBlackTree<_KeyType, _DataType>::Node* RedBlackTree<_KeyType, _DataType>::InteralFindMinRecur(Node* pParent) const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InternalFindMin(Node* pParent)
 {
-	if (pParent->m_pLeft)
-		return InteralFindMinRecur(pParent->m_pLeft);
+	while (pParent->m_pLeft)
+		pParent = pParent->m_pLeft;
 
 	return pParent;
 }
 
 //---------------------------------------------------------------------------------------------------------------------
-// Return the largest starting the input parent node in the tree Recursively
+// Return the largest node under the input parent node
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
-inline typename RedBlackTree<_KeyType, _DataType>::Node* RedBlackTree<_KeyType, _DataType>::InternalFindMaxRecur(Node* pParent) const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InternalFindMax(Node* pParent)
 {
-	if (pParent->m_pRight)
-		return InternalFindMaxRecur(pParent->m_pRight);
+	while (pParent->m_pRight)
+		pParent = pParent->m_pRight;
 
 	return pParent;
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::RecursivePrintNodesInOrder(Node* pNode) const
+//---------------------------------------------------------------------------------------------------------------------
+// Return the node after pNode in pre-order, nullptr after the last one. depth is the depth of pNode on the way in and
+// of the returned node on the way out.
+// Goes down to the left child or else the right one, otherwise climbs until it comes up from a left child whose
+// parent has a right child. Every edge is taken twice over a whole walk, so the walk is O(n) with no stack.
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetPreOrderSuccessor(Node* pNode, size_t& depth)
 {
-	if (pNode)
+	if (pNode->m_pLeft || pNode->m_pRight)
 	{
-		RecursivePrintNodesInOrder(pNode->m_pLeft);
-		std::cout << pNode->m_key << " => " << pNode->m_data << "\n";
-		RecursivePrintNodesInOrder(pNode->m_pRight);
+		++depth;
+		return pNode->m_pLeft ? pNode->m_pLeft : pNode->m_pRight;
 	}
+
+	for (Node* pParent = pNode->m_pParent; pParent; pNode = pParent, pParent = pParent->m_pParent)
+	{
+		if (pNode == pParent->m_pLeft && pParent->m_pRight)
+			return pParent->m_pRight;
+		--depth;
+	}
+
+	return nullptr;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the first node of the subtree in post-order, the leaf reached by going left whenever possible
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetPostOrderFirst(Node* pNode)
+{
+	while (pNode->m_pLeft || pNode->m_pRight)
+		pNode = pNode->m_pLeft ? pNode->m_pLeft : pNode->m_pRight;
+
+	return pNode;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the node after pNode in post-order, only pNode's parent is read so pNode may be freed right after
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetPostOrderSuccessor(Node* pNode)
+{
+	Node* pParent = pNode->m_pParent;
+	if (pParent && pNode == pParent->m_pLeft && pParent->m_pRight)
+		return GetPostOrderFirst(pParent->m_pRight);
+
+	return pParent;
 }
 
-template<class _KeyType, class _DataType>
-inline typename RedBlackTree<_KeyType, _DataType>::Node* RedBlackTree<_KeyType, _DataType>::InternalFindNode(const KeyType& key) const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InternalFindNode(const KeyType& key) const
 {
 	Node* pCurrent = m_pRoot;
 	while (pCurrent)
@@ -664,8 +1470,199 @@ inline typename RedBlackTree<_KeyType, _DataType>::Node* RedBlackTree<_KeyType,
 	return nullptr;
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::FixupAfterInsert(Node* pNodeInserted)
+//---------------------------------------------------------------------------------------------------------------------
+// Return the node with the smallest key which is not less than key, nullptr if every key is less
+// Time: O(logn)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InternalLowerBound(const KeyType& key) const
+{
+	Node* pResult = nullptr;
+	Node* pCurrent = m_pRoot;
+	while (pCurrent)
+	{
+		// Candidate, but something smaller may still qualify on the left
+		if (!(pCurrent->m_key < key))
+		{
+			pResult = pCurrent;
+			pCurrent = pCurrent->m_pLeft;
+		}
+		else
+		{
+			pCurrent = pCurrent->m_pRight;
+		}
+	}
+
+	return pResult;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the node with the smallest key which is greater than key, nullptr if no key is greater
+// Time: O(logn)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InternalUpperBound(const KeyType& key) const
+{
+	Node* pResult = nullptr;
+	Node* pCurrent = m_pRoot;
+	while (pCurrent)
+	{
+		if (key < pCurrent->m_key)
+		{
+			pResult = pCurrent;
+			pCurrent = pCurrent->m_pLeft;
+		}
+		else
+		{
+			pCurrent = pCurrent->m_pRight;
+		}
+	}
+
+	return pResult;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the node with the index-th smallest key, nullptr if index is out of range
+// Time: O(logn)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InternalSelect(size_t index) const
+{
+	static_assert(kOrderStatistics, "Select() needs the subtree sizes");
+
+	Node* pCurrent = m_pRoot;
+	while (pCurrent)
+	{
+		const size_t leftSize = GetSubtreeSize(pCurrent->m_pLeft);
+		if (index < leftSize)
+		{
+			pCurrent = pCurrent->m_pLeft;
+		}
+		else if (index == leftSize)
+		{
+			return pCurrent;
+		}
+		else
+		{
+			// Skip the left subtree and this node
+			index -= leftSize + 1;
+			pCurrent = pCurrent->m_pRight;
+		}
+	}
+
+	return nullptr;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the next node in key order, nullptr after the largest
+// Time: O(logn), amortized O(1) over a full walk
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetSuccessor(Node* pNode)
+{
+	// Smallest node of the right subtree
+	if (pNode->m_pRight)
+	{
+		pNode = pNode->m_pRight;
+		while (pNode->m_pLeft)
+			pNode = pNode->m_pLeft;
+		return pNode;
+	}
+
+	// Otherwise the first ancestor we reach from its left side
+	Node* pParent = pNode->m_pParent;
+	while (pParent && pNode == pParent->m_pRight)
+	{
+		pNode = pParent;
+		pParent = pParent->m_pParent;
+	}
+	return pParent;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return the previous node in key order, nullptr before the smallest
+// Time: O(logn), amortized O(1) over a full walk
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Node* RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetPredecessor(Node* pNode)
+{
+	// Largest node of the left subtree
+	if (pNode->m_pLeft)
+	{
+		pNode = pNode->m_pLeft;
+		while (pNode->m_pRight)
+			pNode = pNode->m_pRight;
+		return pNode;
+	}
+
+	// Otherwise the first ancestor we reach from its right side
+	Node* pParent = pNode->m_pParent;
+	while (pParent && pNode == pParent->m_pLeft)
+	{
+		pNode = pParent;
+		pParent = pParent->m_pParent;
+	}
+	return pParent;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Return how many keys are less than key, which is the index LowerBound(key) would have
+// Time: O(logn)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline size_t RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::Rank(const KeyType& key) const requires (kOrderStatistics)
+{
+	size_t rank = 0;
+	Node* pCurrent = m_pRoot;
+	while (pCurrent)
+	{
+		// This node and its whole left subtree are less than key
+		if (pCurrent->m_key < key)
+		{
+			rank += GetSubtreeSize(pCurrent->m_pLeft) + 1;
+			pCurrent = pCurrent->m_pRight;
+		}
+		else
+		{
+			pCurrent = pCurrent->m_pLeft;
+		}
+	}
+
+	return rank;
+}
+
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline size_t RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetSubtreeSize(const Node* pNode)
+{
+	if constexpr (kOrderStatistics)
+		return pNode ? pNode->m_subtreeSize : 0;
+	else
+		return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Recount pNode's subtree from its children, which must be up to date
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::UpdateSubtreeSize(Node* pNode)
+{
+	if constexpr (kOrderStatistics)
+		pNode->m_subtreeSize = GetSubtreeSize(pNode->m_pLeft) + GetSubtreeSize(pNode->m_pRight) + 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Recount every subtree from pNode up to the root, after a node below pNode was removed
+// Time: O(logn)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::UpdateSubtreeSizesToRoot(Node* pNode)
+{
+	for (; pNode; pNode = pNode->m_pParent)
+		UpdateSubtreeSize(pNode);
+}
+
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::FixupAfterInsert(Node* pNodeInserted)
 {
 	// pNodeInserted is z in the algorithm
 	// pUncle is y in the algorithm
@@ -761,8 +1758,8 @@ inline void RedBlackTree<_KeyType, _DataType>::FixupAfterInsert(Node* pNodeInser
 //     15
 //      \
 //       17
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::RotateLeft(Node* pNode)
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RotateLeft(Node* pNode)
 {
 	assert(pNode);
 	assert(pNode->m_pRight);
@@ -792,10 +1789,16 @@ pNode->m_pParent->m_pRight = pOther;
 // put our node on the other's left node
 pOther->m_pLeft = pNode;
 pNode->m_pParent = pOther;
+	// the other node takes over the whole subtree, our node lost the other node and its right subtree
+	if constexpr (kOrderStatistics)
+	{
+		pOther->m_subtreeSize = pNode->m_subtreeSize;
+		UpdateSubtreeSize(pNode);
+	}
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::RotateRight(Node* pNode)
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RotateRight(Node* pNode)
 {
 	// these nodes must be valid
 	assert(pNode);
@@ -822,154 +1825,166 @@ inline void RedBlackTree<_KeyType, _DataType>::RotateRight(Node* pNode)
 	// put our node on the other's right node
 	pOther->m_pRight = pNode;
 	pNode->m_pParent = pOther;
+	// the other node takes over the whole subtree, our node lost the other node and its left subtree
+	if constexpr (kOrderStatistics)
+	{
+		pOther->m_subtreeSize = pNode->m_subtreeSize;
+		UpdateSubtreeSize(pNode);
+	}
 }
 
-template<class _KeyType, class _DataType>
-inline typename RedBlackTree<_KeyType, _DataType>::NodeColor RedBlackTree<_KeyType, _DataType>::GetNodeColor(Node* pNode) const
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline typename RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::NodeColor RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::GetNodeColor(Node* pNode) const
 {
 	if (pNode)
 		return pNode->m_color;
 	return NodeColor::kBlack;
 }
 
-template<class _KeyType, class _DataType>
-inline void RedBlackTree<_KeyType, _DataType>::FixupAfterDelete(Node* pNodeToFix)
+//---------------------------------------------------------------------------------------------------------------------
+// Restore the red black properties after a black node was removed. pNodeToFix carries an extra black and may be nil,
+// which is why its parent is passed along.
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::FixupAfterDelete(Node* pNodeToFix, Node* pParent)
 {
 	// pNodeToFix is x in the book
 
-	if (!pNodeToFix)
-		return;
-
-	while (pNodeToFix != m_pRoot && GetNodeColor(pNodeToFix->m_pParent) == NodeColor::kBlack)
+	while (pNodeToFix != m_pRoot && GetNodeColor(pNodeToFix) == NodeColor::kBlack)
 	{
 		// If fixing node is a left child
-		if (pNodeToFix == pNodeToFix->m_pParent->m_pLeft)
+		if (pNodeToFix == pParent->m_pLeft)
 		{
-			// Get sibling
-			Node* pSibling = pNodeToFix->m_pParent->m_pRight;
+			// Get sibling, it exists because its side of the tree has at least one more black node than ours
+			Node* pSibling = pParent->m_pRight;
 			assert(pSibling);
 
 			// Case 1: Sibling is red
 			if (pSibling->m_color == NodeColor::kRed)
 			{
 				pSibling->m_color = NodeColor::kBlack;
-				pNodeToFix->m_pParent->m_color = NodeColor::kRed;
-				RotateLeft(pNodeToFix->m_pParent);
-				pSibling = pNodeToFix->m_pParent->m_pRight;
+				pParent->m_color = NodeColor::kRed;
+				RotateLeft(pParent);
+				pSibling = pParent->m_pRight;
 			}
 
-			if (pSibling) // I don't know if brother is guaranteed to exist
+			// Case 2: sibling is black, and both of sibling's children are black
+			if (GetNodeColor(pSibling->m_pLeft) == NodeColor::kBlack && GetNodeColor(pSibling->m_pRight) == NodeColor::kBlack)
+			{
+				pSibling->m_color = NodeColor::kRed;
+				pNodeToFix = pParent;
+				pParent = pNodeToFix->m_pParent;
+			}
+			else
 			{
-				// Case 2: sibling is black, and both of siblings children are black
-				if ((pSibling->m_color == NodeColor::kBlack) &&
-					(pSibling->m_pLeft->m_color == NodeColor::kBlack) &&
-					(pSibling->m_pRight->m_color == NodeColor::kBlack))
+				// Case 3: sibling is black, sibling's left child is red, and sibling's right child is black
+				if (GetNodeColor(pSibling->m_pRight) == NodeColor::kBlack)
 				{
+					pSibling->m_pLeft->m_color = NodeColor::kBlack;
 					pSibling->m_color = NodeColor::kRed;
-					pNodeToFix = pNodeToFix->m_pParent;
-				}
-				else
-				{
-					// Case 3: sibling is black, siblings left child is red, and siblings right child is black
-					if (pSibling->m_pRight->m_color == NodeColor::kBlack)
-					{
-						if (pSibling->m_pLeft)
-							pSibling->m_pLeft->m_color = NodeColor::kBlack;
-
-						pSibling->m_color = NodeColor::kRed;
-						RotateRight(pSibling);
-						pSibling = pNodeToFix->m_pParent->m_pRight;
-					}
-
-					// Case 4: sibling is black, and siblings right child is red
-					pSibling->m_color = pNodeToFix->m_pParent->m_color;
-					pNodeToFix->m_pParent->m_color = NodeColor::kBlack;
-					pSibling->m_pRight->m_color = NodeColor::kBlack;
-					RotateLeft(pNodeToFix->m_pParent);
-					pNodeToFix = m_pRoot;
+					RotateRight(pSibling);
+					pSibling = pParent->m_pRight;
 				}
+
+				// Case 4: sibling is black, and sibling's right child is red
+				pSibling->m_color = pParent->m_color;
+				pParent->m_color = NodeColor::kBlack;
+				pSibling->m_pRight->m_color = NodeColor::kBlack;
+				RotateLeft(pParent);
+				pNodeToFix = m_pRoot;
 			}
 		}
 
-		// Fixing node is a right child
+		// Fixing node is a right child, mirror of the above
 		else
 		{
-			// If fixing node is a right child
-			if (pNodeToFix == pNodeToFix->m_pParent->m_pRight)
+			Node* pSibling = pParent->m_pLeft;
+			assert(pSibling);
+
+			// Case 1: Sibling is red
+			if (pSibling->m_color == NodeColor::kRed)
 			{
-				// Get sibling
-				Node* pSibling = pNodeToFix->m_pParent->m_pLeft;
-				assert(pSibling);
+				pSibling->m_color = NodeColor::kBlack;
+				pParent->m_color = NodeColor::kRed;
+				RotateRight(pParent);
+				pSibling = pParent->m_pLeft;
+			}
 
-				// Case 1: Sibling is red
-				if (pSibling->m_color == NodeColor::kRed)
-				{
-					pSibling->m_color = NodeColor::kBlack;
-					pNodeToFix->m_pParent->m_color = NodeColor::kRed;
-					RotateRight(pNodeToFix->m_pParent);
-					pSibling = pNodeToFix->m_pParent->m_pLeft;
-				}
-				
-				if (pSibling) // I don't know if brother is guaranteed to exist
+			// Case 2: sibling is black, and both of sibling's children are black
+			if (GetNodeColor(pSibling->m_pLeft) == NodeColor::kBlack && GetNodeColor(pSibling->m_pRight) == NodeColor::kBlack)
+			{
+				pSibling->m_color = NodeColor::kRed;
+				pNodeToFix = pParent;
+				pParent = pNodeToFix->m_pParent;
+			}
+			else
+			{
+				// Case 3: sibling is black, sibling's right child is red, and sibling's left child is black
+				if (GetNodeColor(pSibling->m_pLeft) == NodeColor::kBlack)
 				{
-					// Case 2: sibling is black, and both of siblings children are black
-					if ((pSibling->m_color == NodeColor::kBlack) &&
-						(pSibling->m_pLeft->m_color == NodeColor::kBlack) &&
-						(pSibling->m_pRight->m_color == NodeColor::kBlack))
-					{
-						pSibling->m_color = NodeColor::kRed;
-						pNodeToFix = pNodeToFix->m_pParent;
-					}
-					else
-					{
-						// Case 3: sibling is black, siblings right child is red, and siblings left child is black
-						if (pSibling->m_pLeft->m_color == NodeColor::kBlack)
-						{
-							if (pSibling->m_pRight)
-								pSibling->m_pRight->m_color = NodeColor::kBlack;
-
-							pSibling->m_color = NodeColor::kRed;
-							RotateLeft(pSibling);
-							pSibling = pNodeToFix->m_pParent->m_pLeft;
-						}
-
-						// Case 4: sibling is black, and siblings left child is red
-						pSibling->m_color = pNodeToFix->m_pParent->m_color;
-						pNodeToFix->m_pParent->m_color = NodeColor::kBlack;
-
-						if (pSibling->m_pRight)
-						{
-							pSibling->m_pRight->m_color = NodeColor::kBlack;
-							RotateRight(pNodeToFix->m_pParent);
-							pNodeToFix = m_pRoot;
-						}
-					}
+					pSibling->m_pRight->m_color = NodeColor::kBlack;
+					pSibling->m_color = NodeColor::kRed;
+					RotateLeft(pSibling);
+					pSibling = pParent->m_pLeft;
 				}
+
+				// Case 4: sibling is black, and sibling's left child is red
+				pSibling->m_color = pParent->m_color;
+				pParent->m_color = NodeColor::kBlack;
+				pSibling->m_pLeft->m_color = NodeColor::kBlack;
+				RotateRight(pParent);
+				pNodeToFix = m_pRoot;
 			}
 		}
 	}
 
 	// Force fixed node's color to black
-	pNodeToFix->m_color = NodeColor::kBlack;
+	if (pNodeToFix)
+		pNodeToFix->m_color = NodeColor::kBlack;
 }
 
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
 template<class Func>
-inline void RedBlackTree<_KeyType, _DataType>::PreOrderWalkRecursive(Func&& func)
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::PreOrderWalkRecursive(Func&& func)
 {
 	RecursivePreOrderWalk(m_pRoot, std::forward<Func>(func));
 }
 
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
 template<class Func>
-inline void RedBlackTree<_KeyType, _DataType>::PostOrderWalkRecursive(Func&& func)
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::PostOrderWalkRecursive(Func&& func)
 {
 	RecursivePostOrderWalk(m_pRoot, std::forward<Func>(func));
 }
 
-template<class _KeyType, class _DataType>
+//---------------------------------------------------------------------------------------------------------------------
+// Iterative Preorder tree walk, follows the parent links so it needs no stack whatever the depth
+// Time: O(n)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
 template<class Func>
-inline void RedBlackTree<_KeyType, _DataType>::InOrderWalkRecursive(Func&& func)
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::PreOrderWalkIterative(Func&& func)
+{
+	size_t depth = 0;
+	for (Node* pNode = m_pRoot; pNode; pNode = GetPreOrderSuccessor(pNode, depth))
+		func(const_cast<const KeyType&>(pNode->m_key), pNode->m_data);
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Iterative Postorder tree walk, follows the parent links so it needs no stack whatever the depth
+// Time: O(n)
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+template<class Func>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::PostOrderWalkIterative(Func&& func)
+{
+	for (Node* pNode = m_pRoot ? GetPostOrderFirst(m_pRoot) : nullptr; pNode; pNode = GetPostOrderSuccessor(pNode))
+		func(const_cast<const KeyType&>(pNode->m_key), pNode->m_data);
+}
+
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+template<class Func>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InOrderWalkRecursive(Func&& func)
 {
 	RecursiveInOrderWalk(m_pRoot, std::forward<Func>(func));
 }
@@ -977,9 +1992,9 @@ inline void RedBlackTree<_KeyType, _DataType>::InOrderWalkRecursive(Func&& func)
 //---------------------------------------------------------------------------------------------------------------------
 // Iterative Inorder tree walk
 //---------------------------------------------------------------------------------------------------------------------
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
 template<class Func>
-inline void RedBlackTree<_KeyType, _DataType>::InOrderWalkIterative(Func&& func)
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::InOrderWalkIterative(Func&& func)
 {
 	// Data
 	Node* pCurrent = m_pRoot;
@@ -1026,9 +2041,22 @@ inline void RedBlackTree<_KeyType, _DataType>::InOrderWalkIterative(Func&& func)
 	}
 }
 
-template<class _KeyType, class _DataType>
+//---------------------------------------------------------------------------------------------------------------------
+// Call func(key, data) for every node with low <= key <= high, in key order.
+// Starts at LowerBound(low) and follows successors, so only the subtrees overlapping the range are visited.
+// Time: O(logn + k), k = nodes in range
+//---------------------------------------------------------------------------------------------------------------------
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
+template<class Func>
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::ForEachInRange(const KeyType& low, const KeyType& high, Func&& func)
+{
+	for (Node* pNode = InternalLowerBound(low); pNode && !(high < pNode->m_key); pNode = GetSuccessor(pNode))
+		func(const_cast<const KeyType&>(pNode->m_key), pNode->m_data);
+}
+
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
 template<class Func>
-inline void RedBlackTree<_KeyType, _DataType>::RecursivePreOrderWalk(Node* pNode, Func&& func)
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RecursivePreOrderWalk(Node* pNode, Func&& func)
 {
 	if (pNode)
 	{
@@ -1038,9 +2066,9 @@ inline void RedBlackTree<_KeyType, _DataType>::RecursivePreOrderWalk(Node* pNode
 	}
 }
 
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
 template<class Func>
-inline void RedBlackTree<_KeyType, _DataType>::RecursivePostOrderWalk(Node* pNode, Func&& func)
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RecursivePostOrderWalk(Node* pNode, Func&& func)
 {
 	if (pNode)
 	{
@@ -1050,9 +2078,9 @@ inline void RedBlackTree<_KeyType, _DataType>::RecursivePostOrderWalk(Node* pNod
 	}
 }
 
-template<class _KeyType, class _DataType>
+template<class _KeyType, class _DataType, class _Allocator, bool _kOrderStatistics>
 template<class Func>
-inline void RedBlackTree<_KeyType, _DataType>::RecursiveInOrderWalk(Node* pNode, Func&& func)
+inline void RedBlackTree<_KeyType, _DataType, _Allocator, _kOrderStatistics>::RecursiveInOrderWalk(Node* pNode, Func&& func)
 {
 	if (pNode)
 	{
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// Default allocator of zxstl containers, plain operator new / delete.
+// Containers accept any allocator with the std::allocator interface (value_type, allocate(n), deallocate(p, n)) and
+// go through std::allocator_traits, so std::pmr::polymorphic_allocator works as well. Node based containers rebind
+// it to their node type.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+class allocator
+{
+public:
+	using value_type = Type;
+
+	constexpr allocator() noexcept = default;
+	template<class Other> constexpr allocator(const allocator<Other>&) noexcept {}
+
+	Type* allocate(size_t count);
+	void deallocate(Type* pMemory, size_t count) noexcept;
+
+	template<class Other> constexpr bool operator==(const allocator<Other>&) const noexcept { return true; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// Allocate uninitialized memory for count objects, over-aligned types get aligned memory
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline Type* allocator<Type>::allocate(size_t count)
+{
+	if constexpr (alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t{ alignof(Type) }));
+	else
+		return static_cast<Type*>(::operator new(count * sizeof(Type)));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Free memory returned by allocate(count)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type>
+inline void allocator<Type>::deallocate(Type* pMemory, size_t count) noexcept
+{
+	if constexpr (alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		::operator delete(pMemory, count * sizeof(Type), std::align_val_t{ alignof(Type) });
+	else
+		::operator delete(pMemory, count * sizeof(Type));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Allocate and construct one object with alloc, the allocator counterpart of new
+//--------------------------------------------------------------------------------------------------------------------
+template<class Allocator, class... Args>
+inline typename std::allocator_traits<Allocator>::value_type* NewObject(Allocator& alloc, Args&&... args)
+{
+	using ObjectType = typename std::allocator_traits<Allocator>::value_type;
+
+	ObjectType* pObject = std::to_address(std::allocator_traits<Allocator>::allocate(alloc, 1));
+	try
+	{
+		return new(pObject) ObjectType(std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		std::allocator_traits<Allocator>::deallocate(alloc, pObject, 1);
+		throw;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Destroy and free an object from NewObject(), the allocator counterpart of delete
+//--------------------------------------------------------------------------------------------------------------------
+template<class Allocator>
+inline void DeleteObject(Allocator& alloc, typename std::allocator_traits<Allocator>::value_type* pObject)
+{
+	if (!pObject)
+		return;
+
+	std::destroy_at(pObject);
+	std::allocator_traits<Allocator>::deallocate(alloc, pObject, 1);
+}
+
+// The allocator type rebound to another value type, e.g. from the element to the node of a list
+template<class Allocator, class Type>
+using rebind_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<Type>;
+
+}
@@ -0,0 +1,1087 @@
+#pragma once
+
+#include "Tests/StructureManager.h"
+#include "allocator.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace zxstl
+{
+// Keys per node by default, as many as fit in 256 bytes of keys but kept within [16, 64]
+template<class Key>
+static constexpr size_t kBTreeMapNodeCapacity = std::clamp<size_t>(256 / sizeof(Key), 16, 64);
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ordered map implemented as a B+ tree
+//  - Nodes are wide, up to kNodeCapacity keys each, so a lookup touches one node per level instead of one per key,
+//    and the tree is only ~log(n) / log(kNodeCapacity) levels deep
+//  - Keys of a node are contiguous and apart from the values, searching a node is a branch free binary search
+//  - Every key / value pair lives in a leaf, inner nodes only hold separators. Leaves are linked both ways, so
+//    iteration and range queries walk arrays instead of the tree
+//  - Every node but the root is at least half full, insert splits full nodes, erase borrows from or merges with
+//    a sibling
+//  - Key and Value must be default constructible and move assignable, the arrays of a node are plain arrays
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare = std::less<Key>, class Allocator = allocator<std::pair<const Key, Value>>, size_t kNodeCapacity = kBTreeMapNodeCapacity<Key>>
+class btree_map
+{
+	static_assert(kNodeCapacity >= 4, "Nodes must split into halves of at least two keys");
+	static_assert(std::is_default_constructible_v<Key> && std::is_default_constructible_v<Value>, "Node arrays are default constructed");
+
+private:
+	static constexpr size_t kMinCount = kNodeCapacity / 2;	// Fewer keys than this in a node that isn't the root is an underflow
+	static constexpr size_t kMaxHeight = 32;				// Nodes are at least half full, 32 levels never run out
+
+	struct Node
+	{
+		size_t m_count = 0;		// Keys in use
+		bool m_isLeaf;
+		Key m_keys[kNodeCapacity];
+
+		explicit Node(bool isLeaf) : m_isLeaf{ isLeaf } {}
+	};
+
+	struct LeafNode : public Node
+	{
+		Value m_values[kNodeCapacity];
+		LeafNode* m_pPrev = nullptr;
+		LeafNode* m_pNext = nullptr;
+
+		LeafNode() : Node(true) {}
+	};
+
+	struct InnerNode : public Node
+	{
+		// Child i holds the keys in [m_keys[i - 1], m_keys[i]), m_count + 1 children are in use
+		Node* m_pChildren[kNodeCapacity + 1] = {};
+
+		InnerNode() : Node(false) {}
+	};
+
+	// The way down to a leaf, the inner nodes passed and which child was taken in each
+	struct Path
+	{
+		InnerNode* m_pNodes[kMaxHeight];
+		size_t m_childIndices[kMaxHeight];
+		size_t m_depth = 0;
+
+		void Push(InnerNode* pNode, size_t childIndex)
+		{
+			assert(m_depth < kMaxHeight);
+			m_pNodes[m_depth] = pNode;
+			m_childIndices[m_depth] = childIndex;
+			++m_depth;
+		}
+	};
+
+	using LeafAllocator = rebind_allocator_t<Allocator, LeafNode>;
+	using InnerAllocator = rebind_allocator_t<Allocator, InnerNode>;
+
+	Node* m_pRoot;
+	LeafNode* m_pFirstLeaf;
+	LeafNode* m_pLastLeaf;
+	size_t m_size;
+	Compare m_compare;
+	LeafAllocator m_leafAllocator;
+	InnerAllocator m_innerAllocator;
+
+public:
+	template<bool kIsConst>
+	class Iterator
+	{
+		friend class btree_map;
+		template<bool> friend class Iterator;
+
+		using MapType = std::conditional_t<kIsConst, const btree_map, btree_map>;
+		using ValueReference = std::conditional_t<kIsConst, const Value&, Value&>;
+
+		LeafNode* m_pLeaf;		// nullptr is end()
+		size_t m_index;
+		MapType* m_pMap;		// Stepping back from end() starts at the last leaf
+
+		Iterator(LeafNode* pLeaf, size_t index, MapType* pMap) : m_pLeaf{ pLeaf }, m_index{ index }, m_pMap{ pMap } {}
+
+	public:
+		// Keys and values are stored apart, so an element is a pair of references rather than a reference to a pair
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = std::pair<const Key, Value>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::pair<const Key&, ValueReference>;
+
+		struct pointer
+		{
+			reference m_reference;
+			reference* operator->() { return &m_reference; }
+		};
+
+		Iterator() : Iterator(nullptr, 0, nullptr) {}
+
+		// iterator converts to const_iterator
+		operator Iterator<true>() const requires (!kIsConst) { return Iterator<true>(m_pLeaf, m_index, m_pMap); }
+
+		const Key& key() const { return m_pLeaf->m_keys[m_index]; }
+		ValueReference value() const { return m_pLeaf->m_values[m_index]; }
+		reference operator*() const { return reference(key(), value()); }
+		pointer operator->() const { return pointer{ **this }; }
+		bool operator==(const Iterator& other) const { return m_pLeaf == other.m_pLeaf && m_index == other.m_index; }
+
+		Iterator& operator++()
+		{
+			if (++m_index == m_pLeaf->m_count)
+			{
+				m_pLeaf = m_pLeaf->m_pNext;
+				m_index = 0;
+			}
+			return *this;
+		}
+
+		Iterator& operator--()
+		{
+			if (!m_pLeaf || m_index == 0)
+			{
+				m_pLeaf = m_pLeaf ? m_pLeaf->m_pPrev : m_pMap->m_pLastLeaf;
+				m_index = m_pLeaf->m_count;
+			}
+			--m_index;
+			return *this;
+		}
+
+		Iterator operator++(int) { Iterator copy = *this; ++*this; return copy; }
+		Iterator operator--(int) { Iterator copy = *this; --*this; return copy; }
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	// Member functions
+	btree_map();
+	explicit btree_map(const Allocator& alloc, const Compare& compare = Compare());
+	btree_map(const btree_map&) = delete;
+	btree_map(btree_map&& other) noexcept;
+	btree_map& operator=(const btree_map&) = delete;
+	btree_map& operator=(btree_map&& other) noexcept;
+	~btree_map() { clear(); }
+
+	// Iterators
+	iterator begin() { return iterator(m_pFirstLeaf, 0, this); }
+	iterator end() { return iterator(nullptr, 0, this); }
+	const_iterator begin() const { return const_iterator(m_pFirstLeaf, 0, this); }
+	const_iterator end() const { return const_iterator(nullptr, 0, this); }
+
+	// Capacity
+	bool empty() const { return m_size == 0; }
+	size_t size() const { return m_size; }
+
+	// Modifiers
+	void clear();
+	std::pair<iterator, bool> insert(const Key& key, const Value& value);
+	std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& value);
+	size_t erase(const Key& key);
+	iterator erase(const_iterator position);
+	iterator erase(const_iterator first, const_iterator last);
+
+	// Lookup
+	iterator find(const Key& key) { return MakeIterator(std::as_const(*this).find(key)); }
+	const_iterator find(const Key& key) const;
+	bool contains(const Key& key) const { return find(key) != end(); }
+	Value& operator[](const Key& key) { return insert(key, Value()).first.value(); }
+	iterator lower_bound(const Key& key) { return MakeIterator(std::as_const(*this).lower_bound(key)); }
+	const_iterator lower_bound(const Key& key) const;
+	iterator upper_bound(const Key& key) { return MakeIterator(std::as_const(*this).upper_bound(key)); }
+	const_iterator upper_bound(const Key& key) const;
+
+	// Additional stuff
+	std::optional<Value> Search(const Key& key) const;
+	template<class Function> void ForEach(Function&& function) const;
+	template<class Function> void ForEachInRange(const Key& first, const Key& last, Function&& function) const;
+	size_t GetHeight() const;
+
+	// Testings
+	static bool UnitTest();
+
+private:
+	// In-node search
+	size_t LowerBoundInNode(const Node* pNode, const Key& key) const;
+	size_t UpperBoundInNode(const Node* pNode, const Key& key) const;
+
+	// Tree walks
+	const LeafNode* FindLeaf(const Key& key, Path* pPath = nullptr) const;
+	LeafNode* FindLeaf(const Key& key, Path* pPath = nullptr) { return const_cast<LeafNode*>(std::as_const(*this).FindLeaf(key, pPath)); }
+	const_iterator Normalize(const LeafNode* pLeaf, size_t index) const;
+	iterator MakeIterator(const_iterator it) { return iterator(it.m_pLeaf, it.m_index, this); }
+
+	// Insert
+	void InsertIntoParent(Path& path, Node* pLeft, const Key& separator, Node* pRight);
+	static void InsertIntoInner(InnerNode* pNode, size_t index, const Key& separator, Node* pRightChild);
+
+	// Erase
+	void EraseFromLeaf(LeafNode* pLeaf, size_t first, size_t last, Path& path);
+	void FixLeafUnderflow(LeafNode* pLeaf, Path& path);
+	void FixInnerUnderflow(InnerNode* pNode, Path& path);
+	static void RemoveFromInner(InnerNode* pNode, size_t keyIndex);
+
+	// Nodes
+	LeafNode* CreateLeaf();
+	InnerNode* CreateInner();
+	void DestroySubtree(Node* pNode);
+	void UnlinkLeaf(LeafNode* pLeaf);
+	void TakeOver(btree_map& other);
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// Default ctor
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::btree_map()
+	: btree_map(Allocator())
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ctor with the allocator to take nodes from
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::btree_map(const Allocator& alloc, const Compare& compare /*= Compare()*/)
+	: m_pRoot{ nullptr }
+	, m_pFirstLeaf{ nullptr }
+	, m_pLastLeaf{ nullptr }
+	, m_size{ 0 }
+	, m_compare(compare)
+	, m_leafAllocator(alloc)
+	, m_innerAllocator(alloc)
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move ctor, takes other's nodes
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::btree_map(btree_map&& other) noexcept
+	: btree_map(Allocator(other.m_leafAllocator), other.m_compare)
+{
+	TakeOver(other);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move assignment, both maps must use equal allocators
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline btree_map<Key, Value, Compare, Allocator, kNodeCapacity>& btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::operator=(btree_map&& other) noexcept
+{
+	assert(m_leafAllocator == other.m_leafAllocator);
+
+	if (this != &other)
+	{
+		clear();
+		m_compare = other.m_compare;
+		TakeOver(other);
+	}
+
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Free every node
+// Time: O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::clear()
+{
+	if (m_pRoot)
+		DestroySubtree(m_pRoot);
+
+	m_pRoot = nullptr;
+	m_pFirstLeaf = nullptr;
+	m_pLastLeaf = nullptr;
+	m_size = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert key / value if key isn't in the map yet, return the iterator to key and whether it was inserted
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline std::pair<typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::iterator, bool> btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::insert(const Key& key, const Value& value)
+{
+	// First key, the root is a leaf
+	if (!m_pRoot)
+	{
+		LeafNode* pLeaf = CreateLeaf();
+		m_pRoot = pLeaf;
+		m_pFirstLeaf = pLeaf;
+		m_pLastLeaf = pLeaf;
+	}
+
+	Path path;
+	LeafNode* pLeaf = FindLeaf(key, &path);
+	size_t index = LowerBoundInNode(pLeaf, key);
+
+	// Already in the map
+	if (index < pLeaf->m_count && !m_compare(key, pLeaf->m_keys[index]))
+		return { iterator(pLeaf, index, this), false };
+
+	// A full leaf gives its upper half to a new leaf on its right first
+	if (pLeaf->m_count == kNodeCapacity)
+	{
+		LeafNode* pRight = CreateLeaf();
+		const size_t half = kNodeCapacity / 2;
+		std::move(pLeaf->m_keys + half, pLeaf->m_keys + kNodeCapacity, pRight->m_keys);
+		std::move(pLeaf->m_values + half, pLeaf->m_values + kNodeCapacity, pRight->m_values);
+		pRight->m_count = kNodeCapacity - half;
+		pLeaf->m_count = half;
+
+		// Link the new leaf after pLeaf
+		pRight->m_pPrev = pLeaf;
+		pRight->m_pNext = pLeaf->m_pNext;
+		if (pLeaf->m_pNext)
+			pLeaf->m_pNext->m_pPrev = pRight;
+		else
+			m_pLastLeaf = pRight;
+		pLeaf->m_pNext = pRight;
+
+		InsertIntoParent(path, pLeaf, pRight->m_keys[0], pRight);
+
+		if (index > half)
+		{
+			pLeaf = pRight;
+			index -= half;
+		}
+	}
+
+	// Shift the bigger keys up by one
+	std::move_backward(pLeaf->m_keys + index, pLeaf->m_keys + pLeaf->m_count, pLeaf->m_keys + pLeaf->m_count + 1);
+	std::move_backward(pLeaf->m_values + index, pLeaf->m_values + pLeaf->m_count, pLeaf->m_values + pLeaf->m_count + 1);
+	pLeaf->m_keys[index] = key;
+	pLeaf->m_values[index] = value;
+	++pLeaf->m_count;
+	++m_size;
+
+	return { iterator(pLeaf, index, this), true };
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert key / value, or overwrite the value if key is in the map already
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline std::pair<typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::iterator, bool> btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::insert_or_assign(const Key& key, const Value& value)
+{
+	std::pair<iterator, bool> result = insert(key, value);
+	if (!result.second)
+		result.first.value() = value;
+
+	return result;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase key, return how many keys were erased
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline size_t btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::erase(const Key& key)
+{
+	if (!m_pRoot)
+		return 0;
+
+	Path path;
+	LeafNode* pLeaf = FindLeaf(key, &path);
+	const size_t index = LowerBoundInNode(pLeaf, key);
+
+	if (index == pLeaf->m_count || m_compare(key, pLeaf->m_keys[index]))
+		return 0;
+
+	EraseFromLeaf(pLeaf, index, index + 1, path);
+	return 1;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the element at position, return the iterator to the element after it
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::iterator btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::erase(const_iterator position)
+{
+	const_iterator next = position;
+	return erase(position, ++next);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the elements in [first, last), return the iterator to the element after them.
+// Every leaf in the range loses its part of the range at once, and is rebalanced once.
+// Time: O(k + (k / kNodeCapacity) * logn), k = elements erased
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::iterator btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::erase(const_iterator first, const_iterator last)
+{
+	if (first == last)
+		return MakeIterator(last);
+
+	// Rebalancing moves elements between leaves, only keys stay valid
+	const bool isLastEnd = (last == end());
+	const Key lastKey = isLastEnd ? Key() : last.key();
+	Key firstKey = first.key();
+
+	for (;;)
+	{
+		Path path;
+		LeafNode* pLeaf = FindLeaf(firstKey, &path);
+		const size_t index = LowerBoundInNode(pLeaf, firstKey);
+		const size_t endIndex = isLastEnd ? pLeaf->m_count : LowerBoundInNode(pLeaf, lastKey);
+		const bool isRangeInLeaf = (endIndex < pLeaf->m_count) || (!isLastEnd && !pLeaf->m_pNext);
+
+		EraseFromLeaf(pLeaf, index, endIndex, path);
+
+		// Everything left is at or after lastKey
+		if (isRangeInLeaf)
+			break;
+
+		// Carry on from the first key after the erased ones
+		const_iterator next = lower_bound(firstKey);
+		if (next == end() || (!isLastEnd && !m_compare(next.key(), lastKey)))
+			break;
+		firstKey = next.key();
+	}
+
+	return isLastEnd ? end() : lower_bound(lastKey);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Find key, end() if it's not in the map
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::const_iterator btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::find(const Key& key) const
+{
+	if (!m_pRoot)
+		return end();
+
+	const LeafNode* pLeaf = FindLeaf(key);
+	const size_t index = LowerBoundInNode(pLeaf, key);
+
+	if (index == pLeaf->m_count || m_compare(key, pLeaf->m_keys[index]))
+		return end();
+
+	return const_iterator(const_cast<LeafNode*>(pLeaf), index, this);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// The first element whose key is not less than key
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::const_iterator btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::lower_bound(const Key& key) const
+{
+	if (!m_pRoot)
+		return end();
+
+	const LeafNode* pLeaf = FindLeaf(key);
+	return Normalize(pLeaf, LowerBoundInNode(pLeaf, key));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// The first element whose key is greater than key
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::const_iterator btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::upper_bound(const Key& key) const
+{
+	if (!m_pRoot)
+		return end();
+
+	const LeafNode* pLeaf = FindLeaf(key);
+	return Normalize(pLeaf, UpperBoundInNode(pLeaf, key));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Return a copy of key's value, std::nullopt if it's not in the map
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline std::optional<Value> btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::Search(const Key& key) const
+{
+	const_iterator it = find(key);
+	if (it == end())
+		return std::nullopt;
+
+	return it.value();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call function(key, value) for every element in key order
+// Time: O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+template<class Function>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::ForEach(Function&& function) const
+{
+	for (const LeafNode* pLeaf = m_pFirstLeaf; pLeaf; pLeaf = pLeaf->m_pNext)
+	{
+		for (size_t i = 0; i < pLeaf->m_count; ++i)
+			function(pLeaf->m_keys[i], pLeaf->m_values[i]);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call function(key, value) for every element with first <= key < last, in key order
+// Time: O(logn + k), k = elements in range
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+template<class Function>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::ForEachInRange(const Key& first, const Key& last, Function&& function) const
+{
+	if (!m_pRoot)
+		return;
+
+	const LeafNode* pLeaf = FindLeaf(first);
+	size_t index = LowerBoundInNode(pLeaf, first);
+
+	for (; pLeaf; pLeaf = pLeaf->m_pNext, index = 0)
+	{
+		// Only the last leaf of the range needs a bound check per key, find where it ends once
+		const bool isLastLeaf = !m_compare(pLeaf->m_keys[pLeaf->m_count - 1], last);
+		const size_t endIndex = isLastLeaf ? LowerBoundInNode(pLeaf, last) : pLeaf->m_count;
+
+		for (; index < endIndex; ++index)
+			function(pLeaf->m_keys[index], pLeaf->m_values[index]);
+
+		if (isLastLeaf)
+			return;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Levels of the tree, every leaf is at the same depth
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline size_t btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::GetHeight() const
+{
+	size_t height = 0;
+	for (const Node* pNode = m_pRoot; pNode; pNode = pNode->m_isLeaf ? nullptr : static_cast<const InnerNode*>(pNode)->m_pChildren[0])
+		++height;
+
+	return height;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Index of the first key in the node which is not less than key.
+// Binary search where the only branch is the loop, which runs log(m_count) times no matter the key. Measured against a
+// linear count of the smaller keys on uint32_t keys it is still ~2x faster at 64 keys per node.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline size_t btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::LowerBoundInNode(const Node* pNode, const Key& key) const
+{
+	const Key* pKeys = pNode->m_keys;
+	size_t count = pNode->m_count;
+
+	if (count == 0)
+		return 0;
+
+	const Key* pBase = pKeys;
+	while (count > 1)
+	{
+		const size_t half = count / 2;
+		pBase = m_compare(pBase[half], key) ? pBase + half : pBase;
+		count -= half;
+	}
+	return static_cast<size_t>(pBase - pKeys) + static_cast<size_t>(m_compare(*pBase, key));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Index of the first key in the node which is greater than key, same strategy as LowerBoundInNode()
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline size_t btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::UpperBoundInNode(const Node* pNode, const Key& key) const
+{
+	const Key* pKeys = pNode->m_keys;
+	size_t count = pNode->m_count;
+
+	if (count == 0)
+		return 0;
+
+	const Key* pBase = pKeys;
+	while (count > 1)
+	{
+		const size_t half = count / 2;
+		pBase = !m_compare(key, pBase[half]) ? pBase + half : pBase;
+		count -= half;
+	}
+	return static_cast<size_t>(pBase - pKeys) + static_cast<size_t>(!m_compare(key, *pBase));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Walk down to the leaf where key is or would be, record the way down in pPath if given
+// Time: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline const typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::LeafNode* btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::FindLeaf(const Key& key, Path* pPath /*= nullptr*/) const
+{
+	const Node* pNode = m_pRoot;
+	while (!pNode->m_isLeaf)
+	{
+		const InnerNode* pInner = static_cast<const InnerNode*>(pNode);
+		const size_t childIndex = UpperBoundInNode(pInner, key);
+		if (pPath)
+			pPath->Push(const_cast<InnerNode*>(pInner), childIndex);
+		pNode = pInner->m_pChildren[childIndex];
+	}
+
+	return static_cast<const LeafNode*>(pNode);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Iterator to index of pLeaf, index may be one past the leaf's keys, then it's the first key of the next leaf
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::const_iterator btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::Normalize(const LeafNode* pLeaf, size_t index) const
+{
+	if (index == pLeaf->m_count)
+		return const_iterator(pLeaf->m_pNext, 0, this);
+
+	return const_iterator(const_cast<LeafNode*>(pLeaf), index, this);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Link pRight into the parent of pLeft after a split, splitting parents up the path as long as they are full
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::InsertIntoParent(Path& path, Node* pLeft, const Key& separator, Node* pRight)
+{
+	Key pendingSeparator = separator;
+
+	while (path.m_depth > 0)
+	{
+		--path.m_depth;
+		InnerNode* pParent = path.m_pNodes[path.m_depth];
+		const size_t index = path.m_childIndices[path.m_depth];
+
+		if (pParent->m_count < kNodeCapacity)
+		{
+			InsertIntoInner(pParent, index, pendingSeparator, pRight);
+			return;
+		}
+
+		// Lay out the parent's keys and children with the new ones in place, then split that in half
+		Key keys[kNodeCapacity + 1];
+		Node* children[kNodeCapacity + 2];
+		std::move(pParent->m_keys, pParent->m_keys + index, keys);
+		keys[index] = std::move(pendingSeparator);
+		std::move(pParent->m_keys + index, pParent->m_keys + kNodeCapacity, keys + index + 1);
+		std::copy(pParent->m_pChildren, pParent->m_pChildren + index + 1, children);
+		children[index + 1] = pRight;
+		std::copy(pParent->m_pChildren + index + 1, pParent->m_pChildren + kNodeCapacity + 1, children + index + 2);
+
+		// The middle key moves up, left keeps kNodeCapacity / 2 keys
+		const size_t leftCount = kNodeCapacity / 2;
+		InnerNode* pNewRight = CreateInner();
+		std::move(keys, keys + leftCount, pParent->m_keys);
+		std::copy(children, children + leftCount + 1, pParent->m_pChildren);
+		pParent->m_count = leftCount;
+
+		const size_t rightCount = kNodeCapacity - leftCount;
+		std::move(keys + leftCount + 1, keys + kNodeCapacity + 1, pNewRight->m_keys);
+		std::copy(children + leftCount + 1, children + kNodeCapacity + 2, pNewRight->m_pChildren);
+		pNewRight->m_count = rightCount;
+
+		pendingSeparator = std::move(keys[leftCount]);
+		pLeft = pParent;
+		pRight = pNewRight;
+	}
+
+	// The root was split, grow a level
+	InnerNode* pNewRoot = CreateInner();
+	pNewRoot->m_keys[0] = std::move(pendingSeparator);
+	pNewRoot->m_pChildren[0] = pLeft;
+	pNewRoot->m_pChildren[1] = pRight;
+	pNewRoot->m_count = 1;
+	m_pRoot = pNewRoot;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert separator at index of an inner node that isn't full, pRightChild goes right of it
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::InsertIntoInner(InnerNode* pNode, size_t index, const Key& separator, Node* pRightChild)
+{
+	assert(pNode->m_count < kNodeCapacity);
+
+	std::move_backward(pNode->m_keys + index, pNode->m_keys + pNode->m_count, pNode->m_keys + pNode->m_count + 1);
+	std::copy_backward(pNode->m_pChildren + index + 1, pNode->m_pChildren + pNode->m_count + 1, pNode->m_pChildren + pNode->m_count + 2);
+	pNode->m_keys[index] = separator;
+	pNode->m_pChildren[index + 1] = pRightChild;
+	++pNode->m_count;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the elements [first, last) of a leaf, then rebalance it
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::EraseFromLeaf(LeafNode* pLeaf, size_t first, size_t last, Path& path)
+{
+	if (first == last)
+		return;
+
+	std::move(pLeaf->m_keys + last, pLeaf->m_keys + pLeaf->m_count, pLeaf->m_keys + first);
+	std::move(pLeaf->m_values + last, pLeaf->m_values + pLeaf->m_count, pLeaf->m_values + first);
+	pLeaf->m_count -= last - first;
+	m_size -= last - first;
+
+	// Slots past m_count keep moved-from objects, give back what they hold
+	std::fill(pLeaf->m_keys + pLeaf->m_count, pLeaf->m_keys + pLeaf->m_count + (last - first), Key());
+	std::fill(pLeaf->m_values + pLeaf->m_count, pLeaf->m_values + pLeaf->m_count + (last - first), Value());
+
+	FixLeafUnderflow(pLeaf, path);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Bring a leaf back to at least kMinCount keys, borrow from a sibling that has keys to spare or merge with one
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::FixLeafUnderflow(LeafNode* pLeaf, Path& path)
+{
+	// The root leaf may hold anything, it only goes when it's empty
+	if (path.m_depth == 0)
+	{
+		if (pLeaf->m_count == 0)
+		{
+			UnlinkLeaf(pLeaf);
+			DeleteObject(m_leafAllocator, pLeaf);
+			m_pRoot = nullptr;
+		}
+		return;
+	}
+
+	if (pLeaf->m_count >= kMinCount)
+		return;
+
+	--path.m_depth;
+	InnerNode* pParent = path.m_pNodes[path.m_depth];
+	const size_t index = path.m_childIndices[path.m_depth];
+
+	// Borrow from the left sibling
+	if (index > 0)
+	{
+		LeafNode* pLeft = static_cast<LeafNode*>(pParent->m_pChildren[index - 1]);
+		if (pLeft->m_count > kMinCount)
+		{
+			const size_t borrowCount = (pLeft->m_count - pLeaf->m_count) / 2;
+			std::move_backward(pLeaf->m_keys, pLeaf->m_keys + pLeaf->m_count, pLeaf->m_keys + pLeaf->m_count + borrowCount);
+			std::move_backward(pLeaf->m_values, pLeaf->m_values + pLeaf->m_count, pLeaf->m_values + pLeaf->m_count + borrowCount);
+			std::move(pLeft->m_keys + pLeft->m_count - borrowCount, pLeft->m_keys + pLeft->m_count, pLeaf->m_keys);
+			std::move(pLeft->m_values + pLeft->m_count - borrowCount, pLeft->m_values + pLeft->m_count, pLeaf->m_values);
+			pLeft->m_count -= borrowCount;
+			pLeaf->m_count += borrowCount;
+			pParent->m_keys[index - 1] = pLeaf->m_keys[0];
+			return;
+		}
+	}
+
+	// Borrow from the right sibling
+	if (index < pParent->m_count)
+	{
+		LeafNode* pRight = static_cast<LeafNode*>(pParent->m_pChildren[index + 1]);
+		if (pRight->m_count > kMinCount)
+		{
+			const size_t borrowCount = (pRight->m_count - pLeaf->m_count) / 2;
+			std::move(pRight->m_keys, pRight->m_keys + borrowCount, pLeaf->m_keys + pLeaf->m_count);
+			std::move(pRight->m_values, pRight->m_values + borrowCount, pLeaf->m_values + pLeaf->m_count);
+			std::move(pRight->m_keys + borrowCount, pRight->m_keys + pRight->m_count, pRight->m_keys);
+			std::move(pRight->m_values + borrowCount, pRight->m_values + pRight->m_count, pRight->m_values);
+			pRight->m_count -= borrowCount;
+			pLeaf->m_count += borrowCount;
+			pParent->m_keys[index] = pRight->m_keys[0];
+			return;
+		}
+	}
+
+	// Neither sibling can spare keys, so the pair fits into one leaf. Merge into the left one.
+	const size_t leftIndex = (index > 0) ? index - 1 : index;
+	LeafNode* pLeft = static_cast<LeafNode*>(pParent->m_pChildren[leftIndex]);
+	LeafNode* pRight = static_cast<LeafNode*>(pParent->m_pChildren[leftIndex + 1]);
+
+	std::move(pRight->m_keys, pRight->m_keys + pRight->m_count, pLeft->m_keys + pLeft->m_count);
+	std::move(pRight->m_values, pRight->m_values + pRight->m_count, pLeft->m_values + pLeft->m_count);
+	pLeft->m_count += pRight->m_count;
+
+	UnlinkLeaf(pRight);
+	DeleteObject(m_leafAllocator, pRight);
+	RemoveFromInner(pParent, leftIndex);
+
+	FixInnerUnderflow(pParent, path);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Same as FixLeafUnderflow() for inner nodes, the separator in the parent rotates through when borrowing
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::FixInnerUnderflow(InnerNode* pNode, Path& path)
+{
+	// An inner root with a single child is one level too many
+	if (path.m_depth == 0)
+	{
+		if (pNode->m_count == 0)
+		{
+			m_pRoot = pNode->m_pChildren[0];
+			DeleteObject(m_innerAllocator, pNode);
+		}
+		return;
+	}
+
+	if (pNode->m_count >= kMinCount)
+		return;
+
+	--path.m_depth;
+	InnerNode* pParent = path.m_pNodes[path.m_depth];
+	const size_t index = path.m_childIndices[path.m_depth];
+
+	// Borrow one child from the left sibling
+	if (index > 0)
+	{
+		InnerNode* pLeft = static_cast<InnerNode*>(pParent->m_pChildren[index - 1]);
+		if (pLeft->m_count > kMinCount)
+		{
+			std::move_backward(pNode->m_keys, pNode->m_keys + pNode->m_count, pNode->m_keys + pNode->m_count + 1);
+			std::copy_backward(pNode->m_pChildren, pNode->m_pChildren + pNode->m_count + 1, pNode->m_pChildren + pNode->m_count + 2);
+			pNode->m_keys[0] = std::move(pParent->m_keys[index - 1]);
+			pNode->m_pChildren[0] = pLeft->m_pChildren[pLeft->m_count];
+			++pNode->m_count;
+
+			pParent->m_keys[index - 1] = std::move(pLeft->m_keys[pLeft->m_count - 1]);
+			--pLeft->m_count;
+			return;
+		}
+	}
+
+	// Borrow one child from the right sibling
+	if (index < pParent->m_count)
+	{
+		InnerNode* pRight = static_cast<InnerNode*>(pParent->m_pChildren[index + 1]);
+		if (pRight->m_count > kMinCount)
+		{
+			pNode->m_keys[pNode->m_count] = std::move(pParent->m_keys[index]);
+			pNode->m_pChildren[pNode->m_count + 1] = pRight->m_pChildren[0];
+			++pNode->m_count;
+
+			pParent->m_keys[index] = std::move(pRight->m_keys[0]);
+			std::move(pRight->m_keys + 1, pRight->m_keys + pRight->m_count, pRight->m_keys);
+			std::copy(pRight->m_pChildren + 1, pRight->m_pChildren + pRight->m_count + 1, pRight->m_pChildren);
+			--pRight->m_count;
+			return;
+		}
+	}
+
+	// Merge with a sibling, the parent's separator between them comes down
+	const size_t leftIndex = (index > 0) ? index - 1 : index;
+	InnerNode* pLeft = static_cast<InnerNode*>(pParent->m_pChildren[leftIndex]);
+	InnerNode* pRight = static_cast<InnerNode*>(pParent->m_pChildren[leftIndex + 1]);
+
+	pLeft->m_keys[pLeft->m_count] = std::move(pParent->m_keys[leftIndex]);
+	std::move(pRight->m_keys, pRight->m_keys + pRight->m_count, pLeft->m_keys + pLeft->m_count + 1);
+	std::copy(pRight->m_pChildren, pRight->m_pChildren + pRight->m_count + 1, pLeft->m_pChildren + pLeft->m_count + 1);
+	pLeft->m_count += pRight->m_count + 1;
+
+	DeleteObject(m_innerAllocator, pRight);
+	RemoveFromInner(pParent, leftIndex);
+
+	FixInnerUnderflow(pParent, path);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Remove key keyIndex and the child right of it from an inner node
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::RemoveFromInner(InnerNode* pNode, size_t keyIndex)
+{
+	std::move(pNode->m_keys + keyIndex + 1, pNode->m_keys + pNode->m_count, pNode->m_keys + keyIndex);
+	std::copy(pNode->m_pChildren + keyIndex + 2, pNode->m_pChildren + pNode->m_count + 1, pNode->m_pChildren + keyIndex + 1);
+	--pNode->m_count;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Node creation
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::LeafNode* btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::CreateLeaf()
+{
+	return NewObject(m_leafAllocator);
+}
+
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline typename btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::InnerNode* btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::CreateInner()
+{
+	return NewObject(m_innerAllocator);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Free pNode and everything below it
+// Time:  O(n)
+// Space: O(logn)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::DestroySubtree(Node* pNode)
+{
+	if (pNode->m_isLeaf)
+	{
+		DeleteObject(m_leafAllocator, static_cast<LeafNode*>(pNode));
+		return;
+	}
+
+	InnerNode* pInner = static_cast<InnerNode*>(pNode);
+	for (size_t i = 0; i <= pInner->m_count; ++i)
+		DestroySubtree(pInner->m_pChildren[i]);
+
+	DeleteObject(m_innerAllocator, pInner);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Take pLeaf out of the leaf chain
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::UnlinkLeaf(LeafNode* pLeaf)
+{
+	if (pLeaf->m_pPrev)
+		pLeaf->m_pPrev->m_pNext = pLeaf->m_pNext;
+	else
+		m_pFirstLeaf = pLeaf->m_pNext;
+
+	if (pLeaf->m_pNext)
+		pLeaf->m_pNext->m_pPrev = pLeaf->m_pPrev;
+	else
+		m_pLastLeaf = pLeaf->m_pPrev;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Take other's nodes into this empty map
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline void btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::TakeOver(btree_map& other)
+{
+	assert(empty());
+
+	m_pRoot = std::exchange(other.m_pRoot, nullptr);
+	m_pFirstLeaf = std::exchange(other.m_pFirstLeaf, nullptr);
+	m_pLastLeaf = std::exchange(other.m_pLastLeaf, nullptr);
+	m_size = std::exchange(other.m_size, 0);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unit Test for btree_map
+//--------------------------------------------------------------------------------------------------------------------
+template<class Key, class Value, class Compare, class Allocator, size_t kNodeCapacity>
+inline bool btree_map<Key, Value, Compare, Allocator, kNodeCapacity>::UnitTest()
+{
+	// Enough keys for a tree of three levels
+	const size_t keyCount = kNodeCapacity * kNodeCapacity * 2;
+
+	//---------------------------------------------------------------
+	// Insert out of order, every other key
+	//---------------------------------------------------------------
+	btree_map testMap;
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		const size_t key = (i * 7919) % keyCount;
+		if (!testMap.insert(static_cast<Key>(key * 2), static_cast<Value>(key)).second)
+			RETURN_ERROR("btree_map::insert()");
+	}
+
+	if (testMap.size() != keyCount || testMap.insert(static_cast<Key>(0), static_cast<Value>(1)).second || testMap.GetHeight() < 3)
+		RETURN_ERROR("btree_map::insert() duplicate");
+
+	//---------------------------------------------------------------
+	// Lookup
+	//---------------------------------------------------------------
+	for (size_t i = 0; i < keyCount; ++i)
+	{
+		const Key key = static_cast<Key>(i * 2);
+		if (testMap.Search(key) != static_cast<Value>(i) || testMap.contains(static_cast<Key>(i * 2 + 1)))
+			RETURN_ERROR("btree_map::find()");
+
+		auto lowerIt = testMap.lower_bound(static_cast<Key>(i * 2 + 1));
+		auto upperIt = testMap.upper_bound(key);
+		if (i + 1 < keyCount && (lowerIt.key() != static_cast<Key>(i * 2 + 2) || !(lowerIt == upperIt)))
+			RETURN_ERROR("btree_map::lower_bound() / upper_bound()");
+	}
+
+	//---------------------------------------------------------------
+	// Iterate both ways
+	//---------------------------------------------------------------
+	size_t expected = 0;
+	for (auto [key, value] : testMap)
+	{
+		if (key != static_cast<Key>(expected * 2) || value != static_cast<Value>(expected))
+			RETURN_ERROR("btree_map iteration");
+		++expected;
+	}
+
+	for (auto it = testMap.end(); it != testMap.begin();)
+	{
+		--it;
+		if (it->first != static_cast<Key>(--expected * 2))
+			RETURN_ERROR("btree_map reverse iteration");
+	}
+
+	expected = kNodeCapacity;
+	testMap.ForEachInRange(static_cast<Key>(kNodeCapacity * 2 - 1), static_cast<Key>(keyCount), [&expected](const Key& key, const Value&)
+	{
+		expected += (key == static_cast<Key>(expected * 2));
+	});
+	if (expected != keyCount / 2)
+		RETURN_ERROR("btree_map::ForEachInRange()");
+
+	//---------------------------------------------------------------
+	// Erase keys, then a range, then the rest
+	//---------------------------------------------------------------
+	for (size_t i = 0; i < keyCount; i += 3)
+	{
+		if (testMap.erase(static_cast<Key>(i * 2)) != 1)
+			RETURN_ERROR("btree_map::erase(key)");
+	}
+
+	const size_t erasedCount = (keyCount + 2) / 3;
+	if (testMap.size() != keyCount - erasedCount || testMap.contains(static_cast<Key>(0)) || !testMap.contains(static_cast<Key>(2)))
+		RETURN_ERROR("btree_map::erase(key) size");
+
+	auto rangeIt = testMap.erase(testMap.lower_bound(static_cast<Key>(keyCount / 2)), testMap.lower_bound(static_cast<Key>(keyCount)));
+	if (rangeIt == testMap.end() || rangeIt.key() < static_cast<Key>(keyCount) || testMap.lower_bound(static_cast<Key>(keyCount / 2)) != rangeIt)
+		RETURN_ERROR("btree_map::erase(range)");
+
+	Key previousKey = testMap.begin().key();
+	for (auto it = ++testMap.begin(); it != testMap.end(); ++it)
+	{
+		if (!(previousKey < it.key()))
+			RETURN_ERROR("btree_map order after erase");
+		previousKey = it.key();
+	}
+
+	testMap.erase(testMap.begin(), testMap.end());
+	if (!testMap.empty() || testMap.GetHeight() != 0 || testMap.begin() != testMap.end())
+		RETURN_ERROR("btree_map::erase(all)");
+
+	//---------------------------------------------------------------
+	// Non trivial keys, custom order
+	//---------------------------------------------------------------
+	// "999" is the greatest of "0" to "999"
+	const size_t stringCount = 1000;
+	btree_map<std::string, size_t, std::greater<>> stringMap;
+	for (size_t i = 0; i < stringCount; ++i)
+		stringMap[std::to_string(i)] = i;
+
+	btree_map<std::string, size_t, std::greater<>> movedMap(std::move(stringMap));
+	if (!stringMap.empty() || movedMap.size() != stringCount || movedMap.begin().key() != "999" || movedMap.Search("42") != 42u)
+		RETURN_ERROR("btree_map<std::string>");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+
+}
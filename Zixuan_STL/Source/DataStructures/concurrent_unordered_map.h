@@ -0,0 +1,343 @@
+#pragma once
+
+#include "unordered_map.h"
+
+#include <assert.h>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// Thread safe hash map, sharded into independently locked unordered_maps
+//  - The top bits of the hash pick the shard, the inner map uses the low bits, so shards stay evenly loaded
+//  - Every shard has its own reader writer lock and sits on its own cache line, threads working on different
+//    shards never touch the same lock
+//  - Lookups take the shard lock shared and use unordered_map::Peek(), so readers never block each other
+//  - Nothing hands out iterators or references, values are copied out while the shard is locked
+//  - The shards and every shard's tables come from Allocator, which must be safe to use from any thread
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher = hash<Key>, typename KeyEqual = std::equal_to<>, typename Allocator = allocator<std::pair<const Key, Type>>>
+class concurrent_unordered_map
+{
+public:
+	using MapType = unordered_map<Key, Type, Hasher, KeyEqual, Allocator>;
+	using ValueType = typename MapType::ValueType;
+
+	static constexpr size_t kDefaultShardCount = 64;
+	static constexpr size_t kCacheLineSize = 64;
+
+private:
+	struct alignas(kCacheLineSize) Shard
+	{
+		mutable std::shared_mutex m_mutex;
+		MapType m_map;
+
+		explicit Shard(const Allocator& alloc) : m_map(alloc) {}
+	};
+
+	using ShardAllocator = rebind_allocator_t<Allocator, Shard>;
+
+	ShardAllocator m_shardAllocator;
+	Shard* m_pShards;
+	size_t m_shardCount;		// Always a power of two
+	size_t m_shardShift;		// hash >> m_shardShift is the shard index
+	Hasher m_hasher;
+
+public:
+	// Member functions
+	concurrent_unordered_map(size_t shardCount = kDefaultShardCount, const Allocator& alloc = Allocator());
+	concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+	concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+	~concurrent_unordered_map();
+
+	// Capacity, only a snapshot while other threads are writing
+	bool empty() const { return size() == 0; }
+	size_t size() const;
+	size_t shard_count() const { return m_shardCount; }
+
+	// Modifiers
+	void clear();
+	bool insert(const Key& key, const Type& data);
+	bool insert_or_assign(const Key& key, const Type& data);
+	size_t erase(const Key& key) { return InternalErase(key); }
+	template <class K, class H = Hasher, class = typename H::is_transparent> size_t erase(const K& key) { return InternalErase(key); }
+	template <class Predicate> size_t erase_if(Predicate predicate);
+	void reserve(size_t count);
+
+	// Lookup, returns a copy of the value
+	std::optional<Type> find(const Key& key) const { return InternalFind(key); }
+	template <class K, class H = Hasher, class = typename H::is_transparent> std::optional<Type> find(const K& key) const { return InternalFind(key); }
+	bool contains(const Key& key) const { return InternalContains(key); }
+	template <class K, class H = Hasher, class = typename H::is_transparent> bool contains(const K& key) const { return InternalContains(key); }
+
+	// Additional stuff
+	template <class Function> void ForEach(Function&& function) const;
+
+	// Testings
+	static bool UnitTest();
+
+private:
+	template <class K> Shard& GetShard(const K& key) const { return m_pShards[m_hasher(key) >> m_shardShift]; }
+	template <class K> std::optional<Type> InternalFind(const K& key) const;
+	template <class K> bool InternalContains(const K& key) const;
+	template <class K> size_t InternalErase(const K& key);
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ctor, shard count is rounded up to a power of two. More shards means less contention but more memory.
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::concurrent_unordered_map(size_t shardCount /*= kDefaultShardCount*/, const Allocator& alloc /*= Allocator()*/)
+	: m_shardAllocator(alloc)
+	, m_pShards{ nullptr }
+	, m_shardCount{ std::bit_ceil(shardCount > 0 ? shardCount : 1) }
+	, m_shardShift{ 0 }
+	, m_hasher{}
+{
+	// With a single shard the shift would be the full width of size_t, which is undefined, use two instead
+	if (m_shardCount == 1)
+		m_shardCount = 2;
+
+	m_shardShift = sizeof(size_t) * 8 - std::countr_zero(m_shardCount);
+	m_pShards = std::to_address(std::allocator_traits<ShardAllocator>::allocate(m_shardAllocator, m_shardCount));
+	for (size_t i = 0; i < m_shardCount; ++i)
+		new(m_pShards + i) Shard(alloc);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dtor, no other thread may still be using the map
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::~concurrent_unordered_map()
+{
+	std::destroy_n(m_pShards, m_shardCount);
+	std::allocator_traits<ShardAllocator>::deallocate(m_shardAllocator, m_pShards, m_shardCount);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Sum of every shard's size
+// Time:  O(s), s = shard count
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::size() const
+{
+	size_t size = 0;
+	for (size_t i = 0; i < m_shardCount; ++i)
+	{
+		std::shared_lock lock(m_pShards[i].m_mutex);
+		size += m_pShards[i].m_map.size();
+	}
+	return size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Clear every shard, one at a time
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::clear()
+{
+	for (size_t i = 0; i < m_shardCount; ++i)
+	{
+		std::unique_lock lock(m_pShards[i].m_mutex);
+		m_pShards[i].m_map.clear();
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert if the key doesn't exist, return true if inserted
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline bool concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::insert(const Key& key, const Type& data)
+{
+	Shard& shard = GetShard(key);
+	std::unique_lock lock(shard.m_mutex);
+	return shard.m_map.insert(key, data).second;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert, or overwrite the value if the key exists. Return true if inserted
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline bool concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::insert_or_assign(const Key& key, const Type& data)
+{
+	Shard& shard = GetShard(key);
+	std::unique_lock lock(shard.m_mutex);
+	return shard.m_map.insert_or_assign(key, data).second;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase every element which satisfies predicate(const ValueType&), return how many elements are erased.
+// Shards are visited one at a time, the others stay available to other threads.
+// Time:  O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class Predicate>
+inline size_t concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::erase_if(Predicate predicate)
+{
+	size_t erasedCount = 0;
+	for (size_t i = 0; i < m_shardCount; ++i)
+	{
+		std::unique_lock lock(m_pShards[i].m_mutex);
+		MapType& map = m_pShards[i].m_map;
+
+		// Erasing a slot doesn't move any other element, the iterator stays valid
+		for (typename MapType::iterator itr = map.begin(); itr != map.end(); ++itr)
+		{
+			if (predicate(static_cast<const ValueType&>(*itr)))
+			{
+				map.erase(itr);
+				++erasedCount;
+			}
+		}
+	}
+
+	return erasedCount;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Reserve room for count elements in total, assuming keys spread evenly over the shards
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::reserve(size_t count)
+{
+	const size_t countPerShard = (count + m_shardCount - 1) / m_shardCount;
+	for (size_t i = 0; i < m_shardCount; ++i)
+	{
+		std::unique_lock lock(m_pShards[i].m_mutex);
+		m_pShards[i].m_map.reserve(countPerShard);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call function(const ValueType&) on every element, each shard is locked shared while it's visited
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class Function>
+inline void concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::ForEach(Function&& function) const
+{
+	for (size_t i = 0; i < m_shardCount; ++i)
+	{
+		std::shared_lock lock(m_pShards[i].m_mutex);
+		m_pShards[i].m_map.ForEach(function);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Copy the value out under a shared lock
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class K>
+inline std::optional<Type> concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::InternalFind(const K& key) const
+{
+	const Shard& shard = GetShard(key);
+	std::shared_lock lock(shard.m_mutex);
+	const ValueType* pValue = shard.m_map.Peek(key);
+	if (pValue == nullptr)
+		return std::nullopt;
+	return pValue->second;
+}
+
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class K>
+inline bool concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::InternalContains(const K& key) const
+{
+	const Shard& shard = GetShard(key);
+	std::shared_lock lock(shard.m_mutex);
+	return shard.m_map.Peek(key) != nullptr;
+}
+
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class K>
+inline size_t concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::InternalErase(const K& key)
+{
+	Shard& shard = GetShard(key);
+	std::unique_lock lock(shard.m_mutex);
+	return shard.m_map.erase(key);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unit Test for concurrent_unordered_map, every thread works on its own key range and they all share the map
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline bool concurrent_unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::UnitTest()
+{
+	static constexpr size_t kThreadCount = 4;
+	static constexpr size_t kCountPerThread = 5000;
+
+	concurrent_unordered_map testMap;
+	std::vector<std::thread> threads;
+	std::vector<size_t> failures(kThreadCount, 0);
+
+	//---------------------------------------------------------------
+	// Insert, find and erase concurrently
+	//---------------------------------------------------------------
+	for (size_t threadIndex = 0; threadIndex < kThreadCount; ++threadIndex)
+	{
+		threads.emplace_back([&testMap, &failures, threadIndex]()
+		{
+			const size_t first = threadIndex * kCountPerThread;
+			for (size_t i = first; i < first + kCountPerThread; ++i)
+			{
+				if (!testMap.insert_or_assign(static_cast<Key>(i), static_cast<Type>(i)))
+					++failures[threadIndex];
+			}
+
+			for (size_t i = first; i < first + kCountPerThread; ++i)
+			{
+				const std::optional<Type> value = testMap.find(static_cast<Key>(i));
+				if (!value || *value != static_cast<Type>(i))
+					++failures[threadIndex];
+			}
+
+			// Erase one third of the own range
+			for (size_t i = first; i < first + kCountPerThread; i += 3)
+			{
+				if (testMap.erase(static_cast<Key>(i)) != 1)
+					++failures[threadIndex];
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	for (size_t failure : failures)
+	{
+		if (failure != 0)
+			RETURN_ERROR("concurrent_unordered_map::insert_or_assign() / find() / erase()");
+	}
+
+	const size_t expectedSize = kThreadCount * (kCountPerThread - (kCountPerThread + 2) / 3);
+	if (testMap.size() != expectedSize)
+		RETURN_ERROR("concurrent_unordered_map::size()");
+
+	//---------------------------------------------------------------
+	// erase_if
+	//---------------------------------------------------------------
+	const size_t erasedCount = testMap.erase_if([](const ValueType& pair) { return static_cast<size_t>(pair.first) % 2 == 0; });
+
+	size_t oddCount = 0;
+	testMap.ForEach([&oddCount](const ValueType& pair)
+	{
+		if (static_cast<size_t>(pair.first) % 2 != 0)
+			++oddCount;
+	});
+
+	if (oddCount != testMap.size() || erasedCount + oddCount != expectedSize)
+		RETURN_ERROR("concurrent_unordered_map::erase_if()");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// Building blocks of the hash functors, based on wyhash (final version 4)
+//--------------------------------------------------------------------------------------------------------------------
+namespace hash_detail
+{
+	static constexpr uint64_t kSecret[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// 64 x 64 -> 128 bit multiply, low half goes to a, high half goes to b
+	//--------------------------------------------------------------------------------------------------------------------
+	inline void Mum(uint64_t& a, uint64_t& b)
+	{
+#if defined(__SIZEOF_INT128__)
+		const __uint128_t result = static_cast<__uint128_t>(a) * b;
+		a = static_cast<uint64_t>(result);
+		b = static_cast<uint64_t>(result >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		a = _umul128(a, b, &b);
+#else
+		// Schoolbook multiply with 32 bit halves
+		const uint64_t aHigh = a >> 32, aLow = static_cast<uint32_t>(a);
+		const uint64_t bHigh = b >> 32, bLow = static_cast<uint32_t>(b);
+		const uint64_t highHigh = aHigh * bHigh, highLow = aHigh * bLow;
+		const uint64_t lowHigh = aLow * bHigh, lowLow = aLow * bLow;
+		const uint64_t middle = (lowLow >> 32) + static_cast<uint32_t>(highLow) + static_cast<uint32_t>(lowHigh);
+		a = (middle << 32) | static_cast<uint32_t>(lowLow);
+		b = highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+#endif
+	}
+
+	inline uint64_t Mix(uint64_t a, uint64_t b)
+	{
+		Mum(a, b);
+		return a ^ b;
+	}
+
+	inline uint64_t Read8(const uint8_t* pData) { uint64_t value; std::memcpy(&value, pData, 8); return value; }
+	inline uint64_t Read4(const uint8_t* pData) { uint32_t value; std::memcpy(&value, pData, 4); return value; }
+	inline uint64_t Read3(const uint8_t* pData, size_t length) { return (static_cast<uint64_t>(pData[0]) << 16) | (static_cast<uint64_t>(pData[length >> 1]) << 8) | pData[length - 1]; }
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Hash a byte string. Reads 48 bytes per loop with three independent lanes
+	// Time:  O(n), n = length
+	//--------------------------------------------------------------------------------------------------------------------
+	inline uint64_t HashBytes(const void* pKey, size_t length, uint64_t seed = 0)
+	{
+		const uint8_t* pData = static_cast<const uint8_t*>(pKey);
+		seed ^= Mix(seed ^ kSecret[0], kSecret[1]);
+
+		uint64_t a = 0;
+		uint64_t b = 0;
+		if (length <= 16)
+		{
+			if (length >= 4)
+			{
+				a = (Read4(pData) << 32) | Read4(pData + ((length >> 3) << 2));
+				b = (Read4(pData + length - 4) << 32) | Read4(pData + length - 4 - ((length >> 3) << 2));
+			}
+			else if (length > 0)
+			{
+				a = Read3(pData, length);
+			}
+		}
+		else
+		{
+			size_t remaining = length;
+			if (remaining > 48)
+			{
+				uint64_t seed1 = seed;
+				uint64_t seed2 = seed;
+				do
+				{
+					seed = Mix(Read8(pData) ^ kSecret[1], Read8(pData + 8) ^ seed);
+					seed1 = Mix(Read8(pData + 16) ^ kSecret[2], Read8(pData + 24) ^ seed1);
+					seed2 = Mix(Read8(pData + 32) ^ kSecret[3], Read8(pData + 40) ^ seed2);
+					pData += 48;
+					remaining -= 48;
+				} while (remaining > 48);
+				seed ^= seed1 ^ seed2;
+			}
+
+			while (remaining > 16)
+			{
+				seed = Mix(Read8(pData) ^ kSecret[1], Read8(pData + 8) ^ seed);
+				pData += 16;
+				remaining -= 16;
+			}
+
+			// The last 16 bytes, may overlap with what's already been read
+			a = Read8(pData + remaining - 16);
+			b = Read8(pData + remaining - 8);
+		}
+
+		a ^= kSecret[1];
+		b ^= seed;
+		Mum(a, b);
+		return Mix(a ^ kSecret[0] ^ length, b ^ kSecret[1]);
+	}
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Scramble every bit of an integer into every other bit, so keys like 0, 16, 32... don't pile up in the same group
+	//--------------------------------------------------------------------------------------------------------------------
+	inline uint64_t MixInteger(uint64_t key)
+	{
+		return Mix(key ^ kSecret[0], kSecret[1]);
+	}
+
+	// size_t is 32 bits on Win32, keep the high half by folding it in
+	inline size_t Fold(uint64_t hash) { return static_cast<size_t>(hash ^ (hash >> 32)); }
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Combine a hash into seed, used to build hashes of composite keys
+//--------------------------------------------------------------------------------------------------------------------
+inline size_t HashCombine(size_t seed, size_t hash)
+{
+	return hash_detail::Fold(hash_detail::Mix(static_cast<uint64_t>(seed) ^ hash_detail::kSecret[2], static_cast<uint64_t>(hash) ^ hash_detail::kSecret[3]));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Default hash functor of zxstl containers
+//  - Integers, enums and pointers are mixed
+//  - Anything else goes through std::hash first, then gets mixed, so weak hashes (like identity) still spread well
+// Specialize it for your own composite types, HashCombine() helps.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class = void>
+struct hash
+{
+	size_t operator()(const Type& key) const
+	{
+		return hash_detail::Fold(hash_detail::MixInteger(static_cast<uint64_t>(std::hash<Type>{}(key))));
+	}
+};
+
+template<class Type>
+struct hash<Type, std::enable_if_t<std::is_integral_v<Type> || std::is_enum_v<Type>>>
+{
+	size_t operator()(Type key) const
+	{
+		return hash_detail::Fold(hash_detail::MixInteger(static_cast<uint64_t>(key)));
+	}
+};
+
+template<class Type>
+struct hash<Type*>
+{
+	size_t operator()(const Type* pKey) const
+	{
+		return hash_detail::Fold(hash_detail::MixInteger(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pKey))));
+	}
+};
+
+template<class Type>
+struct hash<Type, std::enable_if_t<std::is_floating_point_v<Type>>>
+{
+	// The x87 80 bit long double (64 bit mantissa) sits in 12 or 16 bytes, the bytes after the first 10 are padding
+	// with any value. Every other format uses all of its bytes.
+	static constexpr size_t kSignificantBytes = (std::numeric_limits<Type>::digits == 64) ? 10 : sizeof(Type);
+
+	size_t operator()(Type key) const
+	{
+		// 0.0 and -0.0 are equal, so they must hash the same
+		if (key == static_cast<Type>(0))
+			key = static_cast<Type>(0);
+		return hash_detail::Fold(hash_detail::HashBytes(&key, kSignificantBytes));
+	}
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// String hash. It's transparent, so a map keyed by std::string can be probed with a std::string_view or a
+// string literal without constructing a std::string
+//--------------------------------------------------------------------------------------------------------------------
+struct string_hash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view key) const
+	{
+		return hash_detail::Fold(hash_detail::HashBytes(key.data(), key.size()));
+	}
+};
+
+template<> struct hash<std::string> : string_hash {};
+template<> struct hash<std::string_view> : string_hash {};
+
+template<class First, class Second>
+struct hash<std::pair<First, Second>>
+{
+	size_t operator()(const std::pair<First, Second>& key) const
+	{
+		return HashCombine(hash<First>{}(key.first), hash<Second>{}(key.second));
+	}
+};
+
+}
@@ -0,0 +1,430 @@
+#pragma once
+
+#include "Tests/StructureManager.h"
+
+#include <assert.h>
+#include <iterator>
+#include <utility>
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// The links an object embeds to live in an intrusive_list, derive from it.
+// Derive once per Tag to be in several lists at the same time, e.g. an LRU list and a work queue.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Tag = void>
+class intrusive_list_hook
+{
+	template<class Type, class ListTag> friend class intrusive_list;
+
+	intrusive_list_hook* m_pNext;
+	intrusive_list_hook* m_pPrev;
+
+public:
+	intrusive_list_hook() : m_pNext{ nullptr }, m_pPrev{ nullptr } {}
+
+	// Links belong to the list, a copy starts unlinked
+	intrusive_list_hook(const intrusive_list_hook&) : intrusive_list_hook() {}
+	intrusive_list_hook& operator=(const intrusive_list_hook&) { return *this; }
+
+	// Erase an object from its list before it dies
+	~intrusive_list_hook() { assert(!IsLinked()); }
+
+	bool IsLinked() const { return m_pNext != nullptr; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// Doubly linked list over objects that derive from intrusive_list_hook<Tag>.
+// The list never allocates or owns anything, the caller keeps the objects alive while they are linked.
+// Circular around a sentinel hook, so every link / unlink is branch free and O(1), including erasing an object
+// without knowing where it is in the list.
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag = void>
+class intrusive_list
+{
+private:
+	using Hook = intrusive_list_hook<Tag>;
+
+	Hook m_sentinel;	// m_pNext is the front, m_pPrev is the back
+	size_t m_size;
+
+public:
+	template<class ValueType>
+	class Iterator
+	{
+		friend class intrusive_list;
+
+		Hook* m_pHook;
+
+		explicit Iterator(Hook* pHook) : m_pHook{ pHook } {}
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = Type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+
+		Iterator() : m_pHook{ nullptr } {}
+
+		reference operator*() const { return static_cast<reference>(*m_pHook); }
+		pointer operator->() const { return &**this; }
+		Iterator& operator++() { m_pHook = m_pHook->m_pNext; return *this; }
+		Iterator operator++(int) { Iterator copy = *this; ++*this; return copy; }
+		Iterator& operator--() { m_pHook = m_pHook->m_pPrev; return *this; }
+		Iterator operator--(int) { Iterator copy = *this; --*this; return copy; }
+		bool operator==(const Iterator& other) const { return m_pHook == other.m_pHook; }
+	};
+
+	using iterator = Iterator<Type>;
+	using const_iterator = Iterator<const Type>;
+
+	// Member functions
+	intrusive_list();
+	intrusive_list(const intrusive_list&) = delete;
+	intrusive_list(intrusive_list&& other) noexcept;
+	intrusive_list& operator=(const intrusive_list&) = delete;
+	intrusive_list& operator=(intrusive_list&& other) noexcept;
+	~intrusive_list();
+
+	// Element access
+	Type& front() { assert(!Empty()); return Get(m_sentinel.m_pNext); }
+	const Type& front() const { assert(!Empty()); return Get(m_sentinel.m_pNext); }
+	Type& back() { assert(!Empty()); return Get(m_sentinel.m_pPrev); }
+	const Type& back() const { assert(!Empty()); return Get(m_sentinel.m_pPrev); }
+
+	// Iterators
+	iterator begin() { return iterator(m_sentinel.m_pNext); }
+	iterator end() { return iterator(&m_sentinel); }
+	const_iterator begin() const { return const_iterator(m_sentinel.m_pNext); }
+	const_iterator end() const { return const_iterator(const_cast<Hook*>(&m_sentinel)); }
+	iterator IteratorTo(Type& object) { assert(AsHook(object).IsLinked()); return iterator(&AsHook(object)); }
+
+	// Modifiers
+	void PushFront(Type& object) { LinkBefore(m_sentinel.m_pNext, AsHook(object)); }
+	void PushBack(Type& object) { LinkBefore(&m_sentinel, AsHook(object)); }
+	iterator Insert(iterator position, Type& object);
+	Type& PopFront();
+	Type& PopBack();
+	iterator Erase(Type& object);
+	iterator Erase(iterator position) { return Erase(*position); }
+	void MoveToFront(Type& object);
+	void MoveToBack(Type& object);
+	void Splice(iterator position, intrusive_list& other);
+	void SpliceFront(intrusive_list& other) { Splice(begin(), other); }
+	void SpliceBack(intrusive_list& other) { Splice(end(), other); }
+	void Clear();
+
+	// API
+	bool Empty() const { return m_size == 0; }
+	size_t GetSize() const { return m_size; }
+
+	// Tests
+	static bool UnitTest();
+
+private:
+	static Hook& AsHook(Type& object) { return static_cast<Hook&>(object); }
+	static Type& Get(Hook* pHook) { return static_cast<Type&>(*pHook); }
+	static const Type& Get(const Hook* pHook) { return static_cast<const Type&>(*pHook); }
+
+	void LinkBefore(Hook* pNext, Hook& hook);
+	void Unlink(Hook& hook);
+	void TakeOver(intrusive_list& other);
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// Default ctor, an empty list is the sentinel linked to itself
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline intrusive_list<Type, Tag>::intrusive_list()
+	: m_size{ 0 }
+{
+	m_sentinel.m_pNext = &m_sentinel;
+	m_sentinel.m_pPrev = &m_sentinel;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move ctor
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline intrusive_list<Type, Tag>::intrusive_list(intrusive_list&& other) noexcept
+	: intrusive_list()
+{
+	TakeOver(other);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move assignment, the objects linked to this list are unlinked
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline intrusive_list<Type, Tag>& intrusive_list<Type, Tag>::operator=(intrusive_list&& other) noexcept
+{
+	if (this != &other)
+	{
+		Clear();
+		TakeOver(other);
+	}
+
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Dtor, unlink every object and the sentinel itself
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline intrusive_list<Type, Tag>::~intrusive_list()
+{
+	Clear();
+	m_sentinel.m_pNext = nullptr;
+	m_sentinel.m_pPrev = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Link object in front of position, return the iterator to it
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline typename intrusive_list<Type, Tag>::iterator intrusive_list<Type, Tag>::Insert(iterator position, Type& object)
+{
+	LinkBefore(position.m_pHook, AsHook(object));
+	return iterator(&AsHook(object));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink the first object and return it
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline Type& intrusive_list<Type, Tag>::PopFront()
+{
+	// Underflow checking
+	assert(!Empty());
+
+	Hook& front = *m_sentinel.m_pNext;
+	Unlink(front);
+	return Get(&front);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink the last object and return it
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline Type& intrusive_list<Type, Tag>::PopBack()
+{
+	// Underflow checking
+	assert(!Empty());
+
+	Hook& back = *m_sentinel.m_pPrev;
+	Unlink(back);
+	return Get(&back);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink object from this list wherever it is, return the iterator to the object after it
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline typename intrusive_list<Type, Tag>::iterator intrusive_list<Type, Tag>::Erase(Type& object)
+{
+	Hook& hook = AsHook(object);
+	Hook* pNext = hook.m_pNext;
+	Unlink(hook);
+	return iterator(pNext);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Relink an object of this list to the front, the "touch" of an LRU
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline void intrusive_list<Type, Tag>::MoveToFront(Type& object)
+{
+	Unlink(AsHook(object));
+	PushFront(object);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Relink an object of this list to the back
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline void intrusive_list<Type, Tag>::MoveToBack(Type& object)
+{
+	Unlink(AsHook(object));
+	PushBack(object);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move every object of other in front of position, other ends up empty
+// Time:  O(1)
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline void intrusive_list<Type, Tag>::Splice(iterator position, intrusive_list& other)
+{
+	if (&other == this || other.Empty())
+		return;
+
+	Hook* pFirst = other.m_sentinel.m_pNext;
+	Hook* pLast = other.m_sentinel.m_pPrev;
+	Hook* pNext = position.m_pHook;
+	Hook* pPrev = pNext->m_pPrev;
+
+	// Relink the whole chain between pPrev and pNext
+	pPrev->m_pNext = pFirst;
+	pFirst->m_pPrev = pPrev;
+	pLast->m_pNext = pNext;
+	pNext->m_pPrev = pLast;
+	m_size += other.m_size;
+
+	// Reset other
+	other.m_sentinel.m_pNext = &other.m_sentinel;
+	other.m_sentinel.m_pPrev = &other.m_sentinel;
+	other.m_size = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink every object, the objects themselves are untouched
+// Time: O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline void intrusive_list<Type, Tag>::Clear()
+{
+	Hook* pCurrent = m_sentinel.m_pNext;
+	while (pCurrent != &m_sentinel)
+	{
+		Hook* pNext = pCurrent->m_pNext;
+		pCurrent->m_pNext = nullptr;
+		pCurrent->m_pPrev = nullptr;
+		pCurrent = pNext;
+	}
+
+	m_sentinel.m_pNext = &m_sentinel;
+	m_sentinel.m_pPrev = &m_sentinel;
+	m_size = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Link hook in front of pNext
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline void intrusive_list<Type, Tag>::LinkBefore(Hook* pNext, Hook& hook)
+{
+	// An object can only be in one list per hook
+	assert(!hook.IsLinked());
+
+	Hook* pPrev = pNext->m_pPrev;
+	hook.m_pNext = pNext;
+	hook.m_pPrev = pPrev;
+	pPrev->m_pNext = &hook;
+	pNext->m_pPrev = &hook;
+	++m_size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink hook from its neighbours and mark it unlinked
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline void intrusive_list<Type, Tag>::Unlink(Hook& hook)
+{
+	assert(hook.IsLinked() && &hook != &m_sentinel);
+
+	hook.m_pPrev->m_pNext = hook.m_pNext;
+	hook.m_pNext->m_pPrev = hook.m_pPrev;
+	hook.m_pNext = nullptr;
+	hook.m_pPrev = nullptr;
+	--m_size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Take other's chain into this empty list, the neighbours of the sentinel have to point to our sentinel now
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline void intrusive_list<Type, Tag>::TakeOver(intrusive_list& other)
+{
+	assert(Empty());
+	Splice(end(), other);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unit Test for intrusive_list
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Tag>
+inline bool intrusive_list<Type, Tag>::UnitTest()
+{
+	// An object that is in an LRU list and a work queue at the same time
+	struct LruTag {};
+	struct QueueTag {};
+	struct Entry : public intrusive_list_hook<LruTag>, public intrusive_list_hook<QueueTag>
+	{
+		size_t m_value = 0;
+	};
+
+	Entry entries[kTestSize];
+	for (size_t i = 0; i < kTestSize; ++i)
+		entries[i].m_value = i;
+
+	//---------------------------------------------------------------
+	// Push, pop and order
+	//---------------------------------------------------------------
+	intrusive_list<Entry, LruTag> lru;
+	intrusive_list<Entry, QueueTag> queue;
+	for (size_t i = 0; i < kTestSize; ++i)
+	{
+		lru.PushFront(entries[i]);
+		queue.PushBack(entries[i]);
+	}
+
+	if (lru.GetSize() != kTestSize || queue.GetSize() != kTestSize)
+		RETURN_ERROR("intrusive_list::GetSize()");
+	if (lru.front().m_value != kTestSize - 1 || lru.back().m_value != 0 || queue.front().m_value != 0)
+		RETURN_ERROR("intrusive_list::PushFront() / PushBack()");
+
+	size_t expected = 0;
+	for (const Entry& entry : queue)
+	{
+		if (entry.m_value != expected++)
+			RETURN_ERROR("intrusive_list iteration");
+	}
+
+	//---------------------------------------------------------------
+	// Touch and evict like an LRU, the queue doesn't notice
+	//---------------------------------------------------------------
+	lru.MoveToFront(entries[0]);
+	Entry& evicted = lru.PopBack();
+	if (lru.front().m_value != 0 || evicted.m_value != 1 || lru.GetSize() != kTestSize - 1 || queue.GetSize() != kTestSize)
+		RETURN_ERROR("intrusive_list::MoveToFront() / PopBack()");
+
+	queue.Erase(entries[kTestSize / 2]);
+	if (queue.GetSize() != kTestSize - 1 || static_cast<intrusive_list_hook<QueueTag>&>(entries[kTestSize / 2]).IsLinked())
+		RETURN_ERROR("intrusive_list::Erase()");
+
+	//---------------------------------------------------------------
+	// Splice and move
+	//---------------------------------------------------------------
+	intrusive_list<Entry, QueueTag> otherQueue;
+	otherQueue.PushBack(entries[kTestSize / 2]);
+	queue.SpliceFront(otherQueue);
+	if (!otherQueue.Empty() || queue.GetSize() != kTestSize || queue.front().m_value != kTestSize / 2)
+		RETURN_ERROR("intrusive_list::SpliceFront()");
+
+	intrusive_list<Entry, QueueTag> movedQueue(std::move(queue));
+	if (!queue.Empty() || movedQueue.GetSize() != kTestSize || (--movedQueue.end())->m_value != kTestSize - 1)
+		RETURN_ERROR("intrusive_list move");
+
+	//---------------------------------------------------------------
+	// Clear unlinks, so the entries can die
+	//---------------------------------------------------------------
+	lru.Clear();
+	movedQueue.Clear();
+	if (!lru.Empty() || !movedQueue.Empty())
+		RETURN_ERROR("intrusive_list::Clear()");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+
+}
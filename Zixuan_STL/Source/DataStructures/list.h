@@ -2,18 +2,23 @@
 
 #include <iostream>
 #include <assert.h>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
 #include <utility>
 
+#include "allocator.h"
+
 namespace zxstl
 {
 // 0 = singly linkedlist
 // 1 = doubly linkedlist
-#define DOUBLY_LINKED 0
+#define DOUBLY_LINKED 1
 
 //--------------------------------------------------------------------------------------------------------------------
 // LinkedList class
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type> 
+template<class Type, class Allocator = allocator<Type>>
 class list
 {
 private:
@@ -46,13 +51,25 @@ private:
 		Type GetValue() const { return m_value; }
 	};
 
+	// What a node turns into once its value is destroyed and it's parked in the node pool
+	struct FreeNode
+	{
+		FreeNode* m_pNext;
+	};
+
+	using NodeAllocator = rebind_allocator_t<Allocator, Node>;
+
 	Node* m_pHead;
 	Node* m_pTail;	// A slight hack for making inserting O(n/2) in worst case
 	size_t m_size;
+	NodeAllocator m_nodeAllocator;	// Every node comes from here
+	FreeNode* m_pFreeNodes;			// Node pool, popped nodes wait here for the next push instead of going back to the allocator
+	size_t m_freeNodeCount;
 	
 public:
 	// Member functions
 	list();
+	explicit list(const Allocator& alloc);
 	~list();
 
 	// Element access
@@ -61,8 +78,56 @@ public:
 	constexpr Type& back() { return m_pTail->m_value; }
 	constexpr const Type& back() const { return m_pTail->m_value; }
 
-	// Iterators
-	// TODO
+	// Iterators, bidirectional. Stepping back is O(n) if singly linked.
+	template<class ValueType>
+	class Iterator
+	{
+		friend class list;
+		template<class> friend class Iterator;
+
+		Node* m_pNode;			// nullptr is end()
+		const list* m_pList;	// Stepping back from end() starts at the tail
+
+		Iterator(Node* pNode, const list* pList) : m_pNode{ pNode }, m_pList{ pList } {}
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = Type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+
+		Iterator() : Iterator(nullptr, nullptr) {}
+
+		// iterator converts to const_iterator
+		operator Iterator<const Type>() const { return Iterator<const Type>(m_pNode, m_pList); }
+
+		reference operator*() const { return m_pNode->m_value; }
+		pointer operator->() const { return &m_pNode->m_value; }
+		Iterator& operator++() { m_pNode = m_pNode->m_pNext; return *this; }
+		Iterator operator++(int) { Iterator copy = *this; ++*this; return copy; }
+		Iterator& operator--() { m_pNode = m_pNode ? m_pList->GetPrevious(m_pNode) : m_pList->m_pTail; return *this; }
+		Iterator operator--(int) { Iterator copy = *this; --*this; return copy; }
+		bool operator==(const Iterator& other) const { return m_pNode == other.m_pNode; }
+	};
+
+	using iterator = Iterator<Type>;
+	using const_iterator = Iterator<const Type>;
+
+	iterator begin() { return iterator(m_pHead, this); }
+	iterator end() { return iterator(nullptr, this); }
+	const_iterator begin() const { return const_iterator(m_pHead, this); }
+	const_iterator end() const { return const_iterator(nullptr, this); }
+
+	// Iterator based modifiers, O(1) if doubly linked
+	iterator Insert(const_iterator position, const Type& val);
+	iterator Erase(const_iterator position);
+	iterator Erase(const_iterator first, const_iterator last);
+	void Splice(const_iterator position, list& other);
+	void Splice(const_iterator position, list& other, const_iterator element);
+	void Splice(const_iterator position, list& other, const_iterator first, const_iterator last);
+	void SpliceFront(list& other) { Splice(begin(), other); }
+	void SpliceBack(list& other) { Splice(end(), other); }
 
 	// Capacity
 	void PushFront(const Type& val);
@@ -82,10 +147,17 @@ public:
 	Type HeadValue() const { return m_pHead->GetValue(); }
 	Type TailValue() const { return m_pTail->GetValue(); }
 	void Reverse(size_t begin = 0, size_t end = std::numeric_limits<size_t>::max());	
-	void Sort();
+	template<class Compare = std::less<>> void Sort(Compare compare = Compare());
+	template<class Function> void ForEach(Function&& function) const;
+
+	// Node pool
+	void ReserveNodes(size_t count);
+	void ShrinkNodePool();
+	size_t GetPooledNodeCount() const { return m_freeNodeCount; }
 
 	// Tests
 	static void Test();
+	static bool UnitTest();
 	
 private:
 	Node* SearchNodeByValue(const Type& val);
@@ -94,7 +166,13 @@ private:
 	std::pair<Node*, Node*> SearchPairByValue(const Type& val);	// Return the searched node and it's previous
 	std::pair<Node*, Node*> SearchPairByNode(const Node* pNode);	// Return the searched node and it's previous
 	std::pair<Node*, Node*> SearchPairByIndex(size_t index);		// Return the searched node and it's previous
+	Node* GetPrevious(const Node* pNode) const;
+
+	void LinkChainAfter(Node* pPrevious, Node* pFirst, Node* pLast, size_t count);
+	void UnlinkChain(Node* pPrevious, Node* pFirst, Node* pLast, size_t count);
 
+	Node* AcquireNode(const Type& val);
+	void RecycleNode(Node* pNode);
 	void Destroy();
 	void SetNullptrIfEmpty();
 	void Delete(Node* pNodeToDelete, Node* pPrevious);
@@ -105,32 +183,45 @@ private:
 //--------------------------------------------------------------------------------------------------------------------
 // Default ctor
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline list<Type>::list()
+template<class Type, class Allocator>
+inline list<Type, Allocator>::list()
+	: list(Allocator())
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ctor with the allocator to take nodes from
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline list<Type, Allocator>::list(const Allocator& alloc)
 	: m_pHead{ nullptr }
 	, m_pTail{ nullptr }
 	, m_size{ 0 }
+	, m_nodeAllocator(alloc)
+	, m_pFreeNodes{ nullptr }
+	, m_freeNodeCount{ 0 }
 {
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 // Default dtor
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline list<Type>::~list()
+template<class Type, class Allocator>
+inline list<Type, Allocator>::~list()
 {
 	Destroy();
+	ShrinkNodePool();
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 // Insert val to front
 // Time: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::PushFront(const Type& val)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::PushFront(const Type& val)
 {
 	// Create new node for pushing
-	Node* pNewNode = new Node(val);
+	Node* pNewNode = AcquireNode(val);
 
 	// Set this new node's next to the head
 	pNewNode->m_pNext = m_pHead;
@@ -156,11 +247,11 @@ inline void list<Type>::PushFront(const Type& val)
 // Insert val to back
 // Time: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::PushBack(const Type& val)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::PushBack(const Type& val)
 {
 	// Create new node
-	Node* pNewNode = new Node(val);
+	Node* pNewNode = AcquireNode(val);
 
 	// Set this new node's previous to tail if doubly linked
 #if DOUBLY_LINKED
@@ -186,66 +277,150 @@ inline void list<Type>::PushBack(const Type& val)
 // Insert val to the index
 // Time: O(n)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::Insert(size_t index, const Type& val)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Insert(size_t index, const Type& val)
 {
 	// Error checking
 	assert(index <= m_size);
 
-	// Create new node
-	Node* pNewNode = new Node(val);
+	Node* pPrevious = (index == 0) ? nullptr : SearchNodeByIndex(index - 1);
+	Node* pNewNode = AcquireNode(val);
+	LinkChainAfter(pPrevious, pNewNode, pNewNode, 1);
+}
 
-	// Find the previous
-	Node* pPrevious = nullptr;
+//--------------------------------------------------------------------------------------------------------------------
+// Insert val in front of position, return the iterator to it
+// Time: O(1) if doubly linked, O(n) if singly linked
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline typename list<Type, Allocator>::iterator list<Type, Allocator>::Insert(const_iterator position, const Type& val)
+{
+	Node* pNewNode = AcquireNode(val);
+	LinkChainAfter(GetPrevious(position.m_pNode), pNewNode, pNewNode, 1);
+	return iterator(pNewNode, this);
+}
 
-	// Find the place to insert
-	Node* pNext = m_pHead;
-	for (size_t i = 0; i < index; ++i)
-	{
-		pPrevious = pNext;
-		pNext = pNext->m_pNext;
-	}
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the element at position, return the iterator to the element after it
+// Time: O(1) if doubly linked, O(n) if singly linked
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline typename list<Type, Allocator>::iterator list<Type, Allocator>::Erase(const_iterator position)
+{
+	// Underflow checking
+	assert(position.m_pNode);
 
-	// Set the previous node's next to the new node
-	if (pPrevious)
-	{
-		pPrevious->m_pNext = pNewNode;
-#if DOUBLY_LINKED
-		pNewNode->m_pPrev = pPrevious;
-#endif
-	}
+	Node* pNode = position.m_pNode;
+	Node* pNext = pNode->m_pNext;
+	UnlinkChain(GetPrevious(pNode), pNode, pNode, 1);
+	RecycleNode(pNode);
 
-	// If inserting to a empty list, set head and tail
-	if (m_size == 0)
-	{
-		m_pHead = pNewNode;
-		m_pTail = pNewNode;
-	}
-	// If index is 0, also set new node as head
-	else if (index == 0)
-	{
-		m_pHead = pNewNode;
-	}
+	return iterator(pNext, this);
+}
 
-	// If it's not the end of the list
-	if (pNext)
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the elements in [first, last), return last
+// Time: O(k), k = elements erased, plus O(n) to find first's previous if singly linked
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline typename list<Type, Allocator>::iterator list<Type, Allocator>::Erase(const_iterator first, const_iterator last)
+{
+	if (first == last)
+		return iterator(last.m_pNode, this);
+
+	Node* pPrevious = GetPrevious(first.m_pNode);
+
+	// Count the chain and find its last node
+	Node* pLastErased = first.m_pNode;
+	size_t count = 1;
+	for (; pLastErased->m_pNext != last.m_pNode; pLastErased = pLastErased->m_pNext)
+		++count;
+
+	UnlinkChain(pPrevious, first.m_pNode, pLastErased, count);
+
+	Node* pCurrent = first.m_pNode;
+	while (pCurrent)
 	{
-#if DOUBLY_LINKED
-		pNext->m_pPrev = pNewNode;
-#endif
-		pNewNode->m_pNext = pNext;
+		Node* pNext = pCurrent->m_pNext;
+		RecycleNode(pCurrent);
+		pCurrent = pNext;
 	}
 
-	// Increment size
-	++m_size;
+	return iterator(last.m_pNode, this);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move every node of other in front of position, other ends up empty.
+// Nodes change owner, so both lists must use equal allocators.
+// Time:  O(1) if doubly linked or position is begin() / end()
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Splice(const_iterator position, list& other)
+{
+	assert(m_nodeAllocator == other.m_nodeAllocator);
+
+	if (&other == this || other.Empty())
+		return;
+
+	Node* pFirst = other.m_pHead;
+	Node* pLast = other.m_pTail;
+	const size_t count = other.m_size;
+
+	other.UnlinkChain(nullptr, pFirst, pLast, count);
+	LinkChainAfter(GetPrevious(position.m_pNode), pFirst, pLast, count);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move the node at element from other in front of position, other may be this list
+// Time:  O(1) if doubly linked, O(n) if singly linked
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Splice(const_iterator position, list& other, const_iterator element)
+{
+	assert(m_nodeAllocator == other.m_nodeAllocator);
+
+	Node* pNode = element.m_pNode;
+
+	// Already in place, end() of two lists look the same so compare the lists too
+	if (&other == this && (position.m_pNode == pNode || position.m_pNode == pNode->m_pNext))
+		return;
+
+	other.UnlinkChain(other.GetPrevious(pNode), pNode, pNode, 1);
+	LinkChainAfter(GetPrevious(position.m_pNode), pNode, pNode, 1);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move the nodes in [first, last) from other in front of position, other may be this list as long as position is
+// not in [first, last)
+// Time:  O(k), k = nodes moved, they have to be counted
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Splice(const_iterator position, list& other, const_iterator first, const_iterator last)
+{
+	assert(m_nodeAllocator == other.m_nodeAllocator);
+
+	if (first == last || (&other == this && position == last))
+		return;
+
+	// Count the chain and find its last node
+	Node* pLast = first.m_pNode;
+	size_t count = 1;
+	for (; pLast->m_pNext != last.m_pNode; pLast = pLast->m_pNext)
+		++count;
+
+	other.UnlinkChain(other.GetPrevious(first.m_pNode), first.m_pNode, pLast, count);
+	LinkChainAfter(GetPrevious(position.m_pNode), first.m_pNode, pLast, count);
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 // Find the value and delete it
 // Time: O(n)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::DeleteByValue(const Type& val)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::DeleteByValue(const Type& val)
 {
 	// Underflow checking
 	assert(m_size > 0);
@@ -266,8 +441,8 @@ inline void list<Type>::DeleteByValue(const Type& val)
 // Find the node and delete it
 // Time: O(n)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::DeleteByNode(Node* pNode)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::DeleteByNode(Node* pNode)
 {
 	// Underflow checking
 	assert(m_size > 0);
@@ -288,8 +463,8 @@ inline void list<Type>::DeleteByNode(Node* pNode)
 // Find index and delete it
 // Time: O(n)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::DeleteByIndex(size_t index)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::DeleteByIndex(size_t index)
 {
 	// Underflow checking
 	assert(m_size > 0);
@@ -311,8 +486,8 @@ inline void list<Type>::DeleteByIndex(size_t index)
 // Time:  O(n)
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::Reverse(size_t begin/* = 0*/, size_t end/*= std::numeric_limits<size_t>::max()*/)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Reverse(size_t begin/* = 0*/, size_t end/*= std::numeric_limits<size_t>::max()*/)
 {
 	assert(begin <= end);
 
@@ -355,10 +530,18 @@ inline void list<Type>::Reverse(size_t begin/* = 0*/, size_t end/*= std::numeric
 		pStartPrev->m_pNext = pEnd;
 	else
 		m_pHead = pEnd;
+#if DOUBLY_LINKED
+	pEnd->m_pPrev = pStartPrev;
+#endif
 
 	// Relink tail
 	if (pEndNext)
+	{
 		pStart->m_pNext = pEndNext;
+#if DOUBLY_LINKED
+		pEndNext->m_pPrev = pStart;
+#endif
+	}
 	else
 	{
 		m_pTail = pStart;
@@ -394,11 +577,129 @@ inline void list<Type>::Reverse(size_t begin/* = 0*/, size_t end/*= std::numeric
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Sort this list in numeric order
+// Sort by compare with a bottom-up merge sort that only relinks nodes, stable and allocation free.
+// Every pass merges neighbouring runs of runSize nodes into runs of 2 * runSize, until one pass does a single merge.
+// Time:  O(nlogn)
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline void list<Type, Allocator>::Sort(Compare compare /*= Compare()*/)
+{
+	if (m_size < 2)
+		return;
+
+	for (size_t runSize = 1; ; runSize *= 2)
+	{
+		Node* pLeft = m_pHead;
+		Node* pTail = nullptr;		// Last node of the merged output so far
+		size_t mergeCount = 0;
+
+		m_pHead = nullptr;
+
+		while (pLeft)
+		{
+			++mergeCount;
+
+			// The right run starts runSize nodes after the left one
+			Node* pRight = pLeft;
+			size_t leftSize = 0;
+			while (pRight && leftSize < runSize)
+			{
+				pRight = pRight->m_pNext;
+				++leftSize;
+			}
+			size_t rightSize = runSize;
+
+			// Merge, take from the left run on ties to keep it stable
+			while (leftSize > 0 || (rightSize > 0 && pRight))
+			{
+				Node* pNext = nullptr;
+				if (leftSize == 0 || (rightSize > 0 && pRight && compare(pRight->m_value, pLeft->m_value)))
+				{
+					pNext = pRight;
+					pRight = pRight->m_pNext;
+					--rightSize;
+				}
+				else
+				{
+					pNext = pLeft;
+					pLeft = pLeft->m_pNext;
+					--leftSize;
+				}
+
+				if (pTail)
+					pTail->m_pNext = pNext;
+				else
+					m_pHead = pNext;
+				pTail = pNext;
+			}
+
+			// Both runs are used up, the next pair starts where the right run ended
+			pLeft = pRight;
+		}
+
+		pTail->m_pNext = nullptr;
+		m_pTail = pTail;
+
+		if (mergeCount <= 1)
+			break;
+	}
+
+	// Merging only kept the next pointers up to date
+#if DOUBLY_LINKED
+	Node* pPrevious = nullptr;
+	for (Node* pCurrent = m_pHead; pCurrent; pCurrent = pCurrent->m_pNext)
+	{
+		pCurrent->m_pPrev = pPrevious;
+		pPrevious = pCurrent;
+	}
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call function with every element from head to tail
+// Time: O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Function>
+inline void list<Type, Allocator>::ForEach(Function&& function) const
+{
+	for (const Node* pCurrent = m_pHead; pCurrent; pCurrent = pCurrent->m_pNext)
+		function(pCurrent->m_value);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Fill the node pool up to count nodes, so the next count pushes don't touch the allocator
+// Time:  O(n), n = count
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::Sort()
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::ReserveNodes(size_t count)
 {
+	while (m_freeNodeCount < count)
+	{
+		Node* pNode = std::to_address(std::allocator_traits<NodeAllocator>::allocate(m_nodeAllocator, 1));
+		m_pFreeNodes = new(static_cast<void*>(pNode)) FreeNode{ m_pFreeNodes };
+		++m_freeNodeCount;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Give every pooled node back to the allocator.
+// The pool only grows, call this after a burst of pushes has been popped again.
+// Time:  O(n), n = pooled nodes
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::ShrinkNodePool()
+{
+	while (m_pFreeNodes)
+	{
+		FreeNode* pFreeNode = m_pFreeNodes;
+		m_pFreeNodes = pFreeNode->m_pNext;
+		std::allocator_traits<NodeAllocator>::deallocate(m_nodeAllocator, reinterpret_cast<Node*>(pFreeNode), 1);
+	}
+
+	m_freeNodeCount = 0;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -406,8 +707,8 @@ inline void list<Type>::Sort()
 // Time:  O(n)
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::Print(const char* pPrefix /*=''*/, const char* pSuffix /*=''*/) const
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Print(const char* pPrefix /*=''*/, const char* pSuffix /*=''*/) const
 {
 	Node* pCurrent = m_pHead;
 
@@ -428,8 +729,8 @@ inline void list<Type>::Print(const char* pPrefix /*=''*/, const char* pSuffix /
 //--------------------------------------------------------------------------------------------------------------------
 // Time: O(n)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::Clear()
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Clear()
 {
 	Destroy();
 	m_size = 0;
@@ -439,21 +740,20 @@ inline void list<Type>::Clear()
 // Pop first element and return it's value
 // Time: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline Type list<Type>::PopFront()
+template<class Type, class Allocator>
+inline Type list<Type, Allocator>::PopFront()
 {
 	// Underflow checking
 	assert(m_size > 0);
 
-	// Reset head
 	Node* pFront = m_pHead;
-	m_pHead = pFront->m_pNext;
 
 	// Get return value
-	Type val = pFront->m_value;
+	Type val = std::move(pFront->m_value);
 
-	// Delete pFront
-	DeleteNode(pFront);
+	// Unlink and recycle pFront
+	UnlinkChain(nullptr, pFront, pFront, 1);
+	RecycleNode(pFront);
 
 	// Return Front
 	return val;
@@ -463,34 +763,22 @@ inline Type list<Type>::PopFront()
 // Pop last element and return it's value
 // Time: O(1) if doubly linked, O(n) if singly linked
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline Type list<Type>::PopBack()
+template<class Type, class Allocator>
+inline Type list<Type, Allocator>::PopBack()
 {
 	// Underflow checking
 	assert(m_size > 0);
 
-	// Reset tail
-#if DOUBLY_LINKED
 	Node* pBack = m_pTail;
-	m_pTail = pBack->m_pPrev;
-#else
-	std::pair<Node*, Node*> pNodes = SearchPairByNode(m_pTail);	// O(n), n == m_size :(
-	Node* pPrev = pNodes.first;
-	Node* pBack = pNodes.second;
-	m_pTail = pPrev;
-#endif
 
 	// Get return value
-	Type val = pBack->m_value;
+	Type val = std::move(pBack->m_value);
 
-	// Delete pBack
-	DeleteNode(pBack);
-
-	// Set tail's next to nullptr
-	if (m_pTail)
-		m_pTail->m_pNext = nullptr;
+	// Unlink and recycle pBack, finding its previous is O(n), n == m_size if singly linked :(
+	UnlinkChain(GetPrevious(pBack), pBack, pBack, 1);
+	RecycleNode(pBack);
 
-	// Return Front
+	// Return Back
 	return val;
 }
 
@@ -499,8 +787,8 @@ inline Type list<Type>::PopBack()
 // Time:  O(n)
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline typename list<Type>::Node* list<Type>::SearchNodeByValue(const Type& val)
+template<class Type, class Allocator>
+inline typename list<Type, Allocator>::Node* list<Type, Allocator>::SearchNodeByValue(const Type& val)
 {
 	Node* pResult = m_pHead;
 	while (pResult && pResult->m_value != val)
@@ -514,8 +802,8 @@ inline typename list<Type>::Node* list<Type>::SearchNodeByValue(const Type& val)
 // Time:  O(n)
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline typename list<Type>::Node* list<Type>::SearchNodeByNode(const Node* pNode)
+template<class Type, class Allocator>
+inline typename list<Type, Allocator>::Node* list<Type, Allocator>::SearchNodeByNode(const Node* pNode)
 {
 	Node* pResult = m_pHead;
 	while (pResult && pResult != pNode)
@@ -526,12 +814,24 @@ inline typename list<Type>::Node* list<Type>::SearchNodeByNode(const Node* pNode
 
 //--------------------------------------------------------------------------------------------------------------------
 // Find and return the node with the passed in index, return nullptr if not found
-// Time:  O(n), n = index
+// Time:  O(n), n = index, or min(index, m_size - index) if doubly linked
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline  typename list<Type>::Node* list<Type>::SearchNodeByIndex(size_t index)
+template<class Type, class Allocator>
+inline  typename list<Type, Allocator>::Node* list<Type, Allocator>::SearchNodeByIndex(size_t index)
 {
+#if DOUBLY_LINKED
+	// Closer to the tail, walk backwards
+	if (index < m_size && index > m_size / 2)
+	{
+		Node* pNode = m_pTail;
+		for (size_t i = m_size - 1; i > index; --i)
+			pNode = pNode->m_pPrev;
+
+		return pNode;
+	}
+#endif
+
 	// Get node on index
 	Node* pNodeToDelete = m_pHead;
 	for (size_t i = 0; i < index; ++i)
@@ -546,8 +846,8 @@ inline  typename list<Type>::Node* list<Type>::SearchNodeByIndex(size_t index)
 // Time:  O(n)
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline std::pair<typename list<Type>::Node*, typename list<Type>::Node*> list<Type>::SearchPairByValue(const Type& val)
+template<class Type, class Allocator>
+inline std::pair<typename list<Type, Allocator>::Node*, typename list<Type, Allocator>::Node*> list<Type, Allocator>::SearchPairByValue(const Type& val)
 {
 	Node* pPrevious = nullptr;
 	Node* pResult = m_pHead;
@@ -568,8 +868,8 @@ inline std::pair<typename list<Type>::Node*, typename list<Type>::Node*> list<Ty
 // Time:  O(n)
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline std::pair<typename list<Type>::Node*, typename list<Type>::Node*> list<Type>::SearchPairByNode(const Node* pNode)
+template<class Type, class Allocator>
+inline std::pair<typename list<Type, Allocator>::Node*, typename list<Type, Allocator>::Node*> list<Type, Allocator>::SearchPairByNode(const Node* pNode)
 {
 	Node* pPrevious = nullptr;
 	Node* pResult = m_pHead;
@@ -590,8 +890,8 @@ inline std::pair<typename list<Type>::Node*, typename list<Type>::Node*> list<Ty
 // Time:  O(n)
 // Space: O(1)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline std::pair<typename list<Type>::Node*, typename list<Type>::Node*> list<Type>::SearchPairByIndex(size_t index)
+template<class Type, class Allocator>
+inline std::pair<typename list<Type, Allocator>::Node*, typename list<Type, Allocator>::Node*> list<Type, Allocator>::SearchPairByIndex(size_t index)
 {
 	Node* pPrevious = nullptr;
 	Node* pResult = m_pHead;
@@ -606,27 +906,144 @@ inline std::pair<typename list<Type>::Node*, typename list<Type>::Node*> list<Ty
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Delete every node in the list
+// Return the node in front of pNode, nullptr pNode means end() so the tail is returned
+// Time: O(1) if doubly linked, O(n) if singly linked
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline typename list<Type, Allocator>::Node* list<Type, Allocator>::GetPrevious(const Node* pNode) const
+{
+	if (!pNode)
+		return m_pTail;
+
+#if DOUBLY_LINKED
+	return pNode->m_pPrev;
+#else
+	Node* pPrevious = nullptr;
+	for (Node* pCurrent = m_pHead; pCurrent != pNode; pCurrent = pCurrent->m_pNext)
+		pPrevious = pCurrent;
+	return pPrevious;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Link the chain pFirst..pLast of count nodes after pPrevious, nullptr links it to the front
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::LinkChainAfter(Node* pPrevious, Node* pFirst, Node* pLast, size_t count)
+{
+	Node* pNext = pPrevious ? pPrevious->m_pNext : m_pHead;
+
+	pLast->m_pNext = pNext;
+	if (pPrevious)
+		pPrevious->m_pNext = pFirst;
+	else
+		m_pHead = pFirst;
+
+#if DOUBLY_LINKED
+	pFirst->m_pPrev = pPrevious;
+	if (pNext)
+		pNext->m_pPrev = pLast;
+#endif
+
+	if (!pNext)
+		m_pTail = pLast;
+
+	m_size += count;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink the chain pFirst..pLast of count nodes, pPrevious is the node in front of pFirst
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::UnlinkChain(Node* pPrevious, Node* pFirst, Node* pLast, size_t count)
+{
+	Node* pNext = pLast->m_pNext;
+
+	if (pPrevious)
+		pPrevious->m_pNext = pNext;
+	else
+		m_pHead = pNext;
+
+#if DOUBLY_LINKED
+	if (pNext)
+		pNext->m_pPrev = pPrevious;
+	pFirst->m_pPrev = nullptr;
+#endif
+
+	if (!pNext)
+		m_pTail = pPrevious;
+
+	pLast->m_pNext = nullptr;
+	m_size -= count;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Take a node from the pool, or from the allocator if the pool is empty
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline typename list<Type, Allocator>::Node* list<Type, Allocator>::AcquireNode(const Type& val)
+{
+	if (!m_pFreeNodes)
+		return NewObject(m_nodeAllocator, val);
+
+	// Construct first and pop after, the node overwrites the pool link, so put it back if copying the value throws
+	FreeNode* pFreeNode = m_pFreeNodes;
+	FreeNode* pNextFreeNode = pFreeNode->m_pNext;
+	Node* pNode = nullptr;
+	try
+	{
+		pNode = new(static_cast<void*>(pFreeNode)) Node(val);
+	}
+	catch (...)
+	{
+		m_pFreeNodes = new(static_cast<void*>(pFreeNode)) FreeNode{ pNextFreeNode };
+		throw;
+	}
+
+	m_pFreeNodes = pNextFreeNode;
+	--m_freeNodeCount;
+	return pNode;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Destroy the node's value and park the node in the pool
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::RecycleNode(Node* pNode)
+{
+	std::destroy_at(pNode);
+	m_pFreeNodes = new(static_cast<void*>(pNode)) FreeNode{ m_pFreeNodes };
+	++m_freeNodeCount;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Delete every node in the list, the nodes go to the pool
 // Time: O(n)
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::Destroy()
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Destroy()
 {
 	Node* pCurrent = m_pHead;
 
 	while (pCurrent)
 	{
 		m_pHead = m_pHead->m_pNext;
-		delete pCurrent;
+		RecycleNode(pCurrent);
 		pCurrent = m_pHead;
 	}
+
+	m_pTail = nullptr;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 // Set head and tail to nullptr if the list is empty
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::SetNullptrIfEmpty()
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::SetNullptrIfEmpty()
 {
 	if (m_size <= 0)
 	{
@@ -636,10 +1053,10 @@ inline void list<Type>::SetNullptrIfEmpty()
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Internally delete a node
+// Internally delete a node, pPrevious is only read when singly linked
 //--------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void list<Type>::Delete(Node* pNodeToDelete, Node* pPrevious)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Delete(Node* pNodeToDelete, [[maybe_unused]] Node* pPrevious)
 {
 	// If data is in the list, delete it
 	if (pNodeToDelete)
@@ -652,7 +1069,7 @@ inline void list<Type>::Delete(Node* pNodeToDelete, Node* pPrevious)
 		if (pNodeToDelete->m_pNext)
 			pNodeToDelete->m_pNext->m_pPrev = pNodeToDelete->m_pPrev;
 #else
-		if (pNodeToDelete->m_pNext && pPrevious)
+		if (pPrevious)
 			pPrevious->m_pNext = pNodeToDelete->m_pNext;
 #endif
 
@@ -674,11 +1091,10 @@ inline void list<Type>::Delete(Node* pNodeToDelete, Node* pPrevious)
 	}
 }
 
-template<class Type>
-inline void list<Type>::DeleteNode(Node* pNodeToDelete)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::DeleteNode(Node* pNodeToDelete)
 {
-	pNodeToDelete->ClearPointers();
-	delete pNodeToDelete;
+	RecycleNode(pNodeToDelete);
 	pNodeToDelete = nullptr;
 
 	--m_size;
@@ -687,8 +1103,8 @@ inline void list<Type>::DeleteNode(Node* pNodeToDelete)
 	SetNullptrIfEmpty();
 }
 
-template<class Type>
-inline void list<Type>::AssignNodeAtIndex(size_t index, Node* pNode)
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::AssignNodeAtIndex(size_t index, Node* pNode)
 {
 	Node* pSearchNode = m_pHead;
 
@@ -698,8 +1114,133 @@ inline void list<Type>::AssignNodeAtIndex(size_t index, Node* pNode)
 	pSearchNode = pNode;
 }
 
-template<class Type>
-inline void list<Type>::Test()
+//--------------------------------------------------------------------------------------------------------------------
+// Unit Test for list
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline bool list<Type, Allocator>::UnitTest()
+{
+	//---------------------------------------------------------------
+	// Iterate both ways
+	//---------------------------------------------------------------
+	list testList;
+	for (size_t i = 0; i < kTestSize; ++i)
+		testList.PushBack(static_cast<Type>(i));
+
+	size_t expected = 0;
+	for (const Type& value : testList)
+	{
+		if (value != static_cast<Type>(expected++))
+			RETURN_ERROR("list iteration");
+	}
+
+	for (auto it = testList.end(); it != testList.begin();)
+	{
+		if (*--it != static_cast<Type>(--expected))
+			RETURN_ERROR("list reverse iteration");
+	}
+
+	//---------------------------------------------------------------
+	// Insert and erase through iterators
+	//---------------------------------------------------------------
+	auto it = testList.begin();
+	for (size_t i = 0; i < kTestSize / 2; ++i)
+		++it;
+
+	it = testList.Insert(it, static_cast<Type>(0));
+	testList.Insert(testList.end(), static_cast<Type>(0));
+	if (testList.GetSize() != kTestSize + 2 || testList.back() != static_cast<Type>(0))
+		RETURN_ERROR("list::Insert(iterator)");
+
+	it = testList.Erase(it);
+	testList.Erase(--testList.end());
+	if (testList.GetSize() != kTestSize || *it != static_cast<Type>(kTestSize / 2) || testList.back() != static_cast<Type>(kTestSize - 1))
+		RETURN_ERROR("list::Erase(iterator)");
+
+	//---------------------------------------------------------------
+	// Splice
+	//---------------------------------------------------------------
+	list otherList;
+	otherList.Splice(otherList.end(), testList, testList.begin(), it);
+	if (otherList.GetSize() != kTestSize / 2 || testList.GetSize() != kTestSize - kTestSize / 2 || testList.front() != static_cast<Type>(kTestSize / 2))
+		RETURN_ERROR("list::Splice(range)");
+
+	testList.Splice(testList.begin(), otherList, --otherList.end());
+	testList.Splice(testList.begin(), otherList);
+	if (!otherList.Empty() || testList.GetSize() != kTestSize)
+		RETURN_ERROR("list::Splice()");
+
+	expected = 0;
+	for (const Type& value : testList)
+	{
+		if (value != static_cast<Type>(expected++))
+			RETURN_ERROR("list::Splice() order");
+	}
+
+	//---------------------------------------------------------------
+	// Sort, stable
+	//---------------------------------------------------------------
+	list<std::pair<Type, size_t>> pairList;
+	for (size_t i = 0; i < kTestSize; ++i)
+		pairList.PushFront({ static_cast<Type>(i % 7), i });
+
+	pairList.Sort([](const auto& left, const auto& right) { return left.first < right.first; });
+	for (auto pairIt = ++pairList.begin(); pairIt != pairList.end(); ++pairIt)
+	{
+		auto previous = pairIt;
+		--previous;
+		if (previous->first > pairIt->first || (previous->first == pairIt->first && previous->second < pairIt->second))
+			RETURN_ERROR("list::Sort()");
+	}
+
+	testList.Reverse();
+	testList.Sort();
+	expected = 0;
+	for (const Type& value : testList)
+	{
+		if (value != static_cast<Type>(expected++))
+			RETURN_ERROR("list::Sort() after Reverse()");
+	}
+	if (testList.back() != static_cast<Type>(kTestSize - 1))
+		RETURN_ERROR("list::Sort() tail");
+
+	//---------------------------------------------------------------
+	// Erase everything
+	//---------------------------------------------------------------
+	testList.Erase(testList.begin(), testList.end());
+	if (!testList.Empty() || testList.begin() != testList.end() || testList.GetPooledNodeCount() < kTestSize)
+		RETURN_ERROR("list::Erase(range)");
+
+	//---------------------------------------------------------------
+	// A throwing copy leaves the node in the pool
+	//---------------------------------------------------------------
+	struct ThrowingCopy
+	{
+		ThrowingCopy() = default;
+		ThrowingCopy(const ThrowingCopy&) { throw std::runtime_error("copy"); }
+	};
+
+	list<ThrowingCopy> throwingList;
+	throwingList.ReserveNodes(2);
+	try
+	{
+		throwingList.PushBack(ThrowingCopy());
+	}
+	catch (const std::runtime_error&)
+	{
+	}
+
+	if (!throwingList.Empty() || throwingList.GetPooledNodeCount() != 2)
+		RETURN_ERROR("list::PushBack() throwing copy");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+
+template<class Type, class Allocator>
+inline void list<Type, Allocator>::Test()
 {
 	// Variables for testing
 	bool shouldQuit = false;
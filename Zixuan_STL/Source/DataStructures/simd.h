@@ -0,0 +1,490 @@
+#pragma once
+
+#include <assert.h>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Which instruction sets are compiled in. AVX2 is always built on x86 and picked at runtime.
+// MSVC compiles intrinsics of any instruction set. GCC and Clang only build what the target architecture flags
+// (-mavx2) allow, so the AVX2 code is marked with a target attribute instead and inlined into AVX2 entry points.
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ZXSTL_SIMD_SSE2 1
+#define ZXSTL_SIMD_AVX2 1
+#define ZXSTL_SIMD_AVX2_TARGET
+#define ZXSTL_SIMD_FORCE_INLINE __forceinline
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define ZXSTL_SIMD_SSE2 1
+#define ZXSTL_SIMD_AVX2 1
+#define ZXSTL_SIMD_AVX2_TARGET __attribute__((target("avx2")))
+#define ZXSTL_SIMD_FORCE_INLINE inline __attribute__((always_inline))
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define ZXSTL_SIMD_SSE2 0
+#define ZXSTL_SIMD_AVX2 0
+#endif
+
+namespace zxstl
+{
+//--------------------------------------------------------------------------------------------------------------------
+// Vectorized linear scans over arithmetic arrays, with runtime dispatch to the widest instruction set the CPU has.
+// Every function works on any element type, only integers, float and double take the SIMD path.
+//--------------------------------------------------------------------------------------------------------------------
+namespace simd
+{
+	enum class Level : uint8_t
+	{
+		kScalar,
+		kSse2,
+		kAvx2,
+	};
+
+	template<class Type>
+	inline constexpr bool kIsVectorizable = (std::is_integral_v<Type> && !std::is_same_v<Type, bool>) || std::is_same_v<Type, float> || std::is_same_v<Type, double>;
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// The widest instruction set which is both compiled in and supported by this CPU
+	//--------------------------------------------------------------------------------------------------------------------
+	inline Level DetectLevel()
+	{
+#if ZXSTL_SIMD_AVX2 && defined(_MSC_VER) && !defined(__clang__)
+		// AVX2 needs the CPU bit, and the OS saving the ymm registers (OSXSAVE + XCR0 bits 1 and 2)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+		__cpuid(info, 1);
+		const bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 0x6) == 0x6);
+		if (maxLeaf >= 7 && osSavesYmm)
+		{
+			__cpuidex(info, 7, 0);
+			if (info[1] & (1 << 5))
+				return Level::kAvx2;
+		}
+		return Level::kSse2;
+#elif ZXSTL_SIMD_AVX2
+		// Same checks with the GCC / Clang builtins, xgetbv only exists if OSXSAVE is set
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		if (__builtin_cpu_supports("avx2") && __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_OSXSAVE))
+		{
+			unsigned int xcr0Low = 0, xcr0High = 0;
+			__asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+			if ((xcr0Low & 0x6) == 0x6)
+				return Level::kAvx2;
+		}
+		return Level::kSse2;
+#elif ZXSTL_SIMD_SSE2
+		return Level::kSse2;
+#else
+		return Level::kScalar;
+#endif
+	}
+
+	inline Level& CurrentLevel()
+	{
+		static Level s_level = DetectLevel();
+		return s_level;
+	}
+
+	inline Level GetLevel() { return CurrentLevel(); }
+
+	// Lower the level, for tests and benchmarks. It can't go above what the CPU supports. Not thread safe.
+	inline void SetLevel(Level level) { CurrentLevel() = (level < DetectLevel()) ? level : DetectLevel(); }
+
+	// The scans pass AVX2 registers around before they are inlined into the AVX2 entry points, GCC warns about the ABI
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+	namespace detail
+	{
+		//--------------------------------------------------------------------------------------------------------------------
+		// Instruction set wrappers. Every compare returns all ones in the lanes which match, so Mask() gives one bit per
+		// byte, sizeof(Type) bits for every matching element, no matter the element type.
+		//--------------------------------------------------------------------------------------------------------------------
+#if ZXSTL_SIMD_SSE2
+		struct Sse2
+		{
+			using Register = __m128i;
+			static constexpr size_t kWidth = 16;
+
+			template<class Type> static constexpr bool kHasMinMax = sizeof(Type) < 8 || std::is_floating_point_v<Type>;
+
+			template<class Type>
+			static Register Load(const Type* pData) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData)); }
+
+			static uint32_t Mask(Register value) { return static_cast<uint32_t>(_mm_movemask_epi8(value)); }
+			static Register Or(Register left, Register right) { return _mm_or_si128(left, right); }
+
+			template<class Type>
+			static Register Broadcast(Type value)
+			{
+				if constexpr (std::is_same_v<Type, float>)		return _mm_castps_si128(_mm_set1_ps(value));
+				else if constexpr (std::is_same_v<Type, double>)	return _mm_castpd_si128(_mm_set1_pd(value));
+				else if constexpr (sizeof(Type) == 1)			return _mm_set1_epi8(static_cast<char>(value));
+				else if constexpr (sizeof(Type) == 2)			return _mm_set1_epi16(static_cast<short>(value));
+				else if constexpr (sizeof(Type) == 4)			return _mm_set1_epi32(static_cast<int>(value));
+				else											return _mm_set1_epi64x(static_cast<long long>(value));
+			}
+
+			template<class Type>
+			static Register Equal(Register left, Register right)
+			{
+				if constexpr (std::is_same_v<Type, float>)
+					return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(left), _mm_castsi128_ps(right)));
+				else if constexpr (std::is_same_v<Type, double>)
+					return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(left), _mm_castsi128_pd(right)));
+				else if constexpr (sizeof(Type) == 1)
+					return _mm_cmpeq_epi8(left, right);
+				else if constexpr (sizeof(Type) == 2)
+					return _mm_cmpeq_epi16(left, right);
+				else if constexpr (sizeof(Type) == 4)
+					return _mm_cmpeq_epi32(left, right);
+				else
+				{
+					// No 64 bit compare in SSE2, both 32 bit halves have to match
+					const __m128i equal32 = _mm_cmpeq_epi32(left, right);
+					return _mm_and_si128(equal32, _mm_shuffle_epi32(equal32, _MM_SHUFFLE(2, 3, 0, 1)));
+				}
+			}
+
+			// Min if takeMin, otherwise max
+			template<class Type, bool takeMin>
+			static Register Select(Register left, Register right)
+			{
+				if constexpr (std::is_same_v<Type, float>)
+				{
+					const __m128 a = _mm_castsi128_ps(left), b = _mm_castsi128_ps(right);
+					return _mm_castps_si128(takeMin ? _mm_min_ps(a, b) : _mm_max_ps(a, b));
+				}
+				else if constexpr (std::is_same_v<Type, double>)
+				{
+					const __m128d a = _mm_castsi128_pd(left), b = _mm_castsi128_pd(right);
+					return _mm_castpd_si128(takeMin ? _mm_min_pd(a, b) : _mm_max_pd(a, b));
+				}
+				else if constexpr (sizeof(Type) == 1)
+				{
+					// Only unsigned bytes have min / max, flip the sign bit of signed ones before and after
+					const __m128i bias = _mm_set1_epi8(std::is_signed_v<Type> ? static_cast<char>(0x80) : 0);
+					const __m128i a = _mm_xor_si128(left, bias), b = _mm_xor_si128(right, bias);
+					return _mm_xor_si128(takeMin ? _mm_min_epu8(a, b) : _mm_max_epu8(a, b), bias);
+				}
+				else if constexpr (sizeof(Type) == 2)
+				{
+					// Only signed shorts have min / max
+					const __m128i bias = _mm_set1_epi16(std::is_signed_v<Type> ? 0 : static_cast<short>(0x8000));
+					const __m128i a = _mm_xor_si128(left, bias), b = _mm_xor_si128(right, bias);
+					return _mm_xor_si128(takeMin ? _mm_min_epi16(a, b) : _mm_max_epi16(a, b), bias);
+				}
+				else
+				{
+					// No 32 bit min / max in SSE2, compare and blend with and / andnot
+					const __m128i bias = _mm_set1_epi32(std::is_signed_v<Type> ? 0 : static_cast<int>(0x80000000u));
+					const __m128i leftGreater = _mm_cmpgt_epi32(_mm_xor_si128(left, bias), _mm_xor_si128(right, bias));
+					const __m128i pickRight = takeMin ? leftGreater : _mm_xor_si128(leftGreater, _mm_set1_epi32(-1));
+					return _mm_or_si128(_mm_and_si128(pickRight, right), _mm_andnot_si128(pickRight, left));
+				}
+			}
+		};
+#endif
+
+#if ZXSTL_SIMD_AVX2
+		struct Avx2
+		{
+			using Register = __m256i;
+			static constexpr size_t kWidth = 32;
+
+			template<class Type> static constexpr bool kHasMinMax = true;
+
+			template<class Type>
+			ZXSTL_SIMD_AVX2_TARGET static Register Load(const Type* pData) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData)); }
+
+			ZXSTL_SIMD_AVX2_TARGET static uint32_t Mask(Register value) { return static_cast<uint32_t>(_mm256_movemask_epi8(value)); }
+			ZXSTL_SIMD_AVX2_TARGET static Register Or(Register left, Register right) { return _mm256_or_si256(left, right); }
+
+			template<class Type>
+			ZXSTL_SIMD_AVX2_TARGET static Register Broadcast(Type value)
+			{
+				if constexpr (std::is_same_v<Type, float>)		return _mm256_castps_si256(_mm256_set1_ps(value));
+				else if constexpr (std::is_same_v<Type, double>)	return _mm256_castpd_si256(_mm256_set1_pd(value));
+				else if constexpr (sizeof(Type) == 1)			return _mm256_set1_epi8(static_cast<char>(value));
+				else if constexpr (sizeof(Type) == 2)			return _mm256_set1_epi16(static_cast<short>(value));
+				else if constexpr (sizeof(Type) == 4)			return _mm256_set1_epi32(static_cast<int>(value));
+				else											return _mm256_set1_epi64x(static_cast<long long>(value));
+			}
+
+			template<class Type>
+			ZXSTL_SIMD_AVX2_TARGET static Register Equal(Register left, Register right)
+			{
+				if constexpr (std::is_same_v<Type, float>)
+					return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(left), _mm256_castsi256_ps(right), _CMP_EQ_OQ));
+				else if constexpr (std::is_same_v<Type, double>)
+					return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(left), _mm256_castsi256_pd(right), _CMP_EQ_OQ));
+				else if constexpr (sizeof(Type) == 1)
+					return _mm256_cmpeq_epi8(left, right);
+				else if constexpr (sizeof(Type) == 2)
+					return _mm256_cmpeq_epi16(left, right);
+				else if constexpr (sizeof(Type) == 4)
+					return _mm256_cmpeq_epi32(left, right);
+				else
+					return _mm256_cmpeq_epi64(left, right);
+			}
+
+			template<class Type, bool takeMin>
+			ZXSTL_SIMD_AVX2_TARGET static Register Select(Register left, Register right)
+			{
+				if constexpr (std::is_same_v<Type, float>)
+				{
+					const __m256 a = _mm256_castsi256_ps(left), b = _mm256_castsi256_ps(right);
+					return _mm256_castps_si256(takeMin ? _mm256_min_ps(a, b) : _mm256_max_ps(a, b));
+				}
+				else if constexpr (std::is_same_v<Type, double>)
+				{
+					const __m256d a = _mm256_castsi256_pd(left), b = _mm256_castsi256_pd(right);
+					return _mm256_castpd_si256(takeMin ? _mm256_min_pd(a, b) : _mm256_max_pd(a, b));
+				}
+				else if constexpr (sizeof(Type) == 1 && std::is_signed_v<Type>)	return takeMin ? _mm256_min_epi8(left, right) : _mm256_max_epi8(left, right);
+				else if constexpr (sizeof(Type) == 1)							return takeMin ? _mm256_min_epu8(left, right) : _mm256_max_epu8(left, right);
+				else if constexpr (sizeof(Type) == 2 && std::is_signed_v<Type>)	return takeMin ? _mm256_min_epi16(left, right) : _mm256_max_epi16(left, right);
+				else if constexpr (sizeof(Type) == 2)							return takeMin ? _mm256_min_epu16(left, right) : _mm256_max_epu16(left, right);
+				else if constexpr (sizeof(Type) == 4 && std::is_signed_v<Type>)	return takeMin ? _mm256_min_epi32(left, right) : _mm256_max_epi32(left, right);
+				else if constexpr (sizeof(Type) == 4)							return takeMin ? _mm256_min_epu32(left, right) : _mm256_max_epu32(left, right);
+				else
+				{
+					// No 64 bit min / max in AVX2, compare and blend
+					const __m256i bias = _mm256_set1_epi64x(std::is_signed_v<Type> ? 0 : static_cast<long long>(0x8000000000000000ull));
+					const __m256i leftGreater = _mm256_cmpgt_epi64(_mm256_xor_si256(left, bias), _mm256_xor_si256(right, bias));
+					return takeMin ? _mm256_blendv_epi8(left, right, leftGreater) : _mm256_blendv_epi8(right, left, leftGreater);
+				}
+			}
+		};
+#endif
+
+		//--------------------------------------------------------------------------------------------------------------------
+		// Scalar versions, used for every other element type and for the tails
+		//--------------------------------------------------------------------------------------------------------------------
+		template<class Type>
+		inline size_t FindScalar(const Type* pData, size_t count, const Type& value)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (pData[i] == value)
+					return i;
+			}
+			return count;
+		}
+
+		template<class Type>
+		inline size_t CountScalar(const Type* pData, size_t count, const Type& value)
+		{
+			size_t matchCount = 0;
+			for (size_t i = 0; i < count; ++i)
+				matchCount += (pData[i] == value) ? 1 : 0;
+			return matchCount;
+		}
+
+		template<class Type>
+		inline std::pair<Type, Type> MinMaxScalar(const Type* pData, size_t count)
+		{
+			std::pair<Type, Type> result(pData[0], pData[0]);
+			for (size_t i = 1; i < count; ++i)
+			{
+				if (pData[i] < result.first)
+					result.first = pData[i];
+				if (result.second < pData[i])
+					result.second = pData[i];
+			}
+			return result;
+		}
+
+		//--------------------------------------------------------------------------------------------------------------------
+		// Find, four registers per loop so the loads can run ahead of the compares
+		//--------------------------------------------------------------------------------------------------------------------
+		template<class Isa, class Type>
+		ZXSTL_SIMD_FORCE_INLINE size_t FindVectorized(const Type* pData, size_t count, Type value)
+		{
+			using Register = typename Isa::Register;
+			static constexpr size_t kLanes = Isa::kWidth / sizeof(Type);
+
+			const Register needle = Isa::Broadcast(value);
+			size_t i = 0;
+			for (; i + 4 * kLanes <= count; i += 4 * kLanes)
+			{
+				const Register equal0 = Isa::template Equal<Type>(Isa::Load(pData + i), needle);
+				const Register equal1 = Isa::template Equal<Type>(Isa::Load(pData + i + kLanes), needle);
+				const Register equal2 = Isa::template Equal<Type>(Isa::Load(pData + i + 2 * kLanes), needle);
+				const Register equal3 = Isa::template Equal<Type>(Isa::Load(pData + i + 3 * kLanes), needle);
+				if (Isa::Mask(Isa::Or(Isa::Or(equal0, equal1), Isa::Or(equal2, equal3))) == 0)
+					continue;
+
+				const Register equals[4] = { equal0, equal1, equal2, equal3 };
+				for (size_t block = 0; block < 4; ++block)
+				{
+					const uint32_t mask = Isa::Mask(equals[block]);
+					if (mask != 0)
+						return i + block * kLanes + std::countr_zero(mask) / sizeof(Type);
+				}
+			}
+
+			for (; i + kLanes <= count; i += kLanes)
+			{
+				const uint32_t mask = Isa::Mask(Isa::template Equal<Type>(Isa::Load(pData + i), needle));
+				if (mask != 0)
+					return i + std::countr_zero(mask) / sizeof(Type);
+			}
+
+			return i + FindScalar(pData + i, count - i, value);
+		}
+
+		//--------------------------------------------------------------------------------------------------------------------
+		// Count, every matching element sets sizeof(Type) bits of the mask
+		//--------------------------------------------------------------------------------------------------------------------
+		template<class Isa, class Type>
+		ZXSTL_SIMD_FORCE_INLINE size_t CountVectorized(const Type* pData, size_t count, Type value)
+		{
+			using Register = typename Isa::Register;
+			static constexpr size_t kLanes = Isa::kWidth / sizeof(Type);
+
+			const Register needle = Isa::Broadcast(value);
+			size_t matchedBits = 0;
+			size_t i = 0;
+			for (; i + 2 * kLanes <= count; i += 2 * kLanes)
+			{
+				matchedBits += std::popcount(Isa::Mask(Isa::template Equal<Type>(Isa::Load(pData + i), needle)));
+				matchedBits += std::popcount(Isa::Mask(Isa::template Equal<Type>(Isa::Load(pData + i + kLanes), needle)));
+			}
+
+			for (; i + kLanes <= count; i += kLanes)
+				matchedBits += std::popcount(Isa::Mask(Isa::template Equal<Type>(Isa::Load(pData + i), needle)));
+
+			return matchedBits / sizeof(Type) + CountScalar(pData + i, count - i, value);
+		}
+
+		//--------------------------------------------------------------------------------------------------------------------
+		// MinMax, the tail is covered by one more register overlapping the last full one, min / max don't mind duplicates
+		//--------------------------------------------------------------------------------------------------------------------
+		template<class Isa, class Type>
+		ZXSTL_SIMD_FORCE_INLINE std::pair<Type, Type> MinMaxVectorized(const Type* pData, size_t count)
+		{
+			using Register = typename Isa::Register;
+			static constexpr size_t kLanes = Isa::kWidth / sizeof(Type);
+
+			if (count < kLanes)
+				return MinMaxScalar(pData, count);
+
+			Register minimum = Isa::Load(pData);
+			Register maximum = minimum;
+			for (size_t i = kLanes; i + kLanes <= count; i += kLanes)
+			{
+				const Register values = Isa::Load(pData + i);
+				minimum = Isa::template Select<Type, true>(minimum, values);
+				maximum = Isa::template Select<Type, false>(maximum, values);
+			}
+
+			const Register last = Isa::Load(pData + count - kLanes);
+			minimum = Isa::template Select<Type, true>(minimum, last);
+			maximum = Isa::template Select<Type, false>(maximum, last);
+
+			// Reduce the lanes
+			Type minimums[kLanes];
+			Type maximums[kLanes];
+			std::memcpy(minimums, &minimum, sizeof(Register));
+			std::memcpy(maximums, &maximum, sizeof(Register));
+			return { MinMaxScalar(minimums, kLanes).first, MinMaxScalar(maximums, kLanes).second };
+		}
+
+#if ZXSTL_SIMD_AVX2
+		//--------------------------------------------------------------------------------------------------------------------
+		// AVX2 entry points. The scans are force inlined here, where the Avx2 intrinsic wrappers can inline too.
+		//--------------------------------------------------------------------------------------------------------------------
+		template<class Type>
+		ZXSTL_SIMD_AVX2_TARGET inline size_t FindAvx2(const Type* pData, size_t count, Type value) { return FindVectorized<Avx2>(pData, count, value); }
+
+		template<class Type>
+		ZXSTL_SIMD_AVX2_TARGET inline size_t CountAvx2(const Type* pData, size_t count, Type value) { return CountVectorized<Avx2>(pData, count, value); }
+
+		template<class Type>
+		ZXSTL_SIMD_AVX2_TARGET inline std::pair<Type, Type> MinMaxAvx2(const Type* pData, size_t count) { return MinMaxVectorized<Avx2>(pData, count); }
+#endif
+	}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Index of the first element equal to value, count if there is none
+	// Time:  O(n)
+	//--------------------------------------------------------------------------------------------------------------------
+	template<class Type>
+	inline size_t Find(const Type* pData, size_t count, const Type& value)
+	{
+		if constexpr (kIsVectorizable<Type>)
+		{
+#if ZXSTL_SIMD_AVX2
+			if (GetLevel() >= Level::kAvx2)
+				return detail::FindAvx2(pData, count, value);
+#endif
+#if ZXSTL_SIMD_SSE2
+			if (GetLevel() >= Level::kSse2)
+				return detail::FindVectorized<detail::Sse2>(pData, count, value);
+#endif
+		}
+
+		return detail::FindScalar(pData, count, value);
+	}
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// How many elements are equal to value
+	// Time:  O(n)
+	//--------------------------------------------------------------------------------------------------------------------
+	template<class Type>
+	inline size_t Count(const Type* pData, size_t count, const Type& value)
+	{
+		if constexpr (kIsVectorizable<Type>)
+		{
+#if ZXSTL_SIMD_AVX2
+			if (GetLevel() >= Level::kAvx2)
+				return detail::CountAvx2(pData, count, value);
+#endif
+#if ZXSTL_SIMD_SSE2
+			if (GetLevel() >= Level::kSse2)
+				return detail::CountVectorized<detail::Sse2>(pData, count, value);
+#endif
+		}
+
+		return detail::CountScalar(pData, count, value);
+	}
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Smallest and biggest element, count must not be 0. Which NaN or zero is returned for float inputs containing NaNs
+	// or both signs of zero is unspecified.
+	// Time:  O(n)
+	//--------------------------------------------------------------------------------------------------------------------
+	template<class Type>
+	inline std::pair<Type, Type> MinMax(const Type* pData, size_t count)
+	{
+		assert(count > 0);
+
+		if constexpr (kIsVectorizable<Type>)
+		{
+#if ZXSTL_SIMD_AVX2
+			if (GetLevel() >= Level::kAvx2)
+				return detail::MinMaxAvx2(pData, count);
+#endif
+#if ZXSTL_SIMD_SSE2
+			if constexpr (detail::Sse2::kHasMinMax<Type>)
+			{
+				if (GetLevel() >= Level::kSse2)
+					return detail::MinMaxVectorized<detail::Sse2>(pData, count);
+			}
+#endif
+		}
+
+		return detail::MinMaxScalar(pData, count);
+	}
+}
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include "vector.h"
+
+namespace zxstl
+{
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// vector with room for kInlineCapacity elements inside the object itself, the heap is only used after that.
+// It is a vector, so it has the whole vector API, sorts included, and can be passed to anything taking a vector&.
+// Moving a small_vector relocates its inline elements one by one, it can't just hand over a pointer.
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator = allocator<Type>>
+class small_vector : public vector<Type, Allocator>
+{
+    static_assert(kInlineCapacity > 0, "Use vector if nothing should be kept inline");
+
+    using Base = vector<Type, Allocator>;
+
+private:
+    alignas(Type) std::byte m_inlineBuffer[kInlineCapacity * sizeof(Type)];
+
+public:
+    // Member functions
+    small_vector() noexcept;
+    explicit small_vector(const Allocator& alloc) noexcept;
+    small_vector(const small_vector& other);
+    small_vector(const Base& other);
+    small_vector(small_vector&& other) noexcept;
+    small_vector(Base&& other) noexcept;
+    small_vector& operator=(const small_vector& other);
+    small_vector& operator=(small_vector&& other) noexcept(Base::kIsNothrowMoveAssignable);
+    ~small_vector();
+
+    // Capacity
+    void shrink_to_fit();
+
+    // Modifiers
+    void swap(small_vector& other) noexcept { Swap(*this, other); }
+
+    // Additional stuff
+    bool IsInline() const { return this->m_isInlineBuffer; }
+    static constexpr size_t InlineCapacity() { return kInlineCapacity; }
+
+    // Testings
+    static bool UnitTest();
+
+private:
+    void _reset_to_inline_buffer();
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Default ctor, starts on the inline buffer without touching the heap
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>::small_vector() noexcept
+    : small_vector(Allocator())
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Ctor with an allocator for when the elements outgrow the inline buffer
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>::small_vector(const Allocator& alloc) noexcept
+    : Base(m_inlineBuffer, kInlineCapacity, alloc)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Copy ctor, stays inline if the other's elements fit
+// Time:  O(n)
+// Space: O(n)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>::small_vector(const small_vector& other)
+    : small_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.m_allocator))
+{
+    Base::operator=(other);
+}
+
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>::small_vector(const Base& other)
+    : small_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
+{
+    Base::operator=(other);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Move ctor, takes over the other's heap buffer, or relocates the other's inline elements
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>::small_vector(small_vector&& other) noexcept
+    : small_vector(other.m_allocator)
+{
+    *this = std::move(other);
+}
+
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>::small_vector(Base&& other) noexcept
+    : small_vector(other.get_allocator())
+{
+    Base::operator=(std::move(other));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Copy assignment
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>& small_vector<Type, kInlineCapacity, Allocator>::operator=(const small_vector& other)
+{
+    Base::operator=(other);
+    return *this;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Move assignment, if the other's heap buffer is taken over, the other goes back to its inline buffer
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>& small_vector<Type, kInlineCapacity, Allocator>::operator=(small_vector&& other) noexcept(Base::kIsNothrowMoveAssignable)
+{
+    Base::operator=(std::move(other));
+    other._reset_to_inline_buffer();
+    return *this;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dtor, the elements must be destroyed while the inline buffer is still alive
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline small_vector<Type, kInlineCapacity, Allocator>::~small_vector()
+{
+    this->_destroy();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Requests the removal of unused capacity. Goes back to the inline buffer if the elements fit
+// Time:  O(n)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline void small_vector<Type, kInlineCapacity, Allocator>::shrink_to_fit()
+{
+    if (this->m_isInlineBuffer)
+        return;
+
+    if (this->m_size > kInlineCapacity)
+    {
+        Base::shrink_to_fit();
+        return;
+    }
+
+    Base::_relocate(reinterpret_cast<Type*>(m_inlineBuffer), reinterpret_cast<Type*>(this->m_pBuffer), this->m_size);
+    this->_free_buffer();
+    this->m_pBuffer = m_inlineBuffer;
+    this->m_capacity = kInlineCapacity;
+    this->m_isInlineBuffer = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Unit Test for small_vector
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline bool small_vector<Type, kInlineCapacity, Allocator>::UnitTest()
+{
+    //---------------------------------------------------------------
+    // Stay inline until kInlineCapacity elements
+    //---------------------------------------------------------------
+    small_vector testVec;
+    for (size_t i = 0; i < kInlineCapacity; ++i)
+        testVec.push_back(static_cast<Type>(kInlineCapacity - i));
+
+    if (!testVec.IsInline() || testVec.capacity() != kInlineCapacity)
+        RETURN_ERROR("small_vector::push_back() inline");
+
+    // Sorts come from vector
+    testVec.QuickSort();
+    for (size_t i = 0; i < kInlineCapacity; ++i)
+    {
+        if (testVec[i] != static_cast<Type>(i + 1))
+            RETURN_ERROR("small_vector::QuickSort()");
+    }
+
+    //---------------------------------------------------------------
+    // Copy and move while inline
+    //---------------------------------------------------------------
+    small_vector copiedVec(testVec);
+    small_vector movedVec(std::move(copiedVec));
+    if (!movedVec.IsInline() || movedVec.size() != kInlineCapacity || !copiedVec.empty() || !copiedVec.IsInline())
+        RETURN_ERROR("small_vector copy / move inline");
+    if (!std::is_nothrow_move_assignable_v<small_vector>)
+        RETURN_ERROR("small_vector move assignment must be noexcept with the default allocator");
+
+    //---------------------------------------------------------------
+    // Spill to the heap, then move and shrink back
+    //---------------------------------------------------------------
+    for (size_t i = kInlineCapacity; i < kTestSize + kInlineCapacity; ++i)
+        testVec.push_back(static_cast<Type>(i + 1));
+
+    if (testVec.IsInline() || testVec.size() != kTestSize + kInlineCapacity || testVec.back() != static_cast<Type>(kTestSize + kInlineCapacity))
+        RETURN_ERROR("small_vector::push_back() heap");
+
+    movedVec = std::move(testVec);
+    if (movedVec.IsInline() || !testVec.IsInline() || !testVec.empty() || movedVec.size() != kTestSize + kInlineCapacity)
+        RETURN_ERROR("small_vector move heap");
+
+    movedVec.resize(kInlineCapacity);
+    movedVec.shrink_to_fit();
+    if (!movedVec.IsInline() || movedVec.size() != kInlineCapacity || movedVec.front() != static_cast<Type>(1))
+        RETURN_ERROR("small_vector::shrink_to_fit()");
+
+    //---------------------------------------------------------------
+    // Usable as a vector
+    //---------------------------------------------------------------
+    vector<Type>& baseVec = movedVec;
+    baseVec.insert(0, static_cast<Type>(0));
+    if (baseVec.Find(static_cast<Type>(0)) != 0u || baseVec.Find(static_cast<Type>(1)) != 1u)
+        RETURN_ERROR("small_vector as vector");
+
+    //---------------------------------------------------------------
+    // Non trivial elements
+    //---------------------------------------------------------------
+    small_vector<std::string, kInlineCapacity> stringVec;
+    for (size_t i = 0; i < kTestSize; ++i)
+        stringVec.push_back(std::string(32, static_cast<char>('a' + i % 26)));
+
+    small_vector<std::string, kInlineCapacity> stringCopy(stringVec);
+    stringVec.resize(1);
+    stringVec.shrink_to_fit();
+    stringCopy.swap(stringVec);
+    if (stringVec.size() != kTestSize || stringCopy.size() != 1 || !stringCopy.IsInline() || stringCopy[0] != std::string(32, 'a'))
+        RETURN_ERROR("small_vector<std::string>");
+
+    //---------------------------------------------------------------
+    // Success
+    //---------------------------------------------------------------
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// The heap buffer was taken over by another vector, go back to the inline one
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kInlineCapacity, class Allocator>
+inline void small_vector<Type, kInlineCapacity, Allocator>::_reset_to_inline_buffer()
+{
+    if (this->m_pBuffer)
+        return;
+
+    this->m_pBuffer = m_inlineBuffer;
+    this->m_capacity = kInlineCapacity;
+    this->m_isInlineBuffer = true;
+}
+
+}
@@ -1,159 +1,742 @@
 #pragma once
 
 #include "Tests/StructureManager.h"
-#include "list.h"
-#include "vector.h"
+#include "allocator.h"
+#include "hash.h"
+
+#include <assert.h>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// SSE2 is used to probe 16 control bytes at once, fall back to a scalar loop when it's not available
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZXSTL_HASH_SSE2 1
+#include <emmintrin.h>
+#else
+#define ZXSTL_HASH_SSE2 0
+#endif
 
 namespace zxstl
 {
+// Capacity policy of unordered_map
+// 0 = any multiple of the group width, the first group is picked by modulo and groups are probed linearly
+// 1 = power of two, the first group is picked by masking and groups are probed triangularly
+#define HASH_POWER_OF_TWO_CAPACITY 1
+
+//--------------------------------------------------------------------------------------------------------------------
+// Control byte for every slot in the hash table
+//  - Full slots store the low 7 bits of the hash (H2), so they are always >= 0
+//  - Empty, deleted and the end sentinel are negative
+//--------------------------------------------------------------------------------------------------------------------
+namespace hash_control
+{
+	using ControlByte = int8_t;
+
+	static constexpr ControlByte kEmpty = -128;		// 0b10000000
+	static constexpr ControlByte kDeleted = -2;		// 0b11111110
+	static constexpr ControlByte kSentinel = -1;	// 0b11111111, placed after the last slot to stop iterators
+	static constexpr size_t kGroupWidth = 16;		// How many control bytes are probed at once
+
+	constexpr bool IsFull(ControlByte control) { return control >= 0; }
+	constexpr bool IsEmptyOrDeleted(ControlByte control) { return control < kSentinel; }
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// A group of kGroupWidth control bytes. Every Match function returns a bit mask, bit i is set if byte i matches.
+	//--------------------------------------------------------------------------------------------------------------------
+	struct Group
+	{
+#if ZXSTL_HASH_SSE2
+		__m128i m_controls;
+
+		explicit Group(const ControlByte* pControls)
+			: m_controls{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pControls)) }
+		{
+		}
+
+		uint32_t Match(ControlByte h2) const
+		{
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_controls)));
+		}
+
+		uint32_t MatchEmpty() const
+		{
+			return Match(kEmpty);
+		}
+
+		uint32_t MatchEmptyOrDeleted() const
+		{
+			// kEmpty and kDeleted are both less than kSentinel
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(kSentinel), m_controls)));
+		}
+#else
+		const ControlByte* m_pControls;
+
+		explicit Group(const ControlByte* pControls)
+			: m_pControls{ pControls }
+		{
+		}
+
+		uint32_t Match(ControlByte h2) const
+		{
+			uint32_t mask = 0;
+			for (size_t i = 0; i < kGroupWidth; ++i)
+				mask |= static_cast<uint32_t>(m_pControls[i] == h2) << i;
+			return mask;
+		}
+
+		uint32_t MatchEmpty() const
+		{
+			return Match(kEmpty);
+		}
+
+		uint32_t MatchEmptyOrDeleted() const
+		{
+			uint32_t mask = 0;
+			for (size_t i = 0; i < kGroupWidth; ++i)
+				mask |= static_cast<uint32_t>(IsEmptyOrDeleted(m_pControls[i])) << i;
+			return mask;
+		}
+#endif
+	};
+}
+
 //--------------------------------------------------------------------------------------------------------------------
-// Custom templated chained hash table implementation
+// Forward iterator over the full slots of an unordered_map
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
+template<typename Map>
+class unordered_map_iterator
+{
+public:
+	using ValueType = typename Map::ValueType;
+
+private:
+	const hash_control::ControlByte* m_pControl;
+	ValueType* m_pSlot;
+
+public:
+	unordered_map_iterator(const hash_control::ControlByte* pControl, ValueType* pSlot)
+		: m_pControl{ pControl }
+		, m_pSlot{ pSlot }
+	{
+		SkipEmptySlots();
+	}
+
+	unordered_map_iterator& operator++()
+	{
+		++m_pControl;
+		++m_pSlot;
+		SkipEmptySlots();
+		return *this;
+	}
+
+	unordered_map_iterator operator++(int)
+	{
+		unordered_map_iterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+
+	ValueType* operator->() const { return m_pSlot; }
+	ValueType& operator*() const { return *m_pSlot; }
+	bool operator==(const unordered_map_iterator& other) const { return m_pSlot == other.m_pSlot; }
+	bool operator!=(const unordered_map_iterator& other) const { return m_pSlot != other.m_pSlot; }
+
+private:
+	// The sentinel after the last slot is not empty or deleted, so this loop always stops
+	void SkipEmptySlots()
+	{
+		while (m_pControl && hash_control::IsEmptyOrDeleted(*m_pControl))
+		{
+			++m_pControl;
+			++m_pSlot;
+		}
+	}
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// Custom templated open addressing hash table implementation, SwissTable style
+//  - Keys and values are stored inline in one flat slot array, no node allocation per element
+//  - A parallel control byte array holds 7 bits of every key's hash, probed 16 bytes at a time with SSE2
+//  - Probing walks groups of 16 slots, starting at the group selected by the rest of the hash
+//  - Growing is incremental: the old table is kept alive and drained a few slots per insert / erase,
+//    so no single insertion pays for moving the whole table
+//  - Hasher and KeyEqual are pluggable. If Hasher defines is_transparent, find / contains / erase take any key type
+//    it can hash, e.g. a std::string_view can probe a std::string keyed map without allocating
+//  - Like std::unordered_map the allocator is declared for pair<const Key, Type>, it's rebound to the slots and
+//    the control bytes
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher = hash<Key>, typename KeyEqual = std::equal_to<>, typename Allocator = allocator<std::pair<const Key, Type>>>
 class unordered_map
 {
-	using Table = std::pair<size_t, list<Type>*>;
+public:
+	using KeyType = Key;
+	using MappedType = Type;
+	using ValueType = std::pair<const Key, Type>;
+	using iterator = unordered_map_iterator<unordered_map<Key, Type, Hasher, KeyEqual, Allocator>>;
+
+	static constexpr float kDefaultMaxLoadFactor = 0.875f;
+	static constexpr size_t kMigrationStep = 2 * hash_control::kGroupWidth;		// Old slots moved per insert / erase while growing
 
 private:
-	Table* m_pTable;
-	size_t m_capacity;
-	// Using m_pValues's size
+	using ControlByte = hash_control::ControlByte;
+	using Group = hash_control::Group;
+	using SlotAllocator = rebind_allocator_t<Allocator, ValueType>;
+	using ControlAllocator = rebind_allocator_t<Allocator, ControlByte>;
+
+	static constexpr bool kIsNothrowMoveAssignable = std::allocator_traits<SlotAllocator>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<SlotAllocator>::is_always_equal::value;
+
+	struct Table
+	{
+		ControlByte* m_pControl = nullptr;	// m_capacity + 1 control bytes, the last one is the sentinel
+		ValueType* m_pSlots = nullptr;		// m_capacity uninitialized slots, only the full ones hold an element
+		size_t m_capacity = 0;				// Always a multiple of kGroupWidth
+		size_t m_growthLeft = 0;			// How many empty slots can still be used before we have to grow
+
+		ValueType* GetSlots() const { return m_pSlots; }
+	};
+
+	Table m_table;				// Every new element goes here
+	Table m_oldTable;			// Only valid while growing, drained into m_table
+	size_t m_migrateIndex;		// Next slot of m_oldTable to move
+	size_t m_size;				// Elements in both tables
+	float m_maxLoadFactor;
+	Hasher m_hasher;
+	KeyEqual m_keyEqual;
+	SlotAllocator m_slotAllocator;			// Both tables come from here. Kept on copy assignment, see operator=(unordered_map&&) for moves
+	ControlAllocator m_controlAllocator;
 
 public:
+	// Member functions
 	unordered_map();
-	unordered_map(size_t capacity);
+	explicit unordered_map(const Allocator& alloc);
+	unordered_map(size_t capacity, const Hasher& hasher = Hasher(), const KeyEqual& keyEqual = KeyEqual(), const Allocator& alloc = Allocator());
+	unordered_map(const unordered_map& other);
+	unordered_map(unordered_map&& other) noexcept;
+	unordered_map& operator=(const unordered_map& other);
+	unordered_map& operator=(unordered_map&& other) noexcept(kIsNothrowMoveAssignable);
 	~unordered_map();
 
-	void Insert(Key key, const Type& data);
-	void Delete(Key key);
-	//bool Find(Key key, const Value& outData) const;
+	Allocator get_allocator() const { return Allocator(m_slotAllocator); }
+
+	// Iterators, begin() finishes any pending growth so every element is visited
+	iterator begin();
+	iterator end() { return iterator(nullptr, m_table.GetSlots() + m_table.m_capacity); }
+
+	// Capacity
+	bool empty() const { return m_size == 0; }
+	size_t size() const { return m_size; }
+	size_t capacity() const { return m_table.m_capacity; }
+
+	// Modifiers
+	void clear();
+	std::pair<iterator, bool> insert(const Key& key, const Type& data);
+	std::pair<iterator, bool> insert_or_assign(const Key& key, const Type& data);
+	template <class... Args> std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args);
+	size_t erase(const Key& key) { return InternalErase(key); }
+	template <class K, class H = Hasher, class = typename H::is_transparent> size_t erase(const K& key) { return InternalErase(key); }
+	void erase(iterator position);
+
+	// Lookup, the templated overloads only exist if Hasher is transparent
+	iterator find(const Key& key) { return InternalFind(key); }
+	template <class K, class H = Hasher, class = typename H::is_transparent> iterator find(const K& key) { return InternalFind(key); }
+	bool contains(const Key& key) { return find(key) != end(); }
+	template <class K, class H = Hasher, class = typename H::is_transparent> bool contains(const K& key) { return find(key) != end(); }
+	Type& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+	// Observers
+	Hasher hash_function() const { return m_hasher; }
+	KeyEqual key_eq() const { return m_keyEqual; }
+
+	// Hash policy
+	float load_factor() const { return m_table.m_capacity > 0 ? static_cast<float>(m_size) / static_cast<float>(m_table.m_capacity) : 0.0f; }
+	float max_load_factor() const { return m_maxLoadFactor; }
+	void max_load_factor(float maxLoadFactor);
+	void rehash(size_t count);
+	void reserve(size_t count);
+	bool IsGrowing() const { return m_oldTable.m_pControl != nullptr; }
+
+	// Additional stuff
+	template <class K> const ValueType* Peek(const K& key) const;
+	template <class Function> void ForEach(Function&& function) const;
 	void Print() const;
-    void Clear();
 
+	// Testings
 	static void Test();
+	static bool UnitTest();
 
 private:
-	size_t Hash(Key key) const;
-	void Destroy();
+	template <class K> size_t Hash(const K& key) const { return m_hasher(key); }
+	size_t MaxLoad(size_t capacity) const;
+	size_t CapacityForCount(size_t count) const;
+	static size_t RoundUpCapacity(size_t capacity);
+	static size_t FirstGroup(size_t hash, size_t groupCount);
+	static size_t NextGroup(size_t groupIndex, size_t probe, size_t groupCount);
+
+	iterator MakeIterator(size_t index) { return iterator(m_table.m_pControl + index, m_table.GetSlots() + index); }
+	template <class K> iterator InternalFind(const K& key);
+	template <class K> size_t InternalErase(const K& key);
+	template <class K> size_t FindIndex(const Table& table, const K& key, size_t hash) const;
+	size_t FindInsertIndex(const Table& table, size_t hash) const;
+	size_t InsertNew(size_t hash, ValueType&& value);
+	void EraseAt(Table& table, size_t index);
+
+	void Grow();
+	void MigrateSome(size_t slotCount);
+	void FinishMigration() { MigrateSome(m_oldTable.m_capacity); }
+	void Rehash(size_t newCapacity);
+	void Allocate(Table& table, size_t capacity, size_t maxLoad);
+	void Destroy(Table& table);
 };
 
 //--------------------------------------------------------------------------------------------------------------------
-// Ctor
+// Ctor, no memory is allocated until the first insertion
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::unordered_map()
+	: unordered_map(Allocator())
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ctor with the allocator to take the tables from
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::unordered_map(const Allocator& alloc)
+	: m_table{}
+	, m_oldTable{}
+	, m_migrateIndex{ 0 }
+	, m_size{ 0 }
+	, m_maxLoadFactor{ kDefaultMaxLoadFactor }
+	, m_hasher{}
+	, m_keyEqual{}
+	, m_slotAllocator(alloc)
+	, m_controlAllocator(alloc)
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ctor with initial capacity, rounded up according to the capacity policy
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::unordered_map(size_t capacity, const Hasher& hasher /*= Hasher()*/, const KeyEqual& keyEqual /*= KeyEqual()*/, const Allocator& alloc /*= Allocator()*/)
+	: unordered_map(alloc)
+{
+	m_hasher = hasher;
+	m_keyEqual = keyEqual;
+
+	if (capacity > 0)
+		Rehash(capacity);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Copy ctor, the allocator is picked by select_on_container_copy_construction
+// Time:  O(n), n = other's capacity
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::unordered_map(const unordered_map& other)
+	: unordered_map(Allocator(std::allocator_traits<SlotAllocator>::select_on_container_copy_construction(other.m_slotAllocator)))
+{
+	*this = other;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move ctor, the allocator moves along with the tables
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline unordered_map<Key, Type>::unordered_map()
-	: m_capacity{ kInitialCapacity }
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::unordered_map(unordered_map&& other) noexcept
+	: unordered_map(Allocator(other.m_slotAllocator))
 {
-	m_pTable = new Table[m_capacity];
-	for (size_t i = 0; i < m_capacity; ++i)
+	*this = std::move(other);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Copy assignment.
+// If the other is not growing, control bytes are copied as is so every element keeps its slot.
+// Otherwise elements of both tables are inserted into one table big enough for all of them.
+// Time:  O(n), n = other's capacity
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>& unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::operator=(const unordered_map& other)
+{
+	// Edge-case checking
+	if (this == &other)
+		return *this;
+
+	clear();
+	Destroy(m_table);
+	m_maxLoadFactor = other.m_maxLoadFactor;
+	m_hasher = other.m_hasher;
+	m_keyEqual = other.m_keyEqual;
+
+	if (other.m_table.m_capacity == 0)
+		return *this;
+
+	if (!other.IsGrowing())
+	{
+		Allocate(m_table, other.m_table.m_capacity, 0);
+		std::memcpy(m_table.m_pControl, other.m_table.m_pControl, m_table.m_capacity + 1);
+
+		ValueType* pSlots = m_table.GetSlots();
+		ValueType* pOtherSlots = other.m_table.GetSlots();
+		for (size_t i = 0; i < m_table.m_capacity; ++i)
+		{
+			if (hash_control::IsFull(m_table.m_pControl[i]))
+				new(pSlots + i) ValueType(pOtherSlots[i]);
+		}
+
+		m_table.m_growthLeft = other.m_table.m_growthLeft;
+		m_size = other.m_size;
+		return *this;
+	}
+
+	Rehash(CapacityForCount(other.m_size));
+	for (const Table* pTable : { &other.m_oldTable, &other.m_table })
 	{
-		m_pTable[i].second = new list<Type>;
+		ValueType* pOtherSlots = pTable->GetSlots();
+		for (size_t i = 0; i < pTable->m_capacity; ++i)
+		{
+			if (hash_control::IsFull(pTable->m_pControl[i]))
+				InsertNew(Hash(pOtherSlots[i].first), ValueType(pOtherSlots[i]));
+		}
 	}
+
+	return *this;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Ctor with initial capacity
+// Move assignment. The tables are taken over if the allocator propagates or both allocators are equal, otherwise
+// the elements are moved one by one into memory from this map's allocator.
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline unordered_map<Key, Type>::unordered_map(size_t capacity)
-	: m_capacity{ capacity }
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>& unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::operator=(unordered_map&& other) noexcept(kIsNothrowMoveAssignable)
 {
-	m_pTable = new Table[m_capacity];
-	for (size_t i = 0; i < m_capacity; ++i)
+	// Edge-case checking
+	if (this == &other)
+		return *this;
+
+	clear();
+	Destroy(m_table);
+
+	constexpr bool kPropagateAllocator = std::allocator_traits<SlotAllocator>::propagate_on_container_move_assignment::value;
+	if (!kPropagateAllocator && m_slotAllocator != other.m_slotAllocator)
 	{
-		m_pTable[i].second = new list<Type>;
+		m_maxLoadFactor = other.m_maxLoadFactor;
+		m_hasher = other.m_hasher;
+		m_keyEqual = other.m_keyEqual;
+
+		Rehash(CapacityForCount(other.m_size));
+		for (Table* pTable : { &other.m_oldTable, &other.m_table })
+		{
+			ValueType* pOtherSlots = pTable->GetSlots();
+			for (size_t i = 0; i < pTable->m_capacity; ++i)
+			{
+				if (hash_control::IsFull(pTable->m_pControl[i]))
+					InsertNew(Hash(pOtherSlots[i].first), std::move(pOtherSlots[i]));
+			}
+		}
+
+		other.clear();
+		return *this;
 	}
+
+	if constexpr (kPropagateAllocator)
+	{
+		m_slotAllocator = std::move(other.m_slotAllocator);
+		m_controlAllocator = std::move(other.m_controlAllocator);
+	}
+
+	// Move everything over
+	m_table = other.m_table;
+	m_oldTable = other.m_oldTable;
+	m_migrateIndex = other.m_migrateIndex;
+	m_size = other.m_size;
+	m_maxLoadFactor = other.m_maxLoadFactor;
+	m_hasher = std::move(other.m_hasher);
+	m_keyEqual = std::move(other.m_keyEqual);
+
+	// Clear the other
+	other.m_table = Table{};
+	other.m_oldTable = Table{};
+	other.m_migrateIndex = 0;
+	other.m_size = 0;
+
+	return *this;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 // Dtor
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline unordered_map<Key, Type>::~unordered_map()
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::~unordered_map()
 {
-	Destroy();
+	clear();
+	Destroy(m_table);
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// insert x at the head of list T[Hash(key)]
+// Return iterator to the first element. Finishes growing first, so the iteration covers every element
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline void unordered_map<Key, Type>::Insert(Key key, const Type& data)
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline typename unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::iterator unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::begin()
 {
-	size_t hashKey = Hash(key);
-	m_pTable[hashKey].first = hashKey;
-	m_pTable[hashKey].second->PushBack(data);
+	FinishMigration();
+	return iterator(m_table.m_pControl, m_table.GetSlots());
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// delete x from the list T[Hash(key)]
+// Destroy every element but keep the memory of the current table, so it can be refilled without allocating
+// Time:  O(n), n = capacity
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline void unordered_map<Key, Type>::Delete(Key key)
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::clear()
 {
-	size_t hashKey = Hash(key);
-	m_pTable[hashKey].second->PopBack();
-	if (m_pTable[hashKey].second->Empty())
+	Destroy(m_oldTable);
+	m_migrateIndex = 0;
+	m_size = 0;
+
+	if (m_table.m_capacity == 0)
+		return;
+
+	if constexpr (!std::is_trivially_destructible_v<ValueType>)
 	{
-		delete m_pTable[hashKey].second;
-		m_pTable[hashKey].second = nullptr;
+		ValueType* pSlots = m_table.GetSlots();
+		for (size_t i = 0; i < m_table.m_capacity; ++i)
+		{
+			if (hash_control::IsFull(m_table.m_pControl[i]))
+				pSlots[i].~ValueType();
+		}
 	}
+
+	std::memset(m_table.m_pControl, static_cast<unsigned char>(hash_control::kEmpty), m_table.m_capacity);
+	m_table.m_growthLeft = MaxLoad(m_table.m_capacity);
 }
 
-//template<typename Key, typename Value>
-//inline bool HashTable<Key, Value>::Find(Key key, const Value& outData) const
-//{
-//	return m_pTable[Hash(key)].second->SearchByVal(outData);
-//}
+//--------------------------------------------------------------------------------------------------------------------
+// Insert key value pair if the key doesn't exist yet.
+// Returns the iterator of the element with the key, and whether the insertion took place
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline std::pair<typename unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::iterator, bool> unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::insert(const Key& key, const Type& data)
+{
+	return try_emplace(key, data);
+}
 
 //--------------------------------------------------------------------------------------------------------------------
-// Print key value pair
+// Insert key value pair, or overwrite the value if the key exists
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline std::pair<typename unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::iterator, bool> unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::insert_or_assign(const Key& key, const Type& data)
+{
+	std::pair<iterator, bool> result = try_emplace(key, data);
+	if (!result.second)
+		result.first->second = data;
+	return result;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Construct the value in place from args if the key doesn't exist yet
+// Time:  O(1) on average
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline void unordered_map<Key, Type>::Print() const
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class ...Args>
+inline std::pair<typename unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::iterator, bool> unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::try_emplace(const Key& key, Args&&... args)
 {
-	for (size_t i = 0; i < m_capacity; ++i)
+	// find() already moves a few old slots and pulls the key out of the old table if it's there
+	iterator itr = find(key);
+	if (itr != end())
+		return { itr, false };
+
+	const size_t index = InsertNew(Hash(key), ValueType(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)));
+	return { MakeIterator(index), true };
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the element with the key, return how many elements are erased
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class K>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::InternalErase(const K& key)
+{
+	MigrateSome(kMigrationStep);
+
+	const size_t hash = Hash(key);
+	size_t index = FindIndex(m_table, key, hash);
+	if (index != m_table.m_capacity)
+	{
+		EraseAt(m_table, index);
+		return 1;
+	}
+
+	index = FindIndex(m_oldTable, key, hash);
+	if (index != m_oldTable.m_capacity)
 	{
-		if (!m_pTable[i].second->Empty())
+		EraseAt(m_oldTable, index);
+		return 1;
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the element at the iterator
+// Time:  O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::erase(iterator position)
+{
+	assert(position != end());
+	EraseAt(m_table, static_cast<size_t>(&(*position) - m_table.GetSlots()));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Find the element with the key, return end() if not found.
+// While growing, a key found in the old table is moved to the new one so the iterator stays in a single table.
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class K>
+inline typename unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::iterator unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::InternalFind(const K& key)
+{
+	MigrateSome(kMigrationStep);
+
+	const size_t hash = Hash(key);
+	size_t index = FindIndex(m_table, key, hash);
+	if (index != m_table.m_capacity)
+		return MakeIterator(index);
+
+	const size_t oldIndex = FindIndex(m_oldTable, key, hash);
+	if (oldIndex == m_oldTable.m_capacity)
+		return end();
+
+	// Pull it into the new table. Take it out first, inserting may finish the migration and touch the old slot
+	ValueType value(std::move(m_oldTable.GetSlots()[oldIndex]));
+	EraseAt(m_oldTable, oldIndex);
+	index = InsertNew(hash, std::move(value));
+	return MakeIterator(index);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Set max load factor, shrinking it may grow the table right away
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::max_load_factor(float maxLoadFactor)
+{
+	// Too small a factor lets inserts outrun the incremental migration
+	assert(maxLoadFactor >= 0.125f && maxLoadFactor < 1.0f);
+	m_maxLoadFactor = maxLoadFactor;
+
+	// Let the current table adopt the new policy
+	if (m_table.m_capacity > 0)
+		rehash(0);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Rebuild the table so it has at least count slots and can hold every element under max load factor.
+// This is a full stop-the-world rehash, use reserve() up front to avoid growing at all.
+// Time:  O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::rehash(size_t count)
+{
+	FinishMigration();
+
+	const size_t minCapacity = CapacityForCount(m_size);
+	Rehash(count > minCapacity ? count : minCapacity);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Make room for count elements without growing
+// Time:  O(n) if the table has to grow, O(1) otherwise
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::reserve(size_t count)
+{
+	if (count > 0 && (IsGrowing() || MaxLoad(m_table.m_capacity) < count))
+		rehash(CapacityForCount(count));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Find without pulling the element into the new table or helping the growth, return nullptr if the key is missing.
+// Nothing is modified, so any number of threads can Peek() the same map at once.
+// Time:  O(1) on average
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class K>
+inline const typename unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::ValueType* unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::Peek(const K& key) const
+{
+	const size_t hash = Hash(key);
+	for (const Table* pTable : { &m_table, &m_oldTable })
+	{
+		const size_t index = FindIndex(*pTable, key, hash);
+		if (index != pTable->m_capacity)
+			return pTable->GetSlots() + index;
+	}
+
+	return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call function(const ValueType&) on every element in both tables. Like Peek(), nothing is modified.
+// Time:  O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class Function>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::ForEach(Function&& function) const
+{
+	for (const Table* pTable : { &m_oldTable, &m_table })
+	{
+		const ValueType* pSlots = pTable->GetSlots();
+		for (size_t i = 0; i < pTable->m_capacity; ++i)
 		{
-			std::cout << "Key: " << m_pTable[i].first << ", Value: ";
-			m_pTable[i].second->Print();
+			if (hash_control::IsFull(pTable->m_pControl[i]))
+				function(pSlots[i]);
 		}
 	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// Delete current content
+// Print key value pair
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline void unordered_map<Key, Type>::Clear()
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::Print() const
 {
-	Destroy();
+	ForEach([](const ValueType& pair) { std::cout << "Key: " << pair.first << ", Value: " << pair.second << std::endl; });
+
+	std::cout << "Size: " << m_size << ", Capacity: " << capacity() << ", Load factor: " << load_factor() << std::endl;
 }
 
-template<typename Key, typename Type>
-inline void unordered_map<Key, Type>::Test()
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::Test()
 {
 	// Variables for testing
 	bool shouldQuit = false;
-	size_t i = 0;       // Used as capacity and index
 	Key key = 0;		// Key in hash table
 	Type value = 0;		// Be used as value
 
-	// Create list
-
-	unordered_map<Key, Type> hashTable(9);
+	// Create hash table
+	unordered_map hashTable(9);
 #if _DEBUG
-	hashTable.Insert(5,  0);	// Hashed 5
-	hashTable.Insert(28, 0);	// Hashed 1
-	hashTable.Insert(19, 0);	// Hashed 1, Collision occurs at 1, value added by chainning
-	hashTable.Insert(15, 0);	// Hashed 6
-	hashTable.Insert(20, 0);	// Hashed 2
-	hashTable.Insert(33, 0);	// Hashed 6, Collision occurs at 6, value added by chainning
-	hashTable.Insert(12, 0);	// Hashed 3
-	hashTable.Insert(17, 0);	// Hashed 8
-	hashTable.Insert(10, 0);	// Hashed 1, Collision occurs at 1, value added by chainning
-	
+	hashTable.insert(5,  0);
+	hashTable.insert(28, 0);
+	hashTable.insert(19, 0);
+	hashTable.insert(15, 0);
+	hashTable.insert(20, 0);
+	hashTable.insert(33, 0);
+	hashTable.insert(12, 0);
+	hashTable.insert(17, 0);
+	hashTable.insert(10, 0);
 #endif
 
 	// Loop work
@@ -173,26 +756,40 @@ inline void unordered_map<Key, Type>::Test()
 			std::cin >> key;
 			std::cout << "Enter inserting value: ";
 			std::cin >> value;
-			hashTable.Insert(key, value);
+			hashTable.insert_or_assign(key, value);
 			break;
 
 		case '1':
-			hashTable.Clear();
+			hashTable.clear();
 			break;
 
 		case '2':
 			std::cout << "Enter key: ";
 			std::cin >> key;
-			hashTable.Delete(key);
+			hashTable.erase(key);
+			break;
+
+		case '3':
+		{
+			std::cout << "Enter key: ";
+			std::cin >> key;
+			iterator itr = hashTable.find(key);
+			if (itr != hashTable.end())
+				std::cout << "Found value: " << itr->second << std::endl;
+			else
+				std::cout << "Key is not found." << std::endl;
+			system("pause");
 			break;
+		}
 
-		//case '4':
-		//	std::cout << "Enter key: ";
-		//	std::cin >> key;
-		//	std::cout << "Enter inserting value: ";
-		//	std::cin >> value;
-		//	hashTable.Find(key, value);
-		//	break;
+		case '4':
+		{
+			size_t count = 0;
+			std::cout << "Enter element count to reserve: ";
+			std::cin >> count;
+			hashTable.reserve(count);
+			break;
+		}
 
 		case 'q':            shouldQuit = true;            break;
 		}
@@ -202,31 +799,428 @@ inline void unordered_map<Key, Type>::Test()
 }
 
 //--------------------------------------------------------------------------------------------------------------------
-// The hash function
+// Unit Test for unordered_map
 //--------------------------------------------------------------------------------------------------------------------
-template<typename Key, typename Type>
-inline size_t unordered_map<Key, Type>::Hash(Key key) const
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline bool unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::UnitTest()
 {
-	return static_cast<size_t>(key % m_capacity);
+	//---------------------------------------------------------------
+	// Insert enough keys to grow several times
+	//---------------------------------------------------------------
+	static constexpr size_t kCount = kTestSize * 100;
+	unordered_map testMap;
+	for (size_t i = 0; i < kCount; ++i)
+	{
+		if (!testMap.insert(static_cast<Key>(i), static_cast<Type>(i)).second)
+			RETURN_ERROR("unordered_map::insert()");
+
+		if (testMap.load_factor() > testMap.max_load_factor())
+			RETURN_ERROR("unordered_map::load_factor()");
+	}
+
+	if (testMap.size() != kCount)
+		RETURN_ERROR("unordered_map::size()");
+
+	//---------------------------------------------------------------
+	// Lookup
+	//---------------------------------------------------------------
+	for (size_t i = 0; i < kCount; ++i)
+	{
+		iterator itr = testMap.find(static_cast<Key>(i));
+		if (itr == testMap.end() || itr->second != static_cast<Type>(i))
+			RETURN_ERROR("unordered_map::find()");
+	}
+
+	//---------------------------------------------------------------
+	// Erase every other key, then make sure only the odd ones are left
+	//---------------------------------------------------------------
+	for (size_t i = 0; i < kCount; i += 2)
+	{
+		if (testMap.erase(static_cast<Key>(i)) != 1)
+			RETURN_ERROR("unordered_map::erase()");
+	}
+
+	size_t count = 0;
+	for (const ValueType& pair : testMap)
+	{
+		if (static_cast<size_t>(pair.first) % 2 == 0)
+			RETURN_ERROR("unordered_map::iterator");
+		++count;
+	}
+
+	if (count != kCount / 2 || testMap.size() != kCount / 2)
+		RETURN_ERROR("unordered_map::erase()");
+
+	//---------------------------------------------------------------
+	// Hash policy
+	//---------------------------------------------------------------
+	unordered_map reservedMap;
+	reservedMap.reserve(kCount);
+	const size_t reservedCapacity = reservedMap.capacity();
+	for (size_t i = 0; i < kCount; ++i)
+		reservedMap.insert(static_cast<Key>(i), static_cast<Type>(i));
+
+	if (reservedMap.capacity() != reservedCapacity || reservedMap.IsGrowing())
+		RETURN_ERROR("unordered_map::reserve()");
+
+	reservedMap.max_load_factor(0.5f);
+	if (reservedMap.load_factor() > 0.5f || reservedMap.size() != kCount)
+		RETURN_ERROR("unordered_map::max_load_factor()");
+
+	//---------------------------------------------------------------
+	// Heterogeneous lookup, probing string keys with string_view
+	//---------------------------------------------------------------
+	zxstl::unordered_map<std::string, Type> stringMap;
+	for (size_t i = 0; i < kCount; ++i)
+		stringMap.insert(std::to_string(i), static_cast<Type>(i));
+
+	for (size_t i = 0; i < kCount; ++i)
+	{
+		const std::string key = std::to_string(i);
+		auto itr = stringMap.find(std::string_view(key));
+		if (itr == stringMap.end() || itr->second != static_cast<Type>(i))
+			RETURN_ERROR("unordered_map::find(string_view)");
+	}
+
+	if (stringMap.contains("not a number") || stringMap.erase(std::string_view("0")) != 1 || stringMap.contains("0"))
+		RETURN_ERROR("unordered_map::erase(string_view)");
+
+	//---------------------------------------------------------------
+	// Over-aligned values still get aligned slots
+	//---------------------------------------------------------------
+	struct alignas(64) AlignedValue
+	{
+		Type m_value;
+	};
+
+	zxstl::unordered_map<Key, AlignedValue> alignedMap;
+	for (size_t i = 0; i < kTestSize; ++i)
+		alignedMap.insert(static_cast<Key>(i), AlignedValue{ static_cast<Type>(i) });
+
+	for (const auto& pair : alignedMap)
+	{
+		if (reinterpret_cast<uintptr_t>(&pair.second) % alignof(AlignedValue) != 0)
+			RETURN_ERROR("unordered_map slot alignment");
+	}
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
 }
 
-template<typename Key, typename Type>
-inline void unordered_map<Key, Type>::Destroy()
+//--------------------------------------------------------------------------------------------------------------------
+// How many elements a table with capacity can hold. There is always at least one empty slot, so probing stops.
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::MaxLoad(size_t capacity) const
 {
-	for (size_t i = 0; i < m_capacity; ++i)
+	if (capacity == 0)
+		return 0;
+
+	const size_t maxLoad = static_cast<size_t>(static_cast<float>(capacity) * m_maxLoadFactor);
+	return maxLoad < capacity ? maxLoad : capacity - 1;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Smallest capacity which can hold count elements under max load factor
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::CapacityForCount(size_t count) const
+{
+	size_t capacity = RoundUpCapacity(static_cast<size_t>(static_cast<float>(count) / m_maxLoadFactor) + 1);
+	while (MaxLoad(capacity) < count)
+		capacity = RoundUpCapacity(capacity + 1);
+	return capacity;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Round capacity up to a multiple of the group width, and to a power of two if required by the policy
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::RoundUpCapacity(size_t capacity)
+{
+	if (capacity < hash_control::kGroupWidth)
+		return hash_control::kGroupWidth;
+
+#if HASH_POWER_OF_TWO_CAPACITY
+	return std::bit_ceil(capacity);
+#else
+	return (capacity + hash_control::kGroupWidth - 1) / hash_control::kGroupWidth * hash_control::kGroupWidth;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Select the first group to probe from H1
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::FirstGroup(size_t hash, size_t groupCount)
+{
+#if HASH_POWER_OF_TWO_CAPACITY
+	return (hash >> 7) & (groupCount - 1);
+#else
+	return (hash >> 7) % groupCount;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Select the next group to probe. 
+// Triangular steps (1, 2, 3...) visit every group exactly once when group count is a power of two.
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::NextGroup(size_t groupIndex, size_t probe, size_t groupCount)
+{
+#if HASH_POWER_OF_TWO_CAPACITY
+	return (groupIndex + probe + 1) & (groupCount - 1);
+#else
+	return (groupIndex + 1 == groupCount) ? 0 : groupIndex + 1;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Probe group by group, return the index of the slot holding the key, or table's capacity if not found
+// The search stops at the first group which has an empty slot, since the key would have been inserted there
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+template<class K>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::FindIndex(const Table& table, const K& key, size_t hash) const
+{
+	if (table.m_capacity == 0)
+		return table.m_capacity;
+
+	const ControlByte h2 = static_cast<ControlByte>(hash & 0x7F);
+	const size_t groupCount = table.m_capacity / hash_control::kGroupWidth;
+	size_t groupIndex = FirstGroup(hash, groupCount);
+	ValueType* pSlots = table.GetSlots();
+
+	for (size_t probe = 0; probe < groupCount; ++probe)
+	{
+		const size_t groupStart = groupIndex * hash_control::kGroupWidth;
+		const Group group(table.m_pControl + groupStart);
+
+		// Check every slot which has the same H2
+		for (uint32_t mask = group.Match(h2); mask != 0; mask &= mask - 1)
+		{
+			const size_t index = groupStart + std::countr_zero(mask);
+			if (m_keyEqual(pSlots[index].first, key))
+				return index;
+		}
+
+		if (group.MatchEmpty() != 0)
+			break;
+
+		groupIndex = NextGroup(groupIndex, probe, groupCount);
+	}
+
+	return table.m_capacity;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Return the first empty or deleted slot along the probe sequence of the hash
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::FindInsertIndex(const Table& table, size_t hash) const
+{
+	const size_t groupCount = table.m_capacity / hash_control::kGroupWidth;
+	size_t groupIndex = FirstGroup(hash, groupCount);
+
+	for (size_t probe = 0; probe < groupCount; ++probe)
+	{
+		const size_t groupStart = groupIndex * hash_control::kGroupWidth;
+		const uint32_t mask = Group(table.m_pControl + groupStart).MatchEmptyOrDeleted();
+		if (mask != 0)
+			return groupStart + std::countr_zero(mask);
+
+		groupIndex = NextGroup(groupIndex, probe, groupCount);
+	}
+
+	// Unreachable, max load factor guarantees there is always a free slot
+	assert(false);
+	return table.m_capacity;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move value into the current table, the key must not exist in either table. Grow first if we are out of room.
+// Returns the index of the new slot
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline size_t unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::InsertNew(size_t hash, ValueType&& value)
+{
+	if (m_table.m_capacity == 0)
+		Rehash(kInitialCapacity);
+
+	size_t index = FindInsertIndex(m_table, hash);
+	if (m_table.m_growthLeft == 0 && m_table.m_pControl[index] == hash_control::kEmpty)
+	{
+		Grow();
+		index = FindInsertIndex(m_table, hash);
+	}
+
+	// Empty slots reduce the growth left, reusing a tombstone doesn't
+	if (m_table.m_pControl[index] == hash_control::kEmpty)
+		--m_table.m_growthLeft;
+
+	new(m_table.GetSlots() + index) ValueType(std::move(value));
+	m_table.m_pControl[index] = static_cast<ControlByte>(hash & 0x7F);
+	++m_size;
+
+	return index;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Destroy the element at index.
+// If its group still has an empty slot no probe ever went past this group, so the slot can become empty again.
+// Otherwise leave a tombstone so lookups keep probing.
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::EraseAt(Table& table, size_t index)
+{
+	assert(index < table.m_capacity && hash_control::IsFull(table.m_pControl[index]));
+
+	if constexpr (!std::is_trivially_destructible_v<ValueType>)
+		table.GetSlots()[index].~ValueType();
+
+	const size_t groupStart = index - index % hash_control::kGroupWidth;
+	if (Group(table.m_pControl + groupStart).MatchEmpty() != 0)
+	{
+		table.m_pControl[index] = hash_control::kEmpty;
+		++table.m_growthLeft;
+	}
+	else
+	{
+		table.m_pControl[index] = hash_control::kDeleted;
+	}
+
+	--m_size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// The current table is out of room.
+// If more than half of the used slots are tombstones, clean them up in place.
+// Otherwise start moving to a bigger table, elements are moved over a few at a time by MigrateSome()
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::Grow()
+{
+	// Growing again before the last one is done, e.g. when lots of keys are inserted with a tiny max load factor
+	FinishMigration();
+
+	if (m_size <= MaxLoad(m_table.m_capacity) / 2)
 	{
-		if (m_pTable[i].second)
+		Rehash(m_table.m_capacity);
+		return;
+	}
+
+	const size_t newCapacity = RoundUpCapacity(m_table.m_capacity * kExpandMultiplier);
+	m_oldTable = m_table;
+	m_migrateIndex = 0;
+	m_table = Table{};
+	Allocate(m_table, newCapacity, MaxLoad(newCapacity));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move up to slotCount slots of the old table into the current one, free the old table once it's drained
+// Time:  O(slotCount)
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::MigrateSome(size_t slotCount)
+{
+	if (!IsGrowing())
+		return;
+
+	ValueType* pOldSlots = m_oldTable.GetSlots();
+	ValueType* pSlots = m_table.GetSlots();
+	const size_t end = (m_oldTable.m_capacity - m_migrateIndex > slotCount) ? m_migrateIndex + slotCount : m_oldTable.m_capacity;
+
+	for (; m_migrateIndex < end; ++m_migrateIndex)
+	{
+		if (!hash_control::IsFull(m_oldTable.m_pControl[m_migrateIndex]))
+			continue;
+
+		// Relocate without going through the full insert path, the new table always has room for every old element
+		ValueType& oldValue = pOldSlots[m_migrateIndex];
+		const size_t hash = Hash(oldValue.first);
+		const size_t index = FindInsertIndex(m_table, hash);
+		if (m_table.m_pControl[index] == hash_control::kEmpty && m_table.m_growthLeft > 0)
+			--m_table.m_growthLeft;
+
+		new(pSlots + index) ValueType(std::move(oldValue));
+		m_table.m_pControl[index] = static_cast<ControlByte>(hash & 0x7F);
+
+		if constexpr (!std::is_trivially_destructible_v<ValueType>)
+			oldValue.~ValueType();
+		m_oldTable.m_pControl[m_migrateIndex] = hash_control::kDeleted;
+	}
+
+	if (m_migrateIndex == m_oldTable.m_capacity)
+	{
+		Destroy(m_oldTable);
+		m_migrateIndex = 0;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Create a new table with newCapacity and move every element over at once
+// Time:  O(n), n = old capacity
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::Rehash(size_t newCapacity)
+{
+	FinishMigration();
+
+	// Keep the old table as is, and drain it in one go
+	m_oldTable = m_table;
+	m_migrateIndex = 0;
+	m_table = Table{};
+
+	const size_t capacity = RoundUpCapacity(newCapacity);
+	Allocate(m_table, capacity, MaxLoad(capacity));
+	FinishMigration();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Allocate empty buffers for the table, capacity must already be rounded up
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::Allocate(Table& table, size_t capacity, size_t maxLoad)
+{
+	assert(!table.m_pControl && !table.m_pSlots);
+	assert(capacity % hash_control::kGroupWidth == 0);
+
+	table.m_capacity = capacity;
+	table.m_growthLeft = maxLoad;
+
+	// Every slot starts empty, sentinel goes at the end
+	table.m_pControl = std::to_address(std::allocator_traits<ControlAllocator>::allocate(m_controlAllocator, capacity + 1));
+	std::memset(table.m_pControl, static_cast<unsigned char>(hash_control::kEmpty), capacity);
+	table.m_pControl[capacity] = hash_control::kSentinel;
+
+	// Uninitialized, the allocator aligns them for ValueType
+	table.m_pSlots = std::to_address(std::allocator_traits<SlotAllocator>::allocate(m_slotAllocator, capacity));
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Destroy every element left in the table and free its buffers
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Type, typename Hasher, typename KeyEqual, typename Allocator>
+inline void unordered_map<Key, Type, Hasher, KeyEqual, Allocator>::Destroy(Table& table)
+{
+	if constexpr (!std::is_trivially_destructible_v<ValueType>)
+	{
+		ValueType* pSlots = table.GetSlots();
+		for (size_t i = 0; i < table.m_capacity; ++i)
 		{
-			delete m_pTable[i].second;
-			m_pTable[i].second = nullptr;
+			if (hash_control::IsFull(table.m_pControl[i]))
+				pSlots[i].~ValueType();
 		}
 	}
 
-	if (m_pTable)
+	if (table.m_pControl)
 	{
-		delete[] m_pTable;
-		m_pTable = nullptr;
+		std::allocator_traits<ControlAllocator>::deallocate(m_controlAllocator, table.m_pControl, table.m_capacity + 1);
+		std::allocator_traits<SlotAllocator>::deallocate(m_slotAllocator, table.m_pSlots, table.m_capacity);
 	}
+	table = Table{};
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,699 @@
+#pragma once
+
+#include "Tests/StructureManager.h"
+#include "allocator.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace zxstl
+{
+// Nodes are sized to one cache line by default, though never hold fewer than 4 elements
+static constexpr size_t kUnrolledListNodeBytes = 64;
+static constexpr size_t kUnrolledListNodeHeaderBytes = 2 * sizeof(void*) + sizeof(size_t);
+
+template<class Type>
+static constexpr size_t kUnrolledListBlockSize = std::max<size_t>(4, (kUnrolledListNodeBytes - kUnrolledListNodeHeaderBytes) / sizeof(Type));
+
+//--------------------------------------------------------------------------------------------------------------------
+// Doubly linked list that packs up to kBlockSize elements into every node.
+//  - Traversal touches one node per kBlockSize elements instead of one per element, and the elements of a node
+//    are contiguous, so walking the list runs at close to array speed
+//  - A full node is split in half on insert, a node that drops below half full after a delete is merged with its
+//    next node when they fit together, so nodes stay at least half full on average
+//  - Index lookups skip whole nodes and start from the closer end
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize = kUnrolledListBlockSize<Type>, class Allocator = allocator<Type>>
+class unrolled_list
+{
+	static_assert(kBlockSize >= 2, "A node must be able to hold two elements to be split");
+
+private:
+	struct Node
+	{
+		Node* m_pNext;
+		Node* m_pPrev;
+		size_t m_count;		// Elements constructed in m_storage, always the first m_count slots
+		alignas(Type) unsigned char m_storage[kBlockSize * sizeof(Type)];
+
+		Node() : m_pNext{ nullptr }, m_pPrev{ nullptr }, m_count{ 0 } {}
+
+		Type* Data() { return std::launder(reinterpret_cast<Type*>(m_storage)); }
+		const Type* Data() const { return std::launder(reinterpret_cast<const Type*>(m_storage)); }
+		bool IsFull() const { return m_count == kBlockSize; }
+	};
+
+	using NodeAllocator = rebind_allocator_t<Allocator, Node>;
+
+	Node* m_pHead;
+	Node* m_pTail;
+	size_t m_size;
+	size_t m_nodeCount;
+	NodeAllocator m_nodeAllocator;	// Every node comes from here
+
+public:
+	template<class ValueType>
+	class Iterator
+	{
+		friend class unrolled_list;
+
+		Node* m_pNode;
+		size_t m_index;		// Index inside m_pNode
+
+		Iterator(Node* pNode, size_t index) : m_pNode{ pNode }, m_index{ index } {}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = ValueType*;
+		using reference = ValueType&;
+
+		Iterator() : Iterator(nullptr, 0) {}
+
+		reference operator*() const { return m_pNode->Data()[m_index]; }
+		pointer operator->() const { return m_pNode->Data() + m_index; }
+		Iterator operator++(int) { Iterator copy = *this; ++*this; return copy; }
+		bool operator==(const Iterator& other) const { return m_pNode == other.m_pNode && m_index == other.m_index; }
+
+		Iterator& operator++()
+		{
+			if (++m_index == m_pNode->m_count)
+			{
+				m_pNode = m_pNode->m_pNext;
+				m_index = 0;
+			}
+			return *this;
+		}
+	};
+
+	using iterator = Iterator<Type>;
+	using const_iterator = Iterator<const Type>;
+
+	// Member functions
+	unrolled_list();
+	explicit unrolled_list(const Allocator& alloc);
+	unrolled_list(const unrolled_list&) = delete;
+	unrolled_list(unrolled_list&& other) noexcept;
+	unrolled_list& operator=(const unrolled_list&) = delete;
+	unrolled_list& operator=(unrolled_list&& other) noexcept;
+	~unrolled_list() { Clear(); }
+
+	// Element access
+	Type& front() { assert(!Empty()); return m_pHead->Data()[0]; }
+	const Type& front() const { assert(!Empty()); return m_pHead->Data()[0]; }
+	Type& back() { assert(!Empty()); return m_pTail->Data()[m_pTail->m_count - 1]; }
+	const Type& back() const { assert(!Empty()); return m_pTail->Data()[m_pTail->m_count - 1]; }
+	Type& operator[](size_t index);
+	const Type& operator[](size_t index) const { return const_cast<unrolled_list&>(*this)[index]; }
+
+	// Iterators
+	iterator begin() { return iterator(m_pHead, 0); }
+	iterator end() { return iterator(nullptr, 0); }
+	const_iterator begin() const { return const_iterator(m_pHead, 0); }
+	const_iterator end() const { return const_iterator(nullptr, 0); }
+
+	// Capacity
+	void PushFront(const Type& val);
+	void PushBack(const Type& val);
+	void Insert(size_t index, const Type& val);
+	void DeleteByIndex(size_t index);
+	void Print(const char* pPrefix = "", const char* pSuffix = "") const;
+	void Clear();
+	Type PopFront();
+	Type PopBack();
+
+	// API
+	bool Empty() const { return m_size == 0; }
+	size_t GetSize() const { return m_size; }
+	size_t GetNodeCount() const { return m_nodeCount; }
+	void Reverse();
+	template<class Compare = std::less<>> void Sort(Compare compare = Compare());
+	template<class Function> void ForEach(Function&& function) const;
+
+	// Tests
+	static bool UnitTest();
+
+private:
+	std::pair<Node*, size_t> SearchNodeByIndex(size_t index) const;
+	Node* CreateNodeAfter(Node* pPrevious);
+	void DeleteNode(Node* pNode);
+	void InsertIntoNode(Node* pNode, size_t index, const Type& val);
+	void EraseFromNode(Node* pNode, size_t index);
+	void MergeWithNextIfSparse(Node* pNode);
+	void TakeOver(unrolled_list& other);
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// Default ctor
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline unrolled_list<Type, kBlockSize, Allocator>::unrolled_list()
+	: unrolled_list(Allocator())
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Ctor with the allocator to take nodes from
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline unrolled_list<Type, kBlockSize, Allocator>::unrolled_list(const Allocator& alloc)
+	: m_pHead{ nullptr }
+	, m_pTail{ nullptr }
+	, m_size{ 0 }
+	, m_nodeCount{ 0 }
+	, m_nodeAllocator(alloc)
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move ctor, takes other's nodes
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline unrolled_list<Type, kBlockSize, Allocator>::unrolled_list(unrolled_list&& other) noexcept
+	: unrolled_list(Allocator(other.m_nodeAllocator))
+{
+	TakeOver(other);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Move assignment, both lists must use equal allocators
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline unrolled_list<Type, kBlockSize, Allocator>& unrolled_list<Type, kBlockSize, Allocator>::operator=(unrolled_list&& other) noexcept
+{
+	assert(m_nodeAllocator == other.m_nodeAllocator);
+
+	if (this != &other)
+	{
+		Clear();
+		TakeOver(other);
+	}
+
+	return *this;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Access the element at index
+// Time: O(n / kBlockSize)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline Type& unrolled_list<Type, kBlockSize, Allocator>::operator[](size_t index)
+{
+	assert(index < m_size);
+
+	auto [pNode, indexInNode] = SearchNodeByIndex(index);
+	return pNode->Data()[indexInNode];
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert val to front
+// Time: O(kBlockSize), the elements of the head node shift up by one
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::PushFront(const Type& val)
+{
+	// Start a new head node rather than splitting a full one, a run of PushFront fills nodes completely
+	if (!m_pHead || m_pHead->IsFull())
+		CreateNodeAfter(nullptr);
+
+	InsertIntoNode(m_pHead, 0, val);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert val to back
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::PushBack(const Type& val)
+{
+	if (!m_pTail || m_pTail->IsFull())
+		CreateNodeAfter(m_pTail);
+
+	new(m_pTail->Data() + m_pTail->m_count) Type(val);
+	++m_pTail->m_count;
+	++m_size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert val to the index, a full node is split in half first
+// Time: O(n / kBlockSize + kBlockSize)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::Insert(size_t index, const Type& val)
+{
+	// Error checking
+	assert(index <= m_size);
+
+	if (index == m_size)
+	{
+		PushBack(val);
+		return;
+	}
+
+	auto [pNode, indexInNode] = SearchNodeByIndex(index);
+
+	if (pNode->IsFull())
+	{
+		// Copy first, val may live in the upper half that is about to move
+		const Type value(val);
+
+		// Move the upper half to a new node after this one
+		Node* pNewNode = CreateNodeAfter(pNode);
+		const size_t half = kBlockSize / 2;
+		std::uninitialized_move(pNode->Data() + half, pNode->Data() + kBlockSize, pNewNode->Data());
+		std::destroy(pNode->Data() + half, pNode->Data() + kBlockSize);
+		pNewNode->m_count = kBlockSize - half;
+		pNode->m_count = half;
+
+		if (indexInNode > half)
+			InsertIntoNode(pNewNode, indexInNode - half, value);
+		else
+			InsertIntoNode(pNode, indexInNode, value);
+		return;
+	}
+
+	InsertIntoNode(pNode, indexInNode, val);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Delete the element at index, merge its node with the next one if both fit into one node
+// Time: O(n / kBlockSize + kBlockSize)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::DeleteByIndex(size_t index)
+{
+	// Underflow checking
+	assert(index < m_size);
+
+	auto [pNode, indexInNode] = SearchNodeByIndex(index);
+	EraseFromNode(pNode, indexInNode);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Print each element from head to tail, brackets mark the nodes
+// Time:  O(n)
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::Print(const char* pPrefix /*=''*/, const char* pSuffix /*=''*/) const
+{
+	std::cout << pPrefix << " { ";
+	for (const Node* pNode = m_pHead; pNode; pNode = pNode->m_pNext)
+	{
+		std::cout << "[ ";
+		for (size_t i = 0; i < pNode->m_count; ++i)
+			std::cout << pNode->Data()[i] << ' ';
+		std::cout << (pNode->m_pNext ? "]<=>" : "]");
+	}
+	std::cout << " } " << pSuffix << std::endl;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Destroy every element and free every node
+// Time: O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::Clear()
+{
+	while (m_pHead)
+	{
+		Node* pNext = m_pHead->m_pNext;
+		std::destroy_n(m_pHead->Data(), m_pHead->m_count);
+		DeleteObject(m_nodeAllocator, m_pHead);
+		m_pHead = pNext;
+	}
+
+	m_pTail = nullptr;
+	m_size = 0;
+	m_nodeCount = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Pop first element and return it's value
+// Time: O(kBlockSize)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline Type unrolled_list<Type, kBlockSize, Allocator>::PopFront()
+{
+	// Underflow checking
+	assert(m_size > 0);
+
+	Type val = std::move(m_pHead->Data()[0]);
+	EraseFromNode(m_pHead, 0);
+	return val;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Pop last element and return it's value
+// Time: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline Type unrolled_list<Type, kBlockSize, Allocator>::PopBack()
+{
+	// Underflow checking
+	assert(m_size > 0);
+
+	Type val = std::move(back());
+	EraseFromNode(m_pTail, m_pTail->m_count - 1);
+	return val;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Reverse the whole list, node order and the elements inside every node
+// Time:  O(n)
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::Reverse()
+{
+	for (Node* pNode = m_pHead; pNode; pNode = pNode->m_pPrev)
+	{
+		std::reverse(pNode->Data(), pNode->Data() + pNode->m_count);
+		std::swap(pNode->m_pNext, pNode->m_pPrev);
+	}
+
+	std::swap(m_pHead, m_pTail);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Sort by compare, stable like list::Sort. The elements are moved into one contiguous buffer, sorted there and
+// moved back, so the node layout doesn't change.
+// Time:  O(nlogn)
+// Space: O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+template<class Compare>
+inline void unrolled_list<Type, kBlockSize, Allocator>::Sort(Compare compare /*= Compare()*/)
+{
+	if (m_size < 2)
+		return;
+
+	// A single node is contiguous already
+	if (m_pHead == m_pTail)
+	{
+		std::stable_sort(m_pHead->Data(), m_pHead->Data() + m_pHead->m_count, compare);
+		return;
+	}
+
+	using BufferAllocator = rebind_allocator_t<Allocator, Type>;
+	BufferAllocator bufferAllocator(m_nodeAllocator);
+	Type* pBuffer = std::to_address(std::allocator_traits<BufferAllocator>::allocate(bufferAllocator, m_size));
+
+	// Gather
+	Type* pCursor = pBuffer;
+	for (Node* pNode = m_pHead; pNode; pNode = pNode->m_pNext)
+		pCursor = std::uninitialized_move(pNode->Data(), pNode->Data() + pNode->m_count, pCursor);
+
+	std::stable_sort(pBuffer, pBuffer + m_size, compare);
+
+	// Scatter back into the same nodes
+	pCursor = pBuffer;
+	for (Node* pNode = m_pHead; pNode; pNode = pNode->m_pNext)
+	{
+		std::move(pCursor, pCursor + pNode->m_count, pNode->Data());
+		pCursor += pNode->m_count;
+	}
+
+	std::destroy_n(pBuffer, m_size);
+	std::allocator_traits<BufferAllocator>::deallocate(bufferAllocator, pBuffer, m_size);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Call function with every element from head to tail
+// Time: O(n)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+template<class Function>
+inline void unrolled_list<Type, kBlockSize, Allocator>::ForEach(Function&& function) const
+{
+	for (const Node* pNode = m_pHead; pNode; pNode = pNode->m_pNext)
+	{
+		const Type* pData = pNode->Data();
+		for (size_t i = 0; i < pNode->m_count; ++i)
+			function(pData[i]);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Find the node holding index, return it and the index inside that node.
+// Whole nodes are skipped, starting from whichever end is closer.
+// Time:  O(n / kBlockSize)
+// Space: O(1)
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline std::pair<typename unrolled_list<Type, kBlockSize, Allocator>::Node*, size_t> unrolled_list<Type, kBlockSize, Allocator>::SearchNodeByIndex(size_t index) const
+{
+	assert(index < m_size);
+
+	if (index < m_size / 2)
+	{
+		Node* pNode = m_pHead;
+		while (index >= pNode->m_count)
+		{
+			index -= pNode->m_count;
+			pNode = pNode->m_pNext;
+		}
+		return { pNode, index };
+	}
+
+	// Walk backwards, nodeBegin is the list index of the first element in pNode
+	Node* pNode = m_pTail;
+	size_t nodeBegin = m_size - pNode->m_count;
+	while (index < nodeBegin)
+	{
+		pNode = pNode->m_pPrev;
+		nodeBegin -= pNode->m_count;
+	}
+	return { pNode, index - nodeBegin };
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Link a new empty node after pPrevious, nullptr makes it the head
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline typename unrolled_list<Type, kBlockSize, Allocator>::Node* unrolled_list<Type, kBlockSize, Allocator>::CreateNodeAfter(Node* pPrevious)
+{
+	Node* pNewNode = NewObject(m_nodeAllocator);
+	Node* pNext = pPrevious ? pPrevious->m_pNext : m_pHead;
+
+	pNewNode->m_pPrev = pPrevious;
+	pNewNode->m_pNext = pNext;
+
+	if (pPrevious)
+		pPrevious->m_pNext = pNewNode;
+	else
+		m_pHead = pNewNode;
+
+	if (pNext)
+		pNext->m_pPrev = pNewNode;
+	else
+		m_pTail = pNewNode;
+
+	++m_nodeCount;
+	return pNewNode;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unlink and free an empty node
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::DeleteNode(Node* pNode)
+{
+	assert(pNode->m_count == 0);
+
+	if (pNode->m_pPrev)
+		pNode->m_pPrev->m_pNext = pNode->m_pNext;
+	else
+		m_pHead = pNode->m_pNext;
+
+	if (pNode->m_pNext)
+		pNode->m_pNext->m_pPrev = pNode->m_pPrev;
+	else
+		m_pTail = pNode->m_pPrev;
+
+	DeleteObject(m_nodeAllocator, pNode);
+	--m_nodeCount;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Insert val at index of a node that isn't full, the elements after it shift up by one
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::InsertIntoNode(Node* pNode, size_t index, const Type& val)
+{
+	assert(!pNode->IsFull() && index <= pNode->m_count);
+
+	Type* pData = pNode->Data();
+	if (index == pNode->m_count)
+	{
+		new(pData + index) Type(val);
+	}
+	else
+	{
+		// Copy first, val may be one of the elements that shift
+		Type value(val);
+		new(pData + pNode->m_count) Type(std::move(pData[pNode->m_count - 1]));
+		std::move_backward(pData + index, pData + pNode->m_count - 1, pData + pNode->m_count);
+		pData[index] = std::move(value);
+	}
+
+	++pNode->m_count;
+	++m_size;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Erase the element at index of a node, then free the node if it's empty or merge it if it's sparse
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::EraseFromNode(Node* pNode, size_t index)
+{
+	Type* pData = pNode->Data();
+	std::move(pData + index + 1, pData + pNode->m_count, pData + index);
+	std::destroy_at(pData + pNode->m_count - 1);
+	--pNode->m_count;
+	--m_size;
+
+	if (pNode->m_count == 0)
+		DeleteNode(pNode);
+	else
+		MergeWithNextIfSparse(pNode);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Pull the next node's elements into a node that is less than half full, if they all fit
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::MergeWithNextIfSparse(Node* pNode)
+{
+	Node* pNext = pNode->m_pNext;
+	if (!pNext || pNode->m_count >= kBlockSize / 2 || pNode->m_count + pNext->m_count > kBlockSize)
+		return;
+
+	std::uninitialized_move(pNext->Data(), pNext->Data() + pNext->m_count, pNode->Data() + pNode->m_count);
+	std::destroy_n(pNext->Data(), pNext->m_count);
+	pNode->m_count += pNext->m_count;
+	pNext->m_count = 0;
+	DeleteNode(pNext);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Take other's nodes into this empty list
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline void unrolled_list<Type, kBlockSize, Allocator>::TakeOver(unrolled_list& other)
+{
+	assert(Empty());
+
+	m_pHead = std::exchange(other.m_pHead, nullptr);
+	m_pTail = std::exchange(other.m_pTail, nullptr);
+	m_size = std::exchange(other.m_size, 0);
+	m_nodeCount = std::exchange(other.m_nodeCount, 0);
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Unit Test for unrolled_list
+//--------------------------------------------------------------------------------------------------------------------
+template<class Type, size_t kBlockSize, class Allocator>
+inline bool unrolled_list<Type, kBlockSize, Allocator>::UnitTest()
+{
+	//---------------------------------------------------------------
+	// Push to both ends
+	//---------------------------------------------------------------
+	unrolled_list testList;
+	for (size_t i = 0; i < kTestSize; ++i)
+	{
+		testList.PushBack(static_cast<Type>(kTestSize + i));
+		testList.PushFront(static_cast<Type>(kTestSize - 1 - i));
+	}
+
+	if (testList.GetSize() != 2 * kTestSize || testList.front() != static_cast<Type>(0) || testList.back() != static_cast<Type>(2 * kTestSize - 1))
+		RETURN_ERROR("unrolled_list::PushFront() / PushBack()");
+
+	size_t expected = 0;
+	for (const Type& value : testList)
+	{
+		if (value != static_cast<Type>(expected++))
+			RETURN_ERROR("unrolled_list iteration");
+	}
+
+	//---------------------------------------------------------------
+	// Insert and delete in the middle, splitting and merging nodes
+	//---------------------------------------------------------------
+	for (size_t i = 0; i < kTestSize; ++i)
+		testList.Insert(kTestSize / 2, static_cast<Type>(0));
+
+	for (size_t i = 0; i < kTestSize; ++i)
+		testList.DeleteByIndex(kTestSize / 2);
+
+	for (size_t i = 0; i < 2 * kTestSize; ++i)
+	{
+		if (testList[i] != static_cast<Type>(i))
+			RETURN_ERROR("unrolled_list::Insert() / DeleteByIndex()");
+	}
+
+	// Every node but the last is at least half full after the merges
+	if (testList.GetNodeCount() > (2 * testList.GetSize()) / kBlockSize + 1)
+		RETURN_ERROR("unrolled_list node merging");
+
+	//---------------------------------------------------------------
+	// Reverse and sort
+	//---------------------------------------------------------------
+	testList.Reverse();
+	if (testList.front() != static_cast<Type>(2 * kTestSize - 1) || testList[2 * kTestSize - 1] != static_cast<Type>(0))
+		RETURN_ERROR("unrolled_list::Reverse()");
+
+	testList.Sort();
+	expected = 0;
+	testList.ForEach([&expected](const Type& value) { expected += (value == static_cast<Type>(expected)); });
+	if (expected != 2 * kTestSize)
+		RETURN_ERROR("unrolled_list::Sort()");
+
+	unrolled_list<std::pair<Type, size_t>, kBlockSize> pairList;
+	for (size_t i = 0; i < kTestSize; ++i)
+		pairList.PushFront({ static_cast<Type>(i % 7), i });
+
+	pairList.Sort([](const auto& left, const auto& right) { return left.first < right.first; });
+	for (size_t i = 1; i < kTestSize; ++i)
+	{
+		if (pairList[i - 1].first > pairList[i].first || (pairList[i - 1].first == pairList[i].first && pairList[i - 1].second < pairList[i].second))
+			RETURN_ERROR("unrolled_list::Sort() stability");
+	}
+
+	//---------------------------------------------------------------
+	// Pop everything
+	//---------------------------------------------------------------
+	while (testList.GetSize() > 1)
+	{
+		if (testList.PopBack() < testList.PopFront())
+			RETURN_ERROR("unrolled_list::PopFront() / PopBack()");
+	}
+
+	if (!testList.Empty() || testList.GetNodeCount() != 0)
+		RETURN_ERROR("unrolled_list empty after pops");
+
+	//---------------------------------------------------------------
+	// Non trivial elements
+	//---------------------------------------------------------------
+	unrolled_list<std::string, 4> stringList;
+	for (size_t i = 0; i < kTestSize; ++i)
+		stringList.Insert(i / 2, std::string(32, static_cast<char>('a' + i % 26)));
+
+	stringList.Sort();
+	unrolled_list<std::string, 4> movedList(std::move(stringList));
+	if (!stringList.Empty() || movedList.GetSize() != kTestSize || movedList.front() != std::string(32, 'a'))
+		RETURN_ERROR("unrolled_list<std::string>");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
+
+}
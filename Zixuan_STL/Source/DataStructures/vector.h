@@ -1,9 +1,15 @@
 #pragma once
 #include "Tests/StructureManager.h"
+#include "DataStructures/allocator.h"
+#include "DataStructures/simd.h"
 #include "Utils/Helpers.h"
+#include "Utils/Threading/ThreadPool.h"
 
 #include <assert.h>
+#include <bit>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <type_traits>
 #include <iostream>
 #include <algorithm>
@@ -11,6 +17,7 @@
 #include <math.h>
 #include <numeric>
 #include <optional>
+#include <string>
 #include <utility>
 
 namespace zxstl
@@ -21,6 +28,22 @@ namespace zxstl
 // 2 = last element
 #define PIVOT_PICK 1
 
+// Growth factor of a full vector
+// 0 = 2x, fewer reallocations
+// 1 = 1.5x, less memory wasted, and freed blocks can be reused by later growth
+#define VECTOR_GROWTH_POLICY 0
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// A type is trivially relocatable if moving it to a new address and destroying the old one is the same as a memcpy.
+// Every trivially copyable type is. Specialize this for your own types that are too, e.g. types owning a heap pointer
+// without pointing into themselves, so vectors of them reallocate with a single memcpy.
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<Type>> {};
+
+template<class Type>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<Type>::value;
+
 template<typename Vector>
 class vector_iterator
 {
@@ -86,26 +109,41 @@ inline vector_iterator<Vector> vector_iterator<Vector>::operator--(int)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Unorded array class
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
+template<class Type, size_t kInlineCapacity, class Allocator>
+class small_vector;
+
+template<class Type, class Allocator = allocator<Type>>
 class vector
 {
+    template<class, size_t, class> friend class small_vector;
+
 public:
     using ValueType = Type;
-    using iterator = vector_iterator<vector<Type>>;
+    using AllocatorType = Allocator;
+    using iterator = vector_iterator<vector<Type, Allocator>>;
 
 private:
     std::byte* m_pBuffer;
     size_t m_capacity; 
     size_t m_size;    
+    bool m_isInlineBuffer;      // The buffer lives inside a small_vector, it's never deleted or handed over
+    Allocator m_allocator;      // Where the buffer comes from. Kept on copy assignment, see operator=(vector&&) for moves
+
+    // Move assignment takes the other's buffer, and can't throw, when the allocators are known to be interchangeable
+    static constexpr bool kIsNothrowMoveAssignable = std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value;
 
 public:
     // Member functions
-    constexpr vector(size_t capacity = kInitialCapacity);
+    constexpr vector() noexcept;
+    constexpr explicit vector(const Allocator& alloc) noexcept;
+    constexpr vector(size_t capacity, const Allocator& alloc = Allocator());
     constexpr vector(const vector& other);
     constexpr vector(vector&& other) noexcept;
     constexpr vector& operator=(const vector& other);
-    constexpr vector& operator=(vector&& other) noexcept;
+    constexpr vector& operator=(vector&& other) noexcept(kIsNothrowMoveAssignable);
     constexpr ~vector();
+    constexpr Allocator get_allocator() const noexcept { return m_allocator; }
 
     // Element access
     constexpr Type& at(size_t index);
@@ -157,10 +195,17 @@ public:
     // Additional stuff
     void Print(bool horizontal = true) const;
     std::optional<size_t> Find(const Type& val) const;
+    size_t Count(const Type& val) const;
+    bool Contains(const Type& val) const { return Find(val).has_value(); }
+    std::pair<Type, Type> MinMax() const;
     void BubbleSort();
     void SelectionSort();
     void InsertionSort();
     void QuickSort();
+    template <class Compare = std::less<>> void Sort(Compare compare = Compare());
+    template <class Compare = std::less<>> void ParallelSort(Compare compare = Compare());
+    void RadixSort();
+    template <class Compare = std::less<>> bool IsSorted(Compare compare = Compare()) const;
     void Shuffle();
 
     // Testings
@@ -168,118 +213,192 @@ public:
     static bool UnitTest();
 
 private:
+    constexpr vector(std::byte* pInlineBuffer, size_t inlineCapacity, const Allocator& alloc) noexcept;
+
+    size_t _calculate_growth(size_t minCapacity) const;
+    std::byte* _allocate_buffer(size_t capacity);
     void _update_buffer_with_new_capacity(size_t newCapacity);
+    void _open_gap(size_t index);
+    void _close_gap(size_t index);
+    void _destroy_elements(size_t first);
+    void _free_buffer();
     void _destroy();
+    static void _copy_construct(Type* pDestination, const Type* pSource, size_t count);
+    static void _relocate(Type* pDestination, Type* pSource, size_t count);
     void _internal_quicksort(size_t start, size_t end);
     size_t _partition(size_t start, size_t end);
 
+    static constexpr size_t kInsertionSortThreshold = 16;       // Ranges this small are insertion sorted
+    static constexpr size_t kParallelSortChunkSize = 1 << 15;   // Smallest range worth handing to another thread
+
+    template <class Compare> static void _introsort(Type* pFirst, Type* pLast, size_t depthLimit, Compare& compare);
+    template <class Compare> static Type* _partition_around_median(Type* pFirst, Type* pLast, Compare& compare);
+    template <class Compare> static void _insertion_sort(Type* pFirst, Type* pLast, Compare& compare);
+    template <class Compare> static void _heap_sort(Type* pFirst, Type* pLast, Compare& compare);
+    template <class Compare> static void _sift_down(Type* pHeap, size_t index, size_t count, Compare& compare);
+    template <class Compare> static void _merge(Type* pLeft, Type* pLeftEnd, Type* pRight, Type* pRightEnd, Type* pDestination, Compare& compare);
+    static auto _radix_key(Type value);
+
 #if PIVOT_PICK == 1
     size_t _get_mid_index(size_t start, size_t end) const;
 #endif
 };
 
+// A vector only holds a pointer to its buffer, moving it around in memory is safe if its allocator can be moved too
+template<class Type, class Allocator>
+struct is_trivially_relocatable<vector<Type, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Default ctor, nothing is allocated until the first insertion
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>::vector() noexcept
+    : vector(Allocator())
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Ctor with an allocator to take the buffer from, nothing is allocated until the first insertion
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>::vector(const Allocator& alloc) noexcept
+    : m_pBuffer(nullptr)
+    , m_capacity(0)
+    , m_size(0)
+    , m_isInlineBuffer(false)
+    , m_allocator(alloc)
+{
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Ctor, takes in the size of the array and dynamically allocate in the ctor
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr vector<Type>::vector(size_t capacity /*= kInitialCapacity*/)
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>::vector(size_t capacity, const Allocator& alloc /*= Allocator()*/)
     : m_pBuffer(nullptr)
     , m_capacity(capacity)
     , m_size(0)
+    , m_isInlineBuffer(false)
+    , m_allocator(alloc)
 {
     assert(m_capacity >= 0);
     _update_buffer_with_new_capacity(m_capacity);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Ctor used by small_vector, starts on the inline buffer
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>::vector(std::byte* pInlineBuffer, size_t inlineCapacity, const Allocator& alloc) noexcept
+    : m_pBuffer(pInlineBuffer)
+    , m_capacity(inlineCapacity)
+    , m_size(0)
+    , m_isInlineBuffer(true)
+    , m_allocator(alloc)
+{
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Copy ctor
 // Time:  O(n)
 // Space: O(n)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr vector<Type>::vector(const vector& other)
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>::vector(const vector& other)
     : m_pBuffer(nullptr)
     , m_capacity(other.m_capacity)
     , m_size(other.m_size)
+    , m_isInlineBuffer(false)
+    , m_allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.m_allocator))
 {
     // If the other's buffer exists
     if (other.m_pBuffer)
     {
         // Allocate new memory for buffer
-        m_pBuffer = new std::byte[m_capacity * sizeof(Type)];
+        m_pBuffer = _allocate_buffer(m_capacity);
 
         // Copy everything over
-        Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-        Type* pOtherTypeArray = reinterpret_cast<Type*>(other.m_pBuffer);
-        for (size_t i = 0; i < m_size; ++i)
-            new(pTypeArray + i) Type(pOtherTypeArray[i]);
+        _copy_construct(reinterpret_cast<Type*>(m_pBuffer), reinterpret_cast<const Type*>(other.m_pBuffer), m_size);
     }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// Move ctor
+// Move ctor. An inline buffer can't be taken over, its elements are relocated instead
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr vector<Type>::vector(vector&& other) noexcept
-    : m_pBuffer(other.m_pBuffer)
-    , m_capacity(other.m_capacity)
-    , m_size(other.m_size)
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>::vector(vector&& other) noexcept
+    : vector(other.m_allocator)
 {
-    other.m_size = 0;
-    other.m_capacity = 0;
-    other.m_pBuffer = nullptr;
+    *this = std::move(other);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// Move ctor
+// Copy assignment, the old buffer is reused if it's big enough
 // Time:  O(n)
 // Space: O(n)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr vector<Type>& vector<Type>::operator=(const vector& other)
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>& vector<Type, Allocator>::operator=(const vector& other)
 {
     // Edge-case checking
     if (this == &other)
         return *this;
 
-    // Clean old buffer
-    delete[] m_pBuffer;
-    m_pBuffer = nullptr;
+    // Clean old elements, and the old buffer if it can't hold the other's elements
+    if (m_pBuffer && m_capacity >= other.m_size)
+    {
+        _destroy_elements(0);
+    }
+    else
+    {
+        _destroy();
+        m_capacity = other.m_capacity;
+        if (other.m_pBuffer)
+            m_pBuffer = _allocate_buffer(m_capacity);
+    }
 
     // Copy everything over
     m_size = other.m_size;
-    m_capacity = other.m_capacity;
-
-    // If the other's buffer exists
-    if (other.m_pBuffer)
-    {
-        // Allocate new memory for buffer
-        m_pBuffer = new std::byte[m_capacity * sizeof(Type)];
-
-        // Copy everything over
-        Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-        Type* pOtherTypeArray = reinterpret_cast<Type*>(other.m_pBuffer);
-        for (size_t i = 0; i < m_size; ++i)
-            new(pTypeArray + i) Type(pOtherTypeArray[i]);
-    }
+    if (m_pBuffer)
+        _copy_construct(reinterpret_cast<Type*>(m_pBuffer), reinterpret_cast<const Type*>(other.m_pBuffer), m_size);
 
     return (*this);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// Move ctor
+// Move assignment. The buffer is taken over if the allocator propagates or both allocators are equal, otherwise
+// the elements are relocated into memory from this vector's allocator, which can throw, so it's only noexcept when
+// the allocators can't differ, like std::vector.
+// A small_vector's inline elements are relocated too. A small_vector always has room for them, a plain vector may
+// have to allocate for these few elements, and running out of memory there terminates.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr vector<Type>& vector<Type>::operator=(vector&& other) noexcept
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>& vector<Type, Allocator>::operator=(vector&& other) noexcept(kIsNothrowMoveAssignable)
 {
     // Edge-case checking
     if (this == &other)
         return *this;
 
-    // Clean old buffer
-    delete[] m_pBuffer;
+    constexpr bool kPropagateAllocator = std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value;
+    const bool canTakeBuffer = kPropagateAllocator || m_allocator == other.m_allocator;
+
+    // The other's elements live inside it, relocate them one by one. The other keeps its inline buffer
+    if (other.m_isInlineBuffer || !canTakeBuffer)
+    {
+        _destroy_elements(0);
+        reserve(other.m_size);
+        _relocate(reinterpret_cast<Type*>(m_pBuffer), reinterpret_cast<Type*>(other.m_pBuffer), other.m_size);
+        m_size = other.m_size;
+        other.m_size = 0;
+        return *this;
+    }
+
+    // Clean old elements and buffer
+    _destroy();
 
     // Move everything over
+    if constexpr (kPropagateAllocator)
+        m_allocator = std::move(other.m_allocator);
     m_size = other.m_size;
     m_capacity = other.m_capacity;
     m_pBuffer = other.m_pBuffer;
@@ -295,8 +414,8 @@ constexpr vector<Type>& vector<Type>::operator=(vector&& other) noexcept
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // The destructor will need to clean up and deallocate any memory that was allocated in the constructor.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr vector<Type>::~vector()
+template<class Type, class Allocator>
+constexpr vector<Type, Allocator>::~vector()
 {
     _destroy();
 }
@@ -304,8 +423,8 @@ constexpr vector<Type>::~vector()
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a reference to the element at specified index, with bounds checking.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline constexpr Type& vector<Type>::at(size_t index)
+template<class Type, class Allocator>
+inline constexpr Type& vector<Type, Allocator>::at(size_t index)
 {
     assert(index <= m_size && !empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -315,8 +434,8 @@ inline constexpr Type& vector<Type>::at(size_t index)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a const reference to the element at specified location pos, with bounds checking.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline constexpr const Type& vector<Type>::at(size_t index) const
+template<class Type, class Allocator>
+inline constexpr const Type& vector<Type, Allocator>::at(size_t index) const
 {
     assert(index <= m_size && !empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -326,8 +445,8 @@ inline constexpr const Type& vector<Type>::at(size_t index) const
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a reference to the element at specified location pos. No bounds checking is performed.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr const Type& vector<Type>::operator[](size_t index) const
+template<class Type, class Allocator>
+constexpr const Type& vector<Type, Allocator>::operator[](size_t index) const
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
     return pTypeArray[index];
@@ -336,8 +455,8 @@ constexpr const Type& vector<Type>::operator[](size_t index) const
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a const reference to the element at specified location pos.No bounds checking is performed.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr Type& vector<Type>::operator[](size_t index)
+template<class Type, class Allocator>
+constexpr Type& vector<Type, Allocator>::operator[](size_t index)
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
     return pTypeArray[index];
@@ -346,8 +465,8 @@ constexpr Type& vector<Type>::operator[](size_t index)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a reference to the first element in the container. Calling front on an empty container is undefined.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr Type& vector<Type>::front()
+template<class Type, class Allocator>
+constexpr Type& vector<Type, Allocator>::front()
 {
     assert(!empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -357,8 +476,8 @@ constexpr Type& vector<Type>::front()
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a const reference to the first element in the container. Calling front on an empty container is undefined.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr const Type& vector<Type>::front() const
+template<class Type, class Allocator>
+constexpr const Type& vector<Type, Allocator>::front() const
 {
     assert(!empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -368,8 +487,8 @@ constexpr const Type& vector<Type>::front() const
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a reference to the last element in the container. Calling back on an empty container causes undefined behavior.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr Type& vector<Type>::back()
+template<class Type, class Allocator>
+constexpr Type& vector<Type, Allocator>::back()
 {
     assert(!empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -379,8 +498,8 @@ constexpr Type& vector<Type>::back()
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Returns a reference to the last element in the container. Calling back on an empty container causes undefined behavior.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr const Type& vector<Type>::back() const
+template<class Type, class Allocator>
+constexpr const Type& vector<Type, Allocator>::back() const
 {
     assert(!empty());
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
@@ -391,8 +510,8 @@ constexpr const Type& vector<Type>::back() const
 // Increase the capacity of the vector to a value that's greater or equal to newCapacity. 
 // If newCapacity is greater than the current capacity(), new storage is allocated, otherwise the method does nothing.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline constexpr void vector<Type>::reserve(size_t newCapacity)
+template<class Type, class Allocator>
+inline constexpr void vector<Type, Allocator>::reserve(size_t newCapacity)
 {
     if (newCapacity > m_capacity)
         _update_buffer_with_new_capacity(newCapacity);
@@ -402,85 +521,70 @@ inline constexpr void vector<Type>::reserve(size_t newCapacity)
 // Requests the removal of unused capacity.
 // If reallocation occurs, all iterators, including the past the end iterator, and all references to the elements are invalidated. If no reallocation takes place, no iterators or references are invalidated.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline constexpr void vector<Type>::shrink_to_fit()
+template<class Type, class Allocator>
+inline constexpr void vector<Type, Allocator>::shrink_to_fit()
 {
-    _update_buffer_with_new_capacity(m_size);
+    if (!m_isInlineBuffer)
+        _update_buffer_with_new_capacity(m_size);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// Erases all elements from the container. After this call, size() returns zero.
+// Erases all elements from the container. After this call, size() returns zero. The capacity is kept.
 // Time:  O(n), n = size()
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr void vector<Type>::clear() noexcept
+template<class Type, class Allocator>
+constexpr void vector<Type, Allocator>::clear() noexcept
 {
-    _destroy();
-    m_size = 0;
+    _destroy_elements(0);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Inserts elements at the specified location in the container.
 // Time:  O(n), n = distance(index, m_size)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline constexpr void vector<Type>::insert(size_t index, const Type& val)
+template<class Type, class Allocator>
+inline constexpr void vector<Type, Allocator>::insert(size_t index, const Type& val)
 {
-    assert(index <= m_size);
-
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity * kExpandMultiplier);
-
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-
-    // Move every element after the indexed element one spot forward.
-    std::memmove(pTypeArray + index + 1, pTypeArray + index, (m_size - index) * sizeof(Type));
-
-    new(m_pBuffer + (index * sizeof(Type))) Type(val);
-    ++m_size;
+    emplace(index, val);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Inserts elements at the specified location in the container.
 // Time:  O(n), n = distance(index, m_size)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline constexpr void vector<Type>::insert(size_t index, Type&& val)
+template<class Type, class Allocator>
+inline constexpr void vector<Type, Allocator>::insert(size_t index, Type&& val)
 {
-    assert(index <= m_size);
-
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity * kExpandMultiplier);
-
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-
-    // Move every element after the indexed element one spot forward.
-    std::memmove(pTypeArray + index + 1, pTypeArray + index, (m_size - index) * sizeof(Type));
-
-    new(m_pBuffer + (index * sizeof(Type))) Type(val);
-    ++m_size;
+    emplace(index, std::move(val));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Inserts a new element into the container directly before pos.
 // Time:  O(n), n = distance(index, m_size)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
+template<class Type, class Allocator>
 template<class ...Args>
-inline constexpr void vector<Type>::emplace(size_t index, Args&&... args)
+inline constexpr void vector<Type, Allocator>::emplace(size_t index, Args&&... args)
 {
     assert(index <= m_size);
 
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity * kExpandMultiplier);
+    if (index == m_size)
+    {
+        emplace_back(std::forward<Args>(args)...);
+        return;
+    }
 
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
+    // Build the element first, args may refer to an element which is about to move
+    Type value(std::forward<Args>(args)...);
+
+    if (m_size >= m_capacity || !m_pBuffer)
+        _update_buffer_with_new_capacity(_calculate_growth(m_size + 1));
 
     // Move every element after the indexed element one spot forward.
-    std::memmove(pTypeArray + index + 1, pTypeArray + index, (m_size - index) * sizeof(Type));
+    _open_gap(index);
 
-    new(m_pBuffer + (index * sizeof(Type))) Type(std::forward<Args>(args)...);
+    new(m_pBuffer + (index * sizeof(Type))) Type(std::move(value));
     ++m_size;
 }
 
@@ -489,18 +593,13 @@ inline constexpr void vector<Type>::emplace(size_t index, Args&&... args)
 // Time:  O(n)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr void vector<Type>::erase(size_t index)
+template<class Type, class Allocator>
+constexpr void vector<Type, Allocator>::erase(size_t index)
 {
     assert(index < m_size && !empty());
 
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-    if constexpr (!std::is_trivially_destructible_v<Type>)
-        pTypeArray[index].~Type();
-
-    // Move every element after the indexed element one spot forward.
-    std::memmove(pTypeArray + index, pTypeArray + index + 1, (m_size - index) * sizeof(Type));
-
+    // Move every element after the indexed element one spot backward.
+    _close_gap(index);
     --m_size;
 }
 
@@ -508,28 +607,20 @@ constexpr void vector<Type>::erase(size_t index)
 // Takes in a value to be inserted at the end of the array
 // Time: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr void vector<Type>::push_back(const Type& val)
+template<class Type, class Allocator>
+constexpr void vector<Type, Allocator>::push_back(const Type& val)
 {
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity * kExpandMultiplier);
-
-    new(m_pBuffer + (m_size * sizeof(Type))) Type(val); 
-    ++m_size;
+    emplace_back(val);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Takes in a value to be inserted at the end of the array
 // Time: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr void vector<Type>::push_back(Type&& val)
+template<class Type, class Allocator>
+constexpr void vector<Type, Allocator>::push_back(Type&& val)
 {
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity * kExpandMultiplier);
-
-    new(m_pBuffer + (m_size * sizeof(Type))) Type(val); 
-    ++m_size;
+    emplace_back(std::move(val));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -538,22 +629,10 @@ constexpr void vector<Type>::push_back(Type&& val)
 // Time:  O(n)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr void vector<Type>::push_front(const Type& val)
+template<class Type, class Allocator>
+constexpr void vector<Type, Allocator>::push_front(const Type& val)
 {
-    // If the array is full, expand it
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity * kExpandMultiplier);
-
-    // Shift each element one spot towards to the end in order to create a spot for the new inserted value.
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-    std::memmove(pTypeArray + 1, pTypeArray, m_size * sizeof(Type));
-
-    // Create the new element at front
-    new(m_pBuffer) Type(val);
-
-    // Increment size
-    ++m_size;
+    emplace(0, val);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -562,35 +641,40 @@ constexpr void vector<Type>::push_front(const Type& val)
 // Time:  O(n)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr void vector<Type>::push_front(Type&& val)
+template<class Type, class Allocator>
+constexpr void vector<Type, Allocator>::push_front(Type&& val)
 {    
-    // If the array is full, expand it
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity * kExpandMultiplier);
-
-    // Shift each element one spot towards to the end in order to create a spot for the new inserted value.
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-    std::memmove(pTypeArray + 1, pTypeArray, m_size * sizeof(Type));
-
-    // Create the new element at front
-    new(m_pBuffer) Type(val);
-
-    // Increment size
-    ++m_size;
+    emplace(0, std::move(val));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Emplace an object at the end of the array
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
+template<class Type, class Allocator>
 template<class ...Args>
-constexpr void vector<Type>::emplace_back(Args&& ...args)
+constexpr void vector<Type, Allocator>::emplace_back(Args&& ...args)
 {
     if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity > 0 ? static_cast<size_t>(m_capacity * kExpandMultiplier) : kInitialCapacity);
+    {
+        // Construct the new element in the new buffer before the old elements move, args may refer to one of them
+        const size_t newCapacity = _calculate_growth(m_size + 1);
+        std::byte* pNewBuffer = _allocate_buffer(newCapacity);
+        new(pNewBuffer + (m_size * sizeof(Type))) Type(std::forward<Args>(args)...);
+
+        if (m_pBuffer)
+        {
+            _relocate(reinterpret_cast<Type*>(pNewBuffer), reinterpret_cast<Type*>(m_pBuffer), m_size);
+            _free_buffer();
+        }
+
+        m_pBuffer = pNewBuffer;
+        m_capacity = newCapacity;
+    }
+    else
+    {
+        new(m_pBuffer + (m_size * sizeof(Type))) Type(std::forward<Args>(args)...);
+    }
 
-    new(m_pBuffer + (m_size * sizeof(Type))) Type(std::forward<Args>(args)...);
     ++m_size;
 }
 
@@ -600,26 +684,18 @@ constexpr void vector<Type>::emplace_back(Args&& ...args)
 // Time:  O(n)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
+template<class Type, class Allocator>
 template<class ...Args>
-constexpr void vector<Type>::emplace_front(Args&& ...args)
+constexpr void vector<Type, Allocator>::emplace_front(Args&& ...args)
 {
-    if (m_size >= m_capacity || !m_pBuffer)
-        _update_buffer_with_new_capacity(m_capacity > 0 ? static_cast<size_t>(m_capacity * kExpandMultiplier) : kInitialCapacity);
-
-    // Shift each element one spot towards to the end in order to create a spot for the new inserted value.
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-    std::memmove(pTypeArray + 1, pTypeArray, m_size * sizeof(Type));
-
-    new(m_pBuffer) Type(std::forward<Args>(args)...);
-    ++m_size;
+    emplace(0, std::forward<Args>(args)...);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Removes the last element of the container. Calling pop_back on an empty container results in undefined behavior.
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-constexpr void vector<Type>::pop_back()
+template<class Type, class Allocator>
+constexpr void vector<Type, Allocator>::pop_back()
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -635,31 +711,21 @@ constexpr void vector<Type>::pop_back()
 // If the current size is less than count, additional default-inserted elements are appended
 // Time:  O(n), Linear in the difference between the current size and count. Additional complexity possible due to reallocation if capacity is less than count
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline constexpr void vector<Type>::resize(size_t count)
+template<class Type, class Allocator>
+inline constexpr void vector<Type, Allocator>::resize(size_t count)
 {
-    // Size is greater than count, we need to delete things from the buffer
+    // Size is greater than count, we need to delete things from the buffer. The capacity is kept
     if (m_size > count)
     {
-        // If the type of elements is not trivially destructible, call it's destructor
-        if constexpr (!std::is_trivially_destructible_v<Type>)
-        {
-            Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-            for (size_t i = count - 1; i < m_size; ++i)
-                pTypeArray[i].~Type();
-        }
-
-        _update_buffer_with_new_capacity(count);
+        _destroy_elements(count);
     }
     // Size is less than count, add default values to the end of the buffer
     else
     {
-        size_t loopTime = count - m_size;
-        for (size_t i = 0; i < loopTime; ++i)
+        reserve(count);
+        while (m_size < count)
             emplace_back();
     }
-
-    m_size = count;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -667,8 +733,8 @@ inline constexpr void vector<Type>::resize(size_t count)
 // Time:  O(n)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::Print(bool horizontal /*= true*/) const
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::Print(bool horizontal /*= true*/) const
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -690,20 +756,40 @@ inline void vector<Type>::Print(bool horizontal /*= true*/) const
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Linear search. Return the element's index if found in the buffer
+// Arithmetic types are compared 16 or 32 bytes at a time, see simd.h
 // Time:  O(n)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline std::optional<size_t> vector<Type>::Find(const Type& val) const
+template<class Type, class Allocator>
+inline std::optional<size_t> vector<Type, Allocator>::Find(const Type& val) const
 {
-    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
+    const size_t index = simd::Find(data(), m_size, val);
+    if (index == m_size)
+        return {};
+    return index;
+}
 
-    for (size_t i = 0; i < m_size; ++i)
-    {
-        if (pTypeArray[i] == val)
-            return i;
-    }
-    return {};
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Number of elements equal to val
+// Time:  O(n)
+// Space: O(1)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline size_t vector<Type, Allocator>::Count(const Type& val) const
+{
+    return simd::Count(data(), m_size, val);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Smallest and biggest element in one pass, the vector must not be empty
+// Time:  O(n)
+// Space: O(1)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline std::pair<Type, Type> vector<Type, Allocator>::MinMax() const
+{
+    assert(!empty());
+    return simd::MinMax(data(), m_size);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -711,8 +797,8 @@ inline std::optional<size_t> vector<Type>::Find(const Type& val) const
 // Time:  O(n ^ 2)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::BubbleSort()
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::BubbleSort()
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -734,8 +820,8 @@ inline void vector<Type>::BubbleSort()
 // Time:  O(n ^ 2)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::SelectionSort()
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::SelectionSort()
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -764,8 +850,8 @@ inline void vector<Type>::SelectionSort()
 // Time:  O(n ^ 2)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::InsertionSort()
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::InsertionSort()
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -796,8 +882,8 @@ inline void vector<Type>::InsertionSort()
 // Time:  O(nlog(n))
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::QuickSort()
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::QuickSort()
 {
     _internal_quicksort(0, m_size - 1);
 }
@@ -807,8 +893,8 @@ inline void vector<Type>::QuickSort()
 // Time:  O(nlog(n))
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::_internal_quicksort(size_t start, size_t end)
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_internal_quicksort(size_t start, size_t end)
 {
     if (start < end && end != std::numeric_limits<size_t>::max())
     {
@@ -818,13 +904,160 @@ inline void vector<Type>::_internal_quicksort(size_t start, size_t end)
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Introsort: quicksort with median of three pivots, switching to heap sort if the recursion gets too deep, so the
+// worst case stays O(nlog(n)). Small ranges are left to insertion sort.
+// Time:  O(nlog(n))
+// Space: O(log(n))
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline void vector<Type, Allocator>::Sort(Compare compare /*= Compare()*/)
+{
+    if (m_size > 1)
+        _introsort(data(), data() + m_size, 2 * static_cast<size_t>(std::bit_width(m_size)), compare);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Sort equal sized chunks on ThreadPool, then merge pairs of sorted runs, every merge of a round in parallel
+// Time:  O(nlog(n) / threads + nlog(threads))
+// Space: O(n)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline void vector<Type, Allocator>::ParallelSort(Compare compare /*= Compare()*/)
+{
+    ThreadPool& threadPool = ThreadPool::Get();
+    const size_t chunkCount = std::min(threadPool.GetThreadCount() + 1, m_size / kParallelSortChunkSize);
+    if (chunkCount < 2)
+    {
+        Sort(compare);
+        return;
+    }
+
+    // Run r is [runStarts[r], runStarts[r + 1])
+    vector<size_t> runStarts(chunkCount + 1);
+    for (size_t i = 0; i <= chunkCount; ++i)
+        runStarts.push_back(m_size * i / chunkCount);
+
+    Type* pTypeArray = data();
+    threadPool.ParallelFor(chunkCount, [pTypeArray, &runStarts, &compare](size_t chunk)
+    {
+        Compare chunkCompare = compare;
+        const size_t count = runStarts[chunk + 1] - runStarts[chunk];
+        _introsort(pTypeArray + runStarts[chunk], pTypeArray + runStarts[chunk + 1], 2 * static_cast<size_t>(std::bit_width(count)), chunkCompare);
+    });
+
+    // Merge back and forth between the elements and a scratch copy
+    vector scratch(*this);
+    Type* pSource = pTypeArray;
+    Type* pDestination = scratch.data();
+    size_t runCount = chunkCount;
+    while (runCount > 1)
+    {
+        threadPool.ParallelFor((runCount + 1) / 2, [pSource, pDestination, runCount, &runStarts, &compare](size_t pair)
+        {
+            Compare mergeCompare = compare;
+            const size_t first = runStarts[2 * pair];
+            const size_t middle = runStarts[2 * pair + 1];
+            const size_t last = (2 * pair + 2 <= runCount) ? runStarts[2 * pair + 2] : middle;
+            _merge(pSource + first, pSource + middle, pSource + middle, pSource + last, pDestination + first, mergeCompare);
+        });
+
+        // Every pair of runs is one run now
+        for (size_t i = 0; 2 * i < runCount; ++i)
+            runStarts[i] = runStarts[2 * i];
+        runCount = (runCount + 1) / 2;
+        runStarts[runCount] = m_size;
+
+        std::swap(pSource, pDestination);
+    }
+
+    if (pSource != pTypeArray)
+        std::move(pSource, pSource + m_size, pTypeArray);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// LSD radix sort for integral and floating point elements, one byte per pass. Passes where every key has the same
+// byte are skipped, e.g. the high bytes of small integers.
+// Time:  O(n * sizeof(Type))
+// Space: O(n)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::RadixSort()
+{
+    static_assert(std::is_arithmetic_v<Type> && !std::is_same_v<Type, bool>, "RadixSort only sorts integral and floating point elements");
+
+    static constexpr size_t kBucketCount = 256;
+    static constexpr size_t kPassCount = sizeof(Type);
+
+    if (m_size < 2)
+        return;
+
+    // One histogram per byte, all counted in a single pass
+    size_t counts[kPassCount][kBucketCount] = {};
+    Type* pTypeArray = data();
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        const auto key = _radix_key(pTypeArray[i]);
+        for (size_t pass = 0; pass < kPassCount; ++pass)
+            ++counts[pass][(key >> (pass * 8)) & 0xFF];
+    }
+
+    Type* pScratch = std::to_address(std::allocator_traits<Allocator>::allocate(m_allocator, m_size));
+    Type* pSource = pTypeArray;
+    Type* pDestination = pScratch;
+    for (size_t pass = 0; pass < kPassCount; ++pass)
+    {
+        // Nothing to do if every key falls into one bucket
+        if (counts[pass][(_radix_key(pSource[0]) >> (pass * 8)) & 0xFF] == m_size)
+            continue;
+
+        // Counts to start offsets
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < kBucketCount; ++bucket)
+        {
+            const size_t count = counts[pass][bucket];
+            counts[pass][bucket] = offset;
+            offset += count;
+        }
+
+        for (size_t i = 0; i < m_size; ++i)
+            pDestination[counts[pass][(_radix_key(pSource[i]) >> (pass * 8)) & 0xFF]++] = pSource[i];
+
+        std::swap(pSource, pDestination);
+    }
+
+    if (pSource != pTypeArray)
+        std::memcpy(pTypeArray, pSource, m_size * sizeof(Type));
+
+    std::allocator_traits<Allocator>::deallocate(m_allocator, pScratch, m_size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Return true if no element is less than the one before it
+// Time:  O(n)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline bool vector<Type, Allocator>::IsSorted(Compare compare /*= Compare()*/) const
+{
+    const Type* pTypeArray = data();
+    for (size_t i = 1; i < m_size; ++i)
+    {
+        if (compare(pTypeArray[i], pTypeArray[i - 1]))
+            return false;
+    }
+    return true;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Randomly rearranges elements in the array
 // Time:  O(n)
 // Space: O(1)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::Shuffle()
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::Shuffle()
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
     for (size_t i = 0; i < m_size; ++i)
@@ -834,8 +1067,8 @@ inline void vector<Type>::Shuffle()
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Unit tests
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::InteractiveTest()
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::InteractiveTest()
 {
     // Variables for testing
     bool shouldQuit = false;
@@ -866,7 +1099,7 @@ inline void vector<Type>::InteractiveTest()
     system("cls");
 
     // Create array
-    UnorderedArray<Type> unorderedArray{ (size_t)i };
+    vector<Type> unorderedArray{ (size_t)i };
 #endif
 
     // Loop work
@@ -916,8 +1149,8 @@ inline void vector<Type>::InteractiveTest()
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Unit Test for vector
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline bool vector<Type>::UnitTest()
+template<class Type, class Allocator>
+inline bool vector<Type, Allocator>::UnitTest()
 {
     //---------------------------------------------------------------
     // Prepare vector data. Having a vector with kTestSize int in order
@@ -928,7 +1161,7 @@ inline bool vector<Type>::UnitTest()
         testVec.emplace_back(i);
 
         // front
-        if (testVec.front() != i)
+        if (testVec.front() != 0)
             RETURN_ERROR("vector::front()");
 
         // back
@@ -957,6 +1190,120 @@ inline bool vector<Type>::UnitTest()
     if (testVec.capacity() != testVec.size())
         RETURN_ERROR("vector::shrink_to_fit");
 
+    //---------------------------------------------------------------
+    // Modifiers
+    //---------------------------------------------------------------
+    testVec.insert(0, static_cast<Type>(kTestSize));
+    testVec.erase(1);
+    testVec.push_back(testVec[0]);     // Reallocates while the argument lives in the old buffer
+    if (testVec.size() != kTestSize + 1 || testVec.front() != static_cast<Type>(kTestSize) || testVec.back() != static_cast<Type>(kTestSize) || testVec[1] != 1)
+        RETURN_ERROR("vector::insert() / erase()");
+
+    testVec.resize(kTestSize / 2);
+    if (testVec.size() != kTestSize / 2 || testVec.back() != static_cast<Type>(kTestSize / 2 - 1))
+        RETURN_ERROR("vector::resize()");
+
+    //---------------------------------------------------------------
+    // Non trivial elements, every element must be moved and destroyed exactly once
+    //---------------------------------------------------------------
+    vector<std::string> stringVec(1);
+    for (size_t i = 0; i < kTestSize; ++i)
+        stringVec.push_back(std::string(32, static_cast<char>('a' + i % 26)));
+
+    stringVec.insert(0, std::string("front"));
+    stringVec.erase(kTestSize / 2);
+    vector<std::string> stringCopy(1);
+    stringCopy = stringVec;
+    stringCopy = std::move(stringVec);
+    if (stringCopy.size() != kTestSize || stringCopy[0] != "front" || stringCopy[1] != std::string(32, 'a') || !stringVec.empty())
+        RETURN_ERROR("vector<std::string> copy / move");
+    if (!std::is_nothrow_move_assignable_v<vector<std::string>>)
+        RETURN_ERROR("vector move assignment must be noexcept with the default allocator");
+
+    //---------------------------------------------------------------
+    // Sorts, on random, sorted, reversed and all equal input
+    //---------------------------------------------------------------
+    static constexpr size_t kSortTestSize = 200000;
+    std::mt19937 random(static_cast<unsigned int>(kSortTestSize));
+    vector<Type> sortVec;
+    for (size_t i = 0; i < kSortTestSize; ++i)
+        sortVec.push_back(static_cast<Type>(random() % 1000));
+
+    vector<Type> parallelVec(sortVec);
+    vector<Type> radixVec(sortVec);
+    sortVec.Sort();
+    parallelVec.ParallelSort();
+    radixVec.RadixSort();
+    if (!sortVec.IsSorted() || !parallelVec.IsSorted() || !radixVec.IsSorted())
+        RETURN_ERROR("vector::Sort() / ParallelSort() / RadixSort()");
+
+    for (size_t i = 0; i < kSortTestSize; ++i)
+    {
+        if (sortVec[i] != parallelVec[i] || sortVec[i] != radixVec[i])
+            RETURN_ERROR("vector::Sort() / ParallelSort() / RadixSort() lost elements");
+    }
+
+    sortVec.Sort(std::greater<>());
+    if (!sortVec.IsSorted(std::greater<>()))
+        RETURN_ERROR("vector::Sort(std::greater)");
+
+    sortVec.Sort();
+    for (size_t i = kSortTestSize / 2; i < kSortTestSize; ++i)
+        parallelVec[i] = static_cast<Type>(1);
+    parallelVec.ParallelSort(std::greater<>());
+    if (!sortVec.IsSorted() || !parallelVec.IsSorted(std::greater<>()))
+        RETURN_ERROR("vector::Sort() on sorted input");
+
+    //---------------------------------------------------------------
+    // Linear scans, on every instruction set this CPU has
+    //---------------------------------------------------------------
+    if constexpr (std::is_arithmetic_v<Type>)
+    {
+        const simd::Level detectedLevel = simd::DetectLevel();
+        for (simd::Level level : { simd::Level::kScalar, simd::Level::kSse2, simd::Level::kAvx2 })
+        {
+            simd::SetLevel(level);
+
+            // Sizes around every register width, so the unrolled loops and the tails are all hit
+            for (size_t scanSize = 1; scanSize < 300; scanSize += 7)
+            {
+                vector<Type> scanVec;
+                for (size_t i = 0; i < scanSize; ++i)
+                    scanVec.push_back(static_cast<Type>(random() % 50 + 10));
+
+                const Type missing = static_cast<Type>(5);
+                const Type target = scanVec[random() % scanSize];
+                size_t expectedIndex = 0;
+                while (scanVec[expectedIndex] != target)
+                    ++expectedIndex;
+
+                if (scanVec.Find(target) != expectedIndex || scanVec.Find(missing).has_value() || scanVec.Contains(missing) || !scanVec.Contains(target))
+                    RETURN_ERROR("vector::Find() / Contains()");
+
+                size_t expectedCount = 0;
+                Type expectedMin = scanVec[0];
+                Type expectedMax = scanVec[0];
+                for (size_t i = 0; i < scanSize; ++i)
+                {
+                    expectedCount += (scanVec[i] == target) ? 1 : 0;
+                    expectedMin = std::min(expectedMin, scanVec[i]);
+                    expectedMax = std::max(expectedMax, scanVec[i]);
+                }
+
+                if (scanVec.Count(target) != expectedCount || scanVec.Count(missing) != 0)
+                    RETURN_ERROR("vector::Count()");
+
+                // Put the extremes at the very end, where only the tail handling sees them
+                scanVec.front() = static_cast<Type>(100);
+                scanVec.back() = static_cast<Type>(1);
+                const std::pair<Type, Type> minMax = scanVec.MinMax();
+                if (minMax.first != static_cast<Type>(1) || (scanSize > 1 && minMax.second != static_cast<Type>(100)))
+                    RETURN_ERROR("vector::MinMax()");
+            }
+        }
+        simd::SetLevel(detectedLevel);
+    }
+
     //---------------------------------------------------------------
     // Success
     //---------------------------------------------------------------
@@ -964,20 +1311,36 @@ inline bool vector<Type>::UnitTest()
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// Create a bigger array, update capacity, copy and move elements from previous array to the new one
+// Capacity to grow to when at least minCapacity is needed, multiplied by the growth factor of VECTOR_GROWTH_POLICY
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::_update_buffer_with_new_capacity(size_t newCapacity)
+template<class Type, class Allocator>
+inline size_t vector<Type, Allocator>::_calculate_growth(size_t minCapacity) const
+{
+#if VECTOR_GROWTH_POLICY == 0
+    const size_t grownCapacity = m_capacity * 2;
+#elif VECTOR_GROWTH_POLICY == 1
+    const size_t grownCapacity = m_capacity + m_capacity / 2;
+#endif
+
+    return std::max({ grownCapacity, minCapacity, kInitialCapacity });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Create a bigger array, update capacity, relocate elements from previous array to the new one
+// Time:  O(n), a single memcpy if Type is trivially relocatable
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_update_buffer_with_new_capacity(size_t newCapacity)
 {
-    const size_t newBufferSize = newCapacity * sizeof(Type);
-    std::byte* pNewBuffer = new std::byte[newBufferSize];
+    assert(newCapacity >= m_size);
 
-    // Is trivially copy able
-    // if the current buffer has data, copy it over to our new buffer and deallocate
+    std::byte* pNewBuffer = _allocate_buffer(newCapacity);
+
+    // if the current buffer has data, relocate it over to our new buffer and deallocate
     if (m_pBuffer)
     {
-        std::memcpy(pNewBuffer, m_pBuffer, sizeof(Type) * m_size);
-        delete[] m_pBuffer;
+        _relocate(reinterpret_cast<Type*>(pNewBuffer), reinterpret_cast<Type*>(m_pBuffer), m_size);
+        _free_buffer();
     }
     // point to the new buffer and set new capacity
     m_pBuffer = pNewBuffer;
@@ -985,23 +1348,142 @@ inline void vector<Type>::_update_buffer_with_new_capacity(size_t newCapacity)
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-// Delete pArray and set it to nullptr
-// Time:  O(n)
-// Space: O(1)
+// Shift every element from index one spot towards the end. The spot at index is left unconstructed.
+// Capacity must be greater than size.
+// Time:  O(n), n = distance(index, m_size)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline void vector<Type>::_destroy()
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_open_gap(size_t index)
+{
+    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
+
+    if constexpr (is_trivially_relocatable_v<Type>)
+    {
+        std::memmove(static_cast<void*>(pTypeArray + index + 1), static_cast<const void*>(pTypeArray + index), (m_size - index) * sizeof(Type));
+    }
+    else
+    {
+        // The last element moves into raw memory, the rest move into already moved from elements
+        new(pTypeArray + m_size) Type(std::move(pTypeArray[m_size - 1]));
+        for (size_t i = m_size - 1; i > index; --i)
+            pTypeArray[i] = std::move(pTypeArray[i - 1]);
+        pTypeArray[index].~Type();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Destroy the element at index and shift every element after it one spot towards the begin
+// Time:  O(n), n = distance(index, m_size)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_close_gap(size_t index)
+{
+    Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
+
+    if constexpr (is_trivially_relocatable_v<Type>)
+    {
+        if constexpr (!std::is_trivially_destructible_v<Type>)
+            pTypeArray[index].~Type();
+        std::memmove(static_cast<void*>(pTypeArray + index), static_cast<const void*>(pTypeArray + index + 1), (m_size - index - 1) * sizeof(Type));
+    }
+    else
+    {
+        for (size_t i = index; i + 1 < m_size; ++i)
+            pTypeArray[i] = std::move(pTypeArray[i + 1]);
+        pTypeArray[m_size - 1].~Type();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Destroy every element from first to the end, the buffer is kept
+// Time:  O(n), O(1) if Type is trivially destructible
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_destroy_elements(size_t first)
 {
     // If the type of elements is not trivially destructible, call it's destructor
     if constexpr (!std::is_trivially_destructible_v<Type>)
     {
         Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
-        for (size_t i = 0; i < m_size; ++i)
+        for (size_t i = first; i < m_size; ++i)
             pTypeArray[i].~Type();
     }
 
-    delete[] m_pBuffer;
+    m_size = first;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Delete pArray and set it to nullptr
+// Time:  O(n)
+// Space: O(1)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_destroy()
+{
+    _destroy_elements(0);
+    _free_buffer();
+    m_capacity = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Uninitialized memory for capacity elements, from the allocator
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline std::byte* vector<Type, Allocator>::_allocate_buffer(size_t capacity)
+{
+    return reinterpret_cast<std::byte*>(std::to_address(std::allocator_traits<Allocator>::allocate(m_allocator, capacity)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Give the buffer back to the allocator unless it's inline, the elements must be destroyed or relocated already
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_free_buffer()
+{
+    if (m_pBuffer && !m_isInlineBuffer)
+        std::allocator_traits<Allocator>::deallocate(m_allocator, reinterpret_cast<Type*>(m_pBuffer), m_capacity);
+
     m_pBuffer = nullptr;
+    m_isInlineBuffer = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Copy construct count elements into raw memory
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_copy_construct(Type* pDestination, const Type* pSource, size_t count)
+{
+    if constexpr (std::is_trivially_copyable_v<Type>)
+    {
+        if (count > 0)
+            std::memcpy(pDestination, pSource, count * sizeof(Type));
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+            new(pDestination + i) Type(pSource[i]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Move count elements into raw memory and destroy the sources, the two ranges must not overlap
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline void vector<Type, Allocator>::_relocate(Type* pDestination, Type* pSource, size_t count)
+{
+    if constexpr (is_trivially_relocatable_v<Type>)
+    {
+        if (count > 0)
+            std::memcpy(static_cast<void*>(pDestination), static_cast<const void*>(pSource), count * sizeof(Type));
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            new(pDestination + i) Type(std::move(pSource[i]));
+            pSource[i].~Type();
+        }
+    }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1012,8 +1494,8 @@ inline void vector<Type>::_destroy()
 //		3) Unrestricted / unknown, from j to pivot
 //		4) pivot
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline size_t vector<Type>::_partition(size_t start, size_t end)
+template<class Type, class Allocator>
+inline size_t vector<Type, Allocator>::_partition(size_t start, size_t end)
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -1057,8 +1539,8 @@ inline size_t vector<Type>::_partition(size_t start, size_t end)
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Helper function for Median of three QuickSort
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-template<class Type>
-inline size_t vector<Type>::_get_mid_index(size_t start, size_t end) const
+template<class Type, class Allocator>
+inline size_t vector<Type, Allocator>::_get_mid_index(size_t start, size_t end) const
 {
     Type* pTypeArray = reinterpret_cast<Type*>(m_pBuffer);
 
@@ -1089,4 +1571,207 @@ inline size_t vector<Type>::_get_mid_index(size_t start, size_t end) const
 }
 #endif
 
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Introsort loop. Recurse into the smaller part and loop on the bigger one, so the stack depth stays O(log(n))
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline void vector<Type, Allocator>::_introsort(Type* pFirst, Type* pLast, size_t depthLimit, Compare& compare)
+{
+    while (static_cast<size_t>(pLast - pFirst) > kInsertionSortThreshold)
+    {
+        // Too many bad pivots, heap sort is O(nlog(n)) no matter the input
+        if (depthLimit == 0)
+        {
+            _heap_sort(pFirst, pLast, compare);
+            return;
+        }
+        --depthLimit;
+
+        Type* pCut = _partition_around_median(pFirst, pLast, compare);
+        if (pCut - pFirst < pLast - pCut)
+        {
+            _introsort(pFirst, pCut, depthLimit, compare);
+            pFirst = pCut;
+        }
+        else
+        {
+            _introsort(pCut, pLast, depthLimit, compare);
+            pLast = pCut;
+        }
+    }
+
+    _insertion_sort(pFirst, pLast, compare);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Hoare partition around the median of the second, middle and last elements, which is moved to the first spot.
+// The median of three guarantees an element on each side to stop the scans, so they need no bounds checks.
+// Return the first element of the right part, everything before it is <= the pivot, everything from it is >= the pivot
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline Type* vector<Type, Allocator>::_partition_around_median(Type* pFirst, Type* pLast, Compare& compare)
+{
+    Type* pA = pFirst + 1;
+    Type* pB = pFirst + (pLast - pFirst) / 2;
+    Type* pC = pLast - 1;
+
+    // Move the median of a, b and c to the first spot
+    if (compare(*pA, *pB))
+    {
+        if (compare(*pB, *pC))          Swap(*pFirst, *pB);
+        else if (compare(*pA, *pC))     Swap(*pFirst, *pC);
+        else                            Swap(*pFirst, *pA);
+    }
+    else if (compare(*pA, *pC))         Swap(*pFirst, *pA);
+    else if (compare(*pB, *pC))         Swap(*pFirst, *pC);
+    else                                Swap(*pFirst, *pB);
+
+    Type* pLeft = pFirst + 1;
+    Type* pRight = pLast;
+    while (true)
+    {
+        while (compare(*pLeft, *pFirst))
+            ++pLeft;
+
+        --pRight;
+        while (compare(*pFirst, *pRight))
+            --pRight;
+
+        if (!(pLeft < pRight))
+            return pLeft;
+
+        Swap(*pLeft, *pRight);
+        ++pLeft;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Insertion sort on a small range
+// Time:  O(n ^ 2)
+// Space: O(1)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline void vector<Type, Allocator>::_insertion_sort(Type* pFirst, Type* pLast, Compare& compare)
+{
+    if (pFirst == pLast)
+        return;
+
+    for (Type* pCurrent = pFirst + 1; pCurrent < pLast; ++pCurrent)
+    {
+        Type key = std::move(*pCurrent);
+
+        // Smaller than the first element, shift the whole sorted part
+        if (compare(key, *pFirst))
+        {
+            std::move_backward(pFirst, pCurrent, pCurrent + 1);
+            *pFirst = std::move(key);
+            continue;
+        }
+
+        // Otherwise the first element stops the loop, no need to check the bounds
+        Type* pHole = pCurrent;
+        while (compare(key, *(pHole - 1)))
+        {
+            *pHole = std::move(*(pHole - 1));
+            --pHole;
+        }
+        *pHole = std::move(key);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Heap sort fallback of introsort
+// Time:  O(nlog(n))
+// Space: O(1)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline void vector<Type, Allocator>::_heap_sort(Type* pFirst, Type* pLast, Compare& compare)
+{
+    const size_t count = static_cast<size_t>(pLast - pFirst);
+
+    // Build a max heap
+    for (size_t i = count / 2; i > 0; --i)
+        _sift_down(pFirst, i - 1, count, compare);
+
+    // Move the max to the end one by one
+    for (size_t heapSize = count; heapSize > 1; --heapSize)
+    {
+        Swap(pFirst[0], pFirst[heapSize - 1]);
+        _sift_down(pFirst, 0, heapSize - 1, compare);
+    }
+}
+
+template<class Type, class Allocator>
+template<class Compare>
+inline void vector<Type, Allocator>::_sift_down(Type* pHeap, size_t index, size_t count, Compare& compare)
+{
+    while (true)
+    {
+        size_t largest = index;
+        const size_t left = 2 * index + 1;
+        const size_t right = left + 1;
+
+        if (left < count && compare(pHeap[largest], pHeap[left]))
+            largest = left;
+        if (right < count && compare(pHeap[largest], pHeap[right]))
+            largest = right;
+        if (largest == index)
+            return;
+
+        Swap(pHeap[index], pHeap[largest]);
+        index = largest;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Merge two sorted ranges into pDestination
+// Time:  O(n)
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+template<class Compare>
+inline void vector<Type, Allocator>::_merge(Type* pLeft, Type* pLeftEnd, Type* pRight, Type* pRightEnd, Type* pDestination, Compare& compare)
+{
+    while (pLeft != pLeftEnd && pRight != pRightEnd)
+    {
+        if (compare(*pRight, *pLeft))
+            *pDestination++ = std::move(*pRight++);
+        else
+            *pDestination++ = std::move(*pLeft++);
+    }
+
+    pDestination = std::move(pLeft, pLeftEnd, pDestination);
+    std::move(pRight, pRightEnd, pDestination);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Map an arithmetic value to an unsigned key which sorts the same way
+//  - Signed integers: flip the sign bit, so negative numbers come first
+//  - Floating points: flip every bit of negative numbers, and only the sign bit of positive numbers
+//------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+template<class Type, class Allocator>
+inline auto vector<Type, Allocator>::_radix_key(Type value)
+{
+    if constexpr (std::is_floating_point_v<Type>)
+    {
+        using Key = std::conditional_t<sizeof(Type) == 4, uint32_t, uint64_t>;
+        static_assert(sizeof(Type) == sizeof(Key), "Unsupported floating point size");
+
+        const Key bits = std::bit_cast<Key>(value);
+        const Key signBit = Key(1) << (sizeof(Key) * 8 - 1);
+        return (bits & signBit) ? static_cast<Key>(~bits) : static_cast<Key>(bits | signBit);
+    }
+    else
+    {
+        using Key = std::make_unsigned_t<Type>;
+        if constexpr (std::is_signed_v<Type>)
+            return static_cast<Key>(static_cast<Key>(value) ^ (Key(1) << (sizeof(Key) * 8 - 1)));
+        else
+            return static_cast<Key>(value);
+    }
+}
+
 }
\ No newline at end of file
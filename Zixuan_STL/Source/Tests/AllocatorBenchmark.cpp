@@ -0,0 +1,74 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/list.h"
+#include "DataStructures/RedBlackTree.h"
+#include "Memory/FixedBlockPool.h"
+#include "Memory/MonotonicArena.h"
+#include "Memory/SlabHeap.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+static constexpr size_t kNodeCount = 200'000;
+static constexpr size_t kRoundCount = 10;
+
+//--------------------------------------------------------------------------------------------------------------------
+// Build a tree and a list of kNodeCount nodes and tear them down again, kRoundCount times. Nearly all the time
+// goes into allocating and freeing nodes, which is what the allocators are compared on.
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Allocator>
+size_t RunNodeWorkload(const Allocator& alloc, const char* label, MonotonicArena* pArena = nullptr)
+{
+	START_PROFILER(label);
+
+	size_t checksum = 0;
+	for (size_t round = 0; round < kRoundCount; ++round)
+	{
+		{
+			zxstl::RedBlackTree<uint32_t, uint32_t, Allocator> tree(alloc);
+			uint32_t key = static_cast<uint32_t>(round);
+			for (size_t i = 0; i < kNodeCount; ++i)
+			{
+				key = key * 1664525u + 1013904223u;
+				tree.Insert(key, static_cast<uint32_t>(i));
+			}
+			checksum += tree.GetSize();
+
+			zxstl::list<uint32_t, Allocator> list(alloc);
+			for (size_t i = 0; i < kNodeCount; ++i)
+				list.PushBack(static_cast<uint32_t>(i));
+			while (!list.Empty())
+				checksum += list.PopFront();
+		}
+
+		// Everything of this round is dead, start the arena over
+		if (pArena)
+			pArena->Reset();
+	}
+
+	return checksum;
+}
+
+static void PrintStats(const char* label, const AllocationStats& stats)
+{
+	std::cout << label << ": " << stats.m_bytesInUse << " bytes in use, " << stats.m_highWaterMark << " high-water, "
+		<< stats.m_bytesReserved << " reserved, " << stats.m_allocationCount << " allocations" << std::endl;
+}
+
+int allocatorbenchmark()
+{
+	size_t checksum = 0;
+	checksum += RunNodeWorkload(zxstl::allocator<uint32_t>(), "zxstl::allocator (operator new)");
+	checksum += RunNodeWorkload(PoolAllocator<uint32_t>(), "PoolAllocator (thread local FixedBlockPool)");
+
+	SlabHeap slabHeap;
+	checksum += RunNodeWorkload(SlabAllocator<uint32_t>(slabHeap), "SlabAllocator");
+	PrintStats("SlabHeap", slabHeap.GetStats());
+
+	MonotonicArena arena;
+	checksum += RunNodeWorkload(ArenaAllocator<uint32_t>(arena), "ArenaAllocator (reset every round)", &arena);
+	PrintStats("MonotonicArena", arena.GetStats());
+
+	return static_cast<int>(checksum & 1);
+}
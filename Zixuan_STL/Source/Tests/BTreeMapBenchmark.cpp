@@ -0,0 +1,97 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/btree_map.h"
+#include "DataStructures/RedBlackTree.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <vector>
+
+static constexpr size_t kKeyCount = 1'000'000;
+static constexpr size_t kRangeQueryCount = 100'000;
+static constexpr uint32_t kRangeWidth = 1u << 16;		// ~15 keys per range with 1M random 32 bit keys
+
+// xorshift, cheap enough to not hide the cost of the trees
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+int btreemapbenchmark()
+{
+	std::vector<uint32_t> keys(kKeyCount);
+	uint32_t state = 1;
+	for (uint32_t& key : keys)
+		key = NextRandom(state);
+
+	uint64_t checksum = 0;
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// RedBlackTree, one node and one cache miss per level
+	//--------------------------------------------------------------------------------------------------------------------
+	{
+		zxstl::RedBlackTree<uint32_t, uint32_t> tree;
+		{
+			START_PROFILER("RedBlackTree Insert");
+			for (uint32_t key : keys)
+				tree.Insert(key, key);
+		}
+
+		{
+			START_PROFILER("RedBlackTree Search");
+			for (uint32_t key : keys)
+				checksum += tree.Search(key).value();
+		}
+
+		{
+			START_PROFILER("RedBlackTree in order walk");
+			tree.InOrderWalkIterative([&checksum](uint32_t, uint32_t data) { checksum += data; });
+		}
+	}
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// btree_map, same workloads plus the range queries RedBlackTree can't do yet
+	//--------------------------------------------------------------------------------------------------------------------
+	{
+		zxstl::btree_map<uint32_t, uint32_t> map;
+		{
+			START_PROFILER("btree_map insert");
+			for (uint32_t key : keys)
+				map.insert(key, key);
+		}
+
+		{
+			START_PROFILER("btree_map find");
+			for (uint32_t key : keys)
+				checksum += map.find(key)->second;
+		}
+
+		{
+			START_PROFILER("btree_map ForEach");
+			map.ForEach([&checksum](uint32_t, uint32_t value) { checksum += value; });
+		}
+
+		{
+			START_PROFILER("btree_map ForEachInRange");
+			for (size_t i = 0; i < kRangeQueryCount; ++i)
+			{
+				const uint32_t first = NextRandom(state) & ~(kRangeWidth - 1);
+				map.ForEachInRange(first, first + (kRangeWidth - 1), [&checksum](uint32_t, uint32_t value) { checksum += value; });
+			}
+		}
+
+		{
+			START_PROFILER("btree_map range erase");
+			for (size_t i = 0; i < kRangeQueryCount; ++i)
+			{
+				const uint32_t first = NextRandom(state) & ~(kRangeWidth - 1);
+				map.erase(map.lower_bound(first), map.lower_bound(first + (kRangeWidth - 1)));
+			}
+			checksum += map.size();
+		}
+	}
+
+	return static_cast<int>(checksum & 1);
+}
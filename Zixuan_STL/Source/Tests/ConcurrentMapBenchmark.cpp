@@ -0,0 +1,133 @@
+#include "DataStructures/concurrent_unordered_map.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr size_t kKeyCount = 1 << 16;		// Keys are drawn from [0, kKeyCount)
+static constexpr size_t kOperationsPerThread = 1'000'000;
+static constexpr uint32_t kFindPercent = 90;		// The rest is split between insert_or_assign and erase
+
+//--------------------------------------------------------------------------------------------------------------------
+// What concurrent_unordered_map is compared against, one mutex around the whole table
+//--------------------------------------------------------------------------------------------------------------------
+class MutexGuardedMap
+{
+	mutable std::mutex m_mutex;
+	zxstl::unordered_map<size_t, size_t> m_map;
+
+public:
+	std::optional<size_t> find(size_t key) const
+	{
+		std::lock_guard lock(m_mutex);
+		const auto* pValue = m_map.Peek(key);
+		if (pValue == nullptr)
+			return std::nullopt;
+		return pValue->second;
+	}
+
+	bool insert_or_assign(size_t key, size_t value)
+	{
+		std::lock_guard lock(m_mutex);
+		return m_map.insert_or_assign(key, value).second;
+	}
+
+	size_t erase(size_t key)
+	{
+		std::lock_guard lock(m_mutex);
+		return m_map.erase(key);
+	}
+};
+
+// xorshift, cheap enough to not hide the cost of the map
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Run the mixed workload on threadCount threads, the profiler prints the wall time of the whole run
+// Returns how many finds hit, which also keeps the finds from being optimized away
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Map>
+size_t RunWorkload(Map& map, size_t threadCount, const char* label)
+{
+	// Half of the keys exist before we start
+	for (size_t i = 0; i < kKeyCount; i += 2)
+		map.insert_or_assign(i, i);
+
+	const std::string profilerLabel = std::string(label) + ", " + std::to_string(threadCount) + " threads";
+	START_PROFILER(profilerLabel.c_str());
+
+	std::vector<std::thread> threads;
+	std::vector<size_t> hits(threadCount, 0);
+	for (size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+	{
+		threads.emplace_back([&map, &hits, threadIndex]()
+		{
+			uint32_t state = static_cast<uint32_t>(threadIndex * 2654435761u + 1);
+			size_t hitCount = 0;
+			for (size_t i = 0; i < kOperationsPerThread; ++i)
+			{
+				const uint32_t random = NextRandom(state);
+				const size_t key = random % kKeyCount;
+				const uint32_t operation = (random >> 16) % 100;
+
+				if (operation < kFindPercent)
+					hitCount += map.find(key).has_value();
+				else if (operation % 2 == 0)
+					map.insert_or_assign(key, i);
+				else
+					map.erase(key);
+			}
+
+			// Written once at the end, so the counters don't false share during the run
+			hits[threadIndex] = hitCount;
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return std::accumulate(hits.begin(), hits.end(), size_t(0));
+}
+
+int concurrentmapbenchmark()
+{
+	const size_t maxThreadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		size_t mutexHitCount = 0;
+		{
+			MutexGuardedMap map;
+			mutexHitCount = RunWorkload(map, threadCount, "Mutex guarded unordered_map");
+		}
+
+		size_t concurrentHitCount = 0;
+		{
+			zxstl::concurrent_unordered_map<size_t, size_t> map;
+			concurrentHitCount = RunWorkload(map, threadCount, "concurrent_unordered_map");
+		}
+
+		std::cout << threadCount << " threads, find hits: " << mutexHitCount << " mutex guarded, " << concurrentHitCount << " concurrent" << std::endl;
+
+		// One thread runs the same operations in the same order on both maps, they must agree on every find
+		if (threadCount == 1 && mutexHitCount != concurrentHitCount)
+		{
+			std::cout << "concurrent_unordered_map finds differ from the mutex guarded unordered_map" << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
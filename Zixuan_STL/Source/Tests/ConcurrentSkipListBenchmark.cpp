@@ -0,0 +1,123 @@
+#include "DataStructures/ConcurrentSkipList.h"
+#include "DataStructures/RedBlackTree.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr size_t kKeyCount = 1 << 18;			// Keys are drawn from [0, kKeyCount)
+static constexpr size_t kSearchesPerReader = 1'000'000;
+
+//--------------------------------------------------------------------------------------------------------------------
+// What ConcurrentSkipList is compared against, a RedBlackTree behind a reader writer lock
+//--------------------------------------------------------------------------------------------------------------------
+class SharedMutexGuardedTree
+{
+	mutable std::shared_mutex m_mutex;
+	zxstl::RedBlackTree<size_t, size_t> m_tree;
+
+public:
+	std::optional<size_t> Search(size_t key) const
+	{
+		std::shared_lock lock(m_mutex);
+		return m_tree.Search(key);
+	}
+
+	void Insert(size_t key, size_t data)
+	{
+		std::unique_lock lock(m_mutex);
+		if (!m_tree.Search(key))
+			m_tree.Insert(key, data);
+	}
+
+	void Delete(size_t key)
+	{
+		std::unique_lock lock(m_mutex);
+		m_tree.Delete(key);
+	}
+};
+
+// xorshift, cheap enough to not hide the cost of the map
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// readerCount threads search while one writer keeps inserting and deleting, the profiler prints how long the readers
+// take for their fixed amount of searches
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Map>
+void RunReadMostlyWorkload(size_t readerCount, const char* label)
+{
+	Map map;
+
+	// Half of the keys exist before we start
+	for (size_t i = 0; i < kKeyCount; i += 2)
+		map.Insert(i, i);
+
+	std::atomic<bool> areReadersDone{ false };
+	std::thread writer([&map, &areReadersDone]()
+	{
+		uint32_t state = 0x2545F491u;
+		while (!areReadersDone.load(std::memory_order_relaxed))
+		{
+			const uint32_t random = NextRandom(state);
+			const size_t key = random % kKeyCount;
+			if (random & (1u << 31))
+				map.Insert(key, key);
+			else
+				map.Delete(key);
+		}
+	});
+
+	{
+		const std::string profilerLabel = std::string(label) + ", " + std::to_string(readerCount) + " readers";
+		START_PROFILER(profilerLabel.c_str());
+
+		std::vector<std::thread> readers;
+		std::vector<size_t> hits(readerCount, 0);
+		for (size_t readerIndex = 0; readerIndex < readerCount; ++readerIndex)
+		{
+			readers.emplace_back([&map, &hits, readerIndex]()
+			{
+				uint32_t state = static_cast<uint32_t>(readerIndex * 2654435761u + 1);
+				size_t hitCount = 0;
+				for (size_t i = 0; i < kSearchesPerReader; ++i)
+					hitCount += map.Search(NextRandom(state) % kKeyCount).has_value();
+
+				// Written once at the end, so the counters don't false share during the run
+				hits[readerIndex] = hitCount;
+			});
+		}
+
+		for (std::thread& reader : readers)
+			reader.join();
+	}
+
+	areReadersDone.store(true, std::memory_order_relaxed);
+	writer.join();
+}
+
+int concurrentskiplistbenchmark()
+{
+	// One hardware thread is left to the writer
+	const size_t maxReaderCount = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+
+	for (size_t readerCount = 1; readerCount <= maxReaderCount; readerCount *= 2)
+	{
+		RunReadMostlyWorkload<SharedMutexGuardedTree>(readerCount, "Shared mutex guarded RedBlackTree");
+		RunReadMostlyWorkload<zxstl::ConcurrentSkipList<size_t, size_t>>(readerCount, "ConcurrentSkipList");
+	}
+
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/Graph.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <string>
+
+static constexpr size_t kNodeCount = 200'000;
+static constexpr size_t kEdgesPerNode = 10;
+static constexpr size_t kSearchCount = 5;
+
+// xorshift, cheap enough to not hide the cost of the graph
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Time the searches on one storage mode, the profiler prints each phase
+//--------------------------------------------------------------------------------------------------------------------
+static uint64_t RunSearches(zxstl::Graph<uint32_t>& graph, const char* label)
+{
+	const std::string name(label);
+	uint64_t checksum = 0;
+	auto visit = [&checksum](size_t nodeId, const uint32_t&) { checksum += nodeId; };
+
+	{
+		const std::string profilerLabel = name + " BreadthFirstSearch";
+		START_PROFILER(profilerLabel.c_str());
+		for (size_t i = 0; i < kSearchCount; ++i)
+			graph.BreadthFirstSearch(i, visit);
+	}
+
+	{
+		const std::string profilerLabel = name + " DepthFirstSearchIter";
+		START_PROFILER(profilerLabel.c_str());
+		for (size_t i = 0; i < kSearchCount; ++i)
+			graph.DepthFirstSearchIter(i, [&checksum](const uint32_t& data) { checksum += data; });
+	}
+
+	{
+		const std::string profilerLabel = name + " RunDijkstraSearch";
+		START_PROFILER(profilerLabel.c_str());
+		for (size_t i = 0; i < kSearchCount; ++i)
+			graph.RunDijkstraSearch(i, visit);
+	}
+
+	{
+		const std::string profilerLabel = name + " RunRadixDijkstraSearch";
+		START_PROFILER(profilerLabel.c_str());
+		for (size_t i = 0; i < kSearchCount; ++i)
+			graph.RunRadixDijkstraSearch(i, visit);
+	}
+
+	return checksum;
+}
+
+int graphcsrbenchmark()
+{
+	zxstl::Graph<uint32_t> graph;
+	{
+		START_PROFILER("Graph build");
+		for (size_t i = 0; i < kNodeCount; ++i)
+			graph.AddNode(static_cast<uint32_t>(i));
+
+		uint32_t state = 1;
+		for (size_t i = 0; i < kNodeCount; ++i)
+		{
+			for (size_t edge = 0; edge < kEdgesPerNode; ++edge)
+				graph.AddEdge(i, NextRandom(state) % kNodeCount, static_cast<float>(NextRandom(state) % 100 + 1));
+		}
+	}
+
+	uint64_t checksum = RunSearches(graph, "std::map");
+
+	{
+		START_PROFILER("Graph Freeze");
+		graph.Freeze();
+	}
+
+	checksum += RunSearches(graph, "CSR");
+	return static_cast<int>(checksum & 1);
+}
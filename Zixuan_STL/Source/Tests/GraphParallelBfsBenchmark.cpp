@@ -0,0 +1,77 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/Graph.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <string>
+
+static constexpr size_t kNodeCount = 300'000;
+static constexpr size_t kEdgesPerNode = 16;
+static constexpr size_t kSearchCount = 5;
+
+// xorshift, cheap enough to not hide the cost of the graph
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Time ParallelBreadthFirstSearch() on the frozen graph, the profiler prints each phase
+//--------------------------------------------------------------------------------------------------------------------
+static uint64_t RunParallelSearches(const zxstl::Graph<uint32_t>& graph, const char* label)
+{
+	using Graph = zxstl::Graph<uint32_t>;
+
+	Graph::BreadthFirstSearchState state;
+	uint64_t checksum = 0;
+
+	const std::string profilerLabel = std::string(label) + " ParallelBreadthFirstSearch";
+	START_PROFILER(profilerLabel.c_str());
+	for (size_t i = 0; i < kSearchCount; ++i)
+	{
+		graph.ParallelBreadthFirstSearch(i, state);
+		checksum += state.GetReachedCount();
+	}
+
+	return checksum;
+}
+
+int graphparallelbfsbenchmark()
+{
+	zxstl::Graph<uint32_t> graph;
+	{
+		START_PROFILER("Graph build");
+		for (size_t i = 0; i < kNodeCount; ++i)
+			graph.AddNode(static_cast<uint32_t>(i));
+
+		uint32_t state = 1;
+		for (size_t i = 0; i < kNodeCount; ++i)
+		{
+			for (size_t edge = 0; edge < kEdgesPerNode; ++edge)
+				graph.AddEdge(i, NextRandom(state) % kNodeCount);
+		}
+	}
+
+	uint64_t checksum = 0;
+	graph.Freeze();
+	{
+		START_PROFILER("CSR BreadthFirstSearch");
+		for (size_t i = 0; i < kSearchCount; ++i)
+			graph.BreadthFirstSearch(i, [&checksum](size_t nodeId, const uint32_t&) { checksum += nodeId; });
+	}
+
+	// Top-down only, no incoming edges to go bottom-up with
+	checksum += RunParallelSearches(graph, "Top-down");
+
+	graph.Unfreeze();
+	{
+		START_PROFILER("Graph Freeze with incoming edges");
+		graph.Freeze(true);
+	}
+	checksum += RunParallelSearches(graph, "Direction optimizing");
+
+	return static_cast<int>(checksum & 1);
+}
@@ -0,0 +1,101 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/Graph.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <vector>
+
+static constexpr size_t kGridSize = 512;
+static constexpr size_t kLandmarkCount = 16;
+static constexpr size_t kQueryCount = 200;
+
+// xorshift, cheap enough to not hide the cost of the graph
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Random point to point queries on a road like graph: a grid of two way streets with random travel times
+// Dijkstra from the start, then from both ends, then A* on landmark distances
+//--------------------------------------------------------------------------------------------------------------------
+int graphpointtopointbenchmark()
+{
+	using Graph = zxstl::Graph<uint32_t>;
+
+	Graph graph;
+	uint32_t state = 1;
+	for (size_t i = 0; i < kGridSize * kGridSize; ++i)
+		graph.AddNode(static_cast<uint32_t>(i));
+	for (size_t y = 0; y < kGridSize; ++y)
+	{
+		for (size_t x = 0; x < kGridSize; ++x)
+		{
+			const Graph::NodeId kNodeId = y * kGridSize + x;
+			if (x + 1 < kGridSize)
+			{
+				graph.AddEdge(kNodeId, kNodeId + 1, static_cast<float>(NextRandom(state) % 10 + 1));
+				graph.AddEdge(kNodeId + 1, kNodeId, static_cast<float>(NextRandom(state) % 10 + 1));
+			}
+			if (y + 1 < kGridSize)
+			{
+				graph.AddEdge(kNodeId, kNodeId + kGridSize, static_cast<float>(NextRandom(state) % 10 + 1));
+				graph.AddEdge(kNodeId + kGridSize, kNodeId, static_cast<float>(NextRandom(state) % 10 + 1));
+			}
+		}
+	}
+	graph.Freeze(true);
+
+	std::vector<std::pair<Graph::NodeId, Graph::NodeId>> queries(kQueryCount);
+	for (auto& [start, end] : queries)
+	{
+		start = NextRandom(state) % graph.GetNodeCount();
+		end = NextRandom(state) % graph.GetNodeCount();
+	}
+
+	double checksum = 0.0;
+	size_t reachedCount = 0;
+	auto noVisit = [](Graph::NodeId, const uint32_t&) {};
+
+	Graph::SearchContext context;
+	{
+		START_PROFILER("RunDijkstraFind");
+		for (const auto& [kStart, kEnd] : queries)
+		{
+			graph.RunDijkstraFind(kStart, kEnd, context, noVisit);
+			checksum += context.GetDistance(kEnd);
+			reachedCount += context.GetReachedNodes().size();
+		}
+	}
+
+	{
+		START_PROFILER("RunBidirectionalDijkstraFind");
+		Graph::BidirectionalSearchContext bidirectionalContext;
+		for (const auto& [kStart, kEnd] : queries)
+		{
+			graph.RunBidirectionalDijkstraFind(kStart, kEnd, bidirectionalContext);
+			checksum += bidirectionalContext.GetDistance();
+			reachedCount += bidirectionalContext.GetReachedCount();
+		}
+	}
+
+	{
+		START_PROFILER("BuildLandmarks");
+		graph.BuildLandmarks(kLandmarkCount);
+	}
+
+	{
+		START_PROFILER("RunLandmarkAStar");
+		for (const auto& [kStart, kEnd] : queries)
+		{
+			graph.RunLandmarkAStar(kStart, kEnd, context, noVisit);
+			checksum += context.GetDistance(kEnd);
+			reachedCount += context.GetReachedNodes().size();
+		}
+	}
+
+	return static_cast<int>(checksum + reachedCount) & 1;
+}
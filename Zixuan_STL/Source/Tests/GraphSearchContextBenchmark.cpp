@@ -0,0 +1,77 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/Graph.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <vector>
+
+static constexpr size_t kNodeCount = 1'000'000;
+static constexpr size_t kQueryCount = 1'000;
+static constexpr size_t kQueryLength = 50;		// End node of a query is this many nodes after its start
+
+// xorshift, cheap enough to not hide the cost of the graph
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Short point to point queries on a big road like graph: each node links to the next few ones
+//--------------------------------------------------------------------------------------------------------------------
+int graphsearchcontextbenchmark()
+{
+	using Graph = zxstl::Graph<uint32_t>;
+
+	Graph graph;
+	uint32_t state = 1;
+	for (size_t i = 0; i < kNodeCount; ++i)
+		graph.AddNode(static_cast<uint32_t>(i));
+	for (size_t i = 0; i + 4 < kNodeCount; ++i)
+	{
+		for (size_t step = 1; step <= 4; ++step)
+			graph.AddEdge(i, i + step, static_cast<float>(NextRandom(state) % 10 + step * 4));
+	}
+	graph.Freeze();
+
+	std::vector<Graph::NodeId> starts(kQueryCount);
+	for (Graph::NodeId& start : starts)
+		start = NextRandom(state) % (kNodeCount - kQueryLength);
+
+	uint64_t checksum = 0;
+	auto noVisit = [](Graph::NodeId, const uint32_t&) {};
+
+	{
+		// Every query resets, and then copies back, the data of all the vertices
+		START_PROFILER("RunDijkstraFind into the vertices");
+		for (const Graph::NodeId kStart : starts)
+			checksum += graph.RunDijkstraFind(kStart, kStart + kQueryLength, noVisit).size();
+	}
+
+	{
+		START_PROFILER("RunDijkstraFind with one SearchContext");
+		Graph::SearchContext context;
+		for (const Graph::NodeId kStart : starts)
+			checksum += graph.RunDijkstraFind(kStart, kStart + kQueryLength, context, noVisit).size();
+	}
+
+	{
+		START_PROFILER("RunDijkstraFind with a SearchContext per thread");
+		const Graph& kReadOnlyGraph = graph;
+		ThreadPool& threadPool = ThreadPool::Get();
+		std::vector<Graph::SearchContext> contexts(threadPool.GetThreadCount() + 1);
+		std::vector<uint64_t> pathLengths(contexts.size(), 0);
+		threadPool.ParallelFor(contexts.size(), [&](size_t task)
+		{
+			for (size_t query = task; query < kQueryCount; query += contexts.size())
+				pathLengths[task] += kReadOnlyGraph.RunDijkstraFind(starts[query], starts[query] + kQueryLength, contexts[task], noVisit).size();
+		});
+
+		for (const uint64_t kPathLength : pathLengths)
+			checksum += kPathLength;
+	}
+
+	return static_cast<int>(checksum & 1);
+}
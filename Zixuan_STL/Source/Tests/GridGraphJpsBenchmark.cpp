@@ -0,0 +1,102 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/GridGraph.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <vector>
+
+static constexpr size_t kGridSize = 1024;		// The Graph of a bigger grid takes too long to build with std::map edges
+static constexpr size_t kWallCount = 4000;
+static constexpr size_t kMaxWallLength = 64;
+static constexpr size_t kQueryCount = 20;
+
+// xorshift, cheap enough to not hide the cost of the grid
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Long queries on a grid of random walls: A* on the grid as a Graph, then Jump Point Search with and without tables
+//--------------------------------------------------------------------------------------------------------------------
+int gridgraphjpsbenchmark()
+{
+	using CellId = zxstl::GridGraph::CellId;
+
+	zxstl::GridGraph grid(kGridSize, kGridSize);
+	uint32_t state = 1;
+	for (size_t wall = 0; wall < kWallCount; ++wall)
+	{
+		const size_t kX = NextRandom(state) % kGridSize;
+		const size_t kY = NextRandom(state) % kGridSize;
+		const size_t kLength = NextRandom(state) % kMaxWallLength;
+		const bool kIsHorizontal = NextRandom(state) % 2 == 0;
+		for (size_t i = 0; i < kLength; ++i)
+		{
+			if (kIsHorizontal && kX + i < kGridSize)
+				grid.SetWalkable(kX + i, kY, false);
+			else if (!kIsHorizontal && kY + i < kGridSize)
+				grid.SetWalkable(kX, kY + i, false);
+		}
+	}
+
+	// Corners to opposite corners, wherever the cells are open
+	std::vector<std::pair<CellId, CellId>> queries;
+	while (queries.size() < kQueryCount)
+	{
+		const int kStartX = NextRandom(state) % (kGridSize / 8);
+		const int kStartY = NextRandom(state) % (kGridSize / 8);
+		const int kGoalX = kGridSize - 1 - NextRandom(state) % (kGridSize / 8);
+		const int kGoalY = kGridSize - 1 - NextRandom(state) % (kGridSize / 8);
+		if (grid.IsWalkable(kStartX, kStartY) && grid.IsWalkable(kGoalX, kGoalY))
+			queries.emplace_back(grid.GetCellId(kStartX, kStartY), grid.GetCellId(kGoalX, kGoalY));
+	}
+
+	double checksum = 0.0;
+
+	zxstl::Graph<CellId> graph;
+	{
+		START_PROFILER("Graph build and Freeze");
+		grid.BuildGraph(graph);
+		graph.Freeze();
+	}
+
+	{
+		START_PROFILER("Graph RunAStar");
+		zxstl::Graph<CellId>::SearchContext context;
+		for (const auto& [kStart, kGoal] : queries)
+		{
+			graph.RunAStar(kStart, kGoal, context, [](size_t, const CellId&) {});
+			checksum += context.GetDistance(kGoal);
+		}
+	}
+
+	zxstl::GridGraph::SearchContext context;
+	{
+		START_PROFILER("GridGraph FindPathJps");
+		for (const auto& [kStart, kGoal] : queries)
+		{
+			grid.FindPathJps(kStart, kGoal, context);
+			checksum += context.GetDistance(kGoal);
+		}
+	}
+
+	{
+		START_PROFILER("GridGraph BuildJumpTables");
+		grid.BuildJumpTables();
+	}
+
+	{
+		START_PROFILER("GridGraph FindPathJpsPlus");
+		for (const auto& [kStart, kGoal] : queries)
+		{
+			grid.FindPathJpsPlus(kStart, kGoal, context);
+			checksum += context.GetDistance(kGoal);
+		}
+	}
+
+	return static_cast<int>(checksum) & 1;
+}
@@ -0,0 +1,129 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/RedBlackTree.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+static constexpr size_t kKeyCount = 100'000;
+static constexpr size_t kOperationCount = 2'000'000;
+
+// xorshift, cheap enough to not hide the cost of the trees
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+int redblacktreechurnbenchmark()
+{
+	using Tree = zxstl::RedBlackTree<uint32_t, uint32_t>;
+
+	// Keys are kept in a vector, so each operation hits a key which is in the tree
+	std::vector<uint32_t> keys(kKeyCount);
+	uint32_t state = 1;
+	for (uint32_t& key : keys)
+		key = NextRandom(state);
+
+	uint64_t checksum = 0;
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Steady state churn, every Delete() is followed by an Insert(). std::map allocates for each insert, the tree
+	// takes the node the delete just pooled.
+	//--------------------------------------------------------------------------------------------------------------------
+	{
+		Tree tree;
+		for (uint32_t key : keys)
+			tree.Insert(key, key);
+
+		std::vector<uint32_t> liveKeys = keys;
+		START_PROFILER("RedBlackTree Delete / Insert churn");
+		for (size_t i = 0; i < kOperationCount; ++i)
+		{
+			uint32_t& key = liveKeys[NextRandom(state) % kKeyCount];
+			tree.Delete(key);
+			key = NextRandom(state);
+			tree.Insert(key, key);
+		}
+		checksum += tree.GetSize() + tree.GetPooledNodeCount();
+	}
+
+	{
+		std::multimap<uint32_t, uint32_t> map;
+		for (uint32_t key : keys)
+			map.emplace(key, key);
+
+		std::vector<uint32_t> liveKeys = keys;
+		START_PROFILER("std::multimap erase / emplace churn");
+		for (size_t i = 0; i < kOperationCount; ++i)
+		{
+			uint32_t& key = liveKeys[NextRandom(state) % kKeyCount];
+			map.erase(map.find(key));
+			key = NextRandom(state);
+			map.emplace(key, key);
+		}
+		checksum += map.size();
+	}
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Priority updates, the way ChangeKey() used to work against the way it works now
+	//--------------------------------------------------------------------------------------------------------------------
+	{
+		Tree tree;
+		for (uint32_t key : keys)
+			tree.Insert(key, key);
+
+		std::vector<uint32_t> liveKeys = keys;
+		START_PROFILER("RedBlackTree Search / Delete / Insert");
+		for (size_t i = 0; i < kOperationCount; ++i)
+		{
+			uint32_t& key = liveKeys[NextRandom(state) % kKeyCount];
+			const std::optional<uint32_t> data = tree.Search(key);
+			tree.Delete(key);
+			key = NextRandom(state);
+			tree.Insert(key, *data);
+		}
+		checksum += tree.GetSize();
+	}
+
+	{
+		Tree tree;
+		for (uint32_t key : keys)
+			tree.Insert(key, key);
+
+		std::vector<uint32_t> liveKeys = keys;
+		START_PROFILER("RedBlackTree ChangeKey");
+		for (size_t i = 0; i < kOperationCount; ++i)
+		{
+			uint32_t& key = liveKeys[NextRandom(state) % kKeyCount];
+			const uint32_t newKey = NextRandom(state);
+			tree.ChangeKey(key, newKey);
+			key = newKey;
+		}
+		checksum += tree.GetSize();
+	}
+
+	// Small steps mostly keep the key between its neighbours, no relinking at all
+	{
+		Tree tree;
+		for (uint32_t key : keys)
+			tree.Insert(key, key);
+
+		std::vector<uint32_t> liveKeys = keys;
+		START_PROFILER("RedBlackTree ChangeKey small steps");
+		for (size_t i = 0; i < kOperationCount; ++i)
+		{
+			uint32_t& key = liveKeys[NextRandom(state) % kKeyCount];
+			const uint32_t newKey = key + (NextRandom(state) & 0xff);
+			tree.ChangeKey(key, newKey);
+			key = newKey;
+		}
+		checksum += tree.GetSize();
+	}
+
+	return static_cast<int>(checksum & 1);
+}
@@ -0,0 +1,79 @@
+#include "DataStructures/simd.h"
+#include "DataStructures/vector.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+static constexpr size_t kElementCount = 1 << 22;
+static constexpr size_t kRepeatCount = 50;
+
+static const char* GetLevelName(zxstl::simd::Level level)
+{
+	switch (level)
+	{
+	case zxstl::simd::Level::kScalar:	return "Scalar";
+	case zxstl::simd::Level::kSse2:		return "SSE2";
+	case zxstl::simd::Level::kAvx2:		return "AVX2";
+	}
+	return "";
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Time Find (on a missing value, so the whole array is read), Count and MinMax on one instruction set
+//--------------------------------------------------------------------------------------------------------------------
+template<typename Type>
+size_t RunScans(const zxstl::vector<Type>& values, zxstl::simd::Level level, const char* typeName)
+{
+	zxstl::simd::SetLevel(level);
+	const std::string label = std::string(typeName) + " " + GetLevelName(zxstl::simd::GetLevel());
+
+	// Summed into the result so the optimizer can't drop the scans
+	size_t checksum = 0;
+	{
+		START_PROFILER((label + " Find").c_str());
+		for (size_t i = 0; i < kRepeatCount; ++i)
+			checksum += values.Find(static_cast<Type>(-1)).value_or(0);
+	}
+	{
+		START_PROFILER((label + " Count").c_str());
+		for (size_t i = 0; i < kRepeatCount; ++i)
+			checksum += values.Count(static_cast<Type>(i));
+	}
+	{
+		START_PROFILER((label + " MinMax").c_str());
+		for (size_t i = 0; i < kRepeatCount; ++i)
+			checksum += static_cast<size_t>(values.MinMax().second);
+	}
+	return checksum;
+}
+
+template<typename Type>
+size_t RunAllLevels(const char* typeName)
+{
+	std::mt19937 random(static_cast<unsigned int>(kElementCount));
+	zxstl::vector<Type> values;
+	values.reserve(kElementCount);
+	for (size_t i = 0; i < kElementCount; ++i)
+		values.push_back(static_cast<Type>(random() % 100));
+
+	size_t checksum = 0;
+	for (zxstl::simd::Level level : { zxstl::simd::Level::kScalar, zxstl::simd::Level::kSse2, zxstl::simd::Level::kAvx2 })
+	{
+		if (level <= zxstl::simd::DetectLevel())
+			checksum += RunScans(values, level, typeName);
+	}
+	zxstl::simd::SetLevel(zxstl::simd::DetectLevel());
+	return checksum;
+}
+
+int simdscanbenchmark()
+{
+	size_t checksum = 0;
+	checksum += RunAllLevels<uint8_t>("uint8_t");
+	checksum += RunAllLevels<int32_t>("int32_t");
+	checksum += RunAllLevels<float>("float");
+	checksum += RunAllLevels<double>("double");
+	return static_cast<int>(checksum & 1);
+}
@@ -174,7 +174,8 @@ void StructureManager::InitHashTable()
 	m_operationMap[DataStructure::kHashTable].emplace_back("Insert");
 	m_operationMap[DataStructure::kHashTable].emplace_back("Clear");
 	m_operationMap[DataStructure::kHashTable].emplace_back("Delete");
-	// m_operationMap[DataStructure::kHashTable].emplace_back("Find");
+	m_operationMap[DataStructure::kHashTable].emplace_back("Find");
+	m_operationMap[DataStructure::kHashTable].emplace_back("Reserve");
 }
 
 void StructureManager::InitBinarySearchTree()
@@ -6,8 +6,10 @@
 
 // Used for unit tests
 #define RETURN_ERROR(reason)\
-	std::cout << "Unit test failed at: " << reason << std::endl;\
-	return false;
+	do {\
+		std::cout << "Unit test failed at: " << reason << std::endl;\
+		return false;\
+	} while (0)
 
 static constexpr size_t kTestSize = 50;
 static constexpr size_t kInitialCapacity = 10;   // Default capacity for default ctor
@@ -0,0 +1,87 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/BinarySearchTree.h"
+#include "DataStructures/RedBlackTree.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+static constexpr size_t kKeyCount = 1'000'000;
+static constexpr size_t kBatchCount = 200'000;
+
+// xorshift, cheap enough to not hide the cost of the trees
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+int treebulkloadbenchmark()
+{
+	using Pair = std::pair<uint32_t, uint32_t>;
+
+	uint32_t state = 1;
+	std::vector<Pair> sortedPairs(kKeyCount);
+	for (Pair& pair : sortedPairs)
+		pair = { NextRandom(state), 0 };
+	std::sort(sortedPairs.begin(), sortedPairs.end());
+
+	std::vector<Pair> batch(kBatchCount);
+	for (Pair& pair : batch)
+		pair = { NextRandom(state), 1 };
+
+	uint64_t checksum = 0;
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Warm up an index from sorted data, one Insert() per key against one BuildFromSorted()
+	//--------------------------------------------------------------------------------------------------------------------
+	{
+		zxstl::RedBlackTree<uint32_t, uint32_t> tree;
+		START_PROFILER("RedBlackTree Insert sorted");
+		for (const Pair& pair : sortedPairs)
+			tree.Insert(pair.first, pair.second);
+		checksum += tree.GetSize();
+	}
+
+	{
+		zxstl::RedBlackTree<uint32_t, uint32_t> tree;
+		START_PROFILER("RedBlackTree BuildFromSorted");
+		tree.BuildFromSorted(sortedPairs);
+		checksum += tree.GetSize();
+	}
+
+	{
+		zxstl::BinarySearchTree<uint32_t, uint32_t> tree;
+		START_PROFILER("BinarySearchTree BuildFromSorted");
+		tree.BuildFromSorted(sortedPairs);
+		checksum += tree.GetSize();
+	}
+
+	//--------------------------------------------------------------------------------------------------------------------
+	// Add an unsorted batch to a built index
+	//--------------------------------------------------------------------------------------------------------------------
+	{
+		zxstl::RedBlackTree<uint32_t, uint32_t> tree;
+		tree.BuildFromSorted(sortedPairs);
+
+		START_PROFILER("RedBlackTree Insert batch");
+		for (const Pair& pair : batch)
+			tree.Insert(pair.first, pair.second);
+		checksum += tree.GetSize();
+	}
+
+	{
+		zxstl::RedBlackTree<uint32_t, uint32_t> tree;
+		tree.BuildFromSorted(sortedPairs);
+
+		START_PROFILER("RedBlackTree InsertMany batch");
+		tree.InsertMany(batch);
+		checksum += tree.GetSize();
+	}
+
+	return static_cast<int>(checksum & 1);
+}
@@ -0,0 +1,98 @@
+#include "Tests/StructureManager.h"
+#include "DataStructures/list.h"
+#include "DataStructures/unrolled_list.h"
+#include "Timing/SimpleInstrumentationProfiler.h"
+
+#include <cstdint>
+#include <string>
+
+static constexpr size_t kElementCount = 1'000'000;
+static constexpr size_t kTraversalCount = 20;
+static constexpr size_t kIndexedElementCount = 20'000;		// Insert / DeleteByIndex walk the list, keep it short
+static constexpr size_t kIndexedOperationCount = 20'000;
+
+// xorshift, cheap enough to not hide the cost of the list
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Time the same workloads on list and unrolled_list, the profiler prints each phase
+//--------------------------------------------------------------------------------------------------------------------
+template<typename List>
+uint64_t RunListWorkload(const char* label)
+{
+	const std::string name(label);
+	uint64_t checksum = 0;
+
+	{
+		List list;
+		{
+			const std::string profilerLabel = name + " PushBack";
+			START_PROFILER(profilerLabel.c_str());
+			for (size_t i = 0; i < kElementCount; ++i)
+				list.PushBack(static_cast<uint32_t>(i));
+		}
+
+		{
+			const std::string profilerLabel = name + " traversal";
+			START_PROFILER(profilerLabel.c_str());
+			for (size_t round = 0; round < kTraversalCount; ++round)
+				list.ForEach([&checksum](uint32_t value) { checksum += value; });
+		}
+
+		{
+			const std::string profilerLabel = name + " PopFront";
+			START_PROFILER(profilerLabel.c_str());
+			while (!list.Empty())
+				checksum += list.PopFront();
+		}
+	}
+
+	{
+		List list;
+		for (size_t i = 0; i < kIndexedElementCount; ++i)
+			list.PushBack(static_cast<uint32_t>(i));
+
+		const std::string profilerLabel = name + " Insert / DeleteByIndex";
+		START_PROFILER(profilerLabel.c_str());
+
+		uint32_t state = 1;
+		for (size_t i = 0; i < kIndexedOperationCount; ++i)
+		{
+			const uint32_t random = NextRandom(state);
+			if (list.Empty() || (random & (1u << 31)))
+				list.Insert(random % (list.GetSize() + 1), random);
+			else
+				list.DeleteByIndex(random % list.GetSize());
+		}
+		checksum += list.GetSize();
+	}
+
+	return checksum;
+}
+
+int unrolledlistbenchmark()
+{
+	uint64_t checksum = 0;
+	checksum += RunListWorkload<zxstl::list<uint32_t>>("list");
+	checksum += RunListWorkload<zxstl::unrolled_list<uint32_t>>("unrolled_list");
+
+	// Sort has no counterpart in list yet
+	zxstl::unrolled_list<uint32_t> list;
+	uint32_t state = 1;
+	for (size_t i = 0; i < kElementCount; ++i)
+		list.PushBack(NextRandom(state));
+
+	{
+		START_PROFILER("unrolled_list Sort");
+		list.Sort();
+	}
+	checksum += list.front();
+
+	return static_cast<int>(checksum & 1);
+}
@@ -0,0 +1,105 @@
+// FixedBlockPool.cpp
+#include "FixedBlockPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+//-----------------------------------------------------------------------------------------------------------
+// Blocks are at least pointer sized, to hold the free list link, and rounded up to the alignment. The pool
+// belongs to the constructing thread.
+//-----------------------------------------------------------------------------------------------------------
+FixedBlockPool::FixedBlockPool(size_t blockSize, size_t alignment /*= alignof(std::max_align_t)*/, size_t chunkSize /*= kDefaultChunkSize*/)
+	: m_pFreeList(nullptr)
+	, m_pChunks(nullptr)
+	, m_pUncarved(nullptr)
+	, m_pUncarvedEnd(nullptr)
+	, m_blockSize(AlignUp(std::max(blockSize, sizeof(FreeBlock)), std::max(alignment, alignof(FreeBlock))))
+	, m_alignment(std::max({ alignment, alignof(FreeBlock), alignof(Chunk) }))
+	, m_chunkSize(std::bit_ceil(chunkSize))
+	, m_pRemoteFreeList(nullptr)
+	, m_ownerThread(std::this_thread::get_id())
+{
+	assert((alignment & (alignment - 1)) == 0);
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Move ctor, the chunks now belong to this pool. The other must not have remote frees in flight.
+//-----------------------------------------------------------------------------------------------------------
+FixedBlockPool::FixedBlockPool(FixedBlockPool&& other) noexcept
+	: m_pFreeList(std::exchange(other.m_pFreeList, nullptr))
+	, m_pChunks(std::exchange(other.m_pChunks, nullptr))
+	, m_pUncarved(std::exchange(other.m_pUncarved, nullptr))
+	, m_pUncarvedEnd(std::exchange(other.m_pUncarvedEnd, nullptr))
+	, m_blockSize(other.m_blockSize)
+	, m_alignment(other.m_alignment)
+	, m_chunkSize(other.m_chunkSize)
+	, m_stats(std::exchange(other.m_stats, AllocationStats()))
+	, m_pRemoteFreeList(other.m_pRemoteFreeList.exchange(nullptr, std::memory_order_acquire))
+	, m_ownerThread(other.m_ownerThread.load(std::memory_order_relaxed))
+{
+	for (Chunk* pChunk = m_pChunks; pChunk; pChunk = pChunk->m_pNext)
+		pChunk->m_pPool = this;
+}
+
+FixedBlockPool::~FixedBlockPool()
+{
+	Release();
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Give every chunk back to the system. Every block must have been freed already
+//-----------------------------------------------------------------------------------------------------------
+void FixedBlockPool::Release()
+{
+	ReclaimRemoteFrees();
+	assert(m_stats.m_bytesInUse == 0);
+
+	while (m_pChunks)
+	{
+		Chunk* pNext = m_pChunks->m_pNext;
+		::operator delete(m_pChunks, std::align_val_t{ std::max(m_alignment, m_chunkSize) });
+		m_pChunks = pNext;
+	}
+
+	m_pFreeList = nullptr;
+	m_pUncarved = nullptr;
+	m_pUncarvedEnd = nullptr;
+	m_stats.m_bytesReserved = 0;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Allocate a new chunk, its blocks are carved out one by one as they're needed, so fresh memory isn't touched early
+//-----------------------------------------------------------------------------------------------------------
+void FixedBlockPool::AddChunk()
+{
+	const size_t headerSize = AlignUp(sizeof(Chunk), m_alignment);
+	const size_t chunkSize = std::max(m_chunkSize, headerSize + m_blockSize);
+	const size_t blockCount = (chunkSize - headerSize) / m_blockSize;
+
+	Chunk* pChunk = static_cast<Chunk*>(::operator new(chunkSize, std::align_val_t{ std::max(m_alignment, m_chunkSize) }));
+	pChunk->m_pNext = m_pChunks;
+	pChunk->m_pPool = this;
+	m_pChunks = pChunk;
+
+	m_pUncarved = reinterpret_cast<std::byte*>(pChunk) + headerSize;
+	m_pUncarvedEnd = m_pUncarved + blockCount * m_blockSize;
+	m_stats.m_bytesReserved += chunkSize;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Owner only, put the blocks other threads freed back on the free list
+// Time:  O(n) for n blocks taken back
+//-----------------------------------------------------------------------------------------------------------
+void FixedBlockPool::ReclaimRemoteFrees()
+{
+	FreeBlock* pRemoteBlocks = m_pRemoteFreeList.exchange(nullptr, std::memory_order_acquire);
+	while (pRemoteBlocks)
+	{
+		FreeBlock* pNext = pRemoteBlocks->m_pNext;
+		pRemoteBlocks->m_pNext = m_pFreeList;
+		m_pFreeList = pRemoteBlocks;
+		m_stats.OnDeallocate(m_blockSize);
+		pRemoteBlocks = pNext;
+	}
+}
@@ -0,0 +1,334 @@
+// FixedBlockPool.h
+#pragma once
+
+#include "Memory.h"
+#include "Tests/StructureManager.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------------------
+// Pool of same sized blocks, made for the nodes of node based containers. Blocks are carved out of big chunks
+// on demand, freed blocks go onto an intrusive free list and are handed out again first, so a container which
+// keeps inserting and erasing stops touching the system allocator.
+// The pool belongs to the thread which made it, only that thread allocates. Any thread can free: blocks freed
+// by other threads go onto a lock-free remote list, and the owner takes them all back at once when its own free
+// list runs dry. See GetThreadLocal().
+//-----------------------------------------------------------------------------------------------------------
+class FixedBlockPool
+{
+	friend class SlabHeap;
+
+	struct FreeBlock
+	{
+		FreeBlock* m_pNext;
+	};
+
+	// Header at the front of every chunk, blocks follow. Chunks are aligned to the chunk size, so a block finds
+	// its chunk, and the pool, by masking its address.
+	struct Chunk
+	{
+		Chunk* m_pNext;
+		FixedBlockPool* m_pPool;
+	};
+
+	FreeBlock* m_pFreeList;
+	Chunk* m_pChunks;
+	std::byte* m_pUncarved;			// Blocks of the newest chunk which were never handed out
+	std::byte* m_pUncarvedEnd;
+	size_t m_blockSize;
+	size_t m_alignment;
+	size_t m_chunkSize;				// Power of two
+	AllocationStats m_stats;
+
+	std::atomic<FreeBlock*> m_pRemoteFreeList;		// Pushed by other threads, taken whole by the owner
+	std::atomic<std::thread::id> m_ownerThread;		// No thread while orphaned, see GetThreadLocal()
+
+public:
+	static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+	explicit FixedBlockPool(size_t blockSize, size_t alignment = alignof(std::max_align_t), size_t chunkSize = kDefaultChunkSize);
+	FixedBlockPool(FixedBlockPool&& other) noexcept;
+	FixedBlockPool(const FixedBlockPool&) = delete;
+	FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+	~FixedBlockPool();
+
+	// API
+	void* Allocate();
+	void Deallocate(void* pBlock);
+	void ReclaimRemoteFrees();
+	void Release();
+
+	// Getter
+	size_t GetBlockSize() const { return m_blockSize; }
+	size_t GetAlignment() const { return m_alignment; }
+	const AllocationStats& GetStats() const { return m_stats; }	// Blocks freed by other threads count until reclaimed
+	bool IsOwnedByThisThread() const { return m_ownerThread.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+
+	// Pool a block of a pool with the default chunk size came from
+	static FixedBlockPool& GetOwningPool(void* pBlock);
+	static constexpr bool FitsDefaultChunk(size_t blockSize, size_t alignment);
+
+	template<size_t kBlockSize, size_t kAlignment> static FixedBlockPool& GetThreadLocal();
+
+private:
+	void AddChunk();
+	void PushRemoteFree(FreeBlock* pFreeBlock);
+};
+
+//-----------------------------------------------------------------------------------------------------------
+// Pop the free list, take back the blocks other threads freed, or carve the next block out of the newest chunk
+// Time:  O(1), taking back the remote frees is O(1) per block taken
+//-----------------------------------------------------------------------------------------------------------
+inline void* FixedBlockPool::Allocate()
+{
+	if (!m_pFreeList && m_pRemoteFreeList.load(std::memory_order_relaxed))
+		ReclaimRemoteFrees();
+
+	void* pBlock = m_pFreeList;
+	if (m_pFreeList)
+	{
+		m_pFreeList = m_pFreeList->m_pNext;
+	}
+	else
+	{
+		if (m_pUncarved == m_pUncarvedEnd)
+			AddChunk();
+
+		pBlock = m_pUncarved;
+		m_pUncarved += m_blockSize;
+	}
+
+	m_stats.OnAllocate(m_blockSize);
+	return pBlock;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Push the block onto the free list, or onto the remote list if this thread doesn't own the pool
+// Time:  O(1)
+//-----------------------------------------------------------------------------------------------------------
+inline void FixedBlockPool::Deallocate(void* pBlock)
+{
+	if (!pBlock)
+		return;
+
+	FreeBlock* pFreeBlock = static_cast<FreeBlock*>(pBlock);
+	if (!IsOwnedByThisThread())
+	{
+		PushRemoteFree(pFreeBlock);
+		return;
+	}
+
+	pFreeBlock->m_pNext = m_pFreeList;
+	m_pFreeList = pFreeBlock;
+	m_stats.OnDeallocate(m_blockSize);
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Lock-free push, the owner only ever takes the whole list, so a block can't come back under a push (no ABA)
+//-----------------------------------------------------------------------------------------------------------
+inline void FixedBlockPool::PushRemoteFree(FreeBlock* pFreeBlock)
+{
+	FreeBlock* pHead = m_pRemoteFreeList.load(std::memory_order_relaxed);
+	do
+	{
+		pFreeBlock->m_pNext = pHead;
+	} while (!m_pRemoteFreeList.compare_exchange_weak(pHead, pFreeBlock, std::memory_order_release, std::memory_order_relaxed));
+}
+
+inline FixedBlockPool& FixedBlockPool::GetOwningPool(void* pBlock)
+{
+	const uintptr_t kChunkAddress = reinterpret_cast<uintptr_t>(pBlock) & ~static_cast<uintptr_t>(kDefaultChunkSize - 1);
+	FixedBlockPool* pPool = reinterpret_cast<Chunk*>(kChunkAddress)->m_pPool;
+	assert(pPool->m_chunkSize == kDefaultChunkSize);
+	return *pPool;
+}
+
+// A block fits if the chunk header and one block of that alignment fit in a default chunk
+constexpr bool FixedBlockPool::FitsDefaultChunk(size_t blockSize, size_t alignment)
+{
+	return alignment <= kDefaultChunkSize && AlignUp(sizeof(Chunk), alignment) + blockSize <= kDefaultChunkSize;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Pool of this thread for blocks of kBlockSize bytes, no locking needed to allocate. When the thread exits,
+// the pool is destroyed if every block came back. Otherwise it's orphaned: the blocks still out can be freed
+// from any thread onto its remote list, and the next thread asking for a pool of this size adopts it, blocks
+// freed since included.
+//-----------------------------------------------------------------------------------------------------------
+template<size_t kBlockSize, size_t kAlignment>
+inline FixedBlockPool& FixedBlockPool::GetThreadLocal()
+{
+	static std::mutex s_orphanMutex;
+	static std::vector<FixedBlockPool*> s_orphans;
+
+	struct Owner
+	{
+		FixedBlockPool*& m_pPool;
+
+		~Owner()
+		{
+			// No block out means no thread can be freeing into the pool, it's safe to delete
+			m_pPool->ReclaimRemoteFrees();
+			if (m_pPool->m_stats.m_bytesInUse == 0)
+			{
+				delete m_pPool;
+			}
+			else
+			{
+				m_pPool->m_ownerThread.store(std::thread::id(), std::memory_order_relaxed);
+				std::lock_guard lock(s_orphanMutex);
+				s_orphans.emplace_back(m_pPool);
+			}
+			m_pPool = nullptr;
+		}
+	};
+
+	// The pointer is trivially destructible, so it stays readable while other thread locals are destroyed
+	thread_local FixedBlockPool* s_pPool = nullptr;
+	if (!s_pPool)
+	{
+		{
+			std::lock_guard lock(s_orphanMutex);
+			if (!s_orphans.empty())
+			{
+				s_pPool = s_orphans.back();
+				s_orphans.pop_back();
+			}
+		}
+
+		if (s_pPool)
+			s_pPool->m_ownerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+		else
+			s_pPool = new FixedBlockPool(kBlockSize, kAlignment);
+
+		// Only the first pool is owned, one made after the owner is gone (during thread teardown) is left alive
+		thread_local Owner s_owner{ s_pPool };
+	}
+	return *s_pPool;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// std style allocator taking single objects from the FixedBlockPool sized for Type of the allocating thread.
+// Meant for the nodes of list, RedBlackTree and BinarySearchTree, which allocate one node at a time. Arrays, and
+// types too big for a default chunk, skip the pool.
+// It holds no state: a block goes back to the pool it came from, found from its address, whichever thread frees
+// it. So every PoolAllocator is equal and a container can be handed to another thread, which then allocates
+// from its own pools.
+//-----------------------------------------------------------------------------------------------------------
+template<class Type>
+class PoolAllocator
+{
+	static constexpr bool kIsPooled = FixedBlockPool::FitsDefaultChunk(sizeof(Type), alignof(Type));
+
+public:
+	using value_type = Type;
+	using is_always_equal = std::true_type;
+
+	PoolAllocator() noexcept = default;
+	template<class Other> PoolAllocator(const PoolAllocator<Other>&) noexcept {}
+
+	Type* allocate(size_t count)
+	{
+		if (kIsPooled && count == 1)
+			return static_cast<Type*>(GetPool().Allocate());
+		return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t{ alignof(Type) }));
+	}
+
+	void deallocate(Type* pMemory, size_t count) noexcept
+	{
+		if (kIsPooled && count == 1)
+			FixedBlockPool::GetOwningPool(pMemory).Deallocate(pMemory);
+		else
+			::operator delete(pMemory, std::align_val_t{ alignof(Type) });
+	}
+
+	// Pool of this thread
+	static FixedBlockPool& GetPool() { return FixedBlockPool::GetThreadLocal<sizeof(Type), alignof(Type)>(); }
+
+	template<class Other> bool operator==(const PoolAllocator<Other>&) const noexcept { return true; }
+
+	static bool UnitTest();
+};
+
+//-----------------------------------------------------------------------------------------------------------
+// Automated test, blocks freed on another thread must go back to the pool they came from, even while its thread
+// keeps allocating, and the pool of a thread which exited with blocks out must be adopted
+//-----------------------------------------------------------------------------------------------------------
+template<class Type>
+inline bool PoolAllocator<Type>::UnitTest()
+{
+	static_assert(kIsPooled, "PoolAllocator::UnitTest() needs a pooled type");
+
+	PoolAllocator allocator;
+	if (!(PoolAllocator(PoolAllocator<char>(allocator)) == allocator))
+		RETURN_ERROR("PoolAllocator rebinding");
+
+	//---------------------------------------------------------------
+	// Free on a worker while the owner keeps allocating
+	//---------------------------------------------------------------
+	FixedBlockPool& pool = GetPool();
+	const size_t kBytesInUse = pool.GetStats().m_bytesInUse;
+	std::vector<Type*> blocks;
+	for (size_t i = 0; i < kTestSize * 20; ++i)
+		blocks.emplace_back(allocator.allocate(1));
+
+	std::thread worker([&blocks]()
+	{
+		PoolAllocator workerAllocator;
+		for (Type* pBlock : blocks)
+			workerAllocator.deallocate(pBlock, 1);
+	});
+	for (size_t round = 0; round < kTestSize * 20; ++round)
+		allocator.deallocate(allocator.allocate(1), 1);
+	worker.join();
+
+	pool.ReclaimRemoteFrees();
+	if (pool.GetStats().m_bytesInUse != kBytesInUse)
+		RETURN_ERROR("PoolAllocator::deallocate() on another thread");
+
+	//---------------------------------------------------------------
+	// Allocate on a thread which then exits, its pool is orphaned
+	//---------------------------------------------------------------
+	blocks.clear();
+	std::thread([&blocks]()
+	{
+		PoolAllocator threadAllocator;
+		for (size_t i = 0; i < kTestSize; ++i)
+			blocks.emplace_back(threadAllocator.allocate(1));
+	}).join();
+
+	FixedBlockPool* pOrphan = &FixedBlockPool::GetOwningPool(blocks.front());
+	if (pOrphan == &pool || pOrphan->GetStats().m_bytesInUse != kTestSize * pOrphan->GetBlockSize())
+		RETURN_ERROR("PoolAllocator::allocate() on a thread which exits");
+
+	//---------------------------------------------------------------
+	// Free on another thread, which then adopts the orphan and deletes it on exit
+	//---------------------------------------------------------------
+	bool isAdopted = false;
+	std::thread([&]()
+	{
+		PoolAllocator threadAllocator;
+		for (Type* pBlock : blocks)
+			threadAllocator.deallocate(pBlock, 1);
+
+		Type* pBlock = threadAllocator.allocate(1);
+		isAdopted = &FixedBlockPool::GetOwningPool(pBlock) == pOrphan && GetPool().GetStats().m_bytesInUse == pOrphan->GetBlockSize();
+		threadAllocator.deallocate(pBlock, 1);
+	}).join();
+
+	if (!isAdopted)
+		RETURN_ERROR("FixedBlockPool::GetThreadLocal() adopting an orphaned pool");
+
+	//---------------------------------------------------------------
+	// Success
+	//---------------------------------------------------------------
+	return true;
+}
@@ -0,0 +1,34 @@
+// Memory.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------------------------------------
+// Byte counters kept by every allocator in Memory/
+//-----------------------------------------------------------------------------------------------------------
+struct AllocationStats
+{
+	size_t m_bytesInUse = 0;		// Handed out and not given back yet
+	size_t m_highWaterMark = 0;		// Most bytes in use at once
+	size_t m_bytesReserved = 0;		// Taken from the system, in use or cached for reuse
+	size_t m_allocationCount = 0;	// Every allocation ever made
+
+	void OnAllocate(size_t bytes)
+	{
+		m_bytesInUse += bytes;
+		m_highWaterMark = std::max(m_highWaterMark, m_bytesInUse);
+		++m_allocationCount;
+	}
+
+	void OnDeallocate(size_t bytes) { m_bytesInUse -= bytes; }
+};
+
+// Round value up to a multiple of alignment, which must be a power of two
+constexpr size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+inline std::byte* AlignUp(std::byte* pAddress, size_t alignment)
+{
+	return pAddress + (AlignUp(reinterpret_cast<uintptr_t>(pAddress), alignment) - reinterpret_cast<uintptr_t>(pAddress));
+}
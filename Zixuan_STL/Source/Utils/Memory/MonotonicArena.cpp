@@ -0,0 +1,83 @@
+// MonotonicArena.cpp
+#include "MonotonicArena.h"
+
+#include <algorithm>
+#include <new>
+
+MonotonicArena::MonotonicArena(size_t initialBlockSize /*= kDefaultBlockSize*/)
+	: m_pCurrentBlock(nullptr)
+	, m_pCursor(nullptr)
+	, m_pEnd(nullptr)
+	, m_nextBlockSize(std::max<size_t>(initialBlockSize, 2 * sizeof(Block)))
+{
+}
+
+MonotonicArena::~MonotonicArena()
+{
+	Release();
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Free every allocation at once. The newest block, which is also the biggest, is kept for the next round
+// Time:  O(b), b = block count
+//-----------------------------------------------------------------------------------------------------------
+void MonotonicArena::Reset()
+{
+	if (!m_pCurrentBlock)
+		return;
+
+	FreeBlocks(m_pCurrentBlock->m_pPrevious);
+	m_pCurrentBlock->m_pPrevious = nullptr;
+
+	m_pCursor = reinterpret_cast<std::byte*>(m_pCurrentBlock + 1);
+	m_pEnd = reinterpret_cast<std::byte*>(m_pCurrentBlock) + m_pCurrentBlock->m_size;
+	m_stats.m_bytesInUse = 0;
+	m_stats.m_bytesReserved = m_pCurrentBlock->m_size;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Free every allocation and give every block back to the system
+//-----------------------------------------------------------------------------------------------------------
+void MonotonicArena::Release()
+{
+	FreeBlocks(m_pCurrentBlock);
+	m_pCurrentBlock = nullptr;
+	m_pCursor = nullptr;
+	m_pEnd = nullptr;
+	m_stats.m_bytesInUse = 0;
+	m_stats.m_bytesReserved = 0;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// The current block can't fit bytes, chain a new one which can, at least twice as big as the last one
+//-----------------------------------------------------------------------------------------------------------
+void* MonotonicArena::AllocateFromNewBlock(size_t bytes, size_t alignment)
+{
+	const size_t headerSize = AlignUp(sizeof(Block), alignment);
+	const size_t blockSize = std::max(m_nextBlockSize, headerSize + bytes);
+	const size_t blockAlignment = std::max(alignment, alignof(Block));
+
+	Block* pBlock = static_cast<Block*>(::operator new(blockSize, std::align_val_t{ blockAlignment }));
+	pBlock->m_pPrevious = m_pCurrentBlock;
+	pBlock->m_size = blockSize;
+	pBlock->m_alignment = blockAlignment;
+
+	m_pCurrentBlock = pBlock;
+	m_pCursor = reinterpret_cast<std::byte*>(pBlock) + headerSize + bytes;
+	m_pEnd = reinterpret_cast<std::byte*>(pBlock) + blockSize;
+	m_nextBlockSize = blockSize * 2;
+
+	m_stats.m_bytesReserved += blockSize;
+	m_stats.OnAllocate(bytes);
+	return reinterpret_cast<std::byte*>(pBlock) + headerSize;
+}
+
+void MonotonicArena::FreeBlocks(Block* pBlock)
+{
+	while (pBlock)
+	{
+		Block* pPrevious = pBlock->m_pPrevious;
+		::operator delete(pBlock, std::align_val_t{ pBlock->m_alignment });
+		pBlock = pPrevious;
+	}
+}
@@ -0,0 +1,92 @@
+// MonotonicArena.h
+#pragma once
+
+#include "Memory.h"
+
+#include <cassert>
+#include <cstddef>
+
+//-----------------------------------------------------------------------------------------------------------
+// Bump allocator for data which all dies at the same time, e.g. everything made while handling one request.
+// Allocating is a pointer bump, freeing one allocation does nothing, Reset() frees everything at once.
+// Blocks double in size as the arena grows. Not thread safe.
+//-----------------------------------------------------------------------------------------------------------
+class MonotonicArena
+{
+	// Header at the front of every block, blocks are chained from the newest to the oldest
+	struct Block
+	{
+		Block* m_pPrevious;
+		size_t m_size;
+		size_t m_alignment;
+	};
+
+	Block* m_pCurrentBlock;
+	std::byte* m_pCursor;			// Next free byte in the current block
+	std::byte* m_pEnd;				// End of the current block
+	size_t m_nextBlockSize;
+	AllocationStats m_stats;
+
+public:
+	static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+	explicit MonotonicArena(size_t initialBlockSize = kDefaultBlockSize);
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena& operator=(const MonotonicArena&) = delete;
+	~MonotonicArena();
+
+	// API
+	void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+	void Deallocate(void*, size_t) {}
+	void Reset();
+	void Release();
+
+	// Getter
+	const AllocationStats& GetStats() const { return m_stats; }
+
+private:
+	void* AllocateFromNewBlock(size_t bytes, size_t alignment);
+	void FreeBlocks(Block* pBlock);
+};
+
+//-----------------------------------------------------------------------------------------------------------
+// Bump the cursor, a new block is only needed when the current one is full
+// Time:  O(1)
+//-----------------------------------------------------------------------------------------------------------
+inline void* MonotonicArena::Allocate(size_t bytes, size_t alignment /*= alignof(std::max_align_t)*/)
+{
+	assert((alignment & (alignment - 1)) == 0);
+
+	std::byte* pAligned = AlignUp(m_pCursor, alignment);
+	if (!m_pCursor || static_cast<size_t>(m_pEnd - m_pCursor) < static_cast<size_t>(pAligned - m_pCursor) + bytes)
+		return AllocateFromNewBlock(bytes, alignment);
+
+	m_pCursor = pAligned + bytes;
+	m_stats.OnAllocate(bytes);
+	return pAligned;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// std style allocator handing out memory from a MonotonicArena. deallocate() does nothing, the memory comes back
+// when the arena is reset. The arena must outlive every container using it.
+//-----------------------------------------------------------------------------------------------------------
+template<class Type>
+class ArenaAllocator
+{
+	template<class> friend class ArenaAllocator;
+
+	MonotonicArena* m_pArena;
+
+public:
+	using value_type = Type;
+
+	ArenaAllocator(MonotonicArena& arena) noexcept : m_pArena(&arena) {}
+	template<class Other> ArenaAllocator(const ArenaAllocator<Other>& other) noexcept : m_pArena(other.m_pArena) {}
+
+	Type* allocate(size_t count) { return static_cast<Type*>(m_pArena->Allocate(count * sizeof(Type), alignof(Type))); }
+	void deallocate(Type*, size_t) noexcept {}
+
+	MonotonicArena& GetArena() const { return *m_pArena; }
+
+	template<class Other> bool operator==(const ArenaAllocator<Other>& other) const noexcept { return m_pArena == other.m_pArena; }
+};
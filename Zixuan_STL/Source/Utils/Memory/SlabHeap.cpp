@@ -0,0 +1,93 @@
+// SlabHeap.cpp
+#include "SlabHeap.h"
+
+#include <mutex>
+
+SlabHeap::SlabHeap(size_t chunkSize /*= FixedBlockPool::kDefaultChunkSize*/)
+	: m_ownerThread(std::this_thread::get_id())
+{
+	m_pools.reserve(kSizeClassCount);
+	for (size_t size : kSizeClasses)
+		m_pools.emplace_back(size, kSlabAlignment, chunkSize);
+
+	// Every 16 byte step maps to the first class big enough for it
+	size_t sizeClass = 0;
+	for (size_t step = 0; step < m_classOfSize.size(); ++step)
+	{
+		while (kSizeClasses[sizeClass] < step * kGranularity)
+			++sizeClass;
+		m_classOfSize[step] = static_cast<uint8_t>(sizeClass);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Heap of this thread. Like the thread local pools, it's destroyed with its thread if no memory is in use,
+// otherwise it's orphaned and the next thread asking for a heap adopts it, with all its cached memory.
+//-----------------------------------------------------------------------------------------------------------
+SlabHeap& SlabHeap::GetThreadLocal()
+{
+	static std::mutex s_orphanMutex;
+	static std::vector<SlabHeap*> s_orphans;
+
+	struct Owner
+	{
+		SlabHeap*& m_pHeap;
+
+		~Owner()
+		{
+			if (m_pHeap->m_stats.m_bytesInUse == 0)
+			{
+				delete m_pHeap;
+			}
+			else
+			{
+				m_pHeap->SetOwnerThread(std::thread::id());
+				std::lock_guard lock(s_orphanMutex);
+				s_orphans.emplace_back(m_pHeap);
+			}
+			m_pHeap = nullptr;
+		}
+	};
+
+	thread_local SlabHeap* s_pHeap = nullptr;
+	if (!s_pHeap)
+	{
+		{
+			std::lock_guard lock(s_orphanMutex);
+			if (!s_orphans.empty())
+			{
+				s_pHeap = s_orphans.back();
+				s_orphans.pop_back();
+			}
+		}
+
+		if (s_pHeap)
+			s_pHeap->SetOwnerThread(std::this_thread::get_id());
+		else
+			s_pHeap = new SlabHeap();
+
+		thread_local Owner s_owner{ s_pHeap };
+	}
+	return *s_pHeap;
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Hand the heap and its pools to another thread, or to none while orphaned
+//-----------------------------------------------------------------------------------------------------------
+void SlabHeap::SetOwnerThread(std::thread::id ownerThread)
+{
+	m_ownerThread.store(ownerThread, std::memory_order_relaxed);
+	for (FixedBlockPool& pool : m_pools)
+		pool.m_ownerThread.store(ownerThread, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Reserved bytes are the big allocations plus every chunk of every pool
+//-----------------------------------------------------------------------------------------------------------
+AllocationStats SlabHeap::GetStats() const
+{
+	AllocationStats stats = m_stats;
+	for (const FixedBlockPool& pool : m_pools)
+		stats.m_bytesReserved += pool.GetStats().m_bytesReserved;
+	return stats;
+}
@@ -0,0 +1,129 @@
+// SlabHeap.h
+#pragma once
+
+#include "FixedBlockPool.h"
+#include "Memory.h"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------------------
+// General purpose allocator made of one FixedBlockPool per size class. A request is rounded up to the smallest
+// class that fits it and served by that pool, so small allocations of any size get pool speed. Requests bigger
+// than kMaxSlabSize, or aligned more than kSlabAlignment, go to the system allocator.
+// Not thread safe: the heap belongs to the thread which made it, which alone allocates and frees, asserted in
+// debug builds. See GetThreadLocal().
+//-----------------------------------------------------------------------------------------------------------
+class SlabHeap
+{
+public:
+	static constexpr size_t kMaxSlabSize = 1024;
+	static constexpr size_t kSlabAlignment = 16;
+
+private:
+	// 16 byte steps for the smallest classes, then four classes per power of two, so at most 25% is wasted
+	static constexpr size_t kSizeClasses[] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024 };
+	static constexpr size_t kSizeClassCount = std::size(kSizeClasses);
+	static constexpr size_t kGranularity = 16;
+
+	std::vector<FixedBlockPool> m_pools;
+	std::array<uint8_t, kMaxSlabSize / kGranularity + 1> m_classOfSize;	// Size class index of every 16 byte step
+	AllocationStats m_stats;
+	std::atomic<std::thread::id> m_ownerThread;
+
+public:
+	explicit SlabHeap(size_t chunkSize = FixedBlockPool::kDefaultChunkSize);
+	SlabHeap(const SlabHeap&) = delete;
+	SlabHeap& operator=(const SlabHeap&) = delete;
+
+	// API
+	void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+	void Deallocate(void* pMemory, size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+	// Getter
+	AllocationStats GetStats() const;
+	const FixedBlockPool& GetPool(size_t sizeClass) const { return m_pools[sizeClass]; }
+	static constexpr size_t GetSizeClassCount() { return kSizeClassCount; }
+
+	static SlabHeap& GetThreadLocal();
+	bool IsOwnedByThisThread() const { return m_ownerThread.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+
+private:
+	void SetOwnerThread(std::thread::id ownerThread);
+	static bool IsSlabSized(size_t bytes, size_t alignment) { return bytes <= kMaxSlabSize && alignment <= kSlabAlignment; }
+};
+
+//-----------------------------------------------------------------------------------------------------------
+// Allocate from the pool of the size class of bytes
+// Time:  O(1)
+//-----------------------------------------------------------------------------------------------------------
+inline void* SlabHeap::Allocate(size_t bytes, size_t alignment /*= alignof(std::max_align_t)*/)
+{
+	assert(IsOwnedByThisThread());
+
+	if (!IsSlabSized(bytes, alignment))
+	{
+		m_stats.OnAllocate(bytes);
+		m_stats.m_bytesReserved += bytes;
+		return ::operator new(bytes, std::align_val_t{ alignment });
+	}
+
+	FixedBlockPool& pool = m_pools[m_classOfSize[(bytes + kGranularity - 1) / kGranularity]];
+	m_stats.OnAllocate(pool.GetBlockSize());
+	return pool.Allocate();
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Free memory from Allocate(), bytes and alignment must be what it was allocated with
+// Time:  O(1)
+//-----------------------------------------------------------------------------------------------------------
+inline void SlabHeap::Deallocate(void* pMemory, size_t bytes, size_t alignment /*= alignof(std::max_align_t)*/)
+{
+	if (!pMemory)
+		return;
+
+	assert(IsOwnedByThisThread());
+	if (!IsSlabSized(bytes, alignment))
+	{
+		m_stats.OnDeallocate(bytes);
+		m_stats.m_bytesReserved -= bytes;
+		::operator delete(pMemory, std::align_val_t{ alignment });
+		return;
+	}
+
+	FixedBlockPool& pool = m_pools[m_classOfSize[(bytes + kGranularity - 1) / kGranularity]];
+	m_stats.OnDeallocate(pool.GetBlockSize());
+	pool.Deallocate(pMemory);
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// std style allocator backed by a SlabHeap, the heap of the constructing thread by default.
+// The heap must outlive every container using it. It's thread affine like the heap: a container using it must be
+// filled and destroyed on the heap's thread, use PoolAllocator to hand node containers to other threads.
+//-----------------------------------------------------------------------------------------------------------
+template<class Type>
+class SlabAllocator
+{
+	template<class> friend class SlabAllocator;
+
+	SlabHeap* m_pHeap;
+
+public:
+	using value_type = Type;
+
+	SlabAllocator() noexcept : m_pHeap(&SlabHeap::GetThreadLocal()) {}
+	SlabAllocator(SlabHeap& heap) noexcept : m_pHeap(&heap) {}
+	template<class Other> SlabAllocator(const SlabAllocator<Other>& other) noexcept : m_pHeap(other.m_pHeap) {}
+
+	Type* allocate(size_t count) { return static_cast<Type*>(m_pHeap->Allocate(count * sizeof(Type), alignof(Type))); }
+	void deallocate(Type* pMemory, size_t count) noexcept { m_pHeap->Deallocate(pMemory, count * sizeof(Type), alignof(Type)); }
+
+	SlabHeap& GetHeap() const { return *m_pHeap; }
+
+	template<class Other> bool operator==(const SlabAllocator<Other>& other) const noexcept { return m_pHeap == other.m_pHeap; }
+};
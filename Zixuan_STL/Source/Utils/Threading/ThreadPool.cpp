@@ -0,0 +1,121 @@
+// ThreadPool.cpp
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(size_t threadCount /*= 0*/)
+	: m_shouldQuit(false)
+{
+	if (threadCount == 0)
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+
+	m_threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i)
+		m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Finish the queued tasks, then join every worker
+//-----------------------------------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_shouldQuit = true;
+	}
+	m_taskAvailable.notify_all();
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Pool shared by the whole program
+//-----------------------------------------------------------------------------------------------------------
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool instance;
+	return instance;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_tasks.push(std::move(task));
+	}
+	m_taskAvailable.notify_one();
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Run task(0) ... task(taskCount - 1) across the pool and return once all of them are done.
+// The calling thread takes tasks too, so this is safe to call from inside a task: if every worker is busy,
+// the caller simply runs everything itself.
+//-----------------------------------------------------------------------------------------------------------
+void ThreadPool::ParallelFor(size_t taskCount, const std::function<void(size_t)>& task)
+{
+	if (taskCount == 0)
+		return;
+
+	// Helpers may start after we returned, so they only share this heap state, and only call task while
+	// there are indices left
+	struct State
+	{
+		std::atomic<size_t> m_nextIndex{ 0 };
+		std::atomic<size_t> m_doneCount{ 0 };
+		size_t m_taskCount = 0;
+		const std::function<void(size_t)>* m_pTask = nullptr;
+		std::mutex m_mutex;
+		std::condition_variable m_finished;
+	};
+
+	std::shared_ptr<State> pState = std::make_shared<State>();
+	pState->m_taskCount = taskCount;
+	pState->m_pTask = &task;
+
+	auto work = [pState]()
+	{
+		for (size_t index = pState->m_nextIndex++; index < pState->m_taskCount; index = pState->m_nextIndex++)
+		{
+			(*pState->m_pTask)(index);
+			if (++pState->m_doneCount == pState->m_taskCount)
+			{
+				std::lock_guard lock(pState->m_mutex);
+				pState->m_finished.notify_all();
+			}
+		}
+	};
+
+	const size_t helperCount = std::min(m_threads.size(), taskCount - 1);
+	for (size_t i = 0; i < helperCount; ++i)
+		Enqueue(work);
+
+	work();
+
+	std::unique_lock lock(pState->m_mutex);
+	pState->m_finished.wait(lock, [&pState]() { return pState->m_doneCount == pState->m_taskCount; });
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Take tasks until the pool is destroyed
+//-----------------------------------------------------------------------------------------------------------
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock(m_mutex);
+			m_taskAvailable.wait(lock, [this]() { return m_shouldQuit || !m_tasks.empty(); });
+			if (m_tasks.empty())
+				return;
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop();
+		}
+
+		task();
+	}
+}
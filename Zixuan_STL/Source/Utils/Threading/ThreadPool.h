@@ -0,0 +1,40 @@
+// ThreadPool.h
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------------------
+// Fixed size pool of worker threads, created once and reused, so parallel algorithms don't pay for
+// creating threads on every call
+//-----------------------------------------------------------------------------------------------------------
+class ThreadPool
+{
+	std::vector<std::thread> m_threads;
+	std::queue<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_taskAvailable;
+	bool m_shouldQuit;
+
+public:
+	// threadCount = 0 uses one thread less than the hardware has, the calling thread works as well
+	explicit ThreadPool(size_t threadCount = 0);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool();
+
+	// Getter
+	static ThreadPool& Get();
+	size_t GetThreadCount() const { return m_threads.size(); }
+
+	// API
+	void Enqueue(std::function<void()> task);
+	void ParallelFor(size_t taskCount, const std::function<void(size_t)>& task);
+
+private:
+	void WorkerLoop();
+};